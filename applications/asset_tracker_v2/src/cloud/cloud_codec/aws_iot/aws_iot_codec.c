@@ -16,6 +16,7 @@
 #include "json_helpers.h"
 #include "json_common.h"
 #include "json_protocol_names.h"
+#include "stream_common.h"
 
 #include <logging/log.h>
 LOG_MODULE_REGISTER(cloud_codec, CONFIG_CLOUD_CODEC_LOG_LEVEL);
@@ -474,6 +475,15 @@ int cloud_codec_encode_batch_data(struct cloud_codec_data *output,
 	char *buffer;
 	bool object_added = false;
 
+	if (IS_ENABLED(CONFIG_CLOUD_CODEC_STREAMING)) {
+		return stream_common_batch_data_encode(output, gnss_buf, sensor_buf,
+						       modem_stat_buf, modem_dyn_buf, ui_buf,
+						       accel_buf, bat_buf, gnss_buf_count,
+						       sensor_buf_count, modem_stat_buf_count,
+						       modem_dyn_buf_count, ui_buf_count,
+						       accel_buf_count, bat_buf_count);
+	}
+
 	cJSON *root_obj = cJSON_CreateObject();
 
 	if (root_obj == NULL) {
@@ -200,6 +200,42 @@ struct cloud_codec_data {
 	size_t len;
 };
 
+/** @brief Function that is passed the output of the streaming encoder.
+ *
+ * @param[in] data Encoded output.
+ * @param[in] len Length of the encoded output.
+ * @param[in] user_data User data of the stream.
+ *
+ * @return 0 on success, otherwise a negative error code that stops the encoding.
+ */
+typedef int (*cloud_codec_stream_write_t)(const uint8_t *data, size_t len, void *user_data);
+
+/** @brief Output of the streaming encoder. Zero-initialize it and set either the output
+ *         buffer or the write function. If both are unset, the output is only measured.
+ */
+struct cloud_codec_stream {
+	/** Output buffer. */
+	uint8_t *buf;
+	/** Size of the output buffer. */
+	size_t size;
+	/** Function that is passed the output, in small pieces, if there is no output buffer. */
+	cloud_codec_stream_write_t write;
+	/** User data passed to the write function. */
+	void *user_data;
+	/** Encode CBOR instead of JSON. */
+	bool cbor;
+	/** Unqueue the encoded entries. Leave it unset when measuring the output. */
+	bool commit;
+	/** Length of encoded output. */
+	size_t len;
+	/** First error that occurred. The output that follows is discarded. */
+	int err;
+	/** Nesting depth of the current object or array. */
+	uint8_t depth;
+	/** Bit set for each nesting depth at which a member has been encoded. */
+	uint32_t members;
+};
+
 struct cloud_data_neighbor_cells {
 	struct lte_lc_cells_info cell_data;
 	struct lte_lc_ncell neighbor_cells[17];
@@ -287,6 +323,34 @@ int cloud_codec_encode_batch_data(struct cloud_codec_data *output,
 				  size_t accel_buf_count,
 				  size_t bat_buf_count);
 
+/**
+ * @brief Encode batch data directly into a stream, without allocating memory.
+ *
+ * The output is identical to that of @ref cloud_codec_encode_batch_data when encoding JSON.
+ * Only supported by the AWS IoT and Azure IoT Hub backends, with
+ * CONFIG_CLOUD_CODEC_STREAMING enabled.
+ *
+ * @param[inout] stream Output stream. The output is appended to it.
+ *
+ * @return 0 on success. -ENODATA if there is no data to encode. -ENOMEM if the output
+ *	   buffer is too small. Otherwise a negative error code is returned.
+ */
+int cloud_codec_encode_batch_data_stream(struct cloud_codec_stream *stream,
+					 struct cloud_data_gnss *gnss_buf,
+					 struct cloud_data_sensors *sensor_buf,
+					 struct cloud_data_modem_static *modem_stat_buf,
+					 struct cloud_data_modem_dynamic *modem_dyn_buf,
+					 struct cloud_data_ui *ui_buf,
+					 struct cloud_data_accelerometer *accel_buf,
+					 struct cloud_data_battery *bat_buf,
+					 size_t gnss_buf_count,
+					 size_t sensor_buf_count,
+					 size_t modem_stat_buf_count,
+					 size_t modem_dyn_buf_count,
+					 size_t ui_buf_count,
+					 size_t accel_buf_count,
+					 size_t bat_buf_count);
+
 void cloud_codec_populate_sensor_buffer(
 				struct cloud_data_sensors *sensor_buffer,
 				struct cloud_data_sensors *new_sensor_data,
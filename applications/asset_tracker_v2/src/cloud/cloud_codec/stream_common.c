@@ -0,0 +1,515 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Streaming batch encoder.
+ *
+ * Produces the same output as json_common_batch_data_add() and cJSON_PrintUnformatted(),
+ * without building the cJSON tree first. Entries are validated before anything is written
+ * for them, so that the names of empty arrays, and the root object when there is no data at
+ * all, are never written. The encoded entries are only unqueued when the stream is committed,
+ * which allows measuring the output first.
+ */
+
+#include <zephyr.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <date_time.h>
+
+#include "cloud_codec.h"
+#include "stream_common.h"
+#include "stream_helpers.h"
+#include "json_protocol_names.h"
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(stream_common, CONFIG_CLOUD_CODEC_LOG_LEVEL);
+
+/* Array of entries that is only started once there is an entry to encode */
+struct stream_array {
+	const char *label;
+	bool started;
+};
+
+typedef int (*entry_encode_t)(struct cloud_codec_stream *stream, struct stream_array *array,
+			      void *entry);
+
+static int timestamp_convert(int64_t *ts)
+{
+	int err = date_time_uptime_to_unix_time_ms(ts);
+
+	if (err) {
+		LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
+	}
+
+	return err;
+}
+
+static void entry_start(struct cloud_codec_stream *stream, struct stream_array *array)
+{
+	if (stream->depth == 0) {
+		stream_obj_start(stream, NULL);
+	}
+
+	if (!array->started) {
+		stream_array_start(stream, array->label);
+		array->started = true;
+	}
+
+	stream_obj_start(stream, NULL);
+}
+
+static void entry_end(struct cloud_codec_stream *stream, int64_t ts)
+{
+	stream_add_number(stream, DATA_TIMESTAMP, ts);
+	stream_obj_end(stream);
+}
+
+static int modem_static_encode(struct cloud_codec_stream *stream, struct stream_array *array,
+			       void *entry)
+{
+	struct cloud_data_modem_static *data = entry;
+	int64_t ts = data->ts;
+	int err;
+
+	if (!data->queued) {
+		return -ENODATA;
+	}
+
+	err = timestamp_convert(&ts);
+	if (err) {
+		return err;
+	}
+
+	entry_start(stream, array);
+	stream_obj_start(stream, DATA_VALUE);
+	stream_add_str(stream, MODEM_IMEI, data->imei);
+	stream_add_str(stream, MODEM_ICCID, data->iccid);
+	stream_add_str(stream, MODEM_FIRMWARE_VERSION, data->fw);
+	stream_add_str(stream, MODEM_BOARD, data->brdv);
+	stream_add_str(stream, MODEM_APP_VERSION, data->appv);
+	stream_obj_end(stream);
+	entry_end(stream, ts);
+
+	if (stream->commit && !stream->err) {
+		data->ts = ts;
+		data->queued = false;
+	}
+
+	return stream->err;
+}
+
+static int modem_dynamic_encode(struct cloud_codec_stream *stream, struct stream_array *array,
+				void *entry)
+{
+	struct cloud_data_modem_dynamic *data = entry;
+	int64_t ts = data->ts;
+	uint32_t mccmnc = 0;
+	char *end_ptr;
+	int err;
+
+	if (!data->queued) {
+		return -ENODATA;
+	}
+
+	err = timestamp_convert(&ts);
+	if (err) {
+		return err;
+	}
+
+	if (!data->band_fresh && !data->nw_mode_fresh && !data->rsrp_fresh &&
+	    !data->area_code_fresh && !data->mccmnc_fresh && !data->cell_id_fresh &&
+	    !data->ip_address_fresh) {
+		/* The entry is never encoded, so it is unqueued even when measuring */
+		data->ts = ts;
+		data->queued = false;
+		LOG_WRN("No valid dynamic modem data values present, entry unqueued");
+		return -ENODATA;
+	}
+
+	if (data->mccmnc_fresh) {
+		/* Convert mccmnc to unsigned long integer. */
+		errno = 0;
+		mccmnc = strtoul(data->mccmnc, &end_ptr, 10);
+
+		if ((errno == ERANGE) || (*end_ptr != '\0')) {
+			LOG_ERR("MCCMNC string could not be converted.");
+			return -ENOTEMPTY;
+		}
+	}
+
+	entry_start(stream, array);
+	stream_obj_start(stream, DATA_VALUE);
+
+	if (data->band_fresh) {
+		stream_add_number(stream, MODEM_CURRENT_BAND, data->band);
+	}
+
+	if (data->nw_mode_fresh) {
+		stream_add_str(stream, MODEM_NETWORK_MODE,
+			       (data->nw_mode == LTE_LC_LTE_MODE_LTEM) ? "LTE-M" :
+			       (data->nw_mode == LTE_LC_LTE_MODE_NBIOT) ? "NB-IoT" : "Unknown");
+	}
+
+	if (data->rsrp_fresh) {
+		stream_add_number(stream, MODEM_RSRP, data->rsrp);
+	}
+
+	if (data->area_code_fresh) {
+		stream_add_number(stream, MODEM_AREA_CODE, data->area);
+	}
+
+	if (data->mccmnc_fresh) {
+		stream_add_number(stream, MODEM_MCCMNC, mccmnc);
+	}
+
+	if (data->cell_id_fresh) {
+		stream_add_number(stream, MODEM_CELL_ID, data->cell);
+	}
+
+	if (data->ip_address_fresh) {
+		stream_add_str(stream, MODEM_IP_ADDRESS, data->ip);
+	}
+
+	stream_obj_end(stream);
+	entry_end(stream, ts);
+
+	if (stream->commit && !stream->err) {
+		data->ts = ts;
+		data->queued = false;
+	}
+
+	return stream->err;
+}
+
+static int sensor_encode(struct cloud_codec_stream *stream, struct stream_array *array,
+			 void *entry)
+{
+	struct cloud_data_sensors *data = entry;
+	int64_t ts = data->env_ts;
+	int err;
+
+	if (!data->queued) {
+		return -ENODATA;
+	}
+
+	err = timestamp_convert(&ts);
+	if (err) {
+		return err;
+	}
+
+	entry_start(stream, array);
+	stream_obj_start(stream, DATA_VALUE);
+	stream_add_number(stream, DATA_TEMPERATURE, data->temperature);
+	stream_add_number(stream, DATA_HUMIDITY, data->humidity);
+	stream_add_number(stream, DATA_PRESSURE, data->pressure);
+
+	/* If air quality is negative, the value is not provided. */
+	if (data->bsec_air_quality >= 0) {
+		stream_add_number(stream, DATA_BSEC_IAQ, data->bsec_air_quality);
+	}
+
+	stream_obj_end(stream);
+	entry_end(stream, ts);
+
+	if (stream->commit && !stream->err) {
+		data->env_ts = ts;
+		data->queued = false;
+	}
+
+	return stream->err;
+}
+
+static int gnss_encode(struct cloud_codec_stream *stream, struct stream_array *array,
+		       void *entry)
+{
+	struct cloud_data_gnss *data = entry;
+	int64_t ts = data->gnss_ts;
+	int err;
+
+	if (!data->queued) {
+		return -ENODATA;
+	}
+
+	err = timestamp_convert(&ts);
+	if (err) {
+		return err;
+	}
+
+	switch (data->format) {
+	case CLOUD_CODEC_GNSS_FORMAT_PVT:
+		entry_start(stream, array);
+		stream_obj_start(stream, DATA_VALUE);
+		stream_add_number(stream, DATA_GNSS_LONGITUDE, data->pvt.longi);
+		stream_add_number(stream, DATA_GNSS_LATITUDE, data->pvt.lat);
+		stream_add_number(stream, DATA_GNSS_ACCURACY, data->pvt.acc);
+		stream_add_number(stream, DATA_GNSS_ALTITUDE, data->pvt.alt);
+		stream_add_number(stream, DATA_GNSS_SPEED, data->pvt.spd);
+		stream_add_number(stream, DATA_GNSS_HEADING, data->pvt.hdg);
+		stream_obj_end(stream);
+		break;
+	case CLOUD_CODEC_GNSS_FORMAT_NMEA:
+		entry_start(stream, array);
+		stream_add_str(stream, DATA_VALUE, data->nmea);
+		break;
+	case CLOUD_CODEC_GNSS_FORMAT_INVALID:
+		/* Fall through */
+	default:
+		LOG_WRN("GNSS data format not set");
+		return -EINVAL;
+	}
+
+	entry_end(stream, ts);
+
+	if (stream->commit && !stream->err) {
+		data->gnss_ts = ts;
+		data->queued = false;
+	}
+
+	return stream->err;
+}
+
+static int accel_encode(struct cloud_codec_stream *stream, struct stream_array *array,
+			void *entry)
+{
+	struct cloud_data_accelerometer *data = entry;
+	int64_t ts = data->ts;
+	int err;
+
+	if (!data->queued) {
+		return -ENODATA;
+	}
+
+	err = timestamp_convert(&ts);
+	if (err) {
+		return err;
+	}
+
+	entry_start(stream, array);
+	stream_obj_start(stream, DATA_VALUE);
+	stream_add_number(stream, DATA_MOVEMENT_X, data->values[0]);
+	stream_add_number(stream, DATA_MOVEMENT_Y, data->values[1]);
+	stream_add_number(stream, DATA_MOVEMENT_Z, data->values[2]);
+	stream_obj_end(stream);
+	entry_end(stream, ts);
+
+	if (stream->commit && !stream->err) {
+		data->ts = ts;
+		data->queued = false;
+	}
+
+	return stream->err;
+}
+
+static int ui_encode(struct cloud_codec_stream *stream, struct stream_array *array, void *entry)
+{
+	struct cloud_data_ui *data = entry;
+	int64_t ts = data->btn_ts;
+	int err;
+
+	if (!data->queued) {
+		return -ENODATA;
+	}
+
+	err = timestamp_convert(&ts);
+	if (err) {
+		return err;
+	}
+
+	entry_start(stream, array);
+	stream_add_number(stream, DATA_VALUE, data->btn);
+	entry_end(stream, ts);
+
+	if (stream->commit && !stream->err) {
+		data->btn_ts = ts;
+		data->queued = false;
+	}
+
+	return stream->err;
+}
+
+static int battery_encode(struct cloud_codec_stream *stream, struct stream_array *array,
+			  void *entry)
+{
+	struct cloud_data_battery *data = entry;
+	int64_t ts = data->bat_ts;
+	int err;
+
+	if (!data->queued) {
+		return -ENODATA;
+	}
+
+	err = timestamp_convert(&ts);
+	if (err) {
+		return err;
+	}
+
+	entry_start(stream, array);
+	stream_add_number(stream, DATA_VALUE, data->bat);
+	entry_end(stream, ts);
+
+	if (stream->commit && !stream->err) {
+		data->bat_ts = ts;
+		data->queued = false;
+	}
+
+	return stream->err;
+}
+
+static int batch_add(struct cloud_codec_stream *stream, const char *label, entry_encode_t encode,
+		     void *buf, size_t entry_size, size_t buf_count)
+{
+	struct stream_array array = {
+		.label = label,
+	};
+	int err;
+
+	for (size_t i = 0; i < buf_count; i++) {
+		err = encode(stream, &array, (uint8_t *)buf + i * entry_size);
+		if ((err != 0) && (err != -ENODATA)) {
+			LOG_ERR("Failed adding data to array object");
+			return err;
+		}
+	}
+
+	if (!array.started) {
+		return -ENODATA;
+	}
+
+	stream_array_end(stream);
+
+	return stream->err;
+}
+
+int cloud_codec_encode_batch_data_stream(struct cloud_codec_stream *stream,
+					 struct cloud_data_gnss *gnss_buf,
+					 struct cloud_data_sensors *sensor_buf,
+					 struct cloud_data_modem_static *modem_stat_buf,
+					 struct cloud_data_modem_dynamic *modem_dyn_buf,
+					 struct cloud_data_ui *ui_buf,
+					 struct cloud_data_accelerometer *accel_buf,
+					 struct cloud_data_battery *bat_buf,
+					 size_t gnss_buf_count,
+					 size_t sensor_buf_count,
+					 size_t modem_stat_buf_count,
+					 size_t modem_dyn_buf_count,
+					 size_t ui_buf_count,
+					 size_t accel_buf_count,
+					 size_t bat_buf_count)
+{
+	/* Same order as the cJSON encoder */
+	const struct {
+		const char *label;
+		entry_encode_t encode;
+		void *buf;
+		size_t entry_size;
+		size_t buf_count;
+	} batches[] = {
+		{ DATA_MODEM_STATIC, modem_static_encode, modem_stat_buf,
+		  sizeof(*modem_stat_buf), modem_stat_buf_count },
+		{ DATA_MODEM_DYNAMIC, modem_dynamic_encode, modem_dyn_buf,
+		  sizeof(*modem_dyn_buf), modem_dyn_buf_count },
+		{ DATA_GNSS, gnss_encode, gnss_buf, sizeof(*gnss_buf), gnss_buf_count },
+		{ DATA_ENVIRONMENTALS, sensor_encode, sensor_buf, sizeof(*sensor_buf),
+		  sensor_buf_count },
+		{ DATA_BUTTON, ui_encode, ui_buf, sizeof(*ui_buf), ui_buf_count },
+		{ DATA_BATTERY, battery_encode, bat_buf, sizeof(*bat_buf), bat_buf_count },
+		{ DATA_MOVEMENT, accel_encode, accel_buf, sizeof(*accel_buf), accel_buf_count },
+	};
+	bool object_added = false;
+	int err;
+
+	__ASSERT_NO_MSG(stream->depth == 0);
+
+	/* The root object is a new member at the top level */
+	stream->members &= ~BIT(0);
+
+	for (size_t i = 0; i < ARRAY_SIZE(batches); i++) {
+		err = batch_add(stream, batches[i].label, batches[i].encode, batches[i].buf,
+				batches[i].entry_size, batches[i].buf_count);
+		if (err == 0) {
+			object_added = true;
+		} else if (err != -ENODATA) {
+			return err;
+		}
+	}
+
+	if (!object_added) {
+		LOG_DBG("No data to encode, stream empty...");
+		return -ENODATA;
+	}
+
+	stream_obj_end(stream);
+
+	return stream->err;
+}
+
+int stream_common_batch_data_encode(struct cloud_codec_data *output,
+				    struct cloud_data_gnss *gnss_buf,
+				    struct cloud_data_sensors *sensor_buf,
+				    struct cloud_data_modem_static *modem_stat_buf,
+				    struct cloud_data_modem_dynamic *modem_dyn_buf,
+				    struct cloud_data_ui *ui_buf,
+				    struct cloud_data_accelerometer *accel_buf,
+				    struct cloud_data_battery *bat_buf,
+				    size_t gnss_buf_count,
+				    size_t sensor_buf_count,
+				    size_t modem_stat_buf_count,
+				    size_t modem_dyn_buf_count,
+				    size_t ui_buf_count,
+				    size_t accel_buf_count,
+				    size_t bat_buf_count)
+{
+	struct cloud_codec_stream stream = {
+		.cbor = IS_ENABLED(CONFIG_CLOUD_CODEC_STREAMING_CBOR),
+	};
+	char *buffer;
+	size_t len;
+	int err;
+
+	/* Measure the output without modifying the data */
+	err = cloud_codec_encode_batch_data_stream(&stream, gnss_buf, sensor_buf, modem_stat_buf,
+						   modem_dyn_buf, ui_buf, accel_buf, bat_buf,
+						   gnss_buf_count, sensor_buf_count,
+						   modem_stat_buf_count, modem_dyn_buf_count,
+						   ui_buf_count, accel_buf_count, bat_buf_count);
+	if (err) {
+		return err;
+	}
+
+	len = stream.len;
+
+	/* The buffer is handed over to the cloud module, which frees it once it has been sent */
+	buffer = k_malloc(len + 1);
+	if (buffer == NULL) {
+		LOG_ERR("Failed to allocate memory for encoded batch data");
+		return -ENOMEM;
+	}
+
+	stream = (struct cloud_codec_stream) {
+		.buf = (uint8_t *)buffer,
+		.size = len,
+		.cbor = IS_ENABLED(CONFIG_CLOUD_CODEC_STREAMING_CBOR),
+		.commit = true,
+	};
+
+	err = cloud_codec_encode_batch_data_stream(&stream, gnss_buf, sensor_buf, modem_stat_buf,
+						   modem_dyn_buf, ui_buf, accel_buf, bat_buf,
+						   gnss_buf_count, sensor_buf_count,
+						   modem_stat_buf_count, modem_dyn_buf_count,
+						   ui_buf_count, accel_buf_count, bat_buf_count);
+	if (err) {
+		k_free(buffer);
+		return err;
+	}
+
+	__ASSERT_NO_MSG(stream.len == len);
+
+	buffer[len] = '\0';
+
+	output->buf = buffer;
+	output->len = len;
+
+	return 0;
+}
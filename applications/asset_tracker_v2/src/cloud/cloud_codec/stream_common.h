@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/**@file
+ * @brief Streaming encoder common library header.
+ */
+
+#ifndef STREAM_COMMON_H__
+#define STREAM_COMMON_H__
+
+/**@file
+ *
+ * @defgroup Stream common stream_common
+ * @brief    Module containing common streaming encoding functions.
+ * @{
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <zephyr.h>
+
+#include "cloud_codec.h"
+
+/**
+ * @brief Encode batch data into a buffer of the exact size of the output.
+ *
+ * The output is measured first, and then encoded into a buffer that is allocated with
+ * k_malloc. The output is null-terminated, but the terminator is not included in its length.
+ * It is encoded in CBOR if CONFIG_CLOUD_CODEC_STREAMING_CBOR is enabled.
+ *
+ * @param[out] output Pointer to the encoded output. The buffer must be freed with k_free.
+ *
+ * @return 0 on success. -ENODATA if there is no data to encode. -ENOMEM if the buffer cannot be
+ *	   allocated. Otherwise a negative error code is returned.
+ */
+int stream_common_batch_data_encode(struct cloud_codec_data *output,
+				    struct cloud_data_gnss *gnss_buf,
+				    struct cloud_data_sensors *sensor_buf,
+				    struct cloud_data_modem_static *modem_stat_buf,
+				    struct cloud_data_modem_dynamic *modem_dyn_buf,
+				    struct cloud_data_ui *ui_buf,
+				    struct cloud_data_accelerometer *accel_buf,
+				    struct cloud_data_battery *bat_buf,
+				    size_t gnss_buf_count,
+				    size_t sensor_buf_count,
+				    size_t modem_stat_buf_count,
+				    size_t modem_dyn_buf_count,
+				    size_t ui_buf_count,
+				    size_t accel_buf_count,
+				    size_t bat_buf_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* STREAM_COMMON_H__ */
@@ -0,0 +1,343 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <errno.h>
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "stream_helpers.h"
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(stream_helpers, CONFIG_CLOUD_CODEC_LOG_LEVEL);
+
+/* CBOR major types */
+#define CBOR_UINT	0
+#define CBOR_NINT	1
+#define CBOR_TEXT	3
+#define CBOR_ARRAY	4
+#define CBOR_MAP	5
+#define CBOR_SIMPLE	7
+
+#define CBOR_INDEFINITE 31
+#define CBOR_FALSE	0xf4
+#define CBOR_TRUE	0xf5
+#define CBOR_NULL	0xf6
+#define CBOR_FLOAT32	0xfa
+#define CBOR_FLOAT64	0xfb
+#define CBOR_BREAK	0xff
+
+/* Containers are tracked with one bit per nesting level */
+#define DEPTH_MAX 31
+
+static void emit(struct cloud_codec_stream *stream, const void *data, size_t len)
+{
+	if (stream->err) {
+		return;
+	}
+
+	if (stream->buf) {
+		if (len > stream->size - stream->len) {
+			stream->err = -ENOMEM;
+			return;
+		}
+
+		memcpy(stream->buf + stream->len, data, len);
+	} else if (stream->write) {
+		stream->err = stream->write(data, len, stream->user_data);
+		if (stream->err) {
+			return;
+		}
+	}
+
+	stream->len += len;
+}
+
+static void emit_byte(struct cloud_codec_stream *stream, uint8_t byte)
+{
+	emit(stream, &byte, 1);
+}
+
+/* Encode the head of a CBOR data item, in the shortest form */
+static void cbor_head(struct cloud_codec_stream *stream, uint8_t major, uint64_t value)
+{
+	uint8_t head[9];
+	size_t len;
+
+	if (value < 24) {
+		head[0] = (major << 5) | value;
+		len = 1;
+	} else if (value <= UINT8_MAX) {
+		head[0] = (major << 5) | 24;
+		len = 2;
+	} else if (value <= UINT16_MAX) {
+		head[0] = (major << 5) | 25;
+		len = 3;
+	} else if (value <= UINT32_MAX) {
+		head[0] = (major << 5) | 26;
+		len = 5;
+	} else {
+		head[0] = (major << 5) | 27;
+		len = 9;
+	}
+
+	/* Big endian argument */
+	for (size_t i = len - 1; i > 0; i--) {
+		head[i] = value & 0xff;
+		value >>= 8;
+	}
+
+	emit(stream, head, len);
+}
+
+/* Escape a string like cJSON does */
+static void json_str(struct cloud_codec_stream *stream, const char *str)
+{
+	const char *start = str;
+	char escape[7];
+
+	emit_byte(stream, '"');
+
+	for (; *str; str++) {
+		const uint8_t c = *str;
+
+		if (c >= ' ' && c != '"' && c != '\\') {
+			continue;
+		}
+
+		/* Copy the characters that need no escaping at once */
+		emit(stream, start, str - start);
+		start = str + 1;
+
+		switch (c) {
+		case '"':
+		case '\\':
+			escape[0] = '\\';
+			escape[1] = c;
+			escape[2] = '\0';
+			break;
+		case '\b':
+			strcpy(escape, "\\b");
+			break;
+		case '\f':
+			strcpy(escape, "\\f");
+			break;
+		case '\n':
+			strcpy(escape, "\\n");
+			break;
+		case '\r':
+			strcpy(escape, "\\r");
+			break;
+		case '\t':
+			strcpy(escape, "\\t");
+			break;
+		default:
+			snprintk(escape, sizeof(escape), "\\u%04x", c);
+			break;
+		}
+
+		emit(stream, escape, strlen(escape));
+	}
+
+	emit(stream, start, str - start);
+	emit_byte(stream, '"');
+}
+
+static void str_encode(struct cloud_codec_stream *stream, const char *str)
+{
+	if (stream->cbor) {
+		cbor_head(stream, CBOR_TEXT, strlen(str));
+		emit(stream, str, strlen(str));
+	} else {
+		json_str(stream, str);
+	}
+}
+
+/* Start a member of the current container, with its name inside objects */
+static void member_start(struct cloud_codec_stream *stream, const char *str)
+{
+	if (!stream->cbor && (stream->members & BIT(stream->depth))) {
+		emit_byte(stream, ',');
+	}
+
+	stream->members |= BIT(stream->depth);
+
+	if (str) {
+		str_encode(stream, str);
+
+		if (!stream->cbor) {
+			emit_byte(stream, ':');
+		}
+	}
+}
+
+static void container_start(struct cloud_codec_stream *stream, const char *str, uint8_t major,
+			    char open)
+{
+	if (stream->depth == DEPTH_MAX) {
+		LOG_ERR("Maximum nesting depth reached");
+		stream->err = -EINVAL;
+		return;
+	}
+
+	member_start(stream, str);
+
+	if (stream->cbor) {
+		/* The number of members is not known in advance */
+		emit_byte(stream, (major << 5) | CBOR_INDEFINITE);
+	} else {
+		emit_byte(stream, open);
+	}
+
+	stream->depth++;
+	stream->members &= ~BIT(stream->depth);
+}
+
+static void container_end(struct cloud_codec_stream *stream, char close)
+{
+	__ASSERT_NO_MSG(stream->err || stream->depth > 0);
+
+	if (stream->depth == 0) {
+		return;
+	}
+
+	emit_byte(stream, stream->cbor ? CBOR_BREAK : close);
+	stream->depth--;
+}
+
+void stream_obj_start(struct cloud_codec_stream *stream, const char *str)
+{
+	container_start(stream, str, CBOR_MAP, '{');
+}
+
+void stream_obj_end(struct cloud_codec_stream *stream)
+{
+	container_end(stream, '}');
+}
+
+void stream_array_start(struct cloud_codec_stream *stream, const char *str)
+{
+	container_start(stream, str, CBOR_ARRAY, '[');
+}
+
+void stream_array_end(struct cloud_codec_stream *stream)
+{
+	container_end(stream, ']');
+}
+
+static bool double_equal(double a, double b)
+{
+	double max = fabs(a) > fabs(b) ? fabs(a) : fabs(b);
+
+	return fabs(a - b) <= max * DBL_EPSILON;
+}
+
+/* Print a number like cJSON does */
+static void json_number(struct cloud_codec_stream *stream, double item)
+{
+	char number[26];
+	double test;
+	int valueint;
+	int len;
+
+	if (isnan(item) || isinf(item)) {
+		emit(stream, "null", strlen("null"));
+		return;
+	}
+
+	/* Integer value that cJSON stores along with the number */
+	if (item >= INT_MAX) {
+		valueint = INT_MAX;
+	} else if (item <= (double)INT_MIN) {
+		valueint = INT_MIN;
+	} else {
+		valueint = (int)item;
+	}
+
+	if (item == (double)valueint) {
+		len = snprintf(number, sizeof(number), "%d", valueint);
+	} else {
+		/* 15 significant digits if the number can be recovered from them, else 17 */
+		len = snprintf(number, sizeof(number), "%1.15g", item);
+		if ((sscanf(number, "%lg", &test) != 1) || !double_equal(test, item)) {
+			len = snprintf(number, sizeof(number), "%1.17g", item);
+		}
+	}
+
+	emit(stream, number, len);
+}
+
+static void cbor_number(struct cloud_codec_stream *stream, double item)
+{
+	uint8_t number[9];
+	size_t len;
+
+	if (isnan(item) || isinf(item)) {
+		emit_byte(stream, CBOR_NULL);
+		return;
+	}
+
+	if (item == floor(item) && fabs(item) < 0x1p63) {
+		if (item >= 0) {
+			cbor_head(stream, CBOR_UINT, (uint64_t)item);
+		} else {
+			cbor_head(stream, CBOR_NINT, (uint64_t)(-1 - (int64_t)item));
+		}
+		return;
+	}
+
+	if ((double)(float)item == item) {
+		float value = item;
+		uint32_t bits;
+
+		memcpy(&bits, &value, sizeof(bits));
+		number[0] = CBOR_FLOAT32;
+		sys_put_be32(bits, &number[1]);
+		len = 5;
+	} else {
+		uint64_t bits;
+
+		memcpy(&bits, &item, sizeof(bits));
+		number[0] = CBOR_FLOAT64;
+		sys_put_be64(bits, &number[1]);
+		len = 9;
+	}
+
+	emit(stream, number, len);
+}
+
+void stream_add_number(struct cloud_codec_stream *stream, const char *str, double item)
+{
+	member_start(stream, str);
+
+	if (stream->cbor) {
+		cbor_number(stream, item);
+	} else {
+		json_number(stream, item);
+	}
+}
+
+void stream_add_str(struct cloud_codec_stream *stream, const char *str, const char *item)
+{
+	member_start(stream, str);
+	str_encode(stream, item);
+}
+
+void stream_add_bool(struct cloud_codec_stream *stream, const char *str, bool item)
+{
+	member_start(stream, str);
+
+	if (stream->cbor) {
+		emit_byte(stream, item ? CBOR_TRUE : CBOR_FALSE);
+	} else if (item) {
+		emit(stream, "true", strlen("true"));
+	} else {
+		emit(stream, "false", strlen("false"));
+	}
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdbool.h>
+
+#include "cloud_codec.h"
+
+/**
+ * @brief Start an object.
+ *
+ * Objects and arrays can be nested up to 31 levels.
+ *
+ * @param[inout] stream	Output stream.
+ * @param[in]	 str	Name of the object, or NULL if it is added to an array.
+ */
+void stream_obj_start(struct cloud_codec_stream *stream, const char *str);
+
+/**
+ * @brief End the current object.
+ *
+ * @param[inout] stream	Output stream.
+ */
+void stream_obj_end(struct cloud_codec_stream *stream);
+
+/**
+ * @brief Start an array.
+ *
+ * @param[inout] stream	Output stream.
+ * @param[in]	 str	Name of the array, or NULL if it is added to an array.
+ */
+void stream_array_start(struct cloud_codec_stream *stream, const char *str);
+
+/**
+ * @brief End the current array.
+ *
+ * @param[inout] stream	Output stream.
+ */
+void stream_array_end(struct cloud_codec_stream *stream);
+
+/**
+ * @brief Add a number. It is encoded like cJSON does in JSON, as an integer or a
+ *	  floating point number that is as short as possible in CBOR.
+ *
+ * @param[inout] stream	Output stream.
+ * @param[in]	 str	Name of the number, or NULL if it is added to an array.
+ * @param[in]	 item	Number.
+ */
+void stream_add_number(struct cloud_codec_stream *stream, const char *str, double item);
+
+/**
+ * @brief Add a string. It is escaped like cJSON does in JSON.
+ *
+ * @param[inout] stream	Output stream.
+ * @param[in]	 str	Name of the string, or NULL if it is added to an array.
+ * @param[in]	 item	Null-terminated string.
+ */
+void stream_add_str(struct cloud_codec_stream *stream, const char *str, const char *item);
+
+/**
+ * @brief Add a boolean.
+ *
+ * @param[inout] stream	Output stream.
+ * @param[in]	 str	Name of the boolean, or NULL if it is added to an array.
+ * @param[in]	 item	Boolean.
+ */
+void stream_add_bool(struct cloud_codec_stream *stream, const char *str, bool item);
@@ -0,0 +1,935 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <errno.h>
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/slist.h>
+#include <sys/util.h>
+#if defined(CONFIG_DATA_STORE_FLASH)
+#include <fs/fcb.h>
+#include <storage/flash_map.h>
+#endif
+
+#include "data_store.h"
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(data_store, CONFIG_DATA_STORE_LOG_LEVEL);
+
+/* Maximum number of integer columns of an entry, in addition to the timestamp. */
+#define COLUMNS_MAX 6
+
+/* Maximum size of an encoded entry. The largest one is a dynamic modem entry with all values,
+ * which takes up to 113 bytes.
+ */
+#define RECORD_SIZE_MAX 128
+
+/* Resolution of the floating point values, as the number of steps per unit. */
+#define SCALE_LAT_LON	1e7
+#define SCALE_PVT	1e3
+#define SCALE_SENSOR	1e3
+#define SCALE_PRESSURE	1e5
+#define SCALE_ACCEL	1e3
+
+/* Flags of dynamic modem entries, set for the values that are stored. */
+#define MODEM_AREA	BIT(0)
+#define MODEM_CELL	BIT(1)
+#define MODEM_RSRP	BIT(2)
+#define MODEM_IP	BIT(3)
+#define MODEM_MCCMNC	BIT(4)
+#define MODEM_BAND	BIT(5)
+#define MODEM_NW_MODE	BIT(6)
+
+#define FLASH_MAGIC		0x44415453
+#define FLASH_SECTORS_MAX	16
+
+BUILD_ASSERT(CONFIG_DATA_STORE_BLOCK_SIZE >= RECORD_SIZE_MAX);
+BUILD_ASSERT((CONFIG_DATA_STORE_BLOCK_SIZE % 8) == 0,
+	     "The block size must be a multiple of 8");
+
+/* State of the delta encoding, which is reset at the start of each block. */
+struct codec_state {
+	int64_t ts;
+	int64_t ts_delta;
+	int64_t col[COLUMNS_MAX];
+};
+
+struct writer {
+	uint8_t *buf;
+	size_t size;
+	size_t len;
+	bool err;
+};
+
+struct reader {
+	const uint8_t *buf;
+	size_t size;
+	size_t offset;
+	bool err;
+};
+
+struct block_header {
+	/* Data type and number of entries that have been read, set when written to flash. */
+	uint16_t type;
+	uint16_t skip;
+	/* Number of entries and length of the encoded entries. */
+	uint16_t count;
+	uint16_t len;
+};
+
+struct block {
+	sys_snode_t node;
+	/* The header is written to flash along with the data. */
+	struct block_header hdr;
+	uint8_t data[CONFIG_DATA_STORE_BLOCK_SIZE];
+};
+
+BUILD_ASSERT(offsetof(struct block, data) ==
+	     offsetof(struct block, hdr) + sizeof(struct block_header));
+
+/* Position of the next entry to read in a block. */
+struct cursor {
+	struct codec_state state;
+	size_t offset;
+	uint16_t index;
+};
+
+struct stream {
+	/* Blocks, oldest first. */
+	sys_slist_t blocks;
+	size_t block_count;
+	/* Number of entries that have not been read. */
+	size_t count;
+	/* State after the last entry of the newest block. */
+	struct codec_state writer;
+	/* Next entry to read in the oldest block. */
+	struct cursor cursor;
+};
+
+struct type_codec {
+	const char *name;
+	size_t size;
+	void (*encode)(struct writer *w, struct codec_state *state, const void *entry);
+	void (*decode)(struct reader *r, struct codec_state *state, void *entry);
+};
+
+static struct block blocks[CONFIG_DATA_STORE_BLOCK_COUNT];
+static sys_slist_t free_blocks;
+static struct stream streams[DATA_STORE_TYPE_COUNT];
+
+#if defined(CONFIG_DATA_STORE_FLASH)
+static struct flash_sector flash_sectors[FLASH_SECTORS_MAX];
+static struct fcb fcb;
+static bool flash_ready;
+/* Last entry that has been loaded from flash, none if the sector is NULL. */
+static struct fcb_entry flash_loc;
+/* Block that has been loaded from flash, and the next entry to read in it. */
+static struct block flash_block;
+static struct cursor flash_cursor;
+static bool flash_loaded;
+#endif
+
+static void put_byte(struct writer *w, uint8_t byte)
+{
+	if (w->len == w->size) {
+		w->err = true;
+		return;
+	}
+
+	w->buf[w->len++] = byte;
+}
+
+static uint8_t get_byte(struct reader *r)
+{
+	if (r->offset == r->size) {
+		r->err = true;
+		return 0;
+	}
+
+	return r->buf[r->offset++];
+}
+
+/* Little endian base 128, 7 bits per byte. */
+static void put_varint(struct writer *w, uint64_t value)
+{
+	do {
+		uint8_t byte = value & 0x7f;
+
+		value >>= 7;
+		if (value) {
+			byte |= 0x80;
+		}
+
+		put_byte(w, byte);
+	} while (value);
+}
+
+static uint64_t get_varint(struct reader *r)
+{
+	uint64_t value = 0;
+
+	for (int shift = 0; shift < 64; shift += 7) {
+		uint8_t byte = get_byte(r);
+
+		value |= (uint64_t)(byte & 0x7f) << shift;
+		if (!(byte & 0x80)) {
+			return value;
+		}
+	}
+
+	r->err = true;
+	return 0;
+}
+
+/* Map signed values to unsigned ones so that small differences of either sign are short. */
+static uint64_t zigzag_encode(int64_t value)
+{
+	return ((uint64_t)value << 1) ^ -((uint64_t)value >> 63);
+}
+
+static int64_t zigzag_decode(uint64_t value)
+{
+	return (int64_t)((value >> 1) ^ -(value & 1));
+}
+
+/* Store the difference to the previous value. Overflows wrap around in both directions. */
+static void put_delta(struct writer *w, int64_t *prev, int64_t value)
+{
+	put_varint(w, zigzag_encode((int64_t)((uint64_t)value - (uint64_t)*prev)));
+	*prev = value;
+}
+
+static int64_t get_delta(struct reader *r, int64_t *prev)
+{
+	*prev = (int64_t)((uint64_t)*prev + (uint64_t)zigzag_decode(get_varint(r)));
+
+	return *prev;
+}
+
+/* Timestamps are mostly taken at regular intervals, so the change of the interval is stored. */
+static void put_ts(struct writer *w, struct codec_state *state, int64_t ts)
+{
+	put_delta(w, &state->ts_delta, (int64_t)((uint64_t)ts - (uint64_t)state->ts));
+	state->ts = ts;
+}
+
+static int64_t get_ts(struct reader *r, struct codec_state *state)
+{
+	state->ts = (int64_t)((uint64_t)state->ts + (uint64_t)get_delta(r, &state->ts_delta));
+
+	return state->ts;
+}
+
+static void put_str(struct writer *w, const char *str, size_t size)
+{
+	size_t len = strnlen(str, size - 1);
+
+	put_byte(w, len);
+
+	for (size_t i = 0; i < len; i++) {
+		put_byte(w, str[i]);
+	}
+}
+
+static void get_str(struct reader *r, char *str, size_t size)
+{
+	size_t len = get_byte(r);
+
+	if (len >= size || len > r->size - r->offset) {
+		r->err = true;
+		return;
+	}
+
+	memcpy(str, &r->buf[r->offset], len);
+	str[len] = '\0';
+	r->offset += len;
+}
+
+static int64_t quantize(double value, double scale)
+{
+	double scaled = round(value * scale);
+
+	/* Values that cannot be represented, and NaN, are stored as 0. */
+	if (!(fabs(scaled) < 0x1p62)) {
+		return 0;
+	}
+
+	return (int64_t)scaled;
+}
+
+static void gnss_encode(struct writer *w, struct codec_state *state, const void *entry)
+{
+	const struct cloud_data_gnss *gnss = entry;
+
+	put_varint(w, gnss->format);
+	put_ts(w, state, gnss->gnss_ts);
+
+	if (gnss->format == CLOUD_CODEC_GNSS_FORMAT_NMEA) {
+		put_str(w, gnss->nmea, sizeof(gnss->nmea));
+	} else if (gnss->format == CLOUD_CODEC_GNSS_FORMAT_PVT) {
+		put_delta(w, &state->col[0], quantize(gnss->pvt.lat, SCALE_LAT_LON));
+		put_delta(w, &state->col[1], quantize(gnss->pvt.longi, SCALE_LAT_LON));
+		put_delta(w, &state->col[2], quantize(gnss->pvt.alt, SCALE_PVT));
+		put_delta(w, &state->col[3], quantize(gnss->pvt.acc, SCALE_PVT));
+		put_delta(w, &state->col[4], quantize(gnss->pvt.spd, SCALE_PVT));
+		put_delta(w, &state->col[5], quantize(gnss->pvt.hdg, SCALE_PVT));
+	}
+}
+
+static void gnss_decode(struct reader *r, struct codec_state *state, void *entry)
+{
+	struct cloud_data_gnss *gnss = entry;
+
+	gnss->format = get_varint(r);
+	gnss->gnss_ts = get_ts(r, state);
+
+	if (gnss->format == CLOUD_CODEC_GNSS_FORMAT_NMEA) {
+		get_str(r, gnss->nmea, sizeof(gnss->nmea));
+	} else if (gnss->format == CLOUD_CODEC_GNSS_FORMAT_PVT) {
+		gnss->pvt.lat = get_delta(r, &state->col[0]) / SCALE_LAT_LON;
+		gnss->pvt.longi = get_delta(r, &state->col[1]) / SCALE_LAT_LON;
+		gnss->pvt.alt = get_delta(r, &state->col[2]) / SCALE_PVT;
+		gnss->pvt.acc = get_delta(r, &state->col[3]) / SCALE_PVT;
+		gnss->pvt.spd = get_delta(r, &state->col[4]) / SCALE_PVT;
+		gnss->pvt.hdg = get_delta(r, &state->col[5]) / SCALE_PVT;
+	}
+}
+
+static void sensor_encode(struct writer *w, struct codec_state *state, const void *entry)
+{
+	const struct cloud_data_sensors *sensor = entry;
+
+	put_ts(w, state, sensor->env_ts);
+	put_delta(w, &state->col[0], quantize(sensor->temperature, SCALE_SENSOR));
+	put_delta(w, &state->col[1], quantize(sensor->humidity, SCALE_SENSOR));
+	put_delta(w, &state->col[2], quantize(sensor->pressure, SCALE_PRESSURE));
+	put_delta(w, &state->col[3], sensor->bsec_air_quality);
+}
+
+static void sensor_decode(struct reader *r, struct codec_state *state, void *entry)
+{
+	struct cloud_data_sensors *sensor = entry;
+
+	sensor->env_ts = get_ts(r, state);
+	sensor->temperature = get_delta(r, &state->col[0]) / SCALE_SENSOR;
+	sensor->humidity = get_delta(r, &state->col[1]) / SCALE_SENSOR;
+	sensor->pressure = get_delta(r, &state->col[2]) / SCALE_PRESSURE;
+	sensor->bsec_air_quality = get_delta(r, &state->col[3]);
+}
+
+/* Only the values that are fresh are stored, the others are not encoded for the cloud. */
+static void modem_dyn_encode(struct writer *w, struct codec_state *state, const void *entry)
+{
+	const struct cloud_data_modem_dynamic *modem = entry;
+	uint8_t flags = (modem->area_code_fresh ? MODEM_AREA : 0) |
+			(modem->cell_id_fresh ? MODEM_CELL : 0) |
+			(modem->rsrp_fresh ? MODEM_RSRP : 0) |
+			(modem->ip_address_fresh ? MODEM_IP : 0) |
+			(modem->mccmnc_fresh ? MODEM_MCCMNC : 0) |
+			(modem->band_fresh ? MODEM_BAND : 0) |
+			(modem->nw_mode_fresh ? MODEM_NW_MODE : 0);
+
+	put_varint(w, flags);
+	put_ts(w, state, modem->ts);
+
+	if (flags & MODEM_AREA) {
+		put_delta(w, &state->col[0], modem->area);
+	}
+
+	if (flags & MODEM_CELL) {
+		put_delta(w, &state->col[1], modem->cell);
+	}
+
+	if (flags & MODEM_RSRP) {
+		put_delta(w, &state->col[2], modem->rsrp);
+	}
+
+	if (flags & MODEM_BAND) {
+		put_delta(w, &state->col[3], modem->band);
+	}
+
+	if (flags & MODEM_NW_MODE) {
+		put_delta(w, &state->col[4], modem->nw_mode);
+	}
+
+	if (flags & MODEM_IP) {
+		put_str(w, modem->ip, sizeof(modem->ip));
+	}
+
+	if (flags & MODEM_MCCMNC) {
+		put_str(w, modem->mccmnc, sizeof(modem->mccmnc));
+	}
+}
+
+static void modem_dyn_decode(struct reader *r, struct codec_state *state, void *entry)
+{
+	struct cloud_data_modem_dynamic *modem = entry;
+	uint64_t flags = get_varint(r);
+
+	modem->ts = get_ts(r, state);
+	modem->area_code_fresh = flags & MODEM_AREA;
+	modem->cell_id_fresh = flags & MODEM_CELL;
+	modem->rsrp_fresh = flags & MODEM_RSRP;
+	modem->ip_address_fresh = flags & MODEM_IP;
+	modem->mccmnc_fresh = flags & MODEM_MCCMNC;
+	modem->band_fresh = flags & MODEM_BAND;
+	modem->nw_mode_fresh = flags & MODEM_NW_MODE;
+
+	if (flags & MODEM_AREA) {
+		modem->area = get_delta(r, &state->col[0]);
+	}
+
+	if (flags & MODEM_CELL) {
+		modem->cell = get_delta(r, &state->col[1]);
+	}
+
+	if (flags & MODEM_RSRP) {
+		modem->rsrp = get_delta(r, &state->col[2]);
+	}
+
+	if (flags & MODEM_BAND) {
+		modem->band = get_delta(r, &state->col[3]);
+	}
+
+	if (flags & MODEM_NW_MODE) {
+		modem->nw_mode = get_delta(r, &state->col[4]);
+	}
+
+	if (flags & MODEM_IP) {
+		get_str(r, modem->ip, sizeof(modem->ip));
+	}
+
+	if (flags & MODEM_MCCMNC) {
+		get_str(r, modem->mccmnc, sizeof(modem->mccmnc));
+	}
+}
+
+static void ui_encode(struct writer *w, struct codec_state *state, const void *entry)
+{
+	const struct cloud_data_ui *ui = entry;
+
+	put_ts(w, state, ui->btn_ts);
+	put_delta(w, &state->col[0], ui->btn);
+}
+
+static void ui_decode(struct reader *r, struct codec_state *state, void *entry)
+{
+	struct cloud_data_ui *ui = entry;
+
+	ui->btn_ts = get_ts(r, state);
+	ui->btn = get_delta(r, &state->col[0]);
+}
+
+static void accel_encode(struct writer *w, struct codec_state *state, const void *entry)
+{
+	const struct cloud_data_accelerometer *accel = entry;
+
+	put_ts(w, state, accel->ts);
+
+	for (size_t i = 0; i < ARRAY_SIZE(accel->values); i++) {
+		put_delta(w, &state->col[i], quantize(accel->values[i], SCALE_ACCEL));
+	}
+}
+
+static void accel_decode(struct reader *r, struct codec_state *state, void *entry)
+{
+	struct cloud_data_accelerometer *accel = entry;
+
+	accel->ts = get_ts(r, state);
+
+	for (size_t i = 0; i < ARRAY_SIZE(accel->values); i++) {
+		accel->values[i] = get_delta(r, &state->col[i]) / SCALE_ACCEL;
+	}
+}
+
+static void bat_encode(struct writer *w, struct codec_state *state, const void *entry)
+{
+	const struct cloud_data_battery *bat = entry;
+
+	put_ts(w, state, bat->bat_ts);
+	put_delta(w, &state->col[0], bat->bat);
+}
+
+static void bat_decode(struct reader *r, struct codec_state *state, void *entry)
+{
+	struct cloud_data_battery *bat = entry;
+
+	bat->bat_ts = get_ts(r, state);
+	bat->bat = get_delta(r, &state->col[0]);
+}
+
+static const struct type_codec codecs[] = {
+	[DATA_STORE_TYPE_GNSS] = {
+		"GNSS", sizeof(struct cloud_data_gnss), gnss_encode, gnss_decode
+	},
+	[DATA_STORE_TYPE_SENSOR] = {
+		"sensor", sizeof(struct cloud_data_sensors), sensor_encode, sensor_decode
+	},
+	[DATA_STORE_TYPE_MODEM_DYNAMIC] = {
+		"dynamic modem", sizeof(struct cloud_data_modem_dynamic), modem_dyn_encode,
+		modem_dyn_decode
+	},
+	[DATA_STORE_TYPE_UI] = {
+		"UI", sizeof(struct cloud_data_ui), ui_encode, ui_decode
+	},
+	[DATA_STORE_TYPE_ACCELEROMETER] = {
+		"accelerometer", sizeof(struct cloud_data_accelerometer), accel_encode,
+		accel_decode
+	},
+	[DATA_STORE_TYPE_BATTERY] = {
+		"battery", sizeof(struct cloud_data_battery), bat_encode, bat_decode
+	},
+};
+
+BUILD_ASSERT(ARRAY_SIZE(codecs) == DATA_STORE_TYPE_COUNT);
+
+/* Decode the next entry of a block, which must be of the given type. */
+static int block_read(const struct block *block, enum data_store_type type,
+		      struct cursor *cursor, void *entry)
+{
+	struct reader r = {
+		.buf = block->data,
+		.size = block->hdr.len,
+		.offset = cursor->offset
+	};
+
+	memset(entry, 0, codecs[type].size);
+	codecs[type].decode(&r, &cursor->state, entry);
+	if (r.err) {
+		return -EBADMSG;
+	}
+
+	cursor->offset = r.offset;
+	cursor->index++;
+
+	return 0;
+}
+
+static void entry_queued_set(enum data_store_type type, void *entry)
+{
+	switch (type) {
+	case DATA_STORE_TYPE_GNSS:
+		((struct cloud_data_gnss *)entry)->queued = true;
+		break;
+	case DATA_STORE_TYPE_SENSOR:
+		((struct cloud_data_sensors *)entry)->queued = true;
+		break;
+	case DATA_STORE_TYPE_MODEM_DYNAMIC:
+		((struct cloud_data_modem_dynamic *)entry)->queued = true;
+		break;
+	case DATA_STORE_TYPE_UI:
+		((struct cloud_data_ui *)entry)->queued = true;
+		break;
+	case DATA_STORE_TYPE_ACCELEROMETER:
+		((struct cloud_data_accelerometer *)entry)->queued = true;
+		break;
+	case DATA_STORE_TYPE_BATTERY:
+		((struct cloud_data_battery *)entry)->queued = true;
+		break;
+	default:
+		break;
+	}
+}
+
+/* Remove the oldest block of a stream, along with the entries in it that have not been read. */
+static struct block *stream_block_remove(struct stream *stream)
+{
+	sys_snode_t *node = sys_slist_get(&stream->blocks);
+	struct block *block = CONTAINER_OF(node, struct block, node);
+
+	stream->count -= block->hdr.count - stream->cursor.index;
+	stream->block_count--;
+	memset(&stream->cursor, 0, sizeof(stream->cursor));
+
+	return block;
+}
+
+#if defined(CONFIG_DATA_STORE_FLASH)
+static int flash_write(enum data_store_type type, struct block *block, uint16_t skip)
+{
+	struct fcb_entry loc;
+	size_t len = ROUND_UP(sizeof(block->hdr) + block->hdr.len, fcb.f_align);
+	int err;
+
+	if (!flash_ready) {
+		return -ENODEV;
+	}
+
+	block->hdr.type = type;
+	block->hdr.skip = skip;
+
+	err = fcb_append(&fcb, len, &loc);
+	if (err == -ENOSPC) {
+		LOG_WRN("Flash is full, the oldest sector is erased");
+
+		/* Restart from the oldest entry if the last one that was loaded is erased. */
+		if (flash_loc.fe_sector == fcb.f_oldest) {
+			flash_loc.fe_sector = NULL;
+		}
+
+		err = fcb_rotate(&fcb);
+		if (err) {
+			LOG_ERR("fcb_rotate, error: %d", err);
+			return err;
+		}
+
+		err = fcb_append(&fcb, len, &loc);
+	}
+
+	if (err) {
+		LOG_ERR("fcb_append, error: %d", err);
+		return err;
+	}
+
+	err = flash_area_write(fcb.fap, FCB_ENTRY_FA_DATA_OFF(loc), &block->hdr, len);
+	if (err) {
+		LOG_ERR("flash_area_write, error: %d", err);
+		return err;
+	}
+
+	return fcb_append_finish(&fcb, &loc);
+}
+
+/* Load the next block from flash, and erase the sectors that have been read entirely. */
+static int flash_load(void)
+{
+	const struct block_header *hdr = &flash_block.hdr;
+	int err;
+
+	flash_loaded = false;
+
+	if (!flash_ready || fcb_is_empty(&fcb)) {
+		return -ENODATA;
+	}
+
+	err = fcb_getnext(&fcb, &flash_loc);
+	if (err) {
+		/* All blocks have been read */
+		flash_loc.fe_sector = NULL;
+		return fcb_clear(&fcb) ? -EIO : -ENODATA;
+	}
+
+	while (fcb.f_oldest != flash_loc.fe_sector) {
+		err = fcb_rotate(&fcb);
+		if (err) {
+			LOG_ERR("fcb_rotate, error: %d", err);
+			break;
+		}
+	}
+
+	if (flash_loc.fe_data_len < sizeof(*hdr) ||
+	    flash_loc.fe_data_len > sizeof(*hdr) + sizeof(flash_block.data)) {
+		LOG_ERR("Invalid block length in flash: %d", flash_loc.fe_data_len);
+		return -EBADMSG;
+	}
+
+	err = flash_area_read(fcb.fap, FCB_ENTRY_FA_DATA_OFF(flash_loc), &flash_block.hdr,
+			      flash_loc.fe_data_len);
+	if (err) {
+		LOG_ERR("flash_area_read, error: %d", err);
+		return err;
+	}
+
+	if ((hdr->type >= DATA_STORE_TYPE_COUNT) || (hdr->skip > hdr->count) ||
+	    (hdr->len > flash_loc.fe_data_len - sizeof(*hdr))) {
+		LOG_ERR("Invalid block header in flash");
+		return -EBADMSG;
+	}
+
+	memset(&flash_cursor, 0, sizeof(flash_cursor));
+	flash_loaded = true;
+
+	return 0;
+}
+
+static int flash_get(enum data_store_type *type, uint8_t *entries, size_t count)
+{
+	size_t n = 0;
+	int err;
+
+	while (n == 0) {
+		if (!flash_loaded || flash_cursor.index == flash_block.hdr.count) {
+			err = flash_load();
+			if (err == -ENODATA) {
+				return 0;
+			} else if (err) {
+				return err;
+			}
+		}
+
+		*type = flash_block.hdr.type;
+
+		while ((n < count) && (flash_cursor.index < flash_block.hdr.count)) {
+			/* Entries that were read before the block was written are skipped. */
+			bool skip = flash_cursor.index < flash_block.hdr.skip;
+
+			err = block_read(&flash_block, *type, &flash_cursor,
+					 entries + n * codecs[*type].size);
+			if (err) {
+				LOG_ERR("Invalid block in flash");
+				flash_loaded = false;
+				return err;
+			}
+
+			if (!skip) {
+				entry_queued_set(*type, entries + n * codecs[*type].size);
+				n++;
+			}
+		}
+	}
+
+	return n;
+}
+
+static int flash_init(void)
+{
+	uint32_t sector_count = ARRAY_SIZE(flash_sectors);
+	int err;
+
+	err = flash_area_get_sectors(FLASH_AREA_ID(data_store), &sector_count, flash_sectors);
+	if (err) {
+		LOG_ERR("flash_area_get_sectors, error: %d", err);
+		return err;
+	}
+
+	fcb.f_magic = FLASH_MAGIC;
+	fcb.f_sectors = flash_sectors;
+	fcb.f_sector_cnt = sector_count;
+
+	err = fcb_init(FLASH_AREA_ID(data_store), &fcb);
+	if (err) {
+		LOG_ERR("fcb_init, error: %d", err);
+		return err;
+	}
+
+	/* Blocks are written with their header, padded to the write block size. */
+	if ((sizeof(struct block_header) + CONFIG_DATA_STORE_BLOCK_SIZE) % fcb.f_align) {
+		LOG_ERR("Unsupported flash write block size: %d", fcb.f_align);
+		return -ENOTSUP;
+	}
+
+	/* The timestamps of the entries are uptime based, and not valid after a reboot. */
+	err = fcb_clear(&fcb);
+	if (err) {
+		LOG_ERR("fcb_clear, error: %d", err);
+		return err;
+	}
+
+	flash_loc.fe_sector = NULL;
+	flash_loaded = false;
+	flash_ready = true;
+
+	return 0;
+}
+#endif /* CONFIG_DATA_STORE_FLASH */
+
+/* Get a free block. If there is none, the oldest block of the stream with the most blocks is
+ * written to flash or dropped.
+ */
+static struct block *block_alloc(void)
+{
+	struct stream *victim = &streams[0];
+	enum data_store_type type;
+	struct block *block;
+	sys_snode_t *node;
+	uint16_t skip;
+	int dropped;
+	int err = -ENOTSUP;
+
+	node = sys_slist_get(&free_blocks);
+	if (node) {
+		return CONTAINER_OF(node, struct block, node);
+	}
+
+	for (size_t i = 1; i < ARRAY_SIZE(streams); i++) {
+		if (streams[i].block_count > victim->block_count) {
+			victim = &streams[i];
+		}
+	}
+
+	__ASSERT_NO_MSG(victim->block_count > 0);
+
+	type = victim - streams;
+	skip = victim->cursor.index;
+	block = stream_block_remove(victim);
+	dropped = block->hdr.count - skip;
+
+#if defined(CONFIG_DATA_STORE_FLASH)
+	err = flash_write(type, block, skip);
+#endif
+
+	if (err) {
+		LOG_WRN("Data store is full, %d %s entries dropped", dropped, codecs[type].name);
+	} else {
+		LOG_DBG("%d %s entries written to flash", dropped, codecs[type].name);
+	}
+
+	return block;
+}
+
+int data_store_add(enum data_store_type type, const void *entry)
+{
+	struct stream *stream;
+	struct block *tail;
+	struct codec_state state;
+	uint8_t record[RECORD_SIZE_MAX];
+	struct writer w = {
+		.buf = record,
+		.size = sizeof(record)
+	};
+
+	if (type >= DATA_STORE_TYPE_COUNT) {
+		return -EINVAL;
+	}
+
+	stream = &streams[type];
+	state = stream->writer;
+	tail = SYS_SLIST_PEEK_TAIL_CONTAINER(&stream->blocks, tail, node);
+
+	if (tail) {
+		codecs[type].encode(&w, &state, entry);
+	}
+
+	if (!tail || (w.len > sizeof(tail->data) - tail->hdr.len)) {
+		/* Start a new block, with an entry that does not depend on the previous ones. */
+		tail = block_alloc();
+		memset(&tail->hdr, 0, sizeof(tail->hdr));
+		memset(&state, 0, sizeof(state));
+		w.len = 0;
+		w.err = false;
+
+		codecs[type].encode(&w, &state, entry);
+
+		sys_slist_append(&stream->blocks, &tail->node);
+		stream->block_count++;
+	}
+
+	if (w.err) {
+		__ASSERT(false, "Encoded entry is too large");
+		return -ENOMEM;
+	}
+
+	memcpy(&tail->data[tail->hdr.len], record, w.len);
+	tail->hdr.len += w.len;
+	tail->hdr.count++;
+
+	stream->writer = state;
+	stream->count++;
+
+	return 0;
+}
+
+static int stream_get(enum data_store_type type, uint8_t *entries, size_t count)
+{
+	struct stream *stream = &streams[type];
+	size_t n = 0;
+	int err;
+
+	while ((n < count) && (stream->count > 0)) {
+		struct block *head = SYS_SLIST_PEEK_HEAD_CONTAINER(&stream->blocks, head, node);
+		void *entry = entries + n * codecs[type].size;
+
+		err = block_read(head, type, &stream->cursor, entry);
+		if (err) {
+			return err;
+		}
+
+		entry_queued_set(type, entry);
+		stream->count--;
+		n++;
+
+		if (stream->cursor.index == head->hdr.count) {
+			sys_slist_append(&free_blocks, &stream_block_remove(stream)->node);
+		}
+	}
+
+	return n;
+}
+
+int data_store_get(enum data_store_type *type, void *entries, size_t count)
+{
+	if (!type || !entries) {
+		return -EINVAL;
+	}
+
+	if (count == 0) {
+		return 0;
+	}
+
+#if defined(CONFIG_DATA_STORE_FLASH)
+	int n = flash_get(type, entries, count);
+
+	if (n != 0) {
+		return n;
+	}
+#endif
+
+	for (size_t i = 0; i < ARRAY_SIZE(streams); i++) {
+		if (streams[i].count > 0) {
+			*type = i;
+			return stream_get(i, entries, count);
+		}
+	}
+
+	return 0;
+}
+
+size_t data_store_count(enum data_store_type type)
+{
+	return (type < DATA_STORE_TYPE_COUNT) ? streams[type].count : 0;
+}
+
+size_t data_store_size(enum data_store_type type)
+{
+	struct block *block;
+	size_t size = 0;
+
+	if (type >= DATA_STORE_TYPE_COUNT) {
+		return 0;
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&streams[type].blocks, block, node) {
+		size += block->hdr.len;
+	}
+
+	return size;
+}
+
+void data_store_clear(void)
+{
+	memset(streams, 0, sizeof(streams));
+	sys_slist_init(&free_blocks);
+
+	for (size_t i = 0; i < ARRAY_SIZE(streams); i++) {
+		sys_slist_init(&streams[i].blocks);
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(blocks); i++) {
+		sys_slist_append(&free_blocks, &blocks[i].node);
+	}
+
+#if defined(CONFIG_DATA_STORE_FLASH)
+	if (flash_ready) {
+		(void)fcb_clear(&fcb);
+		flash_loc.fe_sector = NULL;
+	}
+
+	flash_loaded = false;
+#endif
+}
+
+int data_store_init(void)
+{
+	data_store_clear();
+
+#if defined(CONFIG_DATA_STORE_FLASH)
+	return flash_init();
+#else
+	return 0;
+#endif
+}
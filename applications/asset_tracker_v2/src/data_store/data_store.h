@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef DATA_STORE_H__
+#define DATA_STORE_H__
+
+/**@file
+ *
+ * @defgroup data_store Data store
+ * @brief    Compact store for data that does not fit in the ringbuffers of the data module.
+ *
+ * @details Entries are delta encoded per data type into blocks of a fixed-size pool. The first
+ *	    entry of a block is stored in full, and each following entry as the difference to
+ *	    the previous one, in variable-length integers. Floating point values are stored
+ *	    with a fixed resolution:
+ *
+ *	    - Latitude and longitude: 1e-7 degrees.
+ *	    - Altitude, accuracy, speed and heading: 1e-3.
+ *	    - Temperature, humidity and accelerometer values: 1e-3.
+ *	    - Pressure: 1e-5 kPa.
+ *
+ *	    When the pool is exhausted, the oldest block of the data type with the most blocks is
+ *	    written to flash if CONFIG_DATA_STORE_FLASH is enabled, or dropped otherwise.
+ *
+ *	    The API is not thread safe, it is meant to be used from the data module thread only.
+ * @{
+ */
+
+#include <zephyr.h>
+
+#include "cloud/cloud_codec/cloud_codec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Data types that can be stored. */
+enum data_store_type {
+	DATA_STORE_TYPE_GNSS,
+	DATA_STORE_TYPE_SENSOR,
+	DATA_STORE_TYPE_MODEM_DYNAMIC,
+	DATA_STORE_TYPE_UI,
+	DATA_STORE_TYPE_ACCELEROMETER,
+	DATA_STORE_TYPE_BATTERY,
+
+	DATA_STORE_TYPE_COUNT
+};
+
+/** @brief Union of the entries that can be stored, used to size the buffer of data_store_get. */
+union data_store_entry {
+	struct cloud_data_gnss gnss;
+	struct cloud_data_sensors sensor;
+	struct cloud_data_modem_dynamic modem_dyn;
+	struct cloud_data_ui ui;
+	struct cloud_data_accelerometer accel;
+	struct cloud_data_battery bat;
+};
+
+/**
+ * @brief Initialize the data store. The flash partition is erased, because the timestamps of
+ *	  the entries are not valid after a reboot.
+ *
+ * @return 0 on success, otherwise a negative error code.
+ */
+int data_store_init(void);
+
+/**
+ * @brief Add an entry. It is added as queued, regardless of its queued flag.
+ *
+ * @param[in] type Data type of the entry.
+ * @param[in] entry Pointer to the entry, of the structure that corresponds to the type.
+ *
+ * @return 0 on success, otherwise a negative error code.
+ */
+int data_store_add(enum data_store_type type, const void *entry);
+
+/**
+ * @brief Remove the oldest entries of a single data type, and decode them.
+ *
+ * Entries that have been written to flash are returned before the ones that are in RAM. The
+ * returned entries have the queued flag set.
+ *
+ * @param[out] type Data type of the entries.
+ * @param[out] entries Buffer with room for count data_store_entry unions. The entries are written
+ *		       to it as an array of the structure that corresponds to the type.
+ * @param[in] count Maximum number of entries.
+ *
+ * @return Number of entries on success. 0 if the store is empty. Otherwise a negative error code.
+ */
+int data_store_get(enum data_store_type *type, void *entries, size_t count);
+
+/**
+ * @brief Get the number of entries of a data type that are in RAM.
+ *
+ * @param[in] type Data type.
+ *
+ * @return Number of entries.
+ */
+size_t data_store_count(enum data_store_type type);
+
+/**
+ * @brief Get the number of bytes used by the encoded entries of a data type that are in RAM.
+ *
+ * @param[in] type Data type.
+ *
+ * @return Number of bytes.
+ */
+size_t data_store_size(enum data_store_type type);
+
+/**
+ * @brief Remove all entries, including the ones that have been written to flash.
+ */
+void data_store_clear(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* DATA_STORE_H__ */
@@ -18,6 +18,7 @@
 #endif
 
 #include "cloud/cloud_codec/cloud_codec.h"
+#include "data_store/data_store.h"
 
 #define MODULE data_module
 
@@ -91,6 +92,22 @@ static int head_ui_buf;
 static int head_accel_buf;
 static int head_bat_buf;
 
+/* Move the entry that is overwritten next in a ringbuffer to the data store, if it has not
+ * been sent yet.
+ */
+#define RINGBUFFER_SPILL(_type, _buf, _head)						\
+	do {										\
+		int _next = ((_head) + 1) % ARRAY_SIZE(_buf);				\
+											\
+		if (IS_ENABLED(CONFIG_DATA_STORE) && (_buf)[_next].queued) {		\
+			int _err = data_store_add(_type, &(_buf)[_next]);		\
+											\
+			if (_err) {							\
+				LOG_ERR("data_store_add, error: %d", _err);		\
+			}								\
+		}									\
+	} while (0)
+
 /* Default device configuration. */
 static struct cloud_data_cfg current_cfg = {
 	.gnss_timeout			= CONFIG_DATA_GNSS_TIMEOUT_SECONDS,
@@ -338,6 +355,14 @@ static int setup(void)
 
 	date_time_register_handler(date_time_event_handler);
 
+	if (IS_ENABLED(CONFIG_DATA_STORE)) {
+		err = data_store_init();
+		if (err) {
+			LOG_ERR("data_store_init, error: %d", err);
+			return err;
+		}
+	}
+
 	return 0;
 }
 
@@ -394,6 +419,72 @@ static void data_send(enum data_module_event_type event,
 	data->len = 0;
 }
 
+#if defined(CONFIG_DATA_STORE)
+static int stored_data_batch_encode(struct cloud_codec_data *codec, enum data_store_type type,
+				    void *entries, size_t count)
+{
+	return cloud_codec_encode_batch_data(
+		codec,
+		(type == DATA_STORE_TYPE_GNSS) ? entries : NULL,
+		(type == DATA_STORE_TYPE_SENSOR) ? entries : NULL,
+		NULL,
+		(type == DATA_STORE_TYPE_MODEM_DYNAMIC) ? entries : NULL,
+		(type == DATA_STORE_TYPE_UI) ? entries : NULL,
+		(type == DATA_STORE_TYPE_ACCELEROMETER) ? entries : NULL,
+		(type == DATA_STORE_TYPE_BATTERY) ? entries : NULL,
+		(type == DATA_STORE_TYPE_GNSS) ? count : 0,
+		(type == DATA_STORE_TYPE_SENSOR) ? count : 0,
+		0,
+		(type == DATA_STORE_TYPE_MODEM_DYNAMIC) ? count : 0,
+		(type == DATA_STORE_TYPE_UI) ? count : 0,
+		(type == DATA_STORE_TYPE_ACCELEROMETER) ? count : 0,
+		(type == DATA_STORE_TYPE_BATTERY) ? count : 0);
+}
+
+/* Encode the entries of the data store, oldest first, in batch messages of a single data type.
+ * The entries are decoded into a buffer that is allocated on the heap during the encoding.
+ */
+static void stored_data_encode(void)
+{
+	int err, count;
+	enum data_store_type type;
+	struct cloud_codec_data codec = {0};
+	union data_store_entry *entries =
+		k_malloc(sizeof(*entries) * CONFIG_DATA_STORE_BATCH_ENTRY_COUNT);
+
+	if (entries == NULL) {
+		LOG_ERR("Cannot allocate buffer for stored data");
+		return;
+	}
+
+	for (int i = 0; i < CONFIG_DATA_STORE_BATCH_MESSAGE_COUNT; i++) {
+		count = data_store_get(&type, entries, CONFIG_DATA_STORE_BATCH_ENTRY_COUNT);
+		if (count < 0) {
+			LOG_ERR("data_store_get, error: %d", count);
+			continue;
+		} else if (count == 0) {
+			break;
+		}
+
+		err = stored_data_batch_encode(&codec, type, entries, count);
+		if (err == -ENODATA) {
+			/* Entries that are not valid, for instance dynamic modem data without any
+			 * fresh values, are not encoded.
+			 */
+			continue;
+		} else if (err) {
+			LOG_ERR("Error batch-encoding stored data: %d", err);
+			break;
+		}
+
+		LOG_DBG("%d stored entries encoded successfully", count);
+		data_send(DATA_EVT_DATA_SEND_BATCH, &codec);
+	}
+
+	k_free(entries);
+}
+#endif /* CONFIG_DATA_STORE */
+
 /* This function allocates buffer on the heap, which needs to be freed after use. */
 static void data_encode(void)
 {
@@ -483,6 +574,10 @@ static void data_encode(void)
 		SEND_ERROR(data, DATA_EVT_ERROR, err);
 		return;
 	}
+
+#if defined(CONFIG_DATA_STORE)
+	stored_data_encode();
+#endif
 }
 
 #if defined(CONFIG_NRF_CLOUD_AGPS) && !defined(CONFIG_NRF_CLOUD_MQTT)
@@ -1013,6 +1108,8 @@ static void on_all_states(struct data_msg_data *msg)
 			.queued = true
 		};
 
+		RINGBUFFER_SPILL(DATA_STORE_TYPE_UI, ui_buf, head_ui_buf);
+
 		cloud_codec_populate_ui_buffer(ui_buf, &new_ui_data,
 					       &head_ui_buf,
 					       ARRAY_SIZE(ui_buf));
@@ -1085,6 +1182,8 @@ static void on_all_states(struct data_msg_data *msg)
 		strcpy(new_modem_data.ip, msg->module.modem.data.modem_dynamic.ip_address);
 		strcpy(new_modem_data.mccmnc, msg->module.modem.data.modem_dynamic.mccmnc);
 
+		RINGBUFFER_SPILL(DATA_STORE_TYPE_MODEM_DYNAMIC, modem_dyn_buf, head_modem_dyn_buf);
+
 		cloud_codec_populate_modem_dynamic_buffer(
 						modem_dyn_buf,
 						&new_modem_data,
@@ -1105,6 +1204,8 @@ static void on_all_states(struct data_msg_data *msg)
 			.queued = true
 		};
 
+		RINGBUFFER_SPILL(DATA_STORE_TYPE_BATTERY, bat_buf, head_bat_buf);
+
 		cloud_codec_populate_bat_buffer(bat_buf, &new_battery_data,
 						&head_bat_buf,
 						ARRAY_SIZE(bat_buf));
@@ -1122,6 +1223,8 @@ static void on_all_states(struct data_msg_data *msg)
 			.queued = true
 		};
 
+		RINGBUFFER_SPILL(DATA_STORE_TYPE_SENSOR, sensors_buf, head_sensor_buf);
+
 		cloud_codec_populate_sensor_buffer(sensors_buf,
 						   &new_sensor_data,
 						   &head_sensor_buf,
@@ -1143,6 +1246,8 @@ static void on_all_states(struct data_msg_data *msg)
 			.queued = true
 		};
 
+		RINGBUFFER_SPILL(DATA_STORE_TYPE_ACCELEROMETER, accel_buf, head_accel_buf);
+
 		cloud_codec_populate_accel_buffer(accel_buf, &new_movement_data,
 						  &head_accel_buf,
 						  ARRAY_SIZE(accel_buf));
@@ -1182,6 +1287,8 @@ static void on_all_states(struct data_msg_data *msg)
 			return;
 		}
 
+		RINGBUFFER_SPILL(DATA_STORE_TYPE_GNSS, gnss_buf, head_gnss_buf);
+
 		cloud_codec_populate_gnss_buffer(gnss_buf, &new_gnss_data,
 						&head_gnss_buf,
 						ARRAY_SIZE(gnss_buf));
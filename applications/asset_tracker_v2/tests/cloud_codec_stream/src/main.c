@@ -0,0 +1,705 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <zephyr.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <cJSON.h>
+#include <cJSON_os.h>
+
+#include "json_common.h"
+#include "stream_common.h"
+#include "cloud_codec.h"
+#include "json_protocol_names.h"
+
+#define ENTRY_COUNT 4
+#define OUTPUT_SIZE 8192
+#define RANDOM_BATCHES 500
+
+/* Buffers of the data module */
+struct batch {
+	struct cloud_data_gnss gnss[ENTRY_COUNT];
+	struct cloud_data_sensors sensor[ENTRY_COUNT];
+	struct cloud_data_modem_static modem_stat[1];
+	struct cloud_data_modem_dynamic modem_dyn[ENTRY_COUNT];
+	struct cloud_data_ui ui[ENTRY_COUNT];
+	struct cloud_data_accelerometer accel[ENTRY_COUNT];
+	struct cloud_data_battery bat[ENTRY_COUNT];
+};
+
+#define BATCH_ARGS(b)								\
+	(b)->gnss, (b)->sensor, (b)->modem_stat, (b)->modem_dyn, (b)->ui,	\
+	(b)->accel, (b)->bat, ARRAY_SIZE((b)->gnss), ARRAY_SIZE((b)->sensor),	\
+	ARRAY_SIZE((b)->modem_stat), ARRAY_SIZE((b)->modem_dyn),		\
+	ARRAY_SIZE((b)->ui), ARRAY_SIZE((b)->accel), ARRAY_SIZE((b)->bat)
+
+/* The data is encoded by both encoders, starting from identical copies */
+static struct batch batch;
+static struct batch batch_copy;
+static struct batch batch_initial;
+
+static uint8_t output[OUTPUT_SIZE];
+static uint8_t chunks[OUTPUT_SIZE];
+static size_t chunks_len;
+static size_t chunks_limit;
+
+static uint32_t rand_state = 0x12345678;
+
+/* Reproducible pseudo-random numbers, xorshift32 */
+static uint32_t rand_get(void)
+{
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+
+	return rand_state;
+}
+
+/* Numbers that are printed in different ways by cJSON */
+static double number_get(void)
+{
+	static const double special[] = {
+		0, -0.0, 0.1, -1.5, 1e300, -1e-300, 2147483647.0, 2147483648.0,
+		-2147483648.0, -2147483649.0, 1e17, 123456789012345678.0, 0.30000000000000004,
+		NAN, INFINITY, -INFINITY,
+	};
+
+	switch (rand_get() % 4) {
+	case 0:
+		return special[rand_get() % ARRAY_SIZE(special)];
+	case 1:
+		return (int32_t)rand_get();
+	case 2:
+		return (int32_t)rand_get() / (double)(rand_get() | 1);
+	default:
+		return ldexp((int32_t)rand_get(), (int)(rand_get() % 120) - 60);
+	}
+}
+
+/* Strings with characters that must be escaped, and UTF-8 sequences */
+static void string_get(char *str, size_t size)
+{
+	static const char chars[] = "abcXYZ019 -_.:\"\\/\b\f\n\r\t\x01\x1f\x7f\xc3\xa5";
+	size_t len = rand_get() % size;
+
+	for (size_t i = 0; i < len; i++) {
+		str[i] = chars[rand_get() % (sizeof(chars) - 1)];
+	}
+
+	str[len] = '\0';
+}
+
+static bool queued_get(void)
+{
+	return rand_get() % 4 != 0;
+}
+
+static void batch_fill(struct batch *b)
+{
+	memset(b, 0, sizeof(*b));
+
+	for (size_t i = 0; i < ENTRY_COUNT; i++) {
+		struct cloud_data_gnss *gnss = &b->gnss[i];
+		struct cloud_data_sensors *sensor = &b->sensor[i];
+		struct cloud_data_modem_dynamic *modem_dyn = &b->modem_dyn[i];
+		struct cloud_data_accelerometer *accel = &b->accel[i];
+
+		gnss->gnss_ts = rand_get();
+		gnss->queued = queued_get();
+
+		if (rand_get() % 2) {
+			gnss->format = CLOUD_CODEC_GNSS_FORMAT_PVT;
+			gnss->pvt.longi = number_get();
+			gnss->pvt.lat = number_get();
+			gnss->pvt.alt = number_get();
+			gnss->pvt.acc = number_get();
+			gnss->pvt.spd = number_get();
+			gnss->pvt.hdg = number_get();
+		} else {
+			gnss->format = CLOUD_CODEC_GNSS_FORMAT_NMEA;
+			string_get(gnss->nmea, sizeof(gnss->nmea));
+		}
+
+		sensor->env_ts = rand_get();
+		sensor->temperature = number_get();
+		sensor->humidity = number_get();
+		sensor->pressure = number_get();
+		sensor->bsec_air_quality = (int)(rand_get() % 600) - 100;
+		sensor->queued = queued_get();
+
+		modem_dyn->ts = rand_get();
+		modem_dyn->band = rand_get();
+		modem_dyn->nw_mode = rand_get() % 3 ? LTE_LC_LTE_MODE_LTEM : LTE_LC_LTE_MODE_NBIOT;
+		modem_dyn->area = rand_get();
+		modem_dyn->cell = rand_get();
+		modem_dyn->rsrp = rand_get();
+		string_get(modem_dyn->ip, sizeof(modem_dyn->ip));
+		snprintf(modem_dyn->mccmnc, sizeof(modem_dyn->mccmnc), "%u",
+			 rand_get() % 1000000);
+		modem_dyn->queued = queued_get();
+		modem_dyn->area_code_fresh = rand_get() % 2;
+		modem_dyn->cell_id_fresh = rand_get() % 2;
+		modem_dyn->rsrp_fresh = rand_get() % 2;
+		modem_dyn->ip_address_fresh = rand_get() % 2;
+		modem_dyn->mccmnc_fresh = rand_get() % 2;
+		modem_dyn->band_fresh = rand_get() % 2;
+		modem_dyn->nw_mode_fresh = rand_get() % 2;
+
+		b->ui[i].btn = rand_get();
+		b->ui[i].btn_ts = rand_get();
+		b->ui[i].queued = queued_get();
+
+		accel->ts = rand_get();
+		accel->values[0] = number_get();
+		accel->values[1] = number_get();
+		accel->values[2] = number_get();
+		accel->queued = queued_get();
+
+		b->bat[i].bat = rand_get();
+		b->bat[i].bat_ts = rand_get();
+		b->bat[i].queued = queued_get();
+	}
+
+	b->modem_stat[0].ts = rand_get();
+	b->modem_stat[0].queued = queued_get();
+	string_get(b->modem_stat[0].imei, sizeof(b->modem_stat[0].imei));
+	string_get(b->modem_stat[0].iccid, sizeof(b->modem_stat[0].iccid));
+	string_get(b->modem_stat[0].fw, sizeof(b->modem_stat[0].fw));
+	string_get(b->modem_stat[0].brdv, sizeof(b->modem_stat[0].brdv));
+	string_get(b->modem_stat[0].appv, sizeof(b->modem_stat[0].appv));
+}
+
+/* Encode the batch like the cJSON based codec backends do. */
+static int cjson_encode(struct batch *b, char **buffer)
+{
+	const struct {
+		enum json_common_buffer_type type;
+		void *buf;
+		size_t count;
+		const char *label;
+	} arrays[] = {
+		{ JSON_COMMON_MODEM_STATIC, b->modem_stat, ARRAY_SIZE(b->modem_stat),
+		  DATA_MODEM_STATIC },
+		{ JSON_COMMON_MODEM_DYNAMIC, b->modem_dyn, ARRAY_SIZE(b->modem_dyn),
+		  DATA_MODEM_DYNAMIC },
+		{ JSON_COMMON_GNSS, b->gnss, ARRAY_SIZE(b->gnss), DATA_GNSS },
+		{ JSON_COMMON_SENSOR, b->sensor, ARRAY_SIZE(b->sensor), DATA_ENVIRONMENTALS },
+		{ JSON_COMMON_UI, b->ui, ARRAY_SIZE(b->ui), DATA_BUTTON },
+		{ JSON_COMMON_BATTERY, b->bat, ARRAY_SIZE(b->bat), DATA_BATTERY },
+		{ JSON_COMMON_ACCELEROMETER, b->accel, ARRAY_SIZE(b->accel), DATA_MOVEMENT },
+	};
+	bool object_added = false;
+	cJSON *root_obj = cJSON_CreateObject();
+	int err;
+
+	zassert_not_null(root_obj, "Root object is NULL");
+
+	for (size_t i = 0; i < ARRAY_SIZE(arrays); i++) {
+		err = json_common_batch_data_add(root_obj, arrays[i].type, arrays[i].buf,
+						 arrays[i].count, arrays[i].label);
+		if (err == 0) {
+			object_added = true;
+		} else if (err != -ENODATA) {
+			cJSON_Delete(root_obj);
+			return err;
+		}
+	}
+
+	if (!object_added) {
+		cJSON_Delete(root_obj);
+		return -ENODATA;
+	}
+
+	*buffer = cJSON_PrintUnformatted(root_obj);
+	cJSON_Delete(root_obj);
+	zassert_not_null(*buffer, "Buffer is NULL");
+
+	return 0;
+}
+
+static int stream_encode(struct cloud_codec_stream *stream, struct batch *b)
+{
+	return cloud_codec_encode_batch_data_stream(stream, BATCH_ARGS(b));
+}
+
+static int chunk_write(const uint8_t *data, size_t len, void *user_data)
+{
+	zassert_equal_ptr(user_data, chunks, "Wrong user data");
+
+	if (chunks_len + len > chunks_limit) {
+		return -EIO;
+	}
+
+	memcpy(chunks + chunks_len, data, len);
+	chunks_len += len;
+
+	return 0;
+}
+
+/* Decode CBOR into cJSON objects, to compare it with the JSON output. */
+
+static const uint8_t *cbor_pos;
+
+static uint64_t cbor_arg(uint8_t info)
+{
+	uint64_t arg = 0;
+
+	if (info < 24) {
+		return info;
+	}
+
+	zassert_true(info <= 27, "Unexpected additional information %d", info);
+
+	for (size_t i = 0; i < BIT(info - 24); i++) {
+		arg = (arg << 8) | *cbor_pos++;
+	}
+
+	return arg;
+}
+
+static void cbor_str(char *str, size_t size, uint8_t initial)
+{
+	uint64_t len;
+
+	zassert_equal(initial >> 5, 3, "Not a text string");
+
+	len = cbor_arg(initial & 0x1f);
+	zassert_true(len < size, "String too long");
+
+	memcpy(str, cbor_pos, len);
+	str[len] = '\0';
+	cbor_pos += len;
+}
+
+static cJSON *cbor_item(void)
+{
+	const uint8_t initial = *cbor_pos++;
+	const uint8_t info = initial & 0x1f;
+	char str[128];
+	cJSON *item;
+	uint32_t bits32;
+	uint64_t bits64;
+	float value32;
+	double value64;
+
+	switch (initial >> 5) {
+	case 0:
+		return cJSON_CreateNumber(cbor_arg(info));
+	case 1:
+		return cJSON_CreateNumber(-1 - (int64_t)cbor_arg(info));
+	case 3:
+		cbor_str(str, sizeof(str), initial);
+		return cJSON_CreateString(str);
+	case 4:
+		zassert_equal(info, 31, "Array is not indefinite");
+		item = cJSON_CreateArray();
+		while (*cbor_pos != 0xff) {
+			cJSON_AddItemToArray(item, cbor_item());
+		}
+		cbor_pos++;
+		return item;
+	case 5:
+		zassert_equal(info, 31, "Map is not indefinite");
+		item = cJSON_CreateObject();
+		while (*cbor_pos != 0xff) {
+			cbor_str(str, sizeof(str), *cbor_pos++);
+			cJSON_AddItemToObject(item, str, cbor_item());
+		}
+		cbor_pos++;
+		return item;
+	default:
+		break;
+	}
+
+	switch (initial) {
+	case 0xf4:
+		return cJSON_CreateFalse();
+	case 0xf5:
+		return cJSON_CreateTrue();
+	case 0xf6:
+		return cJSON_CreateNull();
+	case 0xfa:
+		bits32 = cbor_arg(26);
+		memcpy(&value32, &bits32, sizeof(value32));
+		return cJSON_CreateNumber(value32);
+	case 0xfb:
+		bits64 = cbor_arg(27);
+		memcpy(&value64, &bits64, sizeof(value64));
+		return cJSON_CreateNumber(value64);
+	default:
+		zassert_unreachable("Unexpected initial byte 0x%02x", initial);
+		return NULL;
+	}
+}
+
+static void test_stream_equals_cjson(void)
+{
+	struct cloud_codec_stream stream;
+	char *expected;
+	int err_expected;
+	int err;
+
+	for (size_t i = 0; i < RANDOM_BATCHES; i++) {
+		batch_fill(&batch);
+		memcpy(&batch_copy, &batch, sizeof(batch));
+
+		err_expected = cjson_encode(&batch, &expected);
+
+		/* Measure */
+		stream = (struct cloud_codec_stream) { 0 };
+		err = stream_encode(&stream, &batch_copy);
+		zassert_equal(err, err_expected, "Return value %d is wrong", err);
+
+		if (err) {
+			zassert_equal(err, -ENODATA, "Return value %d is wrong", err);
+			zassert_equal(stream.len, 0, "Output not empty");
+			continue;
+		}
+
+		zassert_equal(stream.len, strlen(expected), "Wrong length %zu", stream.len);
+
+		/* Encode into a buffer of the exact size */
+		stream = (struct cloud_codec_stream) {
+			.buf = output,
+			.size = strlen(expected),
+			.commit = true,
+		};
+		err = stream_encode(&stream, &batch_copy);
+		zassert_equal(0, err, "Return value %d is wrong", err);
+		zassert_equal(stream.len, strlen(expected), "Wrong length %zu", stream.len);
+		zassert_mem_equal(output, expected, stream.len, "Output differs from cJSON");
+
+		/* The same entries are unqueued, and the same timestamps converted */
+		zassert_mem_equal(&batch, &batch_copy, sizeof(batch), "Data differs");
+
+		cJSON_FreeString(expected);
+	}
+}
+
+static void test_stream_measure(void)
+{
+	struct cloud_codec_stream stream = { 0 };
+	int err;
+
+	batch_fill(&batch);
+
+	/* Entries without any fresh values are unqueued even when measuring */
+	for (size_t i = 0; i < ENTRY_COUNT; i++) {
+		batch.modem_dyn[i].rsrp_fresh = true;
+	}
+
+	memcpy(&batch_initial, &batch, sizeof(batch));
+
+	err = stream_encode(&stream, &batch);
+	zassert_equal(0, err, "Return value %d is wrong", err);
+	zassert_true(stream.len > 0, "Nothing measured");
+	zassert_mem_equal(&batch, &batch_initial, sizeof(batch), "Data modified");
+}
+
+static void test_stream_no_data(void)
+{
+	struct cloud_codec_stream stream = {
+		.buf = output,
+		.size = sizeof(output),
+		.commit = true,
+	};
+	int err;
+
+	memset(&batch, 0, sizeof(batch));
+
+	err = stream_encode(&stream, &batch);
+	zassert_equal(-ENODATA, err, "Return value %d is wrong", err);
+	zassert_equal(0, stream.len, "Output not empty");
+
+	/* Only entries without any fresh values */
+	batch.modem_dyn[0].queued = true;
+
+	err = stream_encode(&stream, &batch);
+	zassert_equal(-ENODATA, err, "Return value %d is wrong", err);
+	zassert_equal(0, stream.len, "Output not empty");
+	zassert_false(batch.modem_dyn[0].queued, "Entry not unqueued");
+}
+
+static void test_stream_buffer_too_small(void)
+{
+	struct cloud_codec_stream stream = { 0 };
+	size_t len;
+	int err;
+
+	do {
+		batch_fill(&batch);
+		err = stream_encode(&stream, &batch);
+	} while (err == -ENODATA);
+
+	zassert_equal(0, err, "Return value %d is wrong", err);
+	len = stream.len;
+
+	stream = (struct cloud_codec_stream) {
+		.buf = output,
+		.size = len - 1,
+	};
+
+	err = stream_encode(&stream, &batch);
+	zassert_equal(-ENOMEM, err, "Return value %d is wrong", err);
+	zassert_true(stream.len < len, "Output overflow");
+}
+
+static void test_stream_write(void)
+{
+	struct cloud_codec_stream stream;
+	size_t len;
+	int err;
+
+	do {
+		batch_fill(&batch);
+		memcpy(&batch_copy, &batch, sizeof(batch));
+
+		stream = (struct cloud_codec_stream) {
+			.buf = output,
+			.size = sizeof(output),
+		};
+		err = stream_encode(&stream, &batch);
+	} while (err == -ENODATA);
+
+	zassert_equal(0, err, "Return value %d is wrong", err);
+	len = stream.len;
+
+	chunks_len = 0;
+	chunks_limit = sizeof(chunks);
+	stream = (struct cloud_codec_stream) {
+		.write = chunk_write,
+		.user_data = chunks,
+	};
+
+	err = stream_encode(&stream, &batch_copy);
+	zassert_equal(0, err, "Return value %d is wrong", err);
+	zassert_equal(len, chunks_len, "Wrong length %zu", chunks_len);
+	zassert_equal(len, stream.len, "Wrong length %zu", stream.len);
+	zassert_mem_equal(output, chunks, len, "Output differs");
+
+	/* Errors of the write function stop the encoding */
+	chunks_len = 0;
+	chunks_limit = len / 2;
+	stream = (struct cloud_codec_stream) {
+		.write = chunk_write,
+		.user_data = chunks,
+	};
+
+	err = stream_encode(&stream, &batch_copy);
+	zassert_equal(-EIO, err, "Return value %d is wrong", err);
+	zassert_true(chunks_len <= chunks_limit, "Written after error");
+}
+
+static void test_stream_invalid(void)
+{
+	struct cloud_codec_stream stream = {
+		.buf = output,
+		.size = sizeof(output),
+		.commit = true,
+	};
+	int err;
+
+	memset(&batch, 0, sizeof(batch));
+	batch.gnss[0].queued = true;
+	batch.gnss[0].format = CLOUD_CODEC_GNSS_FORMAT_INVALID;
+
+	err = stream_encode(&stream, &batch);
+	zassert_equal(-EINVAL, err, "Return value %d is wrong", err);
+
+	memset(&batch, 0, sizeof(batch));
+	batch.modem_dyn[0].queued = true;
+	batch.modem_dyn[0].mccmnc_fresh = true;
+	strcpy(batch.modem_dyn[0].mccmnc, "242O2");
+
+	err = stream_encode(&stream, &batch);
+	zassert_equal(-ENOTEMPTY, err, "Return value %d is wrong", err);
+}
+
+static void test_stream_escaping(void)
+{
+	struct cloud_codec_stream stream = {
+		.buf = output,
+		.size = sizeof(output),
+		.commit = true,
+	};
+	const char *expected =
+		"{"
+			"\"" DATA_MODEM_STATIC "\":["
+				"{"
+					"\"" DATA_VALUE "\":{"
+						"\"" MODEM_IMEI "\":\"a\\\"b\\\\c/\","
+						"\"" MODEM_ICCID "\":\"\\b\\f\\n\\r\\t\","
+						"\"" MODEM_FIRMWARE_VERSION "\":\"\\u0001\\u001f\x7f\","
+						"\"" MODEM_BOARD "\":\"\xc3\xa5\","
+						"\"" MODEM_APP_VERSION "\":\"\""
+					"},"
+					"\"" DATA_TIMESTAMP "\":1563968747123"
+				"}"
+			"]"
+		"}";
+	int err;
+
+	memset(&batch, 0, sizeof(batch));
+	batch.modem_stat[0].queued = true;
+	strcpy(batch.modem_stat[0].imei, "a\"b\\c/");
+	strcpy(batch.modem_stat[0].iccid, "\b\f\n\r\t");
+	strcpy(batch.modem_stat[0].fw, "\x01\x1f\x7f");
+	strcpy(batch.modem_stat[0].brdv, "\xc3\xa5");
+
+	err = stream_encode(&stream, &batch);
+	zassert_equal(0, err, "Return value %d is wrong", err);
+	zassert_equal(strlen(expected), stream.len, "Wrong length %zu", stream.len);
+	zassert_mem_equal(expected, output, stream.len, "Wrong output");
+	zassert_false(batch.modem_stat[0].queued, "Entry not unqueued");
+}
+
+static void test_stream_cbor(void)
+{
+	struct cloud_codec_stream stream;
+	char *expected;
+	char *decoded;
+	cJSON *root_obj;
+	size_t json_total = 0;
+	size_t cbor_total = 0;
+	int err_expected;
+	int err;
+
+	for (size_t i = 0; i < RANDOM_BATCHES; i++) {
+		batch_fill(&batch);
+		memcpy(&batch_copy, &batch, sizeof(batch));
+
+		err_expected = cjson_encode(&batch, &expected);
+
+		stream = (struct cloud_codec_stream) {
+			.buf = output,
+			.size = sizeof(output),
+			.cbor = true,
+			.commit = true,
+		};
+		err = stream_encode(&stream, &batch_copy);
+		zassert_equal(err, err_expected, "Return value %d is wrong", err);
+
+		if (err) {
+			continue;
+		}
+
+		cbor_pos = output;
+		root_obj = cbor_item();
+		zassert_equal_ptr(cbor_pos, output + stream.len, "Trailing output");
+
+		decoded = cJSON_PrintUnformatted(root_obj);
+		zassert_not_null(decoded, "Decoded buffer is NULL");
+		zassert_equal(strcmp(decoded, expected), 0, "CBOR differs from cJSON");
+		zassert_mem_equal(&batch, &batch_copy, sizeof(batch), "Data differs");
+
+		json_total += strlen(expected);
+		cbor_total += stream.len;
+
+		cJSON_FreeString(decoded);
+		cJSON_FreeString(expected);
+		cJSON_Delete(root_obj);
+	}
+
+	TC_PRINT("JSON: %zu bytes, CBOR: %zu bytes\n", json_total, cbor_total);
+	zassert_true(cbor_total < json_total, "CBOR not smaller than JSON");
+}
+
+static bool output_contains(size_t len, const uint8_t *data, size_t data_len)
+{
+	for (size_t i = 0; i + data_len <= len; i++) {
+		if (memcmp(&output[i], data, data_len) == 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void test_stream_cbor_numbers(void)
+{
+	struct cloud_codec_stream stream = {
+		.buf = output,
+		.size = sizeof(output),
+		.cbor = true,
+	};
+	/* Shortest encodings of the numbers */
+	const uint8_t timestamp[] = { 0x1b, 0x00, 0x00, 0x01, 0x6c, 0x23, 0xcd, 0x36, 0x73 };
+	const uint8_t longitude[] = { 0xfb, 0x3f, 0xb9, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9a };
+	const uint8_t latitude[] = { 0x38, 0x3d };
+	const uint8_t altitude[] = { 0xfa, 0x3f, 0xc0, 0x00, 0x00 };
+	const uint8_t accuracy[] = { 0xf6 };
+	const uint8_t speed[] = { 0x19, 0x01, 0x00 };
+	int err;
+
+	memset(&batch, 0, sizeof(batch));
+	batch.gnss[0].queued = true;
+	batch.gnss[0].format = CLOUD_CODEC_GNSS_FORMAT_PVT;
+	batch.gnss[0].pvt.longi = 0.1;
+	batch.gnss[0].pvt.lat = -62;
+	batch.gnss[0].pvt.alt = 1.5;
+	batch.gnss[0].pvt.acc = NAN;
+	batch.gnss[0].pvt.spd = 256;
+
+	err = stream_encode(&stream, &batch);
+	zassert_equal(0, err, "Return value %d is wrong", err);
+	zassert_true(output_contains(stream.len, timestamp, sizeof(timestamp)), "No timestamp");
+	zassert_true(output_contains(stream.len, longitude, sizeof(longitude)), "No longitude");
+	zassert_true(output_contains(stream.len, latitude, sizeof(latitude)), "No latitude");
+	zassert_true(output_contains(stream.len, altitude, sizeof(altitude)), "No altitude");
+	zassert_true(output_contains(stream.len, accuracy, sizeof(accuracy)), "No accuracy");
+	zassert_true(output_contains(stream.len, speed, sizeof(speed)), "No speed");
+}
+
+static void test_stream_batch_data_encode(void)
+{
+	struct cloud_codec_data codec = { 0 };
+	char *expected;
+	int err;
+
+	do {
+		batch_fill(&batch);
+		memcpy(&batch_copy, &batch, sizeof(batch));
+		err = cjson_encode(&batch, &expected);
+	} while (err == -ENODATA);
+
+	zassert_equal(0, err, "Return value %d is wrong", err);
+
+	err = stream_common_batch_data_encode(&codec, BATCH_ARGS(&batch_copy));
+	zassert_equal(0, err, "Return value %d is wrong", err);
+	zassert_not_null(codec.buf, "Buffer is NULL");
+	zassert_equal(strlen(expected), codec.len, "Wrong length %zu", codec.len);
+	zassert_equal(strcmp(expected, codec.buf), 0, "Output differs from cJSON");
+	zassert_mem_equal(&batch, &batch_copy, sizeof(batch), "Data differs");
+
+	k_free(codec.buf);
+	cJSON_FreeString(expected);
+
+	/* Everything has been unqueued */
+	err = stream_common_batch_data_encode(&codec, BATCH_ARGS(&batch_copy));
+	zassert_equal(-ENODATA, err, "Return value %d is wrong", err);
+}
+
+void test_main(void)
+{
+	cJSON_Init();
+
+	ztest_test_suite(cloud_codec_stream,
+		ztest_unit_test(test_stream_equals_cjson),
+		ztest_unit_test(test_stream_measure),
+		ztest_unit_test(test_stream_no_data),
+		ztest_unit_test(test_stream_buffer_too_small),
+		ztest_unit_test(test_stream_write),
+		ztest_unit_test(test_stream_invalid),
+		ztest_unit_test(test_stream_escaping),
+		ztest_unit_test(test_stream_cbor),
+		ztest_unit_test(test_stream_cbor_numbers),
+		ztest_unit_test(test_stream_batch_data_encode)
+	);
+
+	ztest_run_test_suite(cloud_codec_stream);
+}
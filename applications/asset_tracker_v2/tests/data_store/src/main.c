@@ -0,0 +1,541 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <zephyr.h>
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "data_store.h"
+
+/* Number of entries that fit in the store in the worst case, with one entry per block. */
+#define ENTRY_COUNT_MIN CONFIG_DATA_STORE_BLOCK_COUNT
+
+#define SAMPLE_INTERVAL_MS 60000
+
+static union data_store_entry added[DATA_STORE_TYPE_COUNT][1000];
+static union data_store_entry entries[100];
+
+static uint32_t rand_state = 0x12345678;
+
+/* Reproducible pseudo-random numbers, xorshift32 */
+static uint32_t rand_get(void)
+{
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+
+	return rand_state;
+}
+
+/* Random walk around a value, with a step of at most max_step */
+static double walk(double value, double max_step)
+{
+	return value + max_step * ((int32_t)rand_get() / (double)INT32_MAX);
+}
+
+static void string_get(char *str, size_t size)
+{
+	size_t len = rand_get() % size;
+
+	for (size_t i = 0; i < len; i++) {
+		str[i] = 'a' + rand_get() % 26;
+	}
+
+	str[len] = '\0';
+}
+
+/* Fill an entry that follows the previous one, like a sensor sampled at regular intervals. */
+static void entry_fill(enum data_store_type type, union data_store_entry *entry,
+		       const union data_store_entry *prev, int64_t ts)
+{
+	static struct cloud_data_gnss_pvt pvt = { .lat = 63.421, .longi = 10.437, .alt = 100 };
+
+	*entry = *prev;
+
+	switch (type) {
+	case DATA_STORE_TYPE_GNSS:
+		entry->gnss.gnss_ts = ts;
+
+		if (rand_get() % 4) {
+			/* The previous entry can be NMEA, which shares the memory of PVT */
+			pvt.lat = walk(pvt.lat, 0.001);
+			pvt.longi = walk(pvt.longi, 0.001);
+			pvt.alt = walk(pvt.alt, 10);
+			pvt.acc = fabs(walk(20, 10));
+			pvt.spd = fabs(walk(pvt.spd, 1));
+			pvt.hdg = fmod(fabs(walk(pvt.hdg, 30)), 360);
+
+			entry->gnss.format = CLOUD_CODEC_GNSS_FORMAT_PVT;
+			entry->gnss.pvt = pvt;
+		} else {
+			entry->gnss.format = CLOUD_CODEC_GNSS_FORMAT_NMEA;
+			string_get(entry->gnss.nmea, sizeof(entry->gnss.nmea));
+		}
+		break;
+	case DATA_STORE_TYPE_SENSOR:
+		entry->sensor.env_ts = ts;
+		entry->sensor.temperature = walk(prev->sensor.temperature, 0.5);
+		entry->sensor.humidity = walk(prev->sensor.humidity, 1);
+		entry->sensor.pressure = walk(prev->sensor.pressure, 0.05);
+		entry->sensor.bsec_air_quality = rand_get() % 500;
+		break;
+	case DATA_STORE_TYPE_MODEM_DYNAMIC:
+		entry->modem_dyn.ts = ts;
+		entry->modem_dyn.area_code_fresh = rand_get() % 2;
+		entry->modem_dyn.cell_id_fresh = rand_get() % 2;
+		entry->modem_dyn.rsrp_fresh = rand_get() % 2;
+		entry->modem_dyn.ip_address_fresh = rand_get() % 2;
+		entry->modem_dyn.mccmnc_fresh = rand_get() % 2;
+		entry->modem_dyn.band_fresh = rand_get() % 2;
+		entry->modem_dyn.nw_mode_fresh = rand_get() % 2;
+		entry->modem_dyn.area = rand_get();
+		entry->modem_dyn.cell = rand_get();
+		entry->modem_dyn.rsrp = rand_get();
+		entry->modem_dyn.band = rand_get();
+		entry->modem_dyn.nw_mode = rand_get() % 2 ? LTE_LC_LTE_MODE_LTEM :
+							   LTE_LC_LTE_MODE_NBIOT;
+		string_get(entry->modem_dyn.ip, sizeof(entry->modem_dyn.ip));
+		string_get(entry->modem_dyn.mccmnc, sizeof(entry->modem_dyn.mccmnc));
+		break;
+	case DATA_STORE_TYPE_UI:
+		entry->ui.btn_ts = ts;
+		entry->ui.btn = 1 + rand_get() % 2;
+		break;
+	case DATA_STORE_TYPE_ACCELEROMETER:
+		entry->accel.ts = ts;
+		entry->accel.values[0] = walk(0, 20);
+		entry->accel.values[1] = walk(0, 20);
+		entry->accel.values[2] = walk(9.81, 20);
+		break;
+	case DATA_STORE_TYPE_BATTERY:
+		entry->bat.bat_ts = ts;
+		entry->bat.bat = 3600 + rand_get() % 1000;
+		break;
+	default:
+		zassert_unreachable("Unknown type");
+	}
+}
+
+static void entry_add(enum data_store_type type, size_t index, int64_t ts)
+{
+	static const union data_store_entry initial[DATA_STORE_TYPE_COUNT] = {
+		[DATA_STORE_TYPE_SENSOR].sensor = { .temperature = 22.5, .humidity = 40,
+						    .pressure = 101.325 },
+	};
+	const union data_store_entry *prev = index ? &added[type][index - 1] : &initial[type];
+
+	entry_fill(type, &added[type][index], prev, ts);
+	zassert_equal(data_store_add(type, &added[type][index]), 0, "Entry not added");
+}
+
+/* Check that the value is within half the resolution of the store, and the precision of
+ * the float fields.
+ */
+static void value_check(double actual, double expected, double resolution)
+{
+	zassert_true(fabs(actual - expected) <= resolution / 2 + fabs(expected) * FLT_EPSILON,
+		     "%.9f differs from %.9f", actual, expected);
+}
+
+static void entry_check(enum data_store_type type, const void *actual,
+			const union data_store_entry *expected)
+{
+	switch (type) {
+	case DATA_STORE_TYPE_GNSS: {
+		const struct cloud_data_gnss *gnss = actual;
+
+		zassert_true(gnss->queued, "Entry not queued");
+		zassert_equal(gnss->gnss_ts, expected->gnss.gnss_ts, "Wrong timestamp");
+		zassert_equal(gnss->format, expected->gnss.format, "Wrong format");
+
+		if (gnss->format == CLOUD_CODEC_GNSS_FORMAT_NMEA) {
+			zassert_equal(strcmp(gnss->nmea, expected->gnss.nmea), 0, "Wrong NMEA");
+		} else {
+			value_check(gnss->pvt.lat, expected->gnss.pvt.lat, 1e-7);
+			value_check(gnss->pvt.longi, expected->gnss.pvt.longi, 1e-7);
+			value_check(gnss->pvt.alt, expected->gnss.pvt.alt, 1e-3);
+			value_check(gnss->pvt.acc, expected->gnss.pvt.acc, 1e-3);
+			value_check(gnss->pvt.spd, expected->gnss.pvt.spd, 1e-3);
+			value_check(gnss->pvt.hdg, expected->gnss.pvt.hdg, 1e-3);
+		}
+	}
+		break;
+	case DATA_STORE_TYPE_SENSOR: {
+		const struct cloud_data_sensors *sensor = actual;
+
+		zassert_true(sensor->queued, "Entry not queued");
+		zassert_equal(sensor->env_ts, expected->sensor.env_ts, "Wrong timestamp");
+		value_check(sensor->temperature, expected->sensor.temperature, 1e-3);
+		value_check(sensor->humidity, expected->sensor.humidity, 1e-3);
+		value_check(sensor->pressure, expected->sensor.pressure, 1e-5);
+		zassert_equal(sensor->bsec_air_quality, expected->sensor.bsec_air_quality,
+			      "Wrong air quality");
+	}
+		break;
+	case DATA_STORE_TYPE_MODEM_DYNAMIC: {
+		const struct cloud_data_modem_dynamic *modem = actual;
+		const struct cloud_data_modem_dynamic *exp = &expected->modem_dyn;
+
+		zassert_true(modem->queued, "Entry not queued");
+		zassert_equal(modem->ts, exp->ts, "Wrong timestamp");
+		zassert_equal(modem->area_code_fresh, exp->area_code_fresh, "Wrong flag");
+		zassert_equal(modem->cell_id_fresh, exp->cell_id_fresh, "Wrong flag");
+		zassert_equal(modem->rsrp_fresh, exp->rsrp_fresh, "Wrong flag");
+		zassert_equal(modem->ip_address_fresh, exp->ip_address_fresh, "Wrong flag");
+		zassert_equal(modem->mccmnc_fresh, exp->mccmnc_fresh, "Wrong flag");
+		zassert_equal(modem->band_fresh, exp->band_fresh, "Wrong flag");
+		zassert_equal(modem->nw_mode_fresh, exp->nw_mode_fresh, "Wrong flag");
+
+		/* Only the fresh values are stored */
+		zassert_true(!exp->area_code_fresh || modem->area == exp->area, "Wrong area");
+		zassert_true(!exp->cell_id_fresh || modem->cell == exp->cell, "Wrong cell");
+		zassert_true(!exp->rsrp_fresh || modem->rsrp == exp->rsrp, "Wrong RSRP");
+		zassert_true(!exp->band_fresh || modem->band == exp->band, "Wrong band");
+		zassert_true(!exp->nw_mode_fresh || modem->nw_mode == exp->nw_mode,
+			     "Wrong network mode");
+		zassert_true(!exp->ip_address_fresh || !strcmp(modem->ip, exp->ip), "Wrong IP");
+		zassert_true(!exp->mccmnc_fresh || !strcmp(modem->mccmnc, exp->mccmnc),
+			     "Wrong MCCMNC");
+	}
+		break;
+	case DATA_STORE_TYPE_UI: {
+		const struct cloud_data_ui *ui = actual;
+
+		zassert_true(ui->queued, "Entry not queued");
+		zassert_equal(ui->btn_ts, expected->ui.btn_ts, "Wrong timestamp");
+		zassert_equal(ui->btn, expected->ui.btn, "Wrong button");
+	}
+		break;
+	case DATA_STORE_TYPE_ACCELEROMETER: {
+		const struct cloud_data_accelerometer *accel = actual;
+
+		zassert_true(accel->queued, "Entry not queued");
+		zassert_equal(accel->ts, expected->accel.ts, "Wrong timestamp");
+
+		for (size_t i = 0; i < ARRAY_SIZE(accel->values); i++) {
+			value_check(accel->values[i], expected->accel.values[i], 1e-3);
+		}
+	}
+		break;
+	case DATA_STORE_TYPE_BATTERY: {
+		const struct cloud_data_battery *bat = actual;
+
+		zassert_true(bat->queued, "Entry not queued");
+		zassert_equal(bat->bat_ts, expected->bat.bat_ts, "Wrong timestamp");
+		zassert_equal(bat->bat, expected->bat.bat, "Wrong voltage");
+	}
+		break;
+	default:
+		zassert_unreachable("Unknown type");
+	}
+}
+
+static size_t entry_size(enum data_store_type type)
+{
+	static const size_t sizes[] = {
+		[DATA_STORE_TYPE_GNSS] = sizeof(struct cloud_data_gnss),
+		[DATA_STORE_TYPE_SENSOR] = sizeof(struct cloud_data_sensors),
+		[DATA_STORE_TYPE_MODEM_DYNAMIC] = sizeof(struct cloud_data_modem_dynamic),
+		[DATA_STORE_TYPE_UI] = sizeof(struct cloud_data_ui),
+		[DATA_STORE_TYPE_ACCELEROMETER] = sizeof(struct cloud_data_accelerometer),
+		[DATA_STORE_TYPE_BATTERY] = sizeof(struct cloud_data_battery),
+	};
+
+	return sizes[type];
+}
+
+/* Get all entries, and check that they are the last ones that were added of each type. */
+static void entries_check(const size_t *added_count, size_t max_count)
+{
+	size_t got_count[DATA_STORE_TYPE_COUNT] = {0};
+	size_t stored_count[DATA_STORE_TYPE_COUNT];
+	enum data_store_type type;
+	int count;
+
+	for (size_t i = 0; i < DATA_STORE_TYPE_COUNT; i++) {
+		stored_count[i] = data_store_count(i);
+		zassert_true(stored_count[i] <= added_count[i], "Too many entries");
+	}
+
+	while ((count = data_store_get(&type, entries, max_count)) > 0) {
+		zassert_true(count <= max_count, "Too many entries returned");
+		zassert_true(type < DATA_STORE_TYPE_COUNT, "Invalid type");
+
+		for (int i = 0; i < count; i++) {
+			size_t index = added_count[type] - stored_count[type] + got_count[type]++;
+
+			entry_check(type, (uint8_t *)entries + i * entry_size(type),
+				    &added[type][index]);
+		}
+	}
+
+	zassert_equal(count, 0, "Error getting entries: %d", count);
+
+	for (size_t i = 0; i < DATA_STORE_TYPE_COUNT; i++) {
+		zassert_equal(got_count[i], stored_count[i], "Wrong number of entries");
+		zassert_equal(data_store_count(i), 0, "Store is not empty");
+		zassert_equal(data_store_size(i), 0, "Store is not empty");
+	}
+}
+
+static void test_data_store_round_trip(void)
+{
+	size_t added_count[DATA_STORE_TYPE_COUNT] = {0};
+
+	data_store_clear();
+
+	/* Entries of random types, that fit in the store */
+	for (size_t i = 0; i < ENTRY_COUNT_MIN; i++) {
+		enum data_store_type type = rand_get() % DATA_STORE_TYPE_COUNT;
+
+		entry_add(type, added_count[type], (int64_t)i * SAMPLE_INTERVAL_MS);
+		added_count[type]++;
+	}
+
+	for (size_t i = 0; i < DATA_STORE_TYPE_COUNT; i++) {
+		zassert_equal(data_store_count(i), added_count[i], "Entries dropped");
+	}
+
+	entries_check(added_count, ARRAY_SIZE(entries));
+}
+
+/* The oldest entries are dropped when the store is full, block by block. */
+static void test_data_store_full(void)
+{
+	size_t added_count[DATA_STORE_TYPE_COUNT] = {0};
+	size_t stored = 0;
+
+	if (IS_ENABLED(CONFIG_DATA_STORE_FLASH)) {
+		/* The oldest blocks are written to flash instead */
+		ztest_test_skip();
+	}
+
+	data_store_clear();
+
+	for (size_t i = 0; i < ARRAY_SIZE(added[0]); i++) {
+		enum data_store_type type = rand_get() % DATA_STORE_TYPE_COUNT;
+
+		entry_add(type, added_count[type], (int64_t)i * SAMPLE_INTERVAL_MS +
+			  rand_get() % 1000);
+		added_count[type]++;
+	}
+
+	for (size_t i = 0; i < DATA_STORE_TYPE_COUNT; i++) {
+		stored += data_store_count(i);
+	}
+
+	zassert_true(stored >= ENTRY_COUNT_MIN, "Too few entries kept: %d", (int)stored);
+	zassert_true(stored < ARRAY_SIZE(added[0]), "No entries dropped");
+
+	entries_check(added_count, 1 + rand_get() % ARRAY_SIZE(entries));
+}
+
+/* Entries are added and removed in random order. */
+static void test_data_store_interleaved(void)
+{
+	size_t added_count[DATA_STORE_TYPE_COUNT] = {0};
+	size_t got_count[DATA_STORE_TYPE_COUNT] = {0};
+	enum data_store_type type;
+	int count;
+
+	if (IS_ENABLED(CONFIG_DATA_STORE_FLASH)) {
+		/* Entries returned from flash are not counted by data_store_count() */
+		ztest_test_skip();
+	}
+
+	data_store_clear();
+
+	for (size_t i = 0; i < 2000; i++) {
+		if (rand_get() % 3) {
+			type = rand_get() % DATA_STORE_TYPE_COUNT;
+
+			if (added_count[type] == ARRAY_SIZE(added[type])) {
+				continue;
+			}
+
+			entry_add(type, added_count[type], (int64_t)i * SAMPLE_INTERVAL_MS);
+			added_count[type]++;
+			continue;
+		}
+
+		count = data_store_get(&type, entries, 1 + rand_get() % 5);
+		zassert_true(count >= 0, "Error getting entries: %d", count);
+
+		for (int j = 0; j < count; j++) {
+			/* Skip the entries that have been dropped */
+			size_t index = added_count[type] - data_store_count(type) - count + j;
+
+			zassert_true(index >= got_count[type], "Entry returned twice");
+			got_count[type] = index + 1;
+			entry_check(type, (uint8_t *)entries + j * entry_size(type),
+				    &added[type][index]);
+		}
+	}
+
+	entries_check(added_count, ARRAY_SIZE(entries));
+}
+
+/* Samples taken at regular intervals take a fraction of the size of the ringbuffer entries. */
+static void test_data_store_size(void)
+{
+	size_t added_count[DATA_STORE_TYPE_COUNT] = {0};
+
+	for (enum data_store_type type = 0; type < DATA_STORE_TYPE_COUNT; type++) {
+		size_t count;
+		size_t size;
+
+		/* Modem data is mostly strings, and does not compress */
+		if (type == DATA_STORE_TYPE_MODEM_DYNAMIC) {
+			continue;
+		}
+
+		data_store_clear();
+
+		/* Up to two thirds of the store, so that no entries are dropped */
+		for (count = 0; (count < ARRAY_SIZE(added[type])) &&
+				(data_store_size(type) < CONFIG_DATA_STORE_BLOCK_COUNT *
+							 CONFIG_DATA_STORE_BLOCK_SIZE * 2 / 3);
+		     count++) {
+			entry_add(type, count, 1600000000000 + (int64_t)count * SAMPLE_INTERVAL_MS);
+		}
+
+		size = data_store_size(type);
+		added_count[type] = count;
+
+		TC_PRINT("Type %d: %d entries, %d bytes, %d bytes per entry, %.1f times smaller\n",
+			 type, (int)count, (int)size, (int)(size / count),
+			 (double)(count * entry_size(type)) / size);
+
+		zassert_equal(data_store_count(type), count, "Entries dropped");
+		zassert_true(size * 3 < count * entry_size(type), "Entries are too large");
+
+		entries_check(added_count, ARRAY_SIZE(entries));
+		added_count[type] = 0;
+	}
+}
+
+static void test_data_store_invalid(void)
+{
+	struct cloud_data_ui ui = { .btn = 1, .btn_ts = 1000, .queued = true };
+	enum data_store_type type;
+
+	data_store_clear();
+
+	zassert_equal(data_store_add(DATA_STORE_TYPE_COUNT, &ui), -EINVAL, "Invalid type added");
+	zassert_equal(data_store_get(NULL, entries, 1), -EINVAL, "NULL type accepted");
+	zassert_equal(data_store_get(&type, NULL, 1), -EINVAL, "NULL entries accepted");
+	zassert_equal(data_store_get(&type, entries, 0), 0, "Entries returned");
+	zassert_equal(data_store_count(DATA_STORE_TYPE_COUNT), 0, "Invalid type counted");
+
+	/* The queued flag is set on all returned entries */
+	ui.queued = false;
+	zassert_equal(data_store_add(DATA_STORE_TYPE_UI, &ui), 0, "Entry not added");
+	zassert_equal(data_store_get(&type, entries, 1), 1, "Entry not returned");
+	zassert_equal(type, DATA_STORE_TYPE_UI, "Wrong type");
+	zassert_true(entries[0].ui.queued, "Entry not queued");
+}
+
+/* Add GNSS entries until the store has overflowed to flash, after reading some of them. */
+static size_t flash_fill(size_t read_count)
+{
+	enum data_store_type type;
+	size_t count = 0;
+
+	data_store_clear();
+
+	for (; count < read_count; count++) {
+		entry_add(DATA_STORE_TYPE_GNSS, count, (int64_t)count * SAMPLE_INTERVAL_MS);
+	}
+
+	zassert_equal(data_store_get(&type, entries, read_count), read_count,
+		      "Entries not returned");
+
+	for (; count < ARRAY_SIZE(added[0]); count++) {
+		entry_add(DATA_STORE_TYPE_GNSS, count, (int64_t)count * SAMPLE_INTERVAL_MS);
+	}
+
+	return count;
+}
+
+/* The blocks written to flash are returned first, without the entries that were read. */
+static void test_data_store_flash(void)
+{
+	const size_t read_count = 3;
+	enum data_store_type type;
+	size_t added_count;
+	size_t ram_count;
+	size_t first = 0;
+	size_t got = 0;
+	int count;
+
+	if (!IS_ENABLED(CONFIG_DATA_STORE_FLASH)) {
+		ztest_test_skip();
+	}
+
+	added_count = flash_fill(read_count);
+	ram_count = data_store_count(DATA_STORE_TYPE_GNSS);
+
+	while ((count = data_store_get(&type, entries, 1 + rand_get() % 10)) > 0) {
+		const struct cloud_data_gnss *gnss = (const struct cloud_data_gnss *)entries;
+
+		zassert_equal(type, DATA_STORE_TYPE_GNSS, "Wrong type");
+
+		if (got == 0) {
+			/* The oldest sectors are erased if the partition is full */
+			first = gnss[0].gnss_ts / SAMPLE_INTERVAL_MS;
+			zassert_true(first >= read_count, "Read entry returned again");
+		}
+
+		for (int i = 0; i < count; i++) {
+			zassert_true(first + got < added_count, "Too many entries");
+			entry_check(type, &gnss[i], &added[type][first + got]);
+			got++;
+		}
+	}
+
+	zassert_equal(count, 0, "Error getting entries: %d", count);
+	zassert_equal(first + got, added_count, "Newest entries missing");
+	zassert_true(got > ram_count, "No entries returned from flash");
+	zassert_equal(data_store_get(&type, entries, 1), 0, "Store is not empty");
+}
+
+/* The flash partition is erased when the store is cleared, and at boot. */
+static void test_data_store_flash_clear(void)
+{
+	enum data_store_type type;
+
+	if (!IS_ENABLED(CONFIG_DATA_STORE_FLASH)) {
+		ztest_test_skip();
+	}
+
+	(void)flash_fill(0);
+	data_store_clear();
+	zassert_equal(data_store_get(&type, entries, 1), 0, "Entries not cleared");
+
+	(void)flash_fill(0);
+	zassert_equal(data_store_init(), 0, "Initialization failed");
+	zassert_equal(data_store_get(&type, entries, 1), 0, "Entries not erased at boot");
+}
+
+void test_main(void)
+{
+	zassert_equal(data_store_init(), 0, "Initialization failed");
+
+	ztest_test_suite(data_store,
+		ztest_unit_test(test_data_store_round_trip),
+		ztest_unit_test(test_data_store_full),
+		ztest_unit_test(test_data_store_interleaved),
+		ztest_unit_test(test_data_store_size),
+		ztest_unit_test(test_data_store_invalid),
+		ztest_unit_test(test_data_store_flash),
+		ztest_unit_test(test_data_store_flash_clear)
+	);
+
+	ztest_run_test_suite(data_store);
+}
@@ -61,6 +61,7 @@
 #include "tone.h"
 #include "contin_array.h"
 #include "pcm_mix.h"
+#include "sample_rate_conv.h"
 
 #include <logging/log.h>
 LOG_MODULE_REGISTER(audio_datapath, CONFIG_LOG_AUDIO_DATAPATH_LEVEL);
@@ -117,6 +118,11 @@ LOG_MODULE_REGISTER(audio_datapath, CONFIG_LOG_AUDIO_DATAPATH_LEVEL);
 /* Presentation delay in microseconds */
 #define PRES_DLY_US 10000
 
+#if (CONFIG_AUDIO_DATAPATH_SRC)
+/* Converted audio for one frame plus a partial block carried over from the previous frame */
+#define SRC_BUF_NUM_FRAMES ((NUM_BLKS_IN_FRAME + 1) * BLK_MONO_NUM_SAMPS + 8)
+#endif /* (CONFIG_AUDIO_DATAPATH_SRC) */
+
 /* How often to print underrun warning */
 #define UNDERRUN_LOG_INTERVAL_BLKS 5000
 
@@ -182,6 +188,15 @@ static struct {
 		uint16_t ctr; /* Count func calls. Used for collecting data points and waiting */
 		int32_t sum_err_dly_us;
 	} pres_comp;
+
+#if (CONFIG_AUDIO_DATAPATH_SRC)
+	struct {
+		struct sample_rate_conv_ctx ctx;
+		int16_t buf[SRC_BUF_NUM_FRAMES * 2];
+		size_t num_frames; /* Converted frames not yet written to out.fifo */
+		int32_t drift_ppm;
+	} src;
+#endif /* (CONFIG_AUDIO_DATAPATH_SRC) */
 } ctrl_blk;
 
 static bool tone_active;
@@ -326,6 +341,33 @@ static void pres_comp_state_set(enum pres_comp_state new_state)
 	ERR_CHK(ret);
 }
 
+#if (CONFIG_AUDIO_DATAPATH_SRC)
+/**
+ * @brief Slew the sample rate converter to correct a presentation delay error
+ *
+ * @param err_dly_us Wanted minus current presentation delay. Zero stops slewing.
+ */
+static void src_drift_update(int32_t err_dly_us)
+{
+	int ret;
+	/* Correct the error over about one second, i.e. 1 us per second is 1 ppm.
+	 * More delay is wanted for a positive error, so fewer input samples
+	 * must be consumed per output sample.
+	 */
+	int32_t drift_ppm = CLAMP(-err_dly_us, -CONFIG_AUDIO_DATAPATH_SRC_DRIFT_PPM_MAX,
+				  CONFIG_AUDIO_DATAPATH_SRC_DRIFT_PPM_MAX);
+
+	if (drift_ppm == ctrl_blk.src.drift_ppm) {
+		return;
+	}
+
+	ret = sample_rate_conv_drift_set(&ctrl_blk.src.ctx, drift_ppm);
+	ERR_CHK(ret);
+
+	ctrl_blk.src.drift_ppm = drift_ppm;
+}
+#endif /* (CONFIG_AUDIO_DATAPATH_SRC) */
+
 /**
  * @brief Move audio blocks back and forth in FIFO to get audio in sync
  *
@@ -342,6 +384,9 @@ static void audio_datapath_presentation_compensation(uint32_t recv_frame_ts_us,
 	if (ctrl_blk.drift_comp.state != DRFT_STATE_LOCKED) {
 		/* Unconditionally reset state machine if drift compensation looses lock */
 		pres_comp_state_set(PRES_STATE_INIT);
+#if (CONFIG_AUDIO_DATAPATH_SRC)
+		src_drift_update(0);
+#endif /* (CONFIG_AUDIO_DATAPATH_SRC) */
 		return;
 	}
 
@@ -397,6 +442,10 @@ static void audio_datapath_presentation_compensation(uint32_t recv_frame_ts_us,
 		 * and previous sdu_ref_us origins from non-consecutive frames, or into
 		 * PRES_STATE_INIT if drift compensation unlocks.
 		 */
+#if (CONFIG_AUDIO_DATAPATH_SRC)
+		/* Absorb remaining sub-block errors smoothly */
+		src_drift_update(wanted_pres_dly_us - ctrl_blk.current_pres_dly_us);
+#endif /* (CONFIG_AUDIO_DATAPATH_SRC) */
 
 		break;
 	}
@@ -815,31 +864,69 @@ void audio_datapath_stream_out(const uint8_t *buf, size_t size, uint32_t sdu_ref
 		ERR_CHK_MSG(-ECANCELED, "Decoded audio has wrong size");
 	}
 
+	int16_t *pcm_out = (int16_t *)ctrl_blk.decoded_data;
+	uint32_t num_blks_out = NUM_BLKS_IN_FRAME;
+	uint32_t out_ts_us = recv_frame_ts_us;
+
+#if (CONFIG_AUDIO_DATAPATH_SRC)
+	/*** Sample rate conversion ***/
+
+	size_t src_frames;
+
+	/* The first output block starts with the audio carried over from the
+	 * previous frame, so its reference is that much earlier.
+	 */
+	out_ts_us -= ((uint64_t)ctrl_blk.src.num_frames * USEC_PER_SEC) /
+		     CONFIG_AUDIO_SAMPLE_RATE_HZ;
+
+	ret = sample_rate_conv_process(&ctrl_blk.src.ctx, pcm_out,
+				       NUM_BLKS_IN_FRAME * BLK_MONO_NUM_SAMPS,
+				       &ctrl_blk.src.buf[ctrl_blk.src.num_frames * 2],
+				       SRC_BUF_NUM_FRAMES - ctrl_blk.src.num_frames, &src_frames);
+	ERR_CHK(ret);
+
+	ctrl_blk.src.num_frames += src_frames;
+
+	/* The number of whole blocks varies by one when the ratio is adjusted */
+	pcm_out = ctrl_blk.src.buf;
+	num_blks_out = ctrl_blk.src.num_frames / BLK_MONO_NUM_SAMPS;
+#endif /* (CONFIG_AUDIO_DATAPATH_SRC) */
+
 	/*** Add audio data to FIFO buffer ***/
 
 	int32_t num_blks_in_fifo = ctrl_blk.out.prod_blk_idx - ctrl_blk.out.cons_blk_idx;
 
-	if ((num_blks_in_fifo + NUM_BLKS_IN_FRAME) > FIFO_NUM_BLKS) {
+	if ((num_blks_in_fifo + num_blks_out) > FIFO_NUM_BLKS) {
 		LOG_WRN("Output audio stream overrun - Discarding audio frame");
 
+#if (CONFIG_AUDIO_DATAPATH_SRC)
+		ctrl_blk.src.num_frames = 0;
+#endif /* (CONFIG_AUDIO_DATAPATH_SRC) */
+
 		/* Discard frame to allow consumer to catch up */
 		return;
 	}
 
 	uint32_t out_blk_idx = ctrl_blk.out.prod_blk_idx;
 
-	for (uint32_t i = 0; i < NUM_BLKS_IN_FRAME; i++) {
+	for (uint32_t i = 0; i < num_blks_out; i++) {
 		memcpy(&ctrl_blk.out.fifo[out_blk_idx * BLK_STEREO_NUM_SAMPS],
-		       &((int16_t *)ctrl_blk.decoded_data)[i * BLK_STEREO_NUM_SAMPS],
-		       BLK_STEREO_SIZE_OCTETS);
+		       &pcm_out[i * BLK_STEREO_NUM_SAMPS], BLK_STEREO_SIZE_OCTETS);
 
 		/* Record producer block start reference */
-		ctrl_blk.out.prod_blk_ts[out_blk_idx] = recv_frame_ts_us + (i * BLK_PERIOD_US);
+		ctrl_blk.out.prod_blk_ts[out_blk_idx] = out_ts_us + (i * BLK_PERIOD_US);
 
 		out_blk_idx = NEXT_IDX(out_blk_idx);
 	}
 
 	ctrl_blk.out.prod_blk_idx = out_blk_idx;
+
+#if (CONFIG_AUDIO_DATAPATH_SRC)
+	/* Carry the partial block over to the next frame */
+	ctrl_blk.src.num_frames -= num_blks_out * BLK_MONO_NUM_SAMPS;
+	memmove(ctrl_blk.src.buf, &ctrl_blk.src.buf[num_blks_out * BLK_STEREO_NUM_SAMPS],
+		ctrl_blk.src.num_frames * 2 * sizeof(int16_t));
+#endif /* (CONFIG_AUDIO_DATAPATH_SRC) */
 }
 
 int audio_datapath_start(struct data_fifo *fifo_rx)
@@ -857,6 +944,18 @@ int audio_datapath_start(struct data_fifo *fifo_rx)
 		/* Clear counters and mute initial audio */
 		memset(&ctrl_blk.out, 0, sizeof(ctrl_blk.out));
 
+#if (CONFIG_AUDIO_DATAPATH_SRC)
+		int ret = sample_rate_conv_init(&ctrl_blk.src.ctx, CONFIG_AUDIO_SAMPLE_RATE_HZ,
+						CONFIG_AUDIO_SAMPLE_RATE_HZ, 2);
+
+		if (ret) {
+			return ret;
+		}
+
+		ctrl_blk.src.num_frames = 0;
+		ctrl_blk.src.drift_ppm = 0;
+#endif /* (CONFIG_AUDIO_DATAPATH_SRC) */
+
 		audio_datapath_i2s_start();
 		ctrl_blk.stream_started = true;
 
@@ -7,6 +7,7 @@
 #include "data_fifo.h"
 
 #include <zephyr.h>
+#include <string.h>
 
 #include "macros_common.h"
 
@@ -43,6 +44,197 @@ static int msgq_slab_legal_used_elements(struct data_fifo *data_fifo, uint32_t *
 	return 0;
 }
 
+/* Ring indices run from 0 to 2 * elements_max - 1 */
+static uint32_t spsc_idx_next(struct data_fifo *data_fifo, uint32_t idx)
+{
+	return (idx + 1 == 2 * data_fifo->elements_max) ? 0 : idx + 1;
+}
+
+static uint32_t spsc_idx_dist(struct data_fifo *data_fifo, uint32_t head, uint32_t tail)
+{
+	return (head >= tail) ? head - tail : head + 2 * data_fifo->elements_max - tail;
+}
+
+static uint32_t spsc_slot(struct data_fifo *data_fifo, uint32_t idx)
+{
+	return (idx < data_fifo->elements_max) ? idx : idx - data_fifo->elements_max;
+}
+
+static void *spsc_block_ptr(struct data_fifo *data_fifo, uint32_t idx)
+{
+	return &data_fifo->slab_buffer[spsc_slot(data_fifo, idx) * data_fifo->block_size_max];
+}
+
+/* Wake up the other side if it is blocked waiting on this FIFO */
+static void spsc_wake(atomic_t *waiting, struct k_sem *sem)
+{
+	if (atomic_cas(waiting, true, false)) {
+		k_sem_give(sem);
+	}
+}
+
+static int spsc_pointer_first_vacant_get(struct data_fifo *data_fifo, void **data,
+					 k_timeout_t timeout)
+{
+	struct data_fifo_spsc *spsc = &data_fifo->spsc;
+	uint32_t alloc_idx = atomic_get(&spsc->alloc_idx);
+	uint32_t alloced_num;
+	int ret;
+
+	while (spsc_idx_dist(data_fifo, alloc_idx, atomic_get(&spsc->free_idx)) >=
+	       data_fifo->elements_max) {
+		if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+			spsc->stats.full_cnt++;
+			return -ENOMEM;
+		}
+
+		atomic_set(&spsc->vacant_waiting, true);
+
+		/* The consumer may have freed a block before the flag was set */
+		if (spsc_idx_dist(data_fifo, alloc_idx, atomic_get(&spsc->free_idx)) <
+		    data_fifo->elements_max) {
+			break;
+		}
+
+		ret = k_sem_take(&spsc->vacant_sem, timeout);
+		if (ret) {
+			spsc->stats.full_cnt++;
+			return ret;
+		}
+	}
+
+	*data = spsc_block_ptr(data_fifo, alloc_idx);
+
+	alloc_idx = spsc_idx_next(data_fifo, alloc_idx);
+	atomic_set(&spsc->alloc_idx, alloc_idx);
+
+	alloced_num = spsc_idx_dist(data_fifo, alloc_idx, atomic_get(&spsc->free_idx));
+	spsc->stats.alloced_max = MAX(spsc->stats.alloced_max, alloced_num);
+
+	return 0;
+}
+
+static int spsc_block_lock(struct data_fifo *data_fifo, void **data, size_t size)
+{
+	struct data_fifo_spsc *spsc = &data_fifo->spsc;
+	uint32_t lock_idx = atomic_get(&spsc->lock_idx);
+	uint32_t locked_num;
+
+	if (lock_idx == (uint32_t)atomic_get(&spsc->alloc_idx) ||
+	    *data != spsc_block_ptr(data_fifo, lock_idx)) {
+		LOG_ERR("Block not locked in allocation order");
+		return -ESPIPE;
+	}
+
+	data_fifo->size_buffer[spsc_slot(data_fifo, lock_idx)] = size;
+
+	/* Publish the block after its size has been written */
+	lock_idx = spsc_idx_next(data_fifo, lock_idx);
+	atomic_set(&spsc->lock_idx, lock_idx);
+
+	locked_num = spsc_idx_dist(data_fifo, lock_idx, atomic_get(&spsc->read_idx));
+	spsc->stats.locked_max = MAX(spsc->stats.locked_max, locked_num);
+	spsc->stats.locked_sum += locked_num;
+	spsc->stats.lock_cnt++;
+
+	spsc_wake(&spsc->filled_waiting, &spsc->filled_sem);
+
+	return 0;
+}
+
+static int spsc_pointer_last_filled_get(struct data_fifo *data_fifo, void **data, size_t *size,
+					k_timeout_t timeout)
+{
+	struct data_fifo_spsc *spsc = &data_fifo->spsc;
+	uint32_t read_idx = atomic_get(&spsc->read_idx);
+	int ret;
+
+	while (read_idx == (uint32_t)atomic_get(&spsc->lock_idx)) {
+		if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+			spsc->stats.empty_cnt++;
+			return -ENOMSG;
+		}
+
+		atomic_set(&spsc->filled_waiting, true);
+
+		/* The producer may have locked a block before the flag was set */
+		if (read_idx != (uint32_t)atomic_get(&spsc->lock_idx)) {
+			break;
+		}
+
+		ret = k_sem_take(&spsc->filled_sem, timeout);
+		if (ret) {
+			spsc->stats.empty_cnt++;
+			return ret;
+		}
+	}
+
+	*data = spsc_block_ptr(data_fifo, read_idx);
+	*size = data_fifo->size_buffer[spsc_slot(data_fifo, read_idx)];
+
+	atomic_set(&spsc->read_idx, spsc_idx_next(data_fifo, read_idx));
+
+	return 0;
+}
+
+static int spsc_block_free(struct data_fifo *data_fifo, void **data)
+{
+	struct data_fifo_spsc *spsc = &data_fifo->spsc;
+	uint32_t free_idx = atomic_get(&spsc->free_idx);
+
+	if (free_idx == (uint32_t)atomic_get(&spsc->read_idx) ||
+	    *data != spsc_block_ptr(data_fifo, free_idx)) {
+		LOG_ERR("Block not freed in read order");
+		return -EPERM;
+	}
+
+	atomic_set(&spsc->free_idx, spsc_idx_next(data_fifo, free_idx));
+
+	spsc_wake(&spsc->vacant_waiting, &spsc->vacant_sem);
+
+	return 0;
+}
+
+static int spsc_num_used_get(struct data_fifo *data_fifo, uint32_t *alloced_num,
+			     uint32_t *locked_num)
+{
+	struct data_fifo_spsc *spsc = &data_fifo->spsc;
+
+	/* Read order ensures locked <= alloced even if the producer and
+	 * consumer are running concurrently.
+	 */
+	uint32_t free_idx = atomic_get(&spsc->free_idx);
+	uint32_t read_idx = atomic_get(&spsc->read_idx);
+	uint32_t lock_idx = atomic_get(&spsc->lock_idx);
+	uint32_t alloc_idx = atomic_get(&spsc->alloc_idx);
+
+	*alloced_num = spsc_idx_dist(data_fifo, alloc_idx, free_idx);
+	*locked_num = spsc_idx_dist(data_fifo, lock_idx, read_idx);
+
+	return 0;
+}
+
+static int spsc_init(struct data_fifo *data_fifo)
+{
+	struct data_fifo_spsc *spsc = &data_fifo->spsc;
+
+	__ASSERT_NO_MSG(data_fifo->size_buffer != NULL);
+
+	atomic_set(&spsc->alloc_idx, 0);
+	atomic_set(&spsc->lock_idx, 0);
+	atomic_set(&spsc->read_idx, 0);
+	atomic_set(&spsc->free_idx, 0);
+	atomic_set(&spsc->vacant_waiting, false);
+	atomic_set(&spsc->filled_waiting, false);
+	k_sem_init(&spsc->vacant_sem, 0, 1);
+	k_sem_init(&spsc->filled_sem, 0, 1);
+	memset(&spsc->stats, 0, sizeof(spsc->stats));
+
+	data_fifo->initialized = true;
+
+	return 0;
+}
+
 int data_fifo_pointer_first_vacant_get(struct data_fifo *data_fifo, void **data,
 				       k_timeout_t timeout)
 {
@@ -50,6 +242,10 @@ int data_fifo_pointer_first_vacant_get(struct data_fifo *data_fifo, void **data,
 	__ASSERT_NO_MSG(data_fifo->initialized);
 	int ret;
 
+	if (data_fifo->is_spsc) {
+		return spsc_pointer_first_vacant_get(data_fifo, data, timeout);
+	}
+
 	ret = k_mem_slab_alloc(&data_fifo->mem_slab, data, timeout);
 	return ret;
 }
@@ -68,6 +264,10 @@ int data_fifo_block_lock(struct data_fifo *data_fifo, void **data, size_t size)
 		return -EINVAL;
 	}
 
+	if (data_fifo->is_spsc) {
+		return spsc_block_lock(data_fifo, data, size);
+	}
+
 	struct data_fifo_msgq msgq_tmp;
 
 	msgq_tmp.block_ptr = *data;
@@ -93,6 +293,10 @@ int data_fifo_pointer_last_filled_get(struct data_fifo *data_fifo, void **data,
 	__ASSERT_NO_MSG(data_fifo->initialized);
 	int ret;
 
+	if (data_fifo->is_spsc) {
+		return spsc_pointer_last_filled_get(data_fifo, data, size, timeout);
+	}
+
 	struct data_fifo_msgq msgq_tmp;
 
 	ret = k_msgq_get(&data_fifo->msgq, &msgq_tmp, timeout);
@@ -110,6 +314,10 @@ int data_fifo_block_free(struct data_fifo *data_fifo, void **data)
 	__ASSERT_NO_MSG(data_fifo != NULL);
 	__ASSERT_NO_MSG(data_fifo->initialized);
 
+	if (data_fifo->is_spsc) {
+		return spsc_block_free(data_fifo, data);
+	}
+
 	k_mem_slab_free(&data_fifo->mem_slab, data);
 
 	return 0;
@@ -124,6 +332,10 @@ int data_fifo_num_used_get(struct data_fifo *data_fifo, uint32_t *alloced_num, u
 	uint32_t msgq_num_used = UINT32_MAX;
 	uint32_t slab_blocks_num_used = UINT32_MAX;
 
+	if (data_fifo->is_spsc) {
+		return spsc_num_used_get(data_fifo, alloced_num, locked_num);
+	}
+
 	ret = msgq_slab_legal_used_elements(data_fifo, &msgq_num_used, &slab_blocks_num_used);
 	if (ret) {
 		return ret;
@@ -135,6 +347,21 @@ int data_fifo_num_used_get(struct data_fifo *data_fifo, uint32_t *alloced_num, u
 	return ret;
 }
 
+int data_fifo_stats_get(struct data_fifo *data_fifo, struct data_fifo_stats *stats)
+{
+	__ASSERT_NO_MSG(data_fifo != NULL);
+	__ASSERT_NO_MSG(stats != NULL);
+	__ASSERT_NO_MSG(data_fifo->initialized);
+
+	if (!data_fifo->is_spsc) {
+		return -ENOTSUP;
+	}
+
+	*stats = data_fifo->spsc.stats;
+
+	return 0;
+}
+
 int data_fifo_init(struct data_fifo *data_fifo)
 {
 	__ASSERT_NO_MSG(data_fifo != NULL);
@@ -144,6 +371,10 @@ int data_fifo_init(struct data_fifo *data_fifo)
 	__ASSERT_NO_MSG((data_fifo->block_size_max % WB_UP(1)) == 0);
 	int ret;
 
+	if (data_fifo->is_spsc) {
+		return spsc_init(data_fifo);
+	}
+
 	k_msgq_init(&data_fifo->msgq, data_fifo->msgq_buffer, sizeof(struct data_fifo_msgq),
 		    data_fifo->elements_max);
 
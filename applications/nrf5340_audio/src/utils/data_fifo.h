@@ -19,13 +19,53 @@ struct data_fifo_msgq {
 	size_t size;
 };
 
+/* Fill-level statistics. Only collected for FIFOs defined with
+ * DATA_FIFO_SPSC_DEFINE.
+ */
+struct data_fifo_stats {
+	/* Highest number of blocks allocated at the same time */
+	uint32_t alloced_max;
+	/* Highest number of locked blocks waiting to be fetched */
+	uint32_t locked_max;
+	/* Number of blocks locked since init */
+	uint32_t lock_cnt;
+	/* Sum of locked blocks waiting, sampled at each lock. Divide by
+	 * lock_cnt to get the average fill level.
+	 */
+	uint64_t locked_sum;
+	/* Number of times a vacant block was requested from a full FIFO */
+	uint32_t full_cnt;
+	/* Number of times a filled block was requested from an empty FIFO */
+	uint32_t empty_cnt;
+};
+
+/* Single-producer/single-consumer ring state. Each index runs from 0 to
+ * 2 * elements_max - 1 so that a full ring can be told apart from an
+ * empty one. The producer only writes alloc_idx and lock_idx, the
+ * consumer only writes read_idx and free_idx.
+ */
+struct data_fifo_spsc {
+	atomic_t alloc_idx;
+	atomic_t lock_idx;
+	atomic_t read_idx;
+	atomic_t free_idx;
+	atomic_t vacant_waiting;
+	atomic_t filled_waiting;
+	struct k_sem vacant_sem;
+	struct k_sem filled_sem;
+	struct data_fifo_stats stats;
+};
+
 struct data_fifo {
 	char *msgq_buffer;
 	char *slab_buffer;
+	size_t *size_buffer;
 	struct k_mem_slab mem_slab;
 	struct k_msgq msgq;
+	struct data_fifo_spsc spsc;
 	uint32_t elements_max;
 	size_t block_size_max;
+	bool is_spsc;
 	bool initialized;
 };
 
@@ -40,6 +80,32 @@ struct data_fifo {
 				  .elements_max = elements_max_in,                                 \
 				  .initialized = false }
 
+/**
+ * @brief Define a single-producer/single-consumer data_fifo.
+ *
+ * The FIFO has the same API as one defined with DATA_FIFO_DEFINE, but uses
+ * a ring of blocks with atomic indices instead of a message queue and a
+ * memory slab. Kernel objects are only used when a call waits with a timeout
+ * other than K_NO_WAIT.
+ *
+ * The following restrictions apply:
+ * - data_fifo_pointer_first_vacant_get and data_fifo_block_lock must only be
+ *   called from one context (the producer), and data_fifo_pointer_last_filled_get
+ *   and data_fifo_block_free from one other context (the consumer).
+ * - Blocks must be locked in the order they were allocated, and freed in the
+ *   order they were fetched.
+ */
+#define DATA_FIFO_SPSC_DEFINE(name, elements_max_in, block_size_max_in)                            \
+	char __aligned(WB_UP(1))                                                                   \
+		_slab_buffer_##name[(elements_max_in) * (block_size_max_in)] = { 0 };              \
+	size_t _size_buffer_##name[(elements_max_in)] = { 0 };                                    \
+	struct data_fifo name = { .slab_buffer = _slab_buffer_##name,                              \
+				  .size_buffer = _size_buffer_##name,                              \
+				  .block_size_max = block_size_max_in,                             \
+				  .elements_max = elements_max_in,                                 \
+				  .is_spsc = true,                                                 \
+				  .initialized = false }
+
 /**
  * @brief Get pointer to first vacant block in slab.
  *
@@ -56,7 +122,9 @@ struct data_fifo {
  *	or K_FOREVER to wait as long as necessary.
  *
  * @retval 0 Memory allocated.
- * @retval Return values from k_mem_slab_alloc.
+ * @retval -ENOMEM	No vacant block and timeout is K_NO_WAIT.
+ * @retval -EAGAIN	Waiting period timed out.
+ * @retval Other return values from k_mem_slab_alloc.
  */
 int data_fifo_pointer_first_vacant_get(struct data_fifo *data_fifo, void **data,
 				       k_timeout_t timeout);
@@ -79,7 +147,8 @@ int data_fifo_pointer_first_vacant_get(struct data_fifo *data_fifo, void **data,
  * @retval -EINVAL	Supplied size is zero
  * @retval -ESPIPE	Generic return if an error occurs in k_msg_put.
  *			Since data has already been added to the slab, there
- *			must be space in the message queue.
+ *			must be space in the message queue. For an SPSC FIFO,
+ *			returned if the block is not the oldest allocated one.
  */
 int data_fifo_block_lock(struct data_fifo *data_fifo, void **data, size_t size);
 
@@ -99,7 +168,8 @@ int data_fifo_block_lock(struct data_fifo *data_fifo, void **data, size_t size);
  *	or K_FOREVER to wait as long as necessary.
  *
  * @retval 0 Memory pointer retrieved.
- * @retval Return values from k_msgq_get.
+ * @retval -ENOMSG	No filled block and timeout is K_NO_WAIT.
+ * @retval -EAGAIN	Waiting period timed out.
  */
 int data_fifo_pointer_last_filled_get(struct data_fifo *data_fifo, void **data, size_t *size,
 				      k_timeout_t timeout);
@@ -113,7 +183,7 @@ int data_fifo_pointer_last_filled_get(struct data_fifo *data_fifo, void **data,
  * @param data Double pointer to the memory area which is to be freed.
  *
  * @retval 0	Memory block is freed.
- * @retval Return values from k_mem_slab_free.
+ * @retval -EPERM	SPSC FIFO only: the block is not the oldest fetched one.
  */
 int data_fifo_block_free(struct data_fifo *data_fifo, void **data);
 
@@ -132,6 +202,17 @@ int data_fifo_block_free(struct data_fifo *data_fifo, void **data);
 int data_fifo_num_used_get(struct data_fifo *data_fifo, uint32_t *alloced_num,
 			   uint32_t *locked_num);
 
+/**
+ * @brief Get fill-level statistics.
+ *
+ * @param data_fifo Pointer to the data_fifo structure.
+ * @param stats Pointer to where the statistics are stored.
+ *
+ * @retval 0		Success
+ * @retval -ENOTSUP	The FIFO was not defined with DATA_FIFO_SPSC_DEFINE.
+ */
+int data_fifo_stats_get(struct data_fifo *data_fifo, struct data_fifo_stats *stats);
+
 /**
  * @brief Initialise the data_fifo.
  *
@@ -7,6 +7,17 @@
 #include "pcm_mix.h"
 
 #include <zephyr.h>
+#include <string.h>
+
+/* Use the packed saturating add from the DSP extension when available
+ * (e.g. Cortex-M33). Other targets use a portable C equivalent.
+ */
+#if defined(__ARM_FEATURE_SIMD32) && __ARM_FEATURE_SIMD32
+#include <arm_acle.h>
+#define PCM_MIX_SIMD32 1
+#else
+#define PCM_MIX_SIMD32 0
+#endif
 
 #include <logging/log.h>
 LOG_MODULE_REGISTER(pcm_mix, LOG_LEVEL_WRN);
@@ -23,18 +34,63 @@ static void hard_limiter(int32_t *const pcm)
 	}
 }
 
+/* Samples are processed two at a time as packed 2x16-bit words. The
+ * packing below assumes little-endian sample order within a word.
+ */
+BUILD_ASSERT(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "Packed mixing requires little-endian");
+
+static inline uint32_t pcm_word_get(void const *const p)
+{
+	uint32_t word;
+
+	/* PCM buffers are only guaranteed to be 2-byte aligned */
+	memcpy(&word, p, sizeof(word));
+
+	return word;
+}
+
+static inline void pcm_word_put(void *const p, uint32_t word)
+{
+	memcpy(p, &word, sizeof(word));
+}
+
+/* Saturating add of two packed 2x16-bit signed sample pairs.
+ * The portable version is bit-identical to the DSP instruction.
+ */
+static inline uint32_t pcm_qadd16(uint32_t a, uint32_t b)
+{
+#if PCM_MIX_SIMD32
+	return (uint32_t)__qadd16((int16x2_t)a, (int16x2_t)b);
+#else
+	int32_t lo = (int16_t)(a & 0xFFFF) + (int16_t)(b & 0xFFFF);
+	int32_t hi = (int16_t)(a >> 16) + (int16_t)(b >> 16);
+
+	hard_limiter(&lo);
+	hard_limiter(&hi);
+
+	return (uint16_t)lo | ((uint32_t)(uint16_t)hi << 16);
+#endif
+}
+
 /* Mix stereo-stereo or mono-mono. I.e. buffers are of equal size */
 static void pcm_mix_identical(void *const pcm_a, size_t size_a, void const *const pcm_b,
 			      size_t size_b)
 {
-	int32_t res;
+	int16_t *a = (int16_t *)pcm_a;
+	int16_t const *b = (int16_t const *)pcm_b;
+	uint32_t num_samples = size_b / 2;
+	uint32_t i;
+
+	for (i = 0; i + 1 < num_samples; i += 2) {
+		pcm_word_put(&a[i], pcm_qadd16(pcm_word_get(&a[i]), pcm_word_get(&b[i])));
+	}
 
-	for (uint32_t i = 0; i < size_b / 2; i++) {
-		res = ((int16_t *)pcm_a)[i] + ((int16_t *)pcm_b)[i];
+	if (i < num_samples) {
+		/* Odd number of samples */
+		int32_t res = a[i] + b[i];
 
 		hard_limiter(&res);
-
-		((int16_t *)pcm_a)[i] = (int16_t)res;
+		a[i] = (int16_t)res;
 	}
 }
 
@@ -42,18 +98,25 @@ static void pcm_mix_identical(void *const pcm_a, size_t size_a, void const *cons
 static void pcm_mix_b_mono_into_a_stereo_lr(void *const pcm_a, size_t size_a,
 					    void const *const pcm_b, size_t size_b)
 {
-	int32_t res;
+	int16_t *a = (int16_t *)pcm_a;
+	int16_t const *b = (int16_t const *)pcm_b;
+	uint32_t num_samples = size_b / 2;
+	uint32_t i;
+
+	/* Each mono word b1:b0 is spread into the stereo words b0:b0 and b1:b1 */
+	for (i = 0; i + 1 < num_samples; i += 2) {
+		uint32_t mono = pcm_word_get(&b[i]);
+		uint32_t lr_0 = (mono & 0xFFFF) | (mono << 16);
+		uint32_t lr_1 = (mono >> 16) | (mono & 0xFFFF0000);
+
+		pcm_word_put(&a[i * 2], pcm_qadd16(pcm_word_get(&a[i * 2]), lr_0));
+		pcm_word_put(&a[i * 2 + 2], pcm_qadd16(pcm_word_get(&a[i * 2 + 2]), lr_1));
+	}
 
-	/* Use size_b as this is the length of the mono sample.
-	 * This must be *2 to traverse the stereo sample and /2 since
-	 * the sample is two bytes in size.
-	 */
-	for (uint32_t i = 0; i < size_b; i++) {
-		res = ((int16_t *)pcm_a)[i] + ((int16_t *)pcm_b)[i / 2];
+	if (i < num_samples) {
+		uint32_t mono = (uint16_t)b[i];
 
-		hard_limiter(&res);
-
-		((int16_t *)pcm_a)[i] = (int16_t)res;
+		pcm_word_put(&a[i * 2], pcm_qadd16(pcm_word_get(&a[i * 2]), mono | (mono << 16)));
 	}
 }
 
@@ -61,14 +124,24 @@ static void pcm_mix_b_mono_into_a_stereo_lr(void *const pcm_a, size_t size_a,
 static void pcm_mix_b_mono_into_a_stereo_l(void *const pcm_a, size_t size_a,
 					   void const *const pcm_b, size_t size_b)
 {
-	int32_t res;
+	int16_t *a = (int16_t *)pcm_a;
+	int16_t const *b = (int16_t const *)pcm_b;
+	uint32_t num_samples = size_b / 2;
+	uint32_t i;
 
-	for (uint32_t i = 0; i < size_b / 2; i++) {
-		res = ((int16_t *)pcm_a)[i * 2] + ((int16_t *)pcm_b)[i];
+	/* Adding zero to the right channel leaves it unchanged */
+	for (i = 0; i + 1 < num_samples; i += 2) {
+		uint32_t mono = pcm_word_get(&b[i]);
 
-		hard_limiter(&res);
+		pcm_word_put(&a[i * 2], pcm_qadd16(pcm_word_get(&a[i * 2]), mono & 0xFFFF));
+		pcm_word_put(&a[i * 2 + 2], pcm_qadd16(pcm_word_get(&a[i * 2 + 2]), mono >> 16));
+	}
+
+	if (i < num_samples) {
+		int32_t res = a[i * 2] + b[i];
 
-		((int16_t *)pcm_a)[i * 2] = (int16_t)res;
+		hard_limiter(&res);
+		a[i * 2] = (int16_t)res;
 	}
 }
 
@@ -76,14 +149,25 @@ static void pcm_mix_b_mono_into_a_stereo_l(void *const pcm_a, size_t size_a,
 static void pcm_mix_b_mono_into_a_stereo_r(void *const pcm_a, size_t size_a,
 					   void const *const pcm_b, size_t size_b)
 {
-	int32_t res;
+	int16_t *a = (int16_t *)pcm_a;
+	int16_t const *b = (int16_t const *)pcm_b;
+	uint32_t num_samples = size_b / 2;
+	uint32_t i;
+
+	/* Adding zero to the left channel leaves it unchanged */
+	for (i = 0; i + 1 < num_samples; i += 2) {
+		uint32_t mono = pcm_word_get(&b[i]);
+
+		pcm_word_put(&a[i * 2], pcm_qadd16(pcm_word_get(&a[i * 2]), mono << 16));
+		pcm_word_put(&a[i * 2 + 2],
+			     pcm_qadd16(pcm_word_get(&a[i * 2 + 2]), mono & 0xFFFF0000));
+	}
 
-	for (uint32_t i = 0; i < size_b / 2; i++) {
-		res = ((int16_t *)pcm_a)[i * 2 + 1] + ((int16_t *)pcm_b)[i];
+	if (i < num_samples) {
+		int32_t res = a[i * 2 + 1] + b[i];
 
 		hard_limiter(&res);
-
-		((int16_t *)pcm_a)[i * 2 + 1] = (int16_t)res;
+		a[i * 2 + 1] = (int16_t)res;
 	}
 }
 
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "sample_rate_conv.h"
+
+#include <zephyr.h>
+#include <string.h>
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(sample_rate_conv, LOG_LEVEL_WRN);
+
+/*
+ * Polyphase FIR sample rate converter.
+ *
+ * The output sample at fractional input position t is
+ *	y(t) = sum_k x[n - k] * g(k - D + frac)
+ * where x[n] is the newest input sample, D = TAPS / 2 is the filter delay and
+ * g is a Kaiser windowed sinc low-pass filter. g is tabulated at PHASES
+ * fractional positions. Positions in between are linearly interpolated, which
+ * allows any ratio, including one that changes slowly to track clock drift.
+ */
+
+#define POS_ONE (1ULL << 32)
+#define PHASES_LOG2 6
+BUILD_ASSERT((1 << PHASES_LOG2) == SAMPLE_RATE_CONV_PHASES);
+
+/* Fraction of the Nyquist frequency of the lower rate that is kept */
+#define CUTOFF_SCALE 0.85f
+#define KAISER_BETA 8.0f
+#define PI_F 3.14159265358979f
+
+/* sin(x), accurate to about 1e-6. Only used while designing the filter */
+static float sin_approx(float x)
+{
+	/* Reduce to [-pi, pi] */
+	while (x > PI_F) {
+		x -= 2 * PI_F;
+	}
+
+	while (x < -PI_F) {
+		x += 2 * PI_F;
+	}
+
+	/* Reduce to [-pi/2, pi/2] */
+	if (x > PI_F / 2) {
+		x = PI_F - x;
+	} else if (x < -PI_F / 2) {
+		x = -PI_F - x;
+	}
+
+	float x2 = x * x;
+
+	return x * (1.0f -
+		    x2 / 6.0f *
+			    (1.0f - x2 / 20.0f * (1.0f - x2 / 42.0f * (1.0f - x2 / 72.0f))));
+}
+
+/* Zeroth-order modified Bessel function of the first kind */
+static float bessel_i0(float x)
+{
+	float sum = 1.0f;
+	float term = 1.0f;
+
+	for (int k = 1; k < 20; k++) {
+		term *= (x / (2 * k)) * (x / (2 * k));
+		sum += term;
+	}
+
+	return sum;
+}
+
+static float sqrt_approx(float x)
+{
+	float r = x > 1.0f ? x : 1.0f;
+
+	if (x <= 0.0f) {
+		return 0.0f;
+	}
+
+	for (int i = 0; i < 20; i++) {
+		r = 0.5f * (r + x / r);
+	}
+
+	return r;
+}
+
+/* Kaiser windowed sinc. x is in input samples, cutoff in cycles per input sample */
+static float kernel(float x, float cutoff)
+{
+	const float half_len = SAMPLE_RATE_CONV_TAPS / 2;
+	float ratio = x / half_len;
+	float sinc;
+
+	if (ratio <= -1.0f || ratio >= 1.0f) {
+		return 0.0f;
+	}
+
+	if (x > -1e-6f && x < 1e-6f) {
+		sinc = 2 * cutoff;
+	} else {
+		sinc = sin_approx(2 * PI_F * cutoff * x) / (PI_F * x);
+	}
+
+	return sinc * bessel_i0(KAISER_BETA * sqrt_approx(1.0f - ratio * ratio)) /
+	       bessel_i0(KAISER_BETA);
+}
+
+static void filter_design(struct sample_rate_conv_ctx *ctx, float cutoff)
+{
+	float taps[SAMPLE_RATE_CONV_TAPS];
+
+	for (uint32_t p = 0; p <= SAMPLE_RATE_CONV_PHASES; p++) {
+		float frac = (float)p / SAMPLE_RATE_CONV_PHASES;
+		float sum = 0.0f;
+
+		for (uint32_t k = 0; k < SAMPLE_RATE_CONV_TAPS; k++) {
+			taps[k] = kernel((float)k - SAMPLE_RATE_CONV_TAPS / 2 + frac, cutoff);
+			sum += taps[k];
+		}
+
+		/* Unity DC gain for every phase */
+		for (uint32_t k = 0; k < SAMPLE_RATE_CONV_TAPS; k++) {
+			float coef = taps[k] / sum * 32768.0f;
+
+			coef = CLAMP(coef, INT16_MIN, INT16_MAX);
+			ctx->coefs[p][k] = (int16_t)(coef + (coef >= 0 ? 0.5f : -0.5f));
+		}
+	}
+}
+
+int sample_rate_conv_init(struct sample_rate_conv_ctx *ctx, uint32_t in_rate_hz,
+			  uint32_t out_rate_hz, uint8_t channels)
+{
+	float cutoff;
+
+	if (ctx == NULL) {
+		return -ENXIO;
+	}
+
+	if (in_rate_hz == 0 || out_rate_hz == 0 || channels == 0 ||
+	    channels > SAMPLE_RATE_CONV_CHANNELS_MAX) {
+		return -EINVAL;
+	}
+
+	if (in_rate_hz > out_rate_hz * SAMPLE_RATE_CONV_RATIO_MAX ||
+	    out_rate_hz > in_rate_hz * SAMPLE_RATE_CONV_RATIO_MAX) {
+		LOG_ERR("Ratio %d:%d not supported", in_rate_hz, out_rate_hz);
+		return -EINVAL;
+	}
+
+	memset(ctx, 0, sizeof(*ctx));
+
+	ctx->channels = channels;
+	ctx->step_nominal = ((uint64_t)in_rate_hz << 32) / out_rate_hz;
+	ctx->step = ctx->step_nominal;
+
+	/* Band limit to the lower of the two rates */
+	cutoff = 0.5f * CUTOFF_SCALE;
+	if (out_rate_hz < in_rate_hz) {
+		cutoff = cutoff * out_rate_hz / in_rate_hz;
+	}
+
+	filter_design(ctx, cutoff);
+
+	return 0;
+}
+
+int sample_rate_conv_drift_set(struct sample_rate_conv_ctx *ctx, int32_t drift_ppm)
+{
+	__ASSERT_NO_MSG(ctx != NULL);
+
+	if (drift_ppm > SAMPLE_RATE_CONV_DRIFT_PPM_MAX ||
+	    drift_ppm < -SAMPLE_RATE_CONV_DRIFT_PPM_MAX) {
+		return -EINVAL;
+	}
+
+	ctx->step = ctx->step_nominal + ((int64_t)ctx->step_nominal * drift_ppm) / 1000000;
+
+	return 0;
+}
+
+size_t sample_rate_conv_out_frames_max(struct sample_rate_conv_ctx const *const ctx,
+				       size_t in_frames)
+{
+	__ASSERT_NO_MSG(ctx != NULL);
+
+	return (size_t)(((uint64_t)in_frames * POS_ONE) / ctx->step) + 1;
+}
+
+/* Dot product of a history window and one filter phase */
+static inline int32_t fir(int16_t const *window, int16_t const *coefs)
+{
+	int64_t acc = 0;
+
+	for (uint32_t k = 0; k < SAMPLE_RATE_CONV_TAPS; k++) {
+		acc += (int32_t)window[k] * coefs[k];
+	}
+
+	return (int32_t)(acc >> 15);
+}
+
+int sample_rate_conv_process(struct sample_rate_conv_ctx *ctx, int16_t const *in, size_t in_frames,
+			     int16_t *out, size_t out_frames_max, size_t *out_frames)
+{
+	size_t out_cnt = 0;
+
+	if (ctx == NULL || in == NULL || out == NULL || out_frames == NULL) {
+		return -ENXIO;
+	}
+
+	if (out_frames_max < sample_rate_conv_out_frames_max(ctx, in_frames)) {
+		return -ENOMEM;
+	}
+
+	for (size_t i = 0; i < in_frames; i++) {
+		/* Newest sample first in the window, i.e. window[k] = x[n - k] */
+		ctx->history_idx = (ctx->history_idx == 0) ? SAMPLE_RATE_CONV_TAPS - 1 :
+							     ctx->history_idx - 1;
+
+		for (uint8_t ch = 0; ch < ctx->channels; ch++) {
+			int16_t sample = in[i * ctx->channels + ch];
+
+			ctx->history[ch][ctx->history_idx] = sample;
+			ctx->history[ch][ctx->history_idx + SAMPLE_RATE_CONV_TAPS] = sample;
+		}
+
+		while (ctx->pos < POS_ONE) {
+			uint32_t frac = (uint32_t)ctx->pos;
+			uint32_t phase = frac >> (32 - PHASES_LOG2);
+			/* Q15 weight between this and the next phase */
+			int32_t mu = (frac >> (32 - PHASES_LOG2 - 15)) & 0x7FFF;
+
+			for (uint8_t ch = 0; ch < ctx->channels; ch++) {
+				int16_t const *window = &ctx->history[ch][ctx->history_idx];
+				int32_t y0 = fir(window, ctx->coefs[phase]);
+				int32_t y1 = fir(window, ctx->coefs[phase + 1]);
+				int32_t res = y0 + (int32_t)(((int64_t)(y1 - y0) * mu) >> 15);
+
+				out[out_cnt * ctx->channels + ch] =
+					(int16_t)CLAMP(res, INT16_MIN, INT16_MAX);
+			}
+
+			out_cnt++;
+			ctx->pos += ctx->step;
+		}
+
+		ctx->pos -= POS_ONE;
+	}
+
+	*out_frames = out_cnt;
+
+	return 0;
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _SAMPLE_RATE_CONV_H_
+#define _SAMPLE_RATE_CONV_H_
+
+#include <zephyr.h>
+
+/* Number of filter taps per output sample */
+#define SAMPLE_RATE_CONV_TAPS 32
+/* Number of filter phases between two input samples */
+#define SAMPLE_RATE_CONV_PHASES 64
+#define SAMPLE_RATE_CONV_CHANNELS_MAX 2
+/* Largest supported ratio between input and output rate, in either direction */
+#define SAMPLE_RATE_CONV_RATIO_MAX 4
+/* Largest supported drift adjustment */
+#define SAMPLE_RATE_CONV_DRIFT_PPM_MAX 10000
+
+struct sample_rate_conv_ctx {
+	/* Q15 polyphase coefficients. One extra phase for interpolation */
+	int16_t coefs[SAMPLE_RATE_CONV_PHASES + 1][SAMPLE_RATE_CONV_TAPS];
+	/* Input history, stored twice so a full window is always contiguous */
+	int16_t history[SAMPLE_RATE_CONV_CHANNELS_MAX][SAMPLE_RATE_CONV_TAPS * 2];
+	uint32_t history_idx;
+	/* Input samples per output sample, Q32.32 */
+	uint64_t step_nominal;
+	uint64_t step;
+	/* Position of the next output sample relative to the newest input, Q32.32 */
+	uint64_t pos;
+	uint8_t channels;
+};
+
+/**
+ * @brief Initialize a sample rate converter.
+ *
+ * @note The filter is designed for the given rates during init, so this call
+ * is considerably slower than sample_rate_conv_process.
+ *
+ * @param ctx           [out]   Pointer to converter context
+ * @param in_rate_hz    [in]    Input sample rate
+ * @param out_rate_hz   [in]    Output sample rate
+ * @param channels      [in]    Number of interleaved channels (1 or 2)
+ *
+ * @return 0            Success
+ * @return -ENXIO       ctx is NULL
+ * @return -EINVAL      Rate is zero, ratio too large or invalid channel count
+ */
+int sample_rate_conv_init(struct sample_rate_conv_ctx *ctx, uint32_t in_rate_hz,
+			  uint32_t out_rate_hz, uint8_t channels);
+
+/**
+ * @brief Adjust the conversion ratio to absorb clock drift.
+ *
+ * A positive value consumes input faster, i.e. produces fewer output samples.
+ * The new ratio takes effect from the next output sample, so the adjustment is
+ * inaudible.
+ *
+ * @param ctx           [in/out]Pointer to converter context
+ * @param drift_ppm     [in]    Drift in parts per million
+ *
+ * @return 0            Success
+ * @return -EINVAL      |drift_ppm| > SAMPLE_RATE_CONV_DRIFT_PPM_MAX
+ */
+int sample_rate_conv_drift_set(struct sample_rate_conv_ctx *ctx, int32_t drift_ppm);
+
+/**
+ * @brief Get the maximum number of output frames produced from a given
+ * number of input frames with the current ratio.
+ *
+ * @param ctx           [in]    Pointer to converter context
+ * @param in_frames     [in]    Number of input frames
+ *
+ * @return Maximum number of output frames
+ */
+size_t sample_rate_conv_out_frames_max(struct sample_rate_conv_ctx const *const ctx,
+				       size_t in_frames);
+
+/**
+ * @brief Convert a block of signed 16-bit PCM data.
+ *
+ * State is kept between calls, so consecutive blocks form a continuous stream.
+ * A frame is one sample for every channel.
+ *
+ * @param ctx            [in/out]Pointer to converter context
+ * @param in             [in]    Input PCM data
+ * @param in_frames      [in]    Number of input frames
+ * @param out            [out]   Output PCM data
+ * @param out_frames_max [in]    Capacity of out in frames
+ * @param out_frames     [out]   Number of frames written to out
+ *
+ * @return 0            Success
+ * @return -ENXIO       NULL pointer
+ * @return -ENOMEM      out can not hold sample_rate_conv_out_frames_max frames
+ */
+int sample_rate_conv_process(struct sample_rate_conv_ctx *ctx, int16_t const *in, size_t in_frames,
+			     int16_t *out, size_t out_frames_max, size_t *out_frames);
+
+#endif /* _SAMPLE_RATE_CONV_H_ */
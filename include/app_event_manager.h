@@ -50,6 +50,8 @@ enum app_event_type_flags {
 	APP_EVENT_TYPE_FLAGS_USER_SETTABLE_START,
 	APP_EVENT_TYPE_FLAGS_INIT_LOG_ENABLE =
 		APP_EVENT_TYPE_FLAGS_USER_SETTABLE_START,
+	APP_EVENT_TYPE_FLAGS_PRIO_HIGH,
+	APP_EVENT_TYPE_FLAGS_PRIO_LOW,
 
 	/* Number of predefined flags. */
 	APP_EVENT_TYPE_FLAGS_COUNT,
@@ -70,6 +72,48 @@ static inline bool app_event_get_type_flag(const struct event_type *et,
 	return (et->flags & BIT(flag)) != 0;
 }
 
+/**
+ * @brief List of event priority classes.
+ *
+ * Every priority class uses a separate event queue. Pending events of
+ * a higher priority class are processed before the next event of a lower
+ * priority class. Events within a priority class are processed in
+ * the submission order.
+ */
+enum app_event_prio {
+	/** Events that can be delayed by all other events. */
+	APP_EVENT_PRIO_LOW,
+
+	/** Default priority class. */
+	APP_EVENT_PRIO_NORMAL,
+
+	/** Latency-critical events. */
+	APP_EVENT_PRIO_HIGH,
+
+	/** Number of priority classes. */
+	APP_EVENT_PRIO_COUNT,
+};
+
+/** @brief Get event type priority class.
+ *
+ * The priority class is set using @ref APP_EVENT_TYPE_FLAGS_PRIO_HIGH or
+ * @ref APP_EVENT_TYPE_FLAGS_PRIO_LOW flag. Event types without these flags
+ * belong to @ref APP_EVENT_PRIO_NORMAL class.
+ *
+ * @param et   Pointer to the event type.
+ * @retval Priority class of the event type.
+ */
+static inline enum app_event_prio app_event_get_type_prio(const struct event_type *et)
+{
+	if (app_event_get_type_flag(et, APP_EVENT_TYPE_FLAGS_PRIO_HIGH)) {
+		return APP_EVENT_PRIO_HIGH;
+	} else if (app_event_get_type_flag(et, APP_EVENT_TYPE_FLAGS_PRIO_LOW)) {
+		return APP_EVENT_PRIO_LOW;
+	}
+
+	return APP_EVENT_PRIO_NORMAL;
+}
+
 /** @brief Create an event listener object.
  *
  * @param lname   Module name.
@@ -165,6 +209,26 @@ static inline bool app_event_get_type_flag(const struct event_type *et,
 	_APP_EVENT_TYPE_DEFINE(ename, log_fn, ev_info_struct, app_event_type_flags)
 
 
+/** @brief Define an event type with the given number of memory slab blocks.
+ *
+ * This macro works like @ref APP_EVENT_TYPE_DEFINE, but it also sets the
+ * number of blocks in the memory slab of the event type.
+ * The number of blocks is ignored unless
+ * @kconfig{CONFIG_APP_EVENT_MANAGER_EVENT_SLAB} option is enabled.
+ *
+ * @param ename     	   Name of the event.
+ * @param log_fn  	   Function to stringify an event of this type.
+ * @param ev_info_struct   Data structure describing the event type.
+ * @param app_event_type_flags Event type flags.
+ *                         You should use APP_EVENT_FLAGS_CREATE to define them.
+ * @param block_cnt        Number of memory slab blocks.
+ */
+#define APP_EVENT_TYPE_SLAB_DEFINE(ename, log_fn, ev_info_struct, app_event_type_flags,	\
+				   block_cnt)						\
+	_APP_EVENT_TYPE_SLAB_DEFINE(ename, log_fn, ev_info_struct, app_event_type_flags,	\
+				    block_cnt)
+
+
 /** @brief Verify if an event ID is valid.
  *
  * The pointer to an event type structure is used as its ID. This macro
@@ -359,6 +423,24 @@ static inline size_t app_event_manager_event_size(const struct app_event_header
 	const struct {} __event_hook_postprocess_last_sub_redefined = {};  \
 	_APP_EVENT_HOOK_POSTPROCESS_REGISTER(hook_fn, _APP_EM_MARKER_FINAL_ELEMENT)
 
+/**
+ * @brief Register event hook called after every listener notification.
+ *
+ * The hook function should have a form
+ * `void hook(const struct app_event_header *aeh, const struct event_listener *el,
+ * uint32_t cycles)`, where @p cycles is the number of cycles spent in
+ * the notification function of the listener.
+ *
+ * @note
+ * The hook is called in the event processing context. Time spent in the hook
+ * delays processing of the following events.
+ *
+ * @param hook_fn Hook function.
+ */
+#define APP_EVENT_HOOK_DISPATCH_REGISTER(hook_fn)	\
+	_APP_EVENT_HOOK_DISPATCH_REGISTER(hook_fn,	\
+	_APP_EM_SUBS_PRIO_ID(_APP_EM_SUBS_PRIO_NORMAL))
+
 
 /** @brief Initialize the Application Event Manager.
  *
@@ -390,6 +472,132 @@ void *app_event_manager_alloc(size_t size);
 void app_event_manager_free(void *addr);
 
 
+/** @brief Take a reference to a submitted event.
+ *
+ * A listener can call this function from its notification function to keep
+ * the event after the notification function returns. The event is not freed
+ * until every reference is released with @ref app_event_manager_event_unref.
+ * The event data is shared by all references and must be treated as read-only.
+ *
+ * @note
+ * For this function to be available the
+ * @kconfig{CONFIG_APP_EVENT_MANAGER_EVENT_REFCNT} option needs to be enabled.
+ *
+ * @param aeh  Pointer to the application event header of the submitted event.
+ */
+void app_event_manager_event_ref(const struct app_event_header *aeh);
+
+
+/** @brief Release a reference to a submitted event.
+ *
+ * The event is freed when the last reference is released.
+ *
+ * @note
+ * For this function to be available the
+ * @kconfig{CONFIG_APP_EVENT_MANAGER_EVENT_REFCNT} option needs to be enabled.
+ *
+ * @param aeh  Pointer to the application event header of the submitted event.
+ */
+void app_event_manager_event_unref(const struct app_event_header *aeh);
+
+
+/** @brief Get listener dispatch time statistics.
+ *
+ * @note
+ * For this function to be available the
+ * @kconfig{CONFIG_APP_EVENT_MANAGER_LISTENER_STATS} option needs to be enabled.
+ *
+ * @param et     Pointer to the event type.
+ * @param el     Pointer to the listener subscribed to the event type.
+ * @param stats  Pointer to the structure filled with the statistics.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -ENOENT If the listener is not subscribed to the event type.
+ */
+int app_event_manager_listener_stats_get(const struct event_type *et,
+					 const struct event_listener *el,
+					 struct event_subscriber_stats *stats);
+
+
+/** @brief Reset dispatch time statistics of all listeners.
+ *
+ * @note
+ * For this function to be available the
+ * @kconfig{CONFIG_APP_EVENT_MANAGER_LISTENER_STATS} option needs to be enabled.
+ */
+void app_event_manager_listener_stats_reset(void);
+
+
+/** @brief Get upper limit of the listener dispatch time histogram bucket.
+ *
+ * @param idx  Index of the histogram bucket.
+ *
+ * @return Number of cycles that is not reached by the notifications counted
+ *         in the bucket or UINT32_MAX for the last bucket.
+ */
+static inline uint32_t app_event_manager_listener_stats_bucket_limit(size_t idx)
+{
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LISTENER_STATS)
+	if (idx >= CONFIG_APP_EVENT_MANAGER_LISTENER_STATS_BUCKET_CNT - 1) {
+		return UINT32_MAX;
+	}
+
+	return BIT(CONFIG_APP_EVENT_MANAGER_LISTENER_STATS_FIRST_BUCKET_LOG2 + idx);
+#else
+	__ASSERT_NO_MSG(false);
+	return 0;
+#endif
+}
+
+
+/** @brief Event type memory slab statistics.
+ */
+struct app_event_manager_slab_stats {
+	/** Size of a single slab block (in bytes). */
+	size_t block_size;
+
+	/** Number of blocks in the slab. */
+	uint32_t block_cnt;
+
+	/** Number of blocks currently in use. */
+	uint32_t used_cnt;
+
+	/** Maximum number of blocks that were in use at the same time. */
+	uint32_t max_used_cnt;
+
+	/** Number of events allocated with @ref app_event_manager_alloc, because
+	 *  the slab was exhausted or the event did not fit in the block.
+	 */
+	uint32_t fallback_cnt;
+};
+
+
+/** @brief Free an event allocated from the event type memory slab.
+ *
+ * The default implementation of @ref app_event_manager_free calls this function.
+ * Custom implementations of @ref app_event_manager_free must call it as well
+ * if @kconfig{CONFIG_APP_EVENT_MANAGER_EVENT_SLAB} option is enabled.
+ *
+ * @param addr  Pointer to the event.
+ * @retval true  If the event was allocated from the memory slab and it was freed.
+ * @retval false Otherwise.
+ */
+bool app_event_manager_slab_free(void *addr);
+
+
+/** @brief Get statistics of the event type memory slab.
+ *
+ * @note
+ * For this function to be available the
+ * @kconfig{CONFIG_APP_EVENT_MANAGER_EVENT_SLAB} option needs to be enabled.
+ *
+ * @param et     Pointer to the event type.
+ * @param stats  Pointer to the structure filled with the statistics.
+ */
+void app_event_manager_slab_stats_get(const struct event_type *et,
+				      struct app_event_manager_slab_stats *stats);
+
+
 /** @brief Log event.
  *
  * This helper macro simplifies event logging.
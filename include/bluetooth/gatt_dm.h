@@ -264,9 +264,16 @@ const struct bt_gatt_dm_attr *bt_gatt_dm_desc_next(
  * This function is asynchronous. Discovery results are passed through
  * the supplied callback.
  *
- * @note Only one discovery procedure can be started simultaneously. To start
- * another one, wait for the result of the previous procedure to finish
- * and call @ref bt_gatt_dm_data_release if it was successful.
+ * @note Up to @kconfig{CONFIG_BT_GATT_DM_MAX_INSTANCES} discovery procedures
+ * can run simultaneously, each on a different connection. To start another
+ * one on the same connection, wait for the result of the previous procedure
+ * to finish and call @ref bt_gatt_dm_data_release if it was successful.
+ *
+ * @note If @kconfig{CONFIG_BT_GATT_DM_CACHE} is enabled and the peer is
+ * bonded, the Database Hash of the peer is read first. If it matches the
+ * hash stored with the result of an earlier discovery of @p svc_uuid,
+ * the stored result is passed to the completed callback without discovering
+ * the peer database.
  *
  * @param[in]     conn Connection object.
  * @param[in]     svc_uuid UUID of target service
@@ -284,7 +291,9 @@ const struct bt_gatt_dm_attr *bt_gatt_dm_desc_next(
  * Call @ref bt_gatt_dm_continue to discover the next service instance.
  *
  * @retval 0 If the operation was successful.
- *           Otherwise, a (negative) error code is returned.
+ * @retval -EALREADY If a discovery is already running on @p conn
+ *         or no discovery instance is free.
+ *         Otherwise, a (negative) error code is returned.
  */
 int bt_gatt_dm_start(struct bt_conn *conn,
 		     const struct bt_uuid *svc_uuid,
@@ -317,6 +326,25 @@ int bt_gatt_dm_continue(struct bt_gatt_dm *dm, void *context);
  */
 int bt_gatt_dm_data_release(struct bt_gatt_dm *dm);
 
+/** @brief Remove stored discovery results.
+ *
+ * Call this function when the bond with a peer is removed.
+ *
+ * @param[in] addr Address of the peer,
+ *            or NULL to remove the results of all peers.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+#ifdef CONFIG_BT_GATT_DM_CACHE
+int bt_gatt_dm_cache_clear(const bt_addr_le_t *addr);
+#else
+static inline int bt_gatt_dm_cache_clear(const bt_addr_le_t *addr)
+{
+	return 0;
+}
+#endif
+
 /** @brief Print service discovery data.
  *
  * This function prints GATT attributes that belong to the discovered service.
@@ -161,8 +161,8 @@ struct bt_mesh_plvl_srv {
 	const struct bt_mesh_plvl_srv_handlers *const handlers;
 
 #if CONFIG_BT_SETTINGS
-	/** Storage timer */
-	struct k_work_delayable store_timer;
+	/** Pending state storage */
+	struct bt_mesh_model_store store;
 #endif
 	/** Current Power Range. */
 	struct bt_mesh_plvl_range range;
@@ -18,6 +18,7 @@
 #include <bluetooth/mesh/gen_ponoff.h>
 #include <bluetooth/mesh/gen_onoff_srv.h>
 #include <bluetooth/mesh/gen_dtt_srv.h>
+#include <bluetooth/mesh/model_types.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -105,8 +106,8 @@ struct bt_mesh_ponoff_srv {
 			     enum bt_mesh_on_power_up new_on_power_up);
 
 #if CONFIG_BT_SETTINGS
-	/** Storage timer */
-	struct k_work_delayable store_timer;
+	/** Pending state storage */
+	struct bt_mesh_model_store store;
 #endif
 	/** Current OnPowerUp state. */
 	enum bt_mesh_on_power_up on_power_up;
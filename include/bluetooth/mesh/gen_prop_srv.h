@@ -164,8 +164,8 @@ struct bt_mesh_prop_srv {
 	enum bt_mesh_prop_srv_state pub_state;
 
 #if CONFIG_BT_SETTINGS
-	/** Storage timer */
-	struct k_work_delayable store_timer;
+	/** Pending state storage */
+	struct bt_mesh_model_store store;
 #endif
 	/** List of properties supported by the server. */
 	struct bt_mesh_prop *const properties;
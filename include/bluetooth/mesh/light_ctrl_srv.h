@@ -156,8 +156,8 @@ struct bt_mesh_light_ctrl_srv {
 	struct k_work_delayable timer;
 
 #if CONFIG_BT_SETTINGS
-	/** Storage timer */
-	struct k_work_delayable store_timer;
+	/** Pending state storage */
+	struct bt_mesh_model_store store;
 #endif
 	/** Timer for delayed action */
 	struct k_work_delayable action_delay;
@@ -145,8 +145,8 @@ struct bt_mesh_light_sat_srv {
 	struct bt_mesh_tid_ctx prev_transaction;
 
 #if CONFIG_BT_SETTINGS
-	/** Storage timer */
-	struct k_work_delayable store_timer;
+	/** Pending state storage */
+	struct bt_mesh_model_store store;
 #endif
 	/** Saturation range */
 	struct bt_mesh_light_hsl_range range;
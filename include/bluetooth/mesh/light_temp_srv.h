@@ -133,8 +133,8 @@ struct bt_mesh_light_temp_srv {
 	const struct bt_mesh_light_temp_srv_handlers *handlers;
 
 #if CONFIG_BT_SETTINGS
-	/** Storage timer */
-	struct k_work_delayable store_timer;
+	/** Pending state storage */
+	struct bt_mesh_model_store store;
 #endif
 	/** Default light temperature and delta UV */
 	struct bt_mesh_light_temp dflt;
@@ -163,8 +163,8 @@ struct bt_mesh_light_xyl_srv {
 	struct bt_mesh_tid_ctx prev_transaction;
 
 #if CONFIG_BT_SETTINGS
-	/** Storage timer */
-	struct k_work_delayable store_timer;
+	/** Pending state storage */
+	struct bt_mesh_model_store store;
 #endif
 	/** Current range parameters */
 	struct bt_mesh_light_xy_range range;
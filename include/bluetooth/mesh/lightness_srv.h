@@ -162,8 +162,8 @@ struct bt_mesh_lightness_srv {
 	const struct bt_mesh_lightness_srv_handlers *const handlers;
 
 #if CONFIG_BT_SETTINGS
-	/** Storage timer */
-	struct k_work_delayable store_timer;
+	/** Pending state storage */
+	struct bt_mesh_model_store store;
 #endif
 	/** Current Light Level Range. */
 	struct bt_mesh_lightness_range range;
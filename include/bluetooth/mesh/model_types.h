@@ -49,6 +49,31 @@ struct bt_mesh_tid_ctx {
 	uint8_t tid; /**< Transaction ID. */
 };
 
+/** Pending write of model state to persistent storage.
+ *
+ *  Embedded in the model server contexts, and managed by the model
+ *  implementations. Changes to the model state are collected and written
+ *  together after @kconfig{CONFIG_BT_MESH_MODEL_SRV_STORE_TIMEOUT} seconds.
+ */
+struct bt_mesh_model_store {
+	/* Pending write list node. */
+	sys_snode_t node;
+	/* Writes the model state to persistent storage. */
+	void (*write)(struct bt_mesh_model_store *store);
+	/* Whether the write is pending. */
+	bool pending;
+};
+
+/** Model state storage statistics. */
+struct bt_mesh_model_store_stats {
+	/** Number of model state changes marked for storage. */
+	uint32_t marked;
+	/** Number of model state writes to persistent storage. */
+	uint32_t writes;
+	/** Number of model state writes that failed. */
+	uint32_t failed;
+};
+
 /** Model status values. */
 enum bt_mesh_model_status {
 	/** Command successfully processed. */
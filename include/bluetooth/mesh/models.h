@@ -71,6 +71,28 @@
  */
 bool bt_mesh_model_pub_is_unicast(const struct bt_mesh_model *model);
 
+/** @brief Write all pending model state changes to persistent storage.
+ *
+ * Model servers collect changes to their states, and write them to persistent
+ * storage @kconfig{CONFIG_BT_MESH_MODEL_SRV_STORE_TIMEOUT} seconds after the
+ * first change. Call this function to write the pending changes right away,
+ * for instance when the supply voltage drops below a power-fail warning
+ * threshold.
+ *
+ * Blocks until all pending changes have been written. Must not be called from
+ * an interrupt or from the system workqueue.
+ */
+void bt_mesh_model_store_flush(void);
+
+/** @brief Get the model state storage statistics.
+ *
+ * The difference between the number of marked changes and the number of
+ * writes is the number of flash writes saved by collecting changes.
+ *
+ * @param[out] stats Statistics since boot.
+ */
+void bt_mesh_model_store_stats_get(struct bt_mesh_model_store_stats *stats);
+
 /** Shorthand macro for defining a model list directly in the element. */
 #define BT_MESH_MODEL_LIST(...) ((struct bt_mesh_model[]){ __VA_ARGS__ })
 
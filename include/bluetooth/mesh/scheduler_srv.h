@@ -81,6 +81,14 @@ struct bt_mesh_scheduler_srv {
 		 */
 		struct bt_mesh_schedule_entry
 		sch_reg[BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT];
+#if CONFIG_BT_SETTINGS
+		/* Pending storage of the Schedule Register. */
+		struct bt_mesh_model_store store;
+		/* Bit field indicating changed entries
+		 * in the Schedule Register.
+		 */
+		uint16_t store_bitmap;
+#endif
 	};
 	/** Composition data model pointer. */
 	struct bt_mesh_model *model;
@@ -293,6 +293,37 @@ struct bt_mesh_sensor_column {
 	struct sensor_value end;
 };
 
+/** Sensor series value storage.
+ *
+ *  Holds the latest value of every column of a sensor series, so that the
+ *  sensor server can respond to series messages without calling the series
+ *  getter. The values are updated with @ref bt_mesh_sensor_srv_series_set.
+ */
+struct bt_mesh_sensor_series_store {
+	/** Column values. Holds the number of channels indicated by the sensor
+	 *  type for every column, in the order of the columns.
+	 */
+	struct sensor_value *values;
+
+	/** Bitmap with one bit per column, set once the column has been given
+	 *  a value. Columns without a value are left out of the series
+	 *  responses. Must be defined with @c ATOMIC_DEFINE if @c values is
+	 *  set.
+	 */
+	atomic_t *valid;
+
+	/** Uptime in milliseconds of the latest update of every column, or
+	 *  NULL if the column values never expire.
+	 */
+	int64_t *timestamps;
+
+	/** Number of milliseconds after which a column value expires and is
+	 *  left out of the series responses. Only used together with
+	 *  timestamps.
+	 */
+	uint32_t max_age;
+};
+
 /** Sensor series specification. */
 struct bt_mesh_sensor_series {
 	/** Pointer to the list of columns.
@@ -301,7 +332,8 @@ struct bt_mesh_sensor_series {
 	 *  unique. The list of columns do not have to cover the entire valid
 	 *  range, and values that don't fit in any of the columns should be
 	 *  ignored. If columns overlap, samples must be present in all columns
-	 *  they fall into. The columns may come in any order.
+	 *  they fall into. The columns may come in any order, but columns
+	 *  sorted by their start value are looked up faster.
 	 */
 	const struct bt_mesh_sensor_column *columns;
 
@@ -330,6 +362,12 @@ struct bt_mesh_sensor_series {
 		struct bt_mesh_msg_ctx *ctx,
 		const struct bt_mesh_sensor_column *column,
 		struct sensor_value *value);
+
+	/** Optional series value storage. If the storage holds values, the
+	 *  sensor server responds to series messages with them, and the
+	 *  getter is not called.
+	 */
+	struct bt_mesh_sensor_series_store store;
 };
 
 /** Sensor instance. */
@@ -354,7 +392,8 @@ struct bt_mesh_sensor {
 	 *
 	 *  Only sensors whose type have the @ref
 	 *  BT_MESH_SENSOR_TYPE_FLAG_SERIES flag set, a non-empty list of
-	 *  columns and a defined series getter will accept series messages.
+	 *  columns and a defined series getter or value storage will accept
+	 *  series messages.
 	 */
 	const struct bt_mesh_sensor_series series;
 
@@ -408,6 +447,11 @@ struct bt_mesh_sensor {
 
 		/** Flag indicating whether the sensor cadence state has been configured. */
 		uint8_t configured : 1;
+
+		/** Flag indicating whether the series columns are sorted by
+		 *  their start value.
+		 */
+		uint8_t series_sorted : 1;
 	} state;
 };
 
@@ -439,6 +483,9 @@ bool bt_mesh_sensor_delta_threshold(const struct bt_mesh_sensor *sensor,
  *  @kconfig{CONFIG_BT_MESH_SENSOR_ALL_TYPES} or by referencing them in the
  *  application.
  *
+ *  The sensor types are sorted by ID at link time, and the lookup is a binary
+ *  search.
+ *
  *  @param[in] id A Device Property ID.
  *
  *  @return The associated sensor type, or NULL if the ID is unknown.
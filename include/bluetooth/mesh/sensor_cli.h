@@ -35,6 +35,26 @@ struct bt_mesh_sensor_cli_handlers;
 		.cb = _handlers,                                               \
 	}
 
+/** @def BT_MESH_SENSOR_CLI_BATCH_INIT
+ *
+ *  @brief Initialization parameters for @ref bt_mesh_sensor_cli with a buffer
+ *         for batch decoding of sensor data.
+ *
+ *  Every received Sensor Status message is decoded into the buffer, and passed
+ *  to the bt_mesh_sensor_cli_handlers::data_batch callback.
+ *
+ *  @sa bt_mesh_sensor_cli_handlers
+ *
+ *  @param[in] _handlers Message handler structure.
+ *  @param[in] _batch    Array of @ref bt_mesh_sensor_data to decode sensor
+ *                       data into.
+ *  @param[in] _size     Number of elements in the @c _batch array.
+ */
+#define BT_MESH_SENSOR_CLI_BATCH_INIT(_handlers, _batch, _size)               \
+	{                                                                      \
+		.cb = _handlers, .batch = _batch, .batch_size = _size,         \
+	}
+
 /** @def BT_MESH_MODEL_SENSOR_CLI
  *
  *  @brief Sensor Client model composition data entry.
@@ -69,6 +89,10 @@ struct bt_mesh_sensor_cli {
 	struct bt_mesh_msg_ack_ctx ack_ctx;
 	/** Client callback functions. */
 	const struct bt_mesh_sensor_cli_handlers *cb;
+	/** Buffer for batch decoding of sensor data. */
+	struct bt_mesh_sensor_data *batch;
+	/** Number of elements in the batch buffer. */
+	uint32_t batch_size;
 };
 
 /** Sensor cadence status parameters */
@@ -115,6 +139,7 @@ struct bt_mesh_sensor_info {
 	struct bt_mesh_sensor_descriptor descriptor;
 };
 
+/** Sensor data structure. */
 struct bt_mesh_sensor_data {
 	/** Sensor type. */
 	const struct bt_mesh_sensor_type *type;
@@ -142,6 +167,29 @@ struct bt_mesh_sensor_cli_handlers {
 		     const struct bt_mesh_sensor_type *sensor,
 		     const struct sensor_value *value);
 
+	/** @brief Sensor data batch callback.
+	 *
+	 *  Called once for every received Sensor Status message, with all the
+	 *  known sensor values in the message, if the client has a batch buffer
+	 *  (see @ref BT_MESH_SENSOR_CLI_BATCH_INIT). Allows gateways to process
+	 *  messages from multi-sensor servers without a callback for every
+	 *  sensor. Messages with more sensors than the batch buffer fits are
+	 *  passed in several calls.
+	 *
+	 *  The sensors are also passed to the @c data callback, if present.
+	 *
+	 *  @param[in] cli     Sensor client receiving the message.
+	 *  @param[in] ctx     Message context.
+	 *  @param[in] sensors Array of decoded sensor data, pointing into the
+	 *                     batch buffer of the client. Only valid until the
+	 *                     callback returns.
+	 *  @param[in] count   Number of sensors in the @c sensors array.
+	 */
+	void (*data_batch)(struct bt_mesh_sensor_cli *cli,
+			   struct bt_mesh_msg_ctx *ctx,
+			   const struct bt_mesh_sensor_data *sensors,
+			   uint32_t count);
+
 	/** @brief Sensor description callback.
 	 *
 	 *  Called when the client receives sensor descriptors, either as a
@@ -14,6 +14,7 @@
 #define BT_MESH_SENSOR_SRV_H__
 
 #include <bluetooth/mesh/sensor.h>
+#include <bluetooth/mesh/model_types.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -69,8 +70,8 @@ struct bt_mesh_sensor_srv {
 	uint8_t sensor_count;
 
 #if CONFIG_BT_SETTINGS
-	/** Storage timer */
-	struct k_work_delayable store_timer;
+	/** Pending state storage */
+	struct bt_mesh_model_store store;
 #endif
 	/** Publish parameters. */
 	struct bt_mesh_model_pub pub;
@@ -143,6 +144,29 @@ int bt_mesh_sensor_srv_pub(struct bt_mesh_sensor_srv *srv,
 int bt_mesh_sensor_srv_sample(struct bt_mesh_sensor_srv *srv,
 			      struct bt_mesh_sensor *sensor);
 
+/** @brief Set the value of a column in the sensor series value storage.
+ *
+ *  The column is identified by its start value, like in the Sensor Column Get
+ *  message. The column is marked as valid, and if the storage has timestamps,
+ *  the column timestamp is set to the current uptime.
+ *
+ *  The column is updated with the scheduler locked, so this function must not
+ *  be called from an interrupt.
+ *
+ *  @param[in] sensor       Sensor instance with series value storage.
+ *  @param[in] column_start Start value of the column.
+ *  @param[in] value        Column value, interpreted as an array of sensor
+ *                          channel values matching the sensor channels
+ *                          specified by the sensor type.
+ *
+ *  @retval 0        The column value was stored.
+ *  @retval -ENOTSUP The sensor has no series value storage.
+ *  @retval -ENOENT  No column starts at @c column_start.
+ */
+int bt_mesh_sensor_srv_series_set(struct bt_mesh_sensor *sensor,
+				  const struct sensor_value *column_start,
+				  const struct sensor_value *value);
+
 /** @cond INTERNAL_HIDDEN */
 extern const struct bt_mesh_model_cb _bt_mesh_sensor_srv_cb;
 extern const struct bt_mesh_model_op _bt_mesh_sensor_srv_op[];
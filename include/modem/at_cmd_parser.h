@@ -16,6 +16,7 @@
 
 #include <stdlib.h>
 #include <zephyr/types.h>
+#include <sys/util.h>
 
 #include <modem/at_params.h>
 
@@ -128,6 +129,122 @@ enum at_cmd_type {
  */
 enum at_cmd_type at_parser_cmd_type_get(const char *at_cmd);
 
+/** Parameter types used in an AT response schema. */
+enum at_schema_param_type {
+	/** Decimal integer with an optional sign. */
+	AT_SCHEMA_PARAM_NUM,
+	/** String in double quotes. The slice excludes the quotes. */
+	AT_SCHEMA_PARAM_STRING,
+	/** Array in parentheses. The slice excludes the parentheses. */
+	AT_SCHEMA_PARAM_ARRAY,
+	/** Unquoted text up to the next parameter separator or line end. */
+	AT_SCHEMA_PARAM_RAW,
+};
+
+/**
+ * @brief Expected format of an AT response or notification.
+ *
+ * Define with @ref AT_SCHEMA_DEFINE.
+ */
+struct at_schema {
+	/** Response prefix, for example "+CEREG". */
+	const char *prefix;
+	/** Expected parameter types, see @ref at_schema_param_type. */
+	const uint8_t *types;
+	/** Length of the prefix. */
+	uint8_t prefix_len;
+	/** Number of parameters. */
+	uint8_t param_count;
+};
+
+/** Location of a parameter in the parsed string. */
+struct at_param_slice {
+	/** Offset of the first character from the start of the string. */
+	uint16_t offset;
+	/** Number of characters. */
+	uint16_t len;
+};
+
+/**
+ * @brief Define an AT response schema.
+ *
+ * @param name    Name of the schema variable.
+ * @param _prefix Response prefix string literal, for example "+CEREG".
+ * @param ...     Types of the parameters following the prefix,
+ *                see @ref at_schema_param_type.
+ */
+#define AT_SCHEMA_DEFINE(name, _prefix, ...)					\
+	static const uint8_t _at_schema_types_##name[] = { __VA_ARGS__ };	\
+	static const struct at_schema name = {					\
+		.prefix = _prefix,						\
+		.types = _at_schema_types_##name,				\
+		.prefix_len = sizeof(_prefix) - 1,				\
+		.param_count = ARRAY_SIZE(_at_schema_types_##name),		\
+	}
+
+/**
+ * @brief Parse one line of an AT response or notification using a schema.
+ *
+ * The string is parsed in a single pass without allocating or copying
+ * memory. Instead of values, the location of every parameter in
+ * @p at_params_str is stored in @p slices. Use
+ * @ref at_param_slice_int_get and @ref at_param_slice_string_get to read
+ * the values.
+ *
+ * A parameter that is omitted from the string, or not present because the
+ * line has fewer parameters than the schema, gets offset and length zero.
+ *
+ * @param schema         Schema the line must match.
+ * @param at_params_str  Null-terminated string to parse. Leading line breaks
+ *                       are skipped.
+ * @param slices         Array of at least schema->param_count slices.
+ * @param next_param_str If not NULL, set to the start of the next line.
+ *
+ * @return Number of parameters found in the line, or a negative error code.
+ * @retval -EINVAL  One or more of the supplied parameters are invalid.
+ * @retval -ENOMSG  The string does not start with the schema prefix.
+ * @retval -EBADMSG A parameter does not match its type in the schema.
+ * @retval -E2BIG   The line has more parameters than the schema.
+ * @retval -EMSGSIZE The line is too long to be described by slices.
+ */
+int at_parser_schema_parse(const struct at_schema *schema,
+			   const char *at_params_str,
+			   struct at_param_slice *slices,
+			   const char **next_param_str);
+
+/**
+ * @brief Get the value of an integer parameter slice.
+ *
+ * @param at_params_str String the slice was parsed from.
+ * @param slice         Slice of an @ref AT_SCHEMA_PARAM_NUM parameter.
+ * @param value         Parsed value.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -ENODATA The parameter was omitted.
+ * @retval -EBADMSG The slice does not contain an integer.
+ * @retval -ERANGE  The value does not fit in an int32_t.
+ */
+int at_param_slice_int_get(const char *at_params_str,
+			   const struct at_param_slice *slice,
+			   int32_t *value);
+
+/**
+ * @brief Copy the contents of a parameter slice.
+ *
+ * The string is not null-terminated, similar to at_params_string_get().
+ *
+ * @param at_params_str String the slice was parsed from.
+ * @param slice         Slice to copy.
+ * @param value         Destination buffer.
+ * @param len           In: size of @p value. Out: number of characters copied.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -ENOMEM The buffer is too small.
+ */
+int at_param_slice_string_get(const char *at_params_str,
+			      const struct at_param_slice *slice,
+			      char *value, size_t *len);
+
 /** @} */
 
 #ifdef __cplusplus
@@ -43,6 +43,8 @@ struct at_monitor_entry {
 	const at_monitor_handler_t handler;
 	/** Whether monitor is paused. */
 	bool paused;
+	/** Number of notifications dropped because there was no space to copy them. */
+	uint32_t dropped;
 };
 
 /**
@@ -120,6 +122,18 @@ struct at_monitor_isr_entry {
 #define at_monitor_resume(mon) \
 	at_monitor_##mon.paused = 0
 
+/**
+ * @brief Get the number of notifications dropped by a monitor.
+ *
+ * A notification is dropped when it matches monitor @p mon,
+ * but there is no space left to copy it for dispatching in the workqueue.
+ * Only monitors defined with @ref AT_MONITOR can drop notifications.
+ *
+ * @param mon The monitor.
+ */
+#define at_monitor_dropped_get(mon) \
+	(at_monitor_##mon.dropped)
+
 /** @} */
 
 #ifdef __cplusplus
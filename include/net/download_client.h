@@ -120,6 +120,97 @@ struct download_client_cfg {
 typedef int (*download_client_callback_t)(
 	const struct download_client_evt *event);
 
+/**
+ * @brief State of the incremental HTTP response parser.
+ */
+struct download_client_http_parser {
+	/** Parser state. */
+	uint8_t state;
+	/** Header field whose value is being parsed. */
+	uint8_t field;
+	/** Header fields that match the name parsed so far. */
+	uint8_t candidates;
+	/** Length of the name parsed so far. */
+	uint8_t name_len;
+	/** Length of the value. */
+	uint8_t value_len;
+	/** The value did not fit. */
+	bool value_truncated;
+	/** Number of digits of the chunk size. */
+	uint8_t chunk_digits;
+	/** Status line or header field value being parsed. */
+	char value[40];
+	/** HTTP status code. */
+	uint16_t status;
+	/** The body uses chunked transfer encoding. */
+	bool chunked;
+	/** The server closes the connection after the response. */
+	bool connection_close;
+	/** Content-Length was received. */
+	bool has_length;
+	/** Content-Range was received. */
+	bool has_range;
+	/** Value of Content-Length. */
+	size_t content_length;
+	/** Values of Content-Range. */
+	size_t range_first;
+	size_t range_last;
+	size_t range_total;
+	/** Bytes left in the body or in the current chunk. */
+	size_t left;
+};
+
+#if defined(CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE)
+/**
+ * @brief Connection used for pipelined HTTP range requests.
+ */
+struct download_client_http_conn {
+	/** Socket descriptor. */
+	int fd;
+	/** Response buffer. */
+	char *buf;
+	/** Buffer offset. */
+	size_t offset;
+	/** Number of bytes in the buffer that have been parsed. */
+	size_t parsed;
+	/** Parser of the oldest response, the body starts the buffer. */
+	struct download_client_http_parser parser;
+	/** The server closes the connection after the oldest response. */
+	bool connection_close;
+	/** Outstanding range requests, oldest first. */
+	struct {
+		/** Offset of the first byte. */
+		size_t from;
+		/** Number of bytes. */
+		size_t len;
+	} req[CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE_DEPTH];
+	/** Number of outstanding range requests. */
+	uint8_t req_cnt;
+};
+#endif
+
+#if defined(CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW)
+/**
+ * @brief Outstanding CoAP block request.
+ */
+struct download_client_coap_slot {
+	/** Retransmission state, the message ID identifies the response. */
+	struct coap_pending pending;
+	/** Offset of the first byte of the block. */
+	size_t from;
+	/** Datagram holding the response, NULL until it is received. */
+	uint8_t *buf;
+	/** Payload of the response, within @c buf. */
+	const uint8_t *payload;
+	/** Payload length. */
+	uint16_t payload_len;
+	/** More blocks follow this one. */
+	bool more;
+	/** A request has been sent for this slot. */
+	bool in_use;
+};
+#endif
+
 /**
  * @brief Download client instance.
  */
@@ -157,16 +248,47 @@ struct download_client {
 		bool has_header;
 		/** The server has closed the connection. */
 		bool connection_close;
+		/** Response parser. */
+		struct download_client_http_parser parser;
+#if defined(CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE)
+		/** Connections for pipelined range requests.
+		 *  The first one uses the socket and buffer of the client.
+		 */
+		struct download_client_http_conn conn[CONFIG_DOWNLOAD_CLIENT_HTTP_CONNECTIONS];
+		/** Offset of the next byte to request. */
+		size_t next;
+		/** Request buffer, as response buffers are in use while pipelining. */
+		char req_buf[CONFIG_DOWNLOAD_CLIENT_MAX_HOSTNAME_SIZE +
+			     CONFIG_DOWNLOAD_CLIENT_MAX_FILENAME_SIZE + 96];
+#endif
 	} http;
 
+#if CONFIG_DOWNLOAD_CLIENT_HTTP_CONNECTIONS > 1
+	/** Response buffers of the additional HTTP connections. */
+	char http_conn_buf[CONFIG_DOWNLOAD_CLIENT_HTTP_CONNECTIONS - 1]
+			  [CONFIG_DOWNLOAD_CLIENT_BUF_SIZE];
+#endif
+
 	struct {
 		/** CoAP block context. */
 		struct coap_block_context block_ctx;
 
 		/** CoAP pending object. */
 		struct coap_pending pending;
+#if defined(CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW)
+		/** Outstanding block requests. */
+		struct download_client_coap_slot slot[CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW_SIZE];
+		/** Offset of the next block to request. */
+		size_t next;
+#endif
 	} coap;
 
+#if defined(CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW)
+	/** Datagram buffers for the blocks received out of order. */
+	uint8_t coap_win_buf[CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW_SIZE - 1]
+			    [CONFIG_DOWNLOAD_CLIENT_BUF_SIZE];
+#endif
+
 	/** Internal thread ID. */
 	k_tid_t tid;
 	/** Internal download thread. */
@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <zephyr.h>
+#include <zephyr/types.h>
+
+#include <modem/at_cmd_parser.h>
+#include "at_utils.h"
+
+static inline bool is_line_end(char chr)
+{
+	return is_lfcr(chr) || is_terminated(chr);
+}
+
+static inline const char *skip_spaces(const char *str)
+{
+	while (*str == ' ') {
+		str++;
+	}
+
+	return str;
+}
+
+/* Scan one parameter of the given type. On success, returns a pointer to the
+ * first character after the parameter and sets the content start and end.
+ */
+static const char *scan_param(const char *str, enum at_schema_param_type type,
+			      const char **start, const char **end)
+{
+	switch (type) {
+	case AT_SCHEMA_PARAM_NUM:
+		*start = str;
+
+		if (*str == '-' || *str == '+') {
+			str++;
+		}
+
+		if (!isdigit((int)*str)) {
+			return NULL;
+		}
+
+		while (isdigit((int)*str)) {
+			str++;
+		}
+
+		*end = str;
+		return str;
+	case AT_SCHEMA_PARAM_STRING:
+		if (!is_dblquote(*str)) {
+			return NULL;
+		}
+
+		*start = ++str;
+
+		while (!is_dblquote(*str)) {
+			if (is_terminated(*str)) {
+				return NULL;
+			}
+			str++;
+		}
+
+		*end = str;
+		return str + 1;
+	case AT_SCHEMA_PARAM_ARRAY:
+		if (!is_array_start(*str)) {
+			return NULL;
+		}
+
+		*start = ++str;
+
+		while (!is_array_stop(*str)) {
+			if (is_terminated(*str)) {
+				return NULL;
+			}
+			str++;
+		}
+
+		*end = str;
+		return str + 1;
+	case AT_SCHEMA_PARAM_RAW:
+		*start = str;
+
+		while (*str != AT_PARAM_SEPARATOR && !is_line_end(*str)) {
+			str++;
+		}
+
+		*end = str;
+		return str;
+	default:
+		return NULL;
+	}
+}
+
+int at_parser_schema_parse(const struct at_schema *schema,
+			   const char *at_params_str,
+			   struct at_param_slice *slices,
+			   const char **next_param_str)
+{
+	const char *str = at_params_str;
+	const char *start;
+	const char *end;
+	size_t index = 0;
+
+	if (schema == NULL || at_params_str == NULL || slices == NULL) {
+		return -EINVAL;
+	}
+
+	memset(slices, 0, schema->param_count * sizeof(*slices));
+
+	while (is_lfcr(*str)) {
+		str++;
+	}
+
+	if (strncmp(str, schema->prefix, schema->prefix_len) != 0) {
+		return -ENOMSG;
+	}
+
+	str += schema->prefix_len;
+
+	if (*str != AT_RSP_SEPARATOR) {
+		return -ENOMSG;
+	}
+
+	str = skip_spaces(str + 1);
+
+	if (!is_line_end(*str)) {
+		while (true) {
+			if (index == schema->param_count) {
+				return -E2BIG;
+			}
+
+			str = skip_spaces(str);
+
+			/* An omitted parameter keeps an empty slice */
+			if (*str != AT_PARAM_SEPARATOR && !is_line_end(*str)) {
+				str = scan_param(str, schema->types[index], &start, &end);
+				if (str == NULL) {
+					return -EBADMSG;
+				}
+
+				if ((end - at_params_str) > UINT16_MAX) {
+					return -EMSGSIZE;
+				}
+
+				slices[index].offset = start - at_params_str;
+				slices[index].len = end - start;
+
+				str = skip_spaces(str);
+			}
+
+			index++;
+
+			if (is_line_end(*str)) {
+				break;
+			}
+
+			if (*str != AT_PARAM_SEPARATOR) {
+				return -EBADMSG;
+			}
+
+			str++;
+		}
+	}
+
+	if (next_param_str) {
+		while (is_lfcr(*str)) {
+			str++;
+		}
+
+		*next_param_str = str;
+	}
+
+	return index;
+}
+
+int at_param_slice_int_get(const char *at_params_str,
+			   const struct at_param_slice *slice,
+			   int32_t *value)
+{
+	const char *str;
+	const char *end;
+	bool negative = false;
+	int64_t result = 0;
+
+	if (at_params_str == NULL || slice == NULL || value == NULL) {
+		return -EINVAL;
+	}
+
+	if (slice->len == 0) {
+		return -ENODATA;
+	}
+
+	str = at_params_str + slice->offset;
+	end = str + slice->len;
+
+	if (*str == '-' || *str == '+') {
+		negative = (*str == '-');
+		str++;
+	}
+
+	if (str == end) {
+		return -EBADMSG;
+	}
+
+	for (; str < end; str++) {
+		if (!isdigit((int)*str)) {
+			return -EBADMSG;
+		}
+
+		result = result * 10 + (*str - '0');
+
+		if (result > (int64_t)INT32_MAX + 1) {
+			return -ERANGE;
+		}
+	}
+
+	if (negative) {
+		result = -result;
+	}
+
+	if (result > INT32_MAX) {
+		return -ERANGE;
+	}
+
+	*value = (int32_t)result;
+
+	return 0;
+}
+
+int at_param_slice_string_get(const char *at_params_str,
+			      const struct at_param_slice *slice,
+			      char *value, size_t *len)
+{
+	if (at_params_str == NULL || slice == NULL || value == NULL ||
+	    len == NULL) {
+		return -EINVAL;
+	}
+
+	if (*len < slice->len) {
+		return -ENOMEM;
+	}
+
+	memcpy(value, at_params_str + slice->offset, slice->len);
+	*len = slice->len;
+
+	return 0;
+}
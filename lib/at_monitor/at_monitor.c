@@ -15,79 +15,391 @@
 
 LOG_MODULE_REGISTER(at_monitor, CONFIG_AT_MONITOR_LOG_LEVEL);
 
-struct at_notif_fifo {
-	void *fifo_reserved;
+extern struct at_monitor_entry _at_monitor_entry_list_start[];
+extern struct at_monitor_entry _at_monitor_entry_list_end[];
+extern struct at_monitor_isr_entry _at_monitor_isr_entry_list_start[];
+extern struct at_monitor_isr_entry _at_monitor_isr_entry_list_end[];
+
+/* Notification copied for dispatching in the workqueue */
+struct at_notif_rec {
+	/* Size of the record, including padding, or REC_WRAP */
+	uint32_t size;
 	char data[];
 };
 
+/* Marks the end of the used part of the ring, the next record is at the start */
+#define REC_WRAP UINT32_MAX
+#define RING_SIZE ROUND_DOWN(CONFIG_AT_MONITOR_HEAP_SIZE, sizeof(uint32_t))
+
 static void at_monitor_task(struct k_work *work);
 
-static K_FIFO_DEFINE(at_monitor_fifo);
-static K_HEAP_DEFINE(at_monitor_heap, CONFIG_AT_MONITOR_HEAP_SIZE);
 static K_WORK_DEFINE(at_monitor_work, at_monitor_task);
 
-/* This is not static so that tests can call this function */
-void at_monitor_dispatch(const char *notif)
+/* Records are allocated in the ISR and freed in the workqueue in the same order.
+ * Handlers read the notification directly from the ring, so the notification
+ * is copied only once and there is no heap allocation.
+ */
+static struct {
+	uint8_t buf[RING_SIZE] __aligned(sizeof(uint32_t));
+	size_t head;
+	size_t tail;
+	/* Bytes in use, including wrap padding */
+	size_t used;
+	/* Number of records that are ready to be dispatched */
+	size_t committed;
+	struct k_spinlock lock;
+} ring;
+
+static struct at_notif_rec *ring_alloc(size_t size)
 {
-	bool monitored;
-	struct at_notif_fifo *at_notif;
-	size_t sz_needed;
+	struct at_notif_rec *rec = NULL;
+	k_spinlock_key_t key = k_spin_lock(&ring.lock);
 
-	__ASSERT_NO_MSG(notif != NULL);
+	if (ring.used == 0) {
+		ring.head = 0;
+		ring.tail = 0;
+	}
+
+	if (ring.head >= ring.tail && ring.used < RING_SIZE) {
+		if (RING_SIZE - ring.head >= size) {
+			rec = (struct at_notif_rec *)&ring.buf[ring.head];
+		} else if (ring.tail >= size) {
+			((struct at_notif_rec *)&ring.buf[ring.head])->size = REC_WRAP;
+			ring.used += RING_SIZE - ring.head;
+			ring.head = 0;
+			rec = (struct at_notif_rec *)&ring.buf[0];
+		}
+	} else if (ring.head < ring.tail && ring.tail - ring.head >= size) {
+		rec = (struct at_notif_rec *)&ring.buf[ring.head];
+	}
+
+	if (rec) {
+		rec->size = size;
+		ring.head = (ring.head + size) % RING_SIZE;
+		ring.used += size;
+	}
+
+	k_spin_unlock(&ring.lock, key);
+
+	return rec;
+}
+
+static void ring_commit(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&ring.lock);
+
+	ring.committed++;
+
+	k_spin_unlock(&ring.lock, key);
+}
+
+static struct at_notif_rec *ring_peek(void)
+{
+	struct at_notif_rec *rec = NULL;
+	k_spinlock_key_t key = k_spin_lock(&ring.lock);
+
+	if (ring.committed) {
+		rec = (struct at_notif_rec *)&ring.buf[ring.tail];
+		if (rec->size == REC_WRAP) {
+			ring.used -= RING_SIZE - ring.tail;
+			ring.tail = 0;
+			rec = (struct at_notif_rec *)&ring.buf[0];
+		}
+	}
+
+	k_spin_unlock(&ring.lock, key);
+
+	return rec;
+}
+
+static void ring_free(struct at_notif_rec *rec)
+{
+	k_spinlock_key_t key = k_spin_lock(&ring.lock);
+
+	ring.tail = (ring.tail + rec->size) % RING_SIZE;
+	ring.used -= rec->size;
+	ring.committed--;
+
+	k_spin_unlock(&ring.lock, key);
+}
+
+static bool is_prefix_filter(const char *filter)
+{
+	return filter != ANY && (filter[0] == '+' || filter[0] == '%') &&
+	       strlen(filter) <= UINT8_MAX;
+}
+
+#if defined(CONFIG_AT_MONITOR_INDEX)
+
+#define INDEX_SLOTS (2 * CONFIG_AT_MONITOR_INDEX_SIZE)
+#define INDEX_WORDS DIV_ROUND_UP(CONFIG_AT_MONITOR_INDEX_SIZE, 32)
+#define SLOT_EMPTY UINT8_MAX
+
+/* Index of the monitors in one section, built at boot.
+ * Prefix filters are stored in a hash table, keyed by the hash of the filter.
+ * A notification is looked up once for every distinct filter length.
+ */
+struct at_monitor_index {
+	/* Monitors whose filter is matched by scanning the whole notification */
+	uint32_t scan[INDEX_WORDS];
+	/* Hash table with linear probing */
+	uint32_t hash[INDEX_SLOTS];
+	uint8_t mon[INDEX_SLOTS];
+	uint8_t len[INDEX_SLOTS];
+	/* Distinct prefix filter lengths, in ascending order */
+	uint8_t lens[CONFIG_AT_MONITOR_INDEX_SIZE];
+	uint8_t lens_cnt;
+	bool ready;
+};
+
+#define HASH_INIT 2166136261u
+
+/* FNV-1a, which can be extended one character at a time */
+static inline uint32_t hash_step(uint32_t hash, char c)
+{
+	return (hash ^ (uint8_t)c) * 16777619u;
+}
+
+/* The filters of a section are accessed as a strided array, as the
+ * two entry types have a different size.
+ */
+static inline const char *filter_get(const char *const *filters, size_t stride, size_t i)
+{
+	return *(const char *const *)((const uint8_t *)filters + i * stride);
+}
+
+static void index_build(struct at_monitor_index *idx, const char *const *filters,
+			size_t stride, size_t count)
+{
+	if (count > CONFIG_AT_MONITOR_INDEX_SIZE) {
+		LOG_WRN("%d monitors, index size is %d", (int)count, CONFIG_AT_MONITOR_INDEX_SIZE);
+		return;
+	}
+
+	memset(idx, 0, sizeof(*idx));
+	memset(idx->mon, SLOT_EMPTY, sizeof(idx->mon));
+
+	for (size_t i = 0; i < count; i++) {
+		const char *filter = filter_get(filters, stride, i);
+		uint32_t hash = HASH_INIT;
+		uint8_t len;
+		size_t slot;
+		size_t j;
+
+		if (!is_prefix_filter(filter)) {
+			idx->scan[i / 32] |= BIT(i % 32);
+			continue;
+		}
+
+		len = strlen(filter);
+		for (j = 0; j < len; j++) {
+			hash = hash_step(hash, filter[j]);
+		}
+
+		slot = hash % INDEX_SLOTS;
+		while (idx->mon[slot] != SLOT_EMPTY) {
+			slot = (slot + 1) % INDEX_SLOTS;
+		}
+
+		idx->hash[slot] = hash;
+		idx->mon[slot] = i;
+		idx->len[slot] = len;
+
+		/* Insert the length in order, unless already there */
+		for (j = 0; j < idx->lens_cnt && idx->lens[j] < len; j++) {
+		}
+
+		if (j == idx->lens_cnt || idx->lens[j] != len) {
+			memmove(&idx->lens[j + 1], &idx->lens[j], idx->lens_cnt - j);
+			idx->lens[j] = len;
+			idx->lens_cnt++;
+		}
+	}
+
+	idx->ready = true;
+}
+
+/* Find the monitors whose prefix filter matches the notification, and add
+ * the monitors that have to be matched by scanning.
+ */
+static void index_lookup(const struct at_monitor_index *idx, const char *const *filters,
+			 size_t stride, const char *notif, uint32_t *match)
+{
+	uint32_t hash = HASH_INIT;
+	size_t pos = 0;
+
+	if (!idx->ready) {
+		return;
+	}
+
+	memcpy(match, idx->scan, sizeof(idx->scan));
+
+	for (size_t i = 0; i < idx->lens_cnt; i++) {
+		uint8_t len = idx->lens[i];
+
+		for (; pos < len && notif[pos] != '\0'; pos++) {
+			hash = hash_step(hash, notif[pos]);
+		}
+
+		if (pos < len) {
+			/* Notification is shorter than the remaining filters */
+			break;
+		}
+
+		for (size_t slot = hash % INDEX_SLOTS; idx->mon[slot] != SLOT_EMPTY;
+		     slot = (slot + 1) % INDEX_SLOTS) {
+			uint8_t mon = idx->mon[slot];
+
+			if (idx->hash[slot] == hash && idx->len[slot] == len &&
+			    memcmp(filter_get(filters, stride, mon), notif, len) == 0) {
+				match[mon / 32] |= BIT(mon % 32);
+			}
+		}
+	}
+}
+
+#else
+
+#define INDEX_WORDS 1
+
+struct at_monitor_index {
+	bool ready;
+};
+
+static inline void index_lookup(const struct at_monitor_index *idx, const char *const *filters,
+				size_t stride, const char *notif, uint32_t *match)
+{
+}
+
+#endif /* CONFIG_AT_MONITOR_INDEX */
+
+static struct at_monitor_index index_deferred;
+static struct at_monitor_index index_isr;
+
+/* Whether monitor number i of a section matches, given the result of index_lookup() */
+static bool is_match(const struct at_monitor_index *idx, const uint32_t *match, size_t i,
+		     const char *filter, const char *notif)
+{
+	if (idx->ready) {
+		if (!(match[i / 32] & BIT(i % 32))) {
+			return false;
+		}
+
+		if (is_prefix_filter(filter)) {
+			return true;
+		}
+	}
+
+	return filter == ANY || strstr(notif, filter);
+}
+
+#define ISR_FILTERS &_at_monitor_isr_entry_list_start[0].filter, sizeof(struct at_monitor_isr_entry)
+#define DEFERRED_FILTERS &_at_monitor_entry_list_start[0].filter, sizeof(struct at_monitor_entry)
+
+static void dispatch_isr(const char *notif)
+{
+	uint32_t match[INDEX_WORDS];
+
+	index_lookup(&index_isr, ISR_FILTERS, notif, match);
 
-	/* Dispatch to monitors in ISR, if any.
-	 * There might be non-ISR monitors that are interested
-	 * in the same notification, so copy it to the heap afterwards regardless.
-	 */
 	STRUCT_SECTION_FOREACH(at_monitor_isr_entry, e) {
-		if (!e->paused && (e->filter == ANY || strstr(notif, e->filter))) {
+		if (!e->paused && is_match(&index_isr, match, e - _at_monitor_isr_entry_list_start,
+					   e->filter, notif)) {
 			LOG_DBG("Dispatching to %p (ISR)", e->handler);
 			e->handler(notif);
 		}
 	}
+}
+
+static void dispatch_deferred(const char *notif)
+{
+	uint32_t match[INDEX_WORDS];
+
+	index_lookup(&index_deferred, DEFERRED_FILTERS, notif, match);
 
-	monitored = false;
 	STRUCT_SECTION_FOREACH(at_monitor_entry, e) {
-		if (!e->paused && (e->filter == ANY || strstr(notif, e->filter))) {
-			monitored = true;
-			break;
+		if (!e->paused && is_match(&index_deferred, match, e - _at_monitor_entry_list_start,
+					   e->filter, notif)) {
+			LOG_DBG("Dispatching to %p", e->handler);
+			e->handler(notif);
 		}
 	}
+}
+
+/* Count a dropped notification for every monitor that would have received it */
+static void drop_deferred(const char *notif)
+{
+	uint32_t match[INDEX_WORDS];
+
+	index_lookup(&index_deferred, DEFERRED_FILTERS, notif, match);
 
-	if (!monitored) {
+	STRUCT_SECTION_FOREACH(at_monitor_entry, e) {
+		if (!e->paused && is_match(&index_deferred, match, e - _at_monitor_entry_list_start,
+					   e->filter, notif)) {
+			e->dropped++;
+		}
+	}
+}
+
+static bool is_monitored_deferred(const char *notif)
+{
+	uint32_t match[INDEX_WORDS];
+
+	index_lookup(&index_deferred, DEFERRED_FILTERS, notif, match);
+
+	STRUCT_SECTION_FOREACH(at_monitor_entry, e) {
+		if (!e->paused && is_match(&index_deferred, match, e - _at_monitor_entry_list_start,
+					   e->filter, notif)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* This is not static so that tests can call this function */
+void at_monitor_dispatch(const char *notif)
+{
+	struct at_notif_rec *rec;
+	size_t len;
+
+	__ASSERT_NO_MSG(notif != NULL);
+
+	/* Dispatch to monitors in ISR, if any.
+	 * There might be non-ISR monitors that are interested
+	 * in the same notification, so copy it afterwards regardless.
+	 */
+	dispatch_isr(notif);
+
+	if (!is_monitored_deferred(notif)) {
 		return;
 	}
 
-	sz_needed = sizeof(struct at_notif_fifo) + strlen(notif) + sizeof(char);
+	len = strlen(notif) + sizeof(char);
 
-	at_notif = k_heap_alloc(&at_monitor_heap, sz_needed, K_NO_WAIT);
-	if (!at_notif) {
-		LOG_WRN("No heap space for incoming notification: %s",
+	rec = ring_alloc(ROUND_UP(sizeof(struct at_notif_rec) + len, sizeof(uint32_t)));
+	if (!rec) {
+		LOG_WRN("No space for incoming notification: %s",
 			log_strdup(notif));
+		drop_deferred(notif);
 		return;
 	}
 
-	strcpy(at_notif->data, notif);
+	memcpy(rec->data, notif, len);
+	ring_commit();
 
-	k_fifo_put(&at_monitor_fifo, at_notif);
 	k_work_submit(&at_monitor_work);
 }
 
 static void at_monitor_task(struct k_work *work)
 {
-	struct at_notif_fifo *at_notif;
+	struct at_notif_rec *rec;
 
-	while ((at_notif = k_fifo_get(&at_monitor_fifo, K_NO_WAIT))) {
+	while ((rec = ring_peek())) {
 		/* Match notification with all monitors */
-		LOG_DBG("AT notif: %s", log_strdup(at_notif->data));
-		STRUCT_SECTION_FOREACH(at_monitor_entry, e) {
-			if (!e->paused &&
-			   (e->filter == ANY || strstr(at_notif->data, e->filter))) {
-				LOG_DBG("Dispatching to %p", e->handler);
-				e->handler(at_notif->data);
-			}
-		}
-		k_heap_free(&at_monitor_heap, at_notif);
+		LOG_DBG("AT notif: %s", log_strdup(rec->data));
+		dispatch_deferred(rec->data);
+		ring_free(rec);
 	}
 }
 
@@ -95,6 +407,13 @@ static int at_monitor_sys_init(const struct device *unused)
 {
 	int err;
 
+#if defined(CONFIG_AT_MONITOR_INDEX)
+	index_build(&index_deferred, DEFERRED_FILTERS,
+		    _at_monitor_entry_list_end - _at_monitor_entry_list_start);
+	index_build(&index_isr, ISR_FILTERS,
+		    _at_monitor_isr_entry_list_end - _at_monitor_isr_entry_list_start);
+#endif
+
 	err = nrf_modem_at_notif_handler_set(at_monitor_dispatch);
 	if (err) {
 		LOG_ERR("Failed to hook the dispatch function, err %d", err);
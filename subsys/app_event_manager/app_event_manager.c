@@ -5,6 +5,8 @@
  */
 
 #include <stdio.h>
+#include <string.h>
+#include <errno.h>
 #include <zephyr.h>
 #include <spinlock.h>
 #include <sys/slist.h>
@@ -19,10 +21,20 @@ static void event_processor_fn(struct k_work *work);
 
 struct app_event_manager_event_display_bm _app_event_manager_event_display_bm;
 
+#define EVENT_QUEUE_CNT (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_PRIO) ? \
+			 APP_EVENT_PRIO_COUNT : 1)
+
 static K_WORK_DEFINE(event_processor, event_processor_fn);
-static sys_slist_t eventq = SYS_SLIST_STATIC_INIT(&eventq);
+/* Zero-initialized lists are empty. */
+static sys_slist_t eventq[EVENT_QUEUE_CNT];
 static struct k_spinlock lock;
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_WORKQUEUE)
+static K_THREAD_STACK_DEFINE(event_processor_stack,
+			     CONFIG_APP_EVENT_MANAGER_WORKQUEUE_STACK_SIZE);
+static struct k_work_q event_processor_wq;
+#endif
+
 static bool log_is_event_displayed(const struct event_type *et)
 {
 	size_t idx = et - _event_type_list_start;
@@ -134,81 +146,323 @@ void * __weak app_event_manager_alloc(size_t size)
 
 void __weak app_event_manager_free(void *addr)
 {
+	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_SLAB) &&
+	    app_event_manager_slab_free(addr)) {
+		return;
+	}
+
 	k_free(addr);
 }
 
-static void event_processor_fn(struct k_work *work)
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_SLAB)
+static bool slab_owns(const struct k_mem_slab *slab, const void *addr)
 {
-	sys_slist_t events = SYS_SLIST_STATIC_INIT(&events);
+	const char *start = slab->buffer;
+	const char *end = start + slab->num_blocks * slab->block_size;
 
-	/* Make current event list local. */
-	k_spinlock_key_t key = k_spin_lock(&lock);
+	return ((const char *)addr >= start) && ((const char *)addr < end);
+}
+
+void *_app_event_manager_slab_alloc(const struct event_type *et, size_t size)
+{
+	APP_EVENT_ASSERT_ID(et);
+
+	struct app_event_slab *es = et->slab;
+	void *event;
+
+	if ((size <= es->slab->block_size) &&
+	    !k_mem_slab_alloc(es->slab, &event, K_NO_WAIT)) {
+		atomic_val_t used = atomic_inc(&es->used_cnt) + 1;
+		atomic_val_t max_used = atomic_get(&es->max_used_cnt);
+
+		while ((used > max_used) &&
+		       !atomic_cas(&es->max_used_cnt, max_used, used)) {
+			max_used = atomic_get(&es->max_used_cnt);
+		}
+
+		return event;
+	}
+
+	atomic_inc(&es->fallback_cnt);
+
+	return app_event_manager_alloc(size);
+}
+
+bool app_event_manager_slab_free(void *addr)
+{
+	const struct app_event_header *aeh = addr;
+
+	APP_EVENT_ASSERT_ID(aeh->type_id);
+
+	struct app_event_slab *es = aeh->type_id->slab;
+
+	if (!slab_owns(es->slab, addr)) {
+		return false;
+	}
+
+	k_mem_slab_free(es->slab, &addr);
+	atomic_dec(&es->used_cnt);
+
+	return true;
+}
+
+void app_event_manager_slab_stats_get(const struct event_type *et,
+				      struct app_event_manager_slab_stats *stats)
+{
+	APP_EVENT_ASSERT_ID(et);
+	__ASSERT_NO_MSG(stats);
+
+	const struct app_event_slab *es = et->slab;
+
+	stats->block_size = es->slab->block_size;
+	stats->block_cnt = es->slab->num_blocks;
+	stats->used_cnt = atomic_get(&es->used_cnt);
+	stats->max_used_cnt = atomic_get(&es->max_used_cnt);
+	stats->fallback_cnt = atomic_get(&es->fallback_cnt);
+}
+#endif /* CONFIG_APP_EVENT_MANAGER_EVENT_SLAB */
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LISTENER_STATS)
+BUILD_ASSERT(CONFIG_APP_EVENT_MANAGER_LISTENER_STATS_FIRST_BUCKET_LOG2 +
+	     CONFIG_APP_EVENT_MANAGER_LISTENER_STATS_BUCKET_CNT - 2 < 32,
+	     "Histogram bucket limit does not fit in 32 bits");
+
+extern const struct event_subscriber __start_event_subscribers_all[];
+extern const struct event_subscriber __stop_event_subscribers_all[];
 
-	if (sys_slist_is_empty(&eventq)) {
+static size_t stats_bucket_idx(uint32_t cycles)
+{
+	size_t idx = 0;
+
+	if (cycles >= BIT(CONFIG_APP_EVENT_MANAGER_LISTENER_STATS_FIRST_BUCKET_LOG2)) {
+		idx = (32 - __builtin_clz(cycles)) -
+		      CONFIG_APP_EVENT_MANAGER_LISTENER_STATS_FIRST_BUCKET_LOG2;
+	}
+
+	return MIN(idx, CONFIG_APP_EVENT_MANAGER_LISTENER_STATS_BUCKET_CNT - 1);
+}
+
+static void listener_stats_update(struct event_subscriber_stats *stats, uint32_t cycles)
+{
+	stats->call_cnt++;
+	stats->total_cycles += cycles;
+	stats->max_cycles = MAX(stats->max_cycles, cycles);
+	stats->hist[stats_bucket_idx(cycles)]++;
+}
+
+int app_event_manager_listener_stats_get(const struct event_type *et,
+					 const struct event_listener *el,
+					 struct event_subscriber_stats *stats)
+{
+	APP_EVENT_ASSERT_ID(et);
+	__ASSERT_NO_MSG(el);
+	__ASSERT_NO_MSG(stats);
+
+	for (const struct event_subscriber *es = et->subs_start;
+	     es != et->subs_stop;
+	     es++) {
+		if (es->listener == el) {
+			k_spinlock_key_t key = k_spin_lock(&lock);
+
+			*stats = *es->stats;
+			k_spin_unlock(&lock, key);
+
+			return 0;
+		}
+	}
+
+	return -ENOENT;
+}
+
+void app_event_manager_listener_stats_reset(void)
+{
+	for (const struct event_subscriber *es = __start_event_subscribers_all;
+	     es != __stop_event_subscribers_all;
+	     es++) {
+		k_spinlock_key_t key = k_spin_lock(&lock);
+
+		memset(es->stats, 0, sizeof(*es->stats));
 		k_spin_unlock(&lock, key);
-		return;
 	}
+}
+#endif /* CONFIG_APP_EVENT_MANAGER_LISTENER_STATS */
 
-	sys_slist_merge_slist(&events, &eventq);
+static void listener_dispatch_done(const struct app_event_header *aeh,
+				   const struct event_subscriber *es,
+				   uint32_t cycles)
+{
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LISTENER_STATS)
+	k_spinlock_key_t key = k_spin_lock(&lock);
 
+	listener_stats_update(es->stats, cycles);
 	k_spin_unlock(&lock, key);
+#endif
 
-	/* Traverse the list of events. */
-	sys_snode_t *node;
-	while (NULL != (node = sys_slist_get(&events))) {
-		struct app_event_header *aeh = CONTAINER_OF(node,
-						       struct app_event_header,
-						       node);
+	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_DISPATCH_HOOKS)) {
+		STRUCT_SECTION_FOREACH(event_dispatch_hook, h) {
+			h->hook(aeh, es->listener, cycles);
+		}
+	}
+}
 
-		APP_EVENT_ASSERT_ID(aeh->type_id);
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_REFCNT)
+void app_event_manager_event_ref(const struct app_event_header *aeh)
+{
+	APP_EVENT_ASSERT_ID(aeh->type_id);
 
-		const struct event_type *et = aeh->type_id;
+	/* The reference counter is not a part of the event data. */
+	atomic_val_t prev = atomic_inc((atomic_t *)&aeh->ref_cnt);
 
-		if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PREPROCESS_HOOKS)) {
-			STRUCT_SECTION_FOREACH(event_preprocess_hook, h) {
-				h->hook(aeh);
-			}
+	__ASSERT(prev > 0, "Event must be submitted before taking a reference");
+	ARG_UNUSED(prev);
+}
+
+void app_event_manager_event_unref(const struct app_event_header *aeh)
+{
+	APP_EVENT_ASSERT_ID(aeh->type_id);
+
+	atomic_val_t prev = atomic_dec((atomic_t *)&aeh->ref_cnt);
+
+	__ASSERT(prev > 0, "Event reference counter underflow");
+
+	if (prev == 1) {
+		app_event_manager_free((void *)aeh);
+	}
+}
+#endif /* CONFIG_APP_EVENT_MANAGER_EVENT_REFCNT */
+
+static void event_process(struct app_event_header *aeh)
+{
+	APP_EVENT_ASSERT_ID(aeh->type_id);
+
+	const struct event_type *et = aeh->type_id;
+
+	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PREPROCESS_HOOKS)) {
+		STRUCT_SECTION_FOREACH(event_preprocess_hook, h) {
+			h->hook(aeh);
 		}
+	}
+
+	log_event(aeh);
 
-		log_event(aeh);
+	bool consumed = false;
 
-		bool consumed = false;
+	for (const struct event_subscriber *es = et->subs_start;
+	     (es != et->subs_stop) && !consumed;
+	     es++) {
 
-		for (const struct event_subscriber *es = et->subs_start;
-		     (es != et->subs_stop) && !consumed;
-		     es++) {
+		__ASSERT_NO_MSG(es != NULL);
 
-			__ASSERT_NO_MSG(es != NULL);
+		const struct event_listener *el = es->listener;
 
-			const struct event_listener *el = es->listener;
+		__ASSERT_NO_MSG(el != NULL);
+		__ASSERT_NO_MSG(el->notification != NULL);
 
-			__ASSERT_NO_MSG(el != NULL);
-			__ASSERT_NO_MSG(el->notification != NULL);
+		log_event_progress(et, el);
 
-			log_event_progress(et, el);
+		if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LISTENER_STATS) ||
+		    IS_ENABLED(CONFIG_APP_EVENT_MANAGER_DISPATCH_HOOKS)) {
+			uint32_t start = k_cycle_get_32();
 
 			consumed = el->notification(aeh);
+			listener_dispatch_done(aeh, es, k_cycle_get_32() - start);
+		} else {
+			consumed = el->notification(aeh);
+		}
 
-			if (consumed) {
-				log_event_consumed(et);
-			}
+		if (consumed) {
+			log_event_consumed(et);
 		}
+	}
 
-		if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_POSTPROCESS_HOOKS)) {
-			STRUCT_SECTION_FOREACH(event_postprocess_hook, h) {
-				h->hook(aeh);
-			}
+	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_POSTPROCESS_HOOKS)) {
+		STRUCT_SECTION_FOREACH(event_postprocess_hook, h) {
+			h->hook(aeh);
 		}
+	}
 
+	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_REFCNT)) {
+		app_event_manager_event_unref(aeh);
+	} else {
 		app_event_manager_free(aeh);
 	}
 }
 
+static struct app_event_header *event_prio_get(void)
+{
+	sys_snode_t *node = NULL;
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	/* Take the oldest event of the highest non-empty priority class. */
+	for (size_t i = ARRAY_SIZE(eventq); (i > 0) && !node; i--) {
+		node = sys_slist_get(&eventq[i - 1]);
+	}
+
+	k_spin_unlock(&lock, key);
+
+	return (node) ? CONTAINER_OF(node, struct app_event_header, node) : NULL;
+}
+
+static void event_processor_fn(struct k_work *work)
+{
+	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_PRIO)) {
+		struct app_event_header *aeh;
+
+		/* Queues are checked before every event, so that the events of
+		 * a higher priority class submitted in the meantime are not
+		 * delayed by the pending events of a lower priority class.
+		 */
+		while ((aeh = event_prio_get()) != NULL) {
+			event_process(aeh);
+		}
+
+		return;
+	}
+
+	sys_slist_t events = SYS_SLIST_STATIC_INIT(&events);
+
+	/* Make current event list local. */
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	if (sys_slist_is_empty(&eventq[0])) {
+		k_spin_unlock(&lock, key);
+		return;
+	}
+
+	sys_slist_merge_slist(&events, &eventq[0]);
+
+	k_spin_unlock(&lock, key);
+
+	/* Traverse the list of events. */
+	sys_snode_t *node;
+	while (NULL != (node = sys_slist_get(&events))) {
+		struct app_event_header *aeh = CONTAINER_OF(node,
+						       struct app_event_header,
+						       node);
+
+		event_process(aeh);
+	}
+}
+
+static void event_processor_submit(void)
+{
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_WORKQUEUE)
+	k_work_submit_to_queue(&event_processor_wq, &event_processor);
+#else
+	k_work_submit(&event_processor);
+#endif
+}
+
 void _event_submit(struct app_event_header *aeh)
 {
 	__ASSERT_NO_MSG(aeh);
 	APP_EVENT_ASSERT_ID(aeh->type_id);
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_REFCNT)
+	/* Reference held by the Application Event Manager until the event is processed. */
+	atomic_set(&aeh->ref_cnt, 1);
+#endif
+
 	k_spinlock_key_t key = k_spin_lock(&lock);
 
 	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBMIT_HOOKS)) {
@@ -216,10 +470,13 @@ void _event_submit(struct app_event_header *aeh)
 			h->hook(aeh);
 		}
 	}
-	sys_slist_append(&eventq, &aeh->node);
+	size_t queue_idx = IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_PRIO) ?
+			   app_event_get_type_prio(aeh->type_id) : 0;
+
+	sys_slist_append(&eventq[queue_idx], &aeh->node);
 	k_spin_unlock(&lock, key);
 
-	k_work_submit(&event_processor);
+	event_processor_submit();
 }
 
 int app_event_manager_init(void)
@@ -231,6 +488,16 @@ int app_event_manager_init(void)
 
 	log_event_init();
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_WORKQUEUE)
+	k_work_queue_start(&event_processor_wq, event_processor_stack,
+			   K_THREAD_STACK_SIZEOF(event_processor_stack),
+			   CONFIG_APP_EVENT_MANAGER_WORKQUEUE_PRIORITY, NULL);
+	k_thread_name_set(&event_processor_wq.thread, "app_event_manager");
+
+	/* Process events submitted before the workqueue was started. */
+	event_processor_submit();
+#endif
+
 	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_POSTINIT_HOOK)) {
 		STRUCT_SECTION_FOREACH(app_event_manager_postinit_hook, h) {
 			ret = h->hook();
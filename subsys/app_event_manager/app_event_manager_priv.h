@@ -108,12 +108,28 @@ extern "C" {
 	 )
 
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LISTENER_STATS)
+#define _APP_EVENT_SUBSCRIBER_STATS_NAME(lname, ename) \
+	_CONCAT(_CONCAT(__event_subscriber_stats_, ename), lname)
+
+#define _APP_EVENT_SUBSCRIBER_STATS_DEFINE(lname, ename) \
+	static struct event_subscriber_stats _APP_EVENT_SUBSCRIBER_STATS_NAME(lname, ename);
+
+#define _APP_EVENT_SUBSCRIBER_STATS(lname, ename) \
+	.stats = &_APP_EVENT_SUBSCRIBER_STATS_NAME(lname, ename),
+#else
+#define _APP_EVENT_SUBSCRIBER_STATS_DEFINE(lname, ename)
+#define _APP_EVENT_SUBSCRIBER_STATS(lname, ename)
+#endif
+
 /* Subscribe a listener to an event. */
 #define _APP_EVENT_SUBSCRIBE(lname, ename, prio)					\
+	_APP_EVENT_SUBSCRIBER_STATS_DEFINE(lname, ename)				\
 	const struct event_subscriber _CONCAT(_CONCAT(__event_subscriber_, ename), lname)\
 	__used __aligned(__alignof(struct event_subscriber))				\
 	__attribute__((__section__(_APP_EVENT_SUBSCRIBERS_SECTION_NAME(ename, prio)))) = {\
 		.listener = &_CONCAT(__event_listener_, lname),				\
+		_APP_EVENT_SUBSCRIBER_STATS(lname, ename) /* No comma here intentionally */\
 	}
 
 
@@ -121,6 +137,14 @@ extern "C" {
 #define _EVENT_ID(ename) (&_CONCAT(__event_type_, ename))
 
 
+/* Allocate memory for an event of the given ename type. */
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_SLAB)
+#define _APP_EVENT_ALLOC(ename, size) _app_event_manager_slab_alloc(_EVENT_ID(ename), (size))
+#else
+#define _APP_EVENT_ALLOC(ename, size) app_event_manager_alloc(size)
+#endif
+
+
 /* Macro generates a function of name new_ename where ename is provided as
  * an argument. Allocator function is used to create an event of the given
  * ename type.
@@ -129,7 +153,7 @@ extern "C" {
 	static inline struct ename *_CONCAT(new_, ename)(void)			\
 	{									\
 		struct ename *event =						\
-			(struct ename *)app_event_manager_alloc(sizeof(*event));\
+			(struct ename *)_APP_EVENT_ALLOC(ename, sizeof(*event));\
 		BUILD_ASSERT(offsetof(struct ename, header) == 0,		\
 				 "");						\
 		if (event != NULL) {						\
@@ -147,7 +171,7 @@ extern "C" {
 	static inline struct ename *_CONCAT(new_, ename)(size_t size)			\
 	{										\
 		struct ename *event =							\
-			(struct ename *)app_event_manager_alloc(sizeof(*event) + size);	\
+			(struct ename *)_APP_EVENT_ALLOC(ename, sizeof(*event) + size);	\
 		BUILD_ASSERT((offsetof(struct ename, dyndata) +				\
 				  sizeof(event->dyndata.size)) ==			\
 				 sizeof(*event), "");					\
@@ -221,6 +245,54 @@ extern "C" {
 #define _APP_EVENT_TYPE_DEFINE_SIZES(ename)
 #endif
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_SLAB)
+/** @brief Event type memory slab.
+ *
+ * Memory slab used to allocate events of the given type together with
+ * its usage statistics.
+ */
+struct app_event_slab {
+	/** Pointer to the memory slab. */
+	struct k_mem_slab *slab;
+
+	/** Number of blocks currently in use. */
+	atomic_t used_cnt;
+
+	/** Maximum number of blocks that were in use at the same time. */
+	atomic_t max_used_cnt;
+
+	/** Number of allocations that fell back to app_event_manager_alloc. */
+	atomic_t fallback_cnt;
+};
+
+#define _APP_EVENT_SLAB_DEFAULT_BLOCK_CNT CONFIG_APP_EVENT_MANAGER_EVENT_SLAB_BLOCK_CNT
+
+/* Size of the slab block. Events with dynamic data get additional space reserved. */
+#define _APP_EVENT_SLAB_BLOCK_SIZE(ename)					\
+	(sizeof(struct ename) + ((_CONCAT(ename, _HAS_DYNDATA)) ?		\
+		CONFIG_APP_EVENT_MANAGER_EVENT_SLAB_DYNDATA_SIZE : 0))
+
+/* Additional macro level makes sure that the slab name is expanded. */
+#define _APP_EVENT_SLAB_MEM_DEFINE(name, block_size, block_cnt, align) \
+	K_MEM_SLAB_DEFINE(name, ROUND_UP(block_size, align), block_cnt, align)
+
+#define _APP_EVENT_SLAB_DEFINE(ename, block_cnt)					\
+	BUILD_ASSERT((block_cnt) > 0, "Event slab must contain at least one block");	\
+	_APP_EVENT_SLAB_MEM_DEFINE(_CONCAT(__event_slab_mem_, ename),			\
+				   _APP_EVENT_SLAB_BLOCK_SIZE(ename), (block_cnt),	\
+				   __alignof(struct ename));				\
+	static struct app_event_slab _CONCAT(__event_slab_, ename) = {			\
+		.slab = &_CONCAT(__event_slab_mem_, ename),				\
+	}
+
+#define _APP_EVENT_TYPE_DEFINE_SLAB(ename)             \
+	.slab = &_CONCAT(__event_slab_, ename),
+#else
+#define _APP_EVENT_SLAB_DEFAULT_BLOCK_CNT 0
+#define _APP_EVENT_SLAB_DEFINE(ename, block_cnt)
+#define _APP_EVENT_TYPE_DEFINE_SLAB(ename)
+#endif
+
 /** @brief Event header.
  *
  * When defining an event structure, the application event header
@@ -232,6 +304,11 @@ struct app_event_header {
 
 	/** Pointer to the event type object. */
 	const struct event_type *type_id;
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_REFCNT)
+	/** Number of references to the submitted event. */
+	atomic_t ref_cnt;
+#endif
 };
 
 /** Function to log data from this event. */
@@ -294,6 +371,11 @@ struct event_type {
 	/** The size of the event structure */
 	uint16_t struct_size;
 #endif
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_SLAB)
+	/** Memory slab used to allocate events of this type. */
+	struct app_event_slab *slab;
+#endif
 };
 
 
@@ -302,10 +384,19 @@ extern struct event_type _event_type_list_end[];
 
 
 #define _APP_EVENT_TYPE_DEFINE(ename, log_fn, trace_data_pointer, et_flags)		\
+	_APP_EVENT_TYPE_SLAB_DEFINE(ename, log_fn, trace_data_pointer, et_flags,		\
+				    _APP_EVENT_SLAB_DEFAULT_BLOCK_CNT)
+
+#define _APP_EVENT_TYPE_SLAB_DEFINE(ename, log_fn, trace_data_pointer, et_flags, block_cnt)\
 	BUILD_ASSERT(((et_flags) & ((BIT_MASK(APP_EVENT_TYPE_FLAGS_USER_SETTABLE_START-	\
 		APP_EVENT_TYPE_FLAGS_SYSTEM_START))<<					\
 		APP_EVENT_TYPE_FLAGS_SYSTEM_START)) == 0);				\
+	BUILD_ASSERT(((et_flags) & (BIT(APP_EVENT_TYPE_FLAGS_PRIO_HIGH) |		\
+		BIT(APP_EVENT_TYPE_FLAGS_PRIO_LOW))) !=					\
+		(BIT(APP_EVENT_TYPE_FLAGS_PRIO_HIGH) | BIT(APP_EVENT_TYPE_FLAGS_PRIO_LOW)),\
+		"Event type cannot belong to more than one priority class");		\
 	_APP_EVENT_SUBSCRIBERS_ARRAY_TAGS(ename);					\
+	_APP_EVENT_SLAB_DEFINE(ename, block_cnt);					\
 	STRUCT_SECTION_ITERABLE(event_type, _CONCAT(__event_type_, ename)) = {		\
 		.name            = STRINGIFY(ename),					\
 		.subs_start      = _APP_EVENT_SUBSCRIBERS_START_TAG(ename),		\
@@ -317,6 +408,7 @@ extern struct event_type _event_type_list_end[];
 				((et_flags) | BIT(APP_EVENT_TYPE_FLAGS_HAS_DYNDATA)) :	\
 				((et_flags) & (~BIT(APP_EVENT_TYPE_FLAGS_HAS_DYNDATA)))),\
 		_APP_EVENT_TYPE_DEFINE_SIZES(ename) /* No comma here intentionally */	\
+		_APP_EVENT_TYPE_DEFINE_SLAB(ename) /* No comma here intentionally */	\
 	}
 
 /**
@@ -356,6 +448,11 @@ extern struct app_event_manager_event_display_bm _app_event_manager_event_displa
 		     "Enable APP_EVENT_MANAGER_POSTPROCESS_HOOKS before usage"); \
 	_APP_EVENT_HOOK_REGISTER(event_postprocess_hook, hook_fn, prio)
 
+#define _APP_EVENT_HOOK_DISPATCH_REGISTER(hook_fn, prio)                      \
+	BUILD_ASSERT(IS_ENABLED(CONFIG_APP_EVENT_MANAGER_DISPATCH_HOOKS),     \
+		     "Enable APP_EVENT_MANAGER_DISPATCH_HOOKS before usage"); \
+	_APP_EVENT_HOOK_REGISTER(event_dispatch_hook, hook_fn, prio)
+
 /**
  * @brief Joining together event type flags.
  */
@@ -392,11 +489,37 @@ struct event_listener {
 };
 
 
+/** @brief Listener dispatch time statistics.
+ *
+ * Statistics gathered for a listener subscribed to a given event type.
+ */
+struct event_subscriber_stats {
+	/** Number of notifications. */
+	uint32_t call_cnt;
+
+	/** Maximum number of cycles spent in a single notification. */
+	uint32_t max_cycles;
+
+	/** Total number of cycles spent in all notifications. */
+	uint64_t total_cycles;
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LISTENER_STATS)
+	/** Histogram of the number of cycles spent in a single notification. */
+	uint32_t hist[CONFIG_APP_EVENT_MANAGER_LISTENER_STATS_BUCKET_CNT];
+#endif
+};
+
+
 /** @brief Event subscriber.
  */
 struct event_subscriber {
 	/** Pointer to the listener. */
 	const struct event_listener *listener;
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LISTENER_STATS)
+	/** Pointer to the dispatch time statistics. */
+	struct event_subscriber_stats *stats;
+#endif
 };
 
 
@@ -427,6 +550,15 @@ struct event_postprocess_hook {
 	void (*hook)(const struct app_event_header *aeh);
 };
 
+/** @brief Structure used to register event dispatch hook
+ */
+struct event_dispatch_hook {
+	/** @brief Hook function */
+	void (*hook)(const struct app_event_header *aeh,
+		     const struct event_listener *el,
+		     uint32_t cycles);
+};
+
 
 
 /** @brief Submit an event to the Application Event Manager.
@@ -435,6 +567,17 @@ struct event_postprocess_hook {
  */
 void _event_submit(struct app_event_header *aeh);
 
+/** @brief Allocate an event from the memory slab of the given event type.
+ *
+ * If the memory slab is exhausted or the event does not fit in the slab block,
+ * the event is allocated using @ref app_event_manager_alloc.
+ *
+ * @param et    Pointer to the event type.
+ * @param size  Amount of memory requested (in bytes).
+ * @retval Address of the allocated memory if successful, otherwise NULL.
+ */
+void *_app_event_manager_slab_alloc(const struct event_type *et, size_t size);
+
 #ifdef __cplusplus
 }
 #endif
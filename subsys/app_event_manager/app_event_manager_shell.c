@@ -81,6 +81,83 @@ static int show_subscribers(const struct shell *shell, size_t argc,
 	return 0;
 }
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_SLAB)
+static int show_slab_stats(const struct shell *shell, size_t argc,
+		char **argv)
+{
+	shell_fprintf(shell, SHELL_NORMAL, "Event slab statistics:\n");
+
+	STRUCT_SECTION_FOREACH(event_type, et) {
+		struct app_event_manager_slab_stats stats;
+
+		app_event_manager_slab_stats_get(et, &stats);
+
+		shell_fprintf(shell, SHELL_NORMAL,
+			      "|\t[E:%s] block size: %zu, used: %u/%u, max used: %u,"
+			      " fallback: %u\n",
+			      et->name, stats.block_size, stats.used_cnt,
+			      stats.block_cnt, stats.max_used_cnt,
+			      stats.fallback_cnt);
+	}
+
+	return 0;
+}
+#endif /* CONFIG_APP_EVENT_MANAGER_EVENT_SLAB */
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LISTENER_STATS)
+static int show_listener_stats(const struct shell *shell, size_t argc,
+		char **argv)
+{
+	shell_fprintf(shell, SHELL_NORMAL, "Listener dispatch time statistics (cycles):\n");
+
+	STRUCT_SECTION_FOREACH(event_type, et) {
+		for (const struct event_subscriber *es = et->subs_start;
+		     es != et->subs_stop;
+		     es++) {
+			struct event_subscriber_stats stats;
+			const struct event_listener *el = es->listener;
+
+			if (app_event_manager_listener_stats_get(et, el, &stats) ||
+			    (stats.call_cnt == 0)) {
+				continue;
+			}
+
+			shell_fprintf(shell, SHELL_NORMAL,
+				      "|\t[E:%s] -> [L:%s] calls: %u, avg: %u, max: %u\n",
+				      et->name, el->name, stats.call_cnt,
+				      (uint32_t)(stats.total_cycles / stats.call_cnt),
+				      stats.max_cycles);
+
+			for (size_t i = 0; i < ARRAY_SIZE(stats.hist); i++) {
+				uint32_t limit = app_event_manager_listener_stats_bucket_limit(i);
+
+				if (limit == UINT32_MAX) {
+					shell_fprintf(shell, SHELL_NORMAL,
+						      "|\t\t>=%u: %u\n",
+						      app_event_manager_listener_stats_bucket_limit(
+							i - 1),
+						      stats.hist[i]);
+				} else {
+					shell_fprintf(shell, SHELL_NORMAL,
+						      "|\t\t<%u: %u\n", limit, stats.hist[i]);
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+static int reset_listener_stats(const struct shell *shell, size_t argc,
+		char **argv)
+{
+	app_event_manager_listener_stats_reset();
+	shell_fprintf(shell, SHELL_NORMAL, "Listener dispatch time statistics reset\n");
+
+	return 0;
+}
+#endif /* CONFIG_APP_EVENT_MANAGER_LISTENER_STATS */
+
 static void set_event_displaying(const struct shell *shell, size_t argc,
 				 char **argv, bool enable)
 {
@@ -155,6 +232,16 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_app_event_manager,
 	SHELL_CMD_ARG(show_subscribers, NULL, "Show subscribers",
 		      show_subscribers, 0, 0),
 	SHELL_CMD_ARG(show_events, NULL, "Show events", show_events, 0, 0),
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LISTENER_STATS)
+	SHELL_CMD_ARG(show_listener_stats, NULL, "Show listener dispatch time statistics",
+		      show_listener_stats, 0, 0),
+	SHELL_CMD_ARG(reset_listener_stats, NULL, "Reset listener dispatch time statistics",
+		      reset_listener_stats, 0, 0),
+#endif
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_SLAB)
+	SHELL_CMD_ARG(show_slab_stats, NULL, "Show event slab statistics",
+		      show_slab_stats, 0, 0),
+#endif
 	SHELL_CMD_ARG(disable, NULL, "Disable displaying event with given ID",
 		      disable_event_displaying, 0,
 		      sizeof(_app_event_manager_event_display_bm) * 8 - 1),
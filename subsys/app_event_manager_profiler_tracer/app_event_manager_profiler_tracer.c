@@ -10,7 +10,7 @@
 
 LOG_MODULE_REGISTER(app_event_manager_profiler_tracer, CONFIG_APP_EVENT_MANAGER_LOG_LEVEL);
 
-#define IDS_COUNT (CONFIG_APP_EVENT_MANAGER_MAX_EVENT_CNT + 2)
+#define IDS_COUNT (CONFIG_APP_EVENT_MANAGER_MAX_EVENT_CNT + 3)
 
 extern struct profiler_info _profiler_info_list_start[];
 extern struct profiler_info _profiler_info_list_end[];
@@ -96,6 +96,53 @@ static void app_event_manager_trace_event_submission(const struct app_event_head
 
 APP_EVENT_HOOK_ON_SUBMIT_REGISTER_FIRST(app_event_manager_trace_event_submission);
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PROFILER_TRACER_TRACE_DISPATCH_TIME)
+/** @brief Trace time spent in the listener notification.
+ *
+ * @param aeh     Pointer to the application event header of the event that is
+ *                processed by app_event_manager.
+ * @param el      Pointer to the notified listener.
+ * @param cycles  Number of cycles spent in the notification.
+ **/
+static void app_event_manager_trace_event_dispatch(const struct app_event_header *aeh,
+						   const struct event_listener *el,
+						   uint32_t cycles)
+{
+	size_t event_cnt = _profiler_info_list_end - _profiler_info_list_start;
+	size_t trace_evt_id = profiler_event_ids[event_cnt + 2];
+
+	if (!is_profiling_enabled(trace_evt_id)) {
+		return;
+	}
+
+	struct log_event_buf buf;
+
+	ARG_UNUSED(buf);
+
+	profiler_log_start(&buf);
+	profiler_log_add_mem_address(&buf, aeh);
+	profiler_log_encode_string(&buf, el->name);
+	profiler_log_encode_uint32(&buf, cycles);
+	profiler_log_send(&buf, trace_evt_id);
+}
+
+APP_EVENT_HOOK_DISPATCH_REGISTER(app_event_manager_trace_event_dispatch);
+
+static void trace_register_dispatch_tracking_event(void)
+{
+	static const char * const labels[] = {"_em_mem_address_", "listener", "cycles"};
+	enum profiler_arg types[] = {PROFILER_ARG_U32, PROFILER_ARG_STRING, PROFILER_ARG_U32};
+	size_t event_cnt = _profiler_info_list_end - _profiler_info_list_start;
+
+	ARG_UNUSED(types);
+	ARG_UNUSED(labels);
+
+	profiler_event_ids[event_cnt + 2] =
+		profiler_register_event_type("event_dispatch", labels, types,
+					     ARRAY_SIZE(types));
+}
+#endif /* CONFIG_APP_EVENT_MANAGER_PROFILER_TRACER_TRACE_DISPATCH_TIME */
+
 static void trace_register_execution_tracking_events(void)
 {
 	static const char * const labels[] = {EM_MEM_ADDRESS_LABEL};
@@ -136,6 +183,10 @@ static void trace_register_events(void)
 	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PROFILER_TRACER_TRACE_EVENT_EXECUTION)) {
 		trace_register_execution_tracking_events();
 	}
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PROFILER_TRACER_TRACE_DISPATCH_TIME)
+	trace_register_dispatch_tracking_event();
+#endif
 }
 
 /** @brief Initialize tracing in the Application Event Manager.
@@ -147,9 +198,10 @@ static int app_event_manager_trace_event_init(void)
 {
 	/* Every profiled Application Event Manager event registers a single profiler event.
 	 * Apart from that 2 additional profiler events are used to indicate processing
-	 * start and end of an Application Event Manager event.
+	 * start and end of an Application Event Manager event and 1 to indicate
+	 * the listener dispatch time.
 	 */
-	__ASSERT_NO_MSG(_profiler_info_list_end - _profiler_info_list_start + 2 <=
+	__ASSERT_NO_MSG(_profiler_info_list_end - _profiler_info_list_start + 3 <=
 			CONFIG_PROFILER_MAX_NUMBER_OF_APP_EVENTS);
 
 	if (profiler_init()) {
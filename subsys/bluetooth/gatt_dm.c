@@ -6,19 +6,26 @@
 
 #include <inttypes.h>
 #include <zephyr.h>
+#include <settings/settings.h>
+#include <sys/util.h>
 #include <logging/log.h>
 
 #include <bluetooth/gatt_dm.h>
 
 LOG_MODULE_REGISTER(bt_gatt_dm, CONFIG_BT_GATT_DM_LOG_LEVEL);
 
-/* Available sizes: 128, 512, 2048... */
-#define CHUNK_DATA_SIZE (128 - sizeof(struct k_mem_block_id) \
-		- sizeof(struct data_chunk_item *))
-
 #define DATA_ALIGN 4U
 
-/* They are placed in data_chunk without padding, so they must be aligned */
+#if CONFIG_BT_GATT_DM_CACHE
+#define CACHE_KEY_PREFIX "bt/dm"
+/* Prefix, peer address and service UUID, separated by slashes */
+#define CACHE_KEY_SIZE (sizeof(CACHE_KEY_PREFIX) + 2 * sizeof(bt_addr_le_t) + \
+			1 + 2 * sizeof(((struct bt_uuid_128 *)0)->val) + 1)
+/* Key of the discovery result followed by the entry tag */
+#define CACHE_ENTRY_KEY_SIZE (CACHE_KEY_SIZE + 2)
+#endif
+
+/* They are placed in the data storage without padding, so they must be aligned */
 BUILD_ASSERT(sizeof(struct bt_gatt_service_val) % DATA_ALIGN == 0);
 BUILD_ASSERT(sizeof(struct bt_gatt_chrc) % DATA_ALIGN == 0);
 
@@ -29,14 +36,6 @@ enum {
 	STATE_NUM
 };
 
-/* One item in linked list containing dynamically allocated user data chunks */
-struct data_chunk_item {
-	/* Required by the sys_slist */
-	sys_snode_t node;
-	/* User data storage */
-	uint8_t data[CHUNK_DATA_SIZE];
-};
-
 /* The instance structure real declaration */
 struct bt_gatt_dm {
 	/* Connection object */
@@ -61,78 +60,70 @@ struct bt_gatt_dm {
 		struct bt_uuid_128 u128;
 	} svc_uuid;
 
-	/* Single-linked list of allocated chunks for user data */
-	sys_slist_t chunk_list;
-	/* The used length of the current chunk */
-	size_t cur_chunk_len;
+	/* Storage for the UUIDs and values of the parsed attributes */
+	uint8_t data[CONFIG_BT_GATT_DM_DATA_SIZE] __aligned(DATA_ALIGN);
+	/* The used length of the data storage */
+	size_t data_len;
 
 	/* The pointer to callback structure */
 	const struct bt_gatt_dm_cb *callback;
 
 	/* Indicates that services should be searched by the UUID. */
 	bool search_svc_by_uuid;
+
+#if CONFIG_BT_GATT_DM_CACHE
+	struct {
+		/* Parameters of the Database Hash read */
+		struct bt_gatt_read_params read_params;
+		/* Database Hash of the peer */
+		uint8_t hash[16];
+		/* Settings key of the discovery result */
+		char key[CACHE_KEY_SIZE];
+		/* Indicates that the discovery result should be stored */
+		bool store;
+	} cache;
+#endif
 };
 
-/* Currently only one instance is supported */
-static struct bt_gatt_dm bt_gatt_dm_inst;
+/* Each instance serves one discovery at a time */
+static struct bt_gatt_dm bt_gatt_dm_pool[CONFIG_BT_GATT_DM_MAX_INSTANCES];
+/* Serializes taking the instances */
+static struct k_spinlock bt_gatt_dm_pool_lock;
 
-/* Returns pointer to newly allocated space in a dm->data_chunk */
+/* Returns pointer to newly allocated space in a dm->data */
 static void *user_data_alloc(struct bt_gatt_dm *dm,
 			     size_t len)
 {
 	uint8_t *user_data_loc;
-	struct data_chunk_item *item;
 
 	/* Round up len to 32 bits to make sure that return pointers are always
 	 * correctly aligned.
 	 */
 	len = ROUND_UP(len, DATA_ALIGN);
 
-	__ASSERT_NO_MSG(len <= CHUNK_DATA_SIZE);
-
-	if (sys_slist_is_empty(&dm->chunk_list) ||
-	    dm->cur_chunk_len + len > CHUNK_DATA_SIZE) {
-
-		item = k_calloc(1, sizeof(struct data_chunk_item));
-
-		if (!item) {
-			return NULL;
-		}
-
-		sys_slist_append(&dm->chunk_list, &item->node);
-		dm->cur_chunk_len = 0;
-
-	} else {
-
-		item = SYS_SLIST_PEEK_TAIL_CONTAINER(&dm->chunk_list, item,
-						     node);
-
+	if (dm->data_len + len > sizeof(dm->data)) {
+		return NULL;
 	}
 
-	user_data_loc = &item->data[dm->cur_chunk_len];
-	dm->cur_chunk_len += len;
+	user_data_loc = &dm->data[dm->data_len];
+	dm->data_len += len;
+
+	memset(user_data_loc, 0, len);
 
 	return user_data_loc;
 }
 
 static void svc_attr_memory_release(struct bt_gatt_dm *dm)
 {
-	sys_snode_t *node;
-	struct data_chunk_item *item;
-
 	LOG_DBG("Attr memory release");
 
 	/* Clear attributes */
 	dm->cur_attr_id = 0;
+	dm->data_len = 0;
 
-	/* Release dynamic memory data chunks */
-	while (!sys_slist_is_empty(&dm->chunk_list)) {
-		node = sys_slist_get_not_empty(&dm->chunk_list);
-		item = CONTAINER_OF(node, struct data_chunk_item, node);
-		k_free(item);
-	}
-
-	dm->cur_chunk_len = 0;
+#if CONFIG_BT_GATT_DM_CACHE
+	dm->cache.store = false;
+#endif
 }
 
 /* Returns size of UUID structure with padding for memory alignment */
@@ -154,7 +145,7 @@ static size_t get_uuid_size(const struct bt_uuid *uuid)
 /** @brief Stores attribute in bt_gatt_dm instance.
  *
  * This function stores attr at dm->attrs array. Its UUID is stored in
- * dm->data_chunk. The Discovery Manager attribute does not contain
+ * dm->data. The Discovery Manager attribute does not contain
  * a pointer to the context data. This data could be either
  * bt_gatt_service_val or bt_gatt_chrc. It is assumed that attribute context
  * data (if any) is always placed before its UUID data. For this purpose,
@@ -247,9 +238,211 @@ static struct bt_gatt_dm_attr *attr_find_by_handle(
 	return NULL;
 }
 
+#if CONFIG_BT_GATT_DM_CACHE
+
+/* Entries stored under the key of a cached discovery result */
+enum {
+	CACHE_TAG_HDR = 'h',
+	CACHE_TAG_ATTRS = 'a',
+	CACHE_TAG_DATA = 'd',
+};
+
+/* Header of a cached discovery result */
+struct cache_hdr {
+	/* Database Hash of the peer at the time of the discovery */
+	uint8_t hash[16];
+	/* Number of the stored attributes */
+	uint16_t attr_cnt;
+	/* Length of the stored data */
+	uint16_t data_len;
+};
+
+/* Returns the length of the "bt/dm/<addr>" key */
+static size_t cache_addr_key(char *key, const bt_addr_le_t *addr)
+{
+	size_t len = snprintk(key, CACHE_KEY_SIZE, CACHE_KEY_PREFIX "/");
+
+	return len + bin2hex((const uint8_t *)addr, sizeof(*addr),
+			     &key[len], CACHE_KEY_SIZE - len);
+}
+
+/* Encodes the "bt/dm/<addr>/<service UUID>" key */
+static void cache_key(char *key, const bt_addr_le_t *addr,
+		      const struct bt_uuid *svc_uuid)
+{
+	size_t len = cache_addr_key(key, addr);
+
+	if (!svc_uuid) {
+		snprintk(&key[len], CACHE_KEY_SIZE - len, "/any");
+	} else if (svc_uuid->type == BT_UUID_TYPE_16) {
+		snprintk(&key[len], CACHE_KEY_SIZE - len, "/%04x",
+			 BT_UUID_16(svc_uuid)->val);
+	} else {
+		key[len++] = '/';
+		bin2hex(BT_UUID_128(svc_uuid)->val,
+			sizeof(BT_UUID_128(svc_uuid)->val),
+			&key[len], CACHE_KEY_SIZE - len);
+	}
+}
+
+static void cache_entry_key(char *key, const struct bt_gatt_dm *dm, char tag)
+{
+	snprintk(key, CACHE_ENTRY_KEY_SIZE, "%s/%c", dm->cache.key, tag);
+}
+
+static struct bt_uuid *uuid_to_offset(const struct bt_gatt_dm *dm,
+				      const struct bt_uuid *uuid)
+{
+	return (struct bt_uuid *)((const uint8_t *)uuid - dm->data);
+}
+
+/* Returns NULL if the offset does not point to a UUID in dm->data */
+static struct bt_uuid *uuid_from_offset(struct bt_gatt_dm *dm,
+					const struct bt_uuid *offset)
+{
+	uintptr_t off = (uintptr_t)offset;
+	struct bt_uuid *uuid;
+	size_t uuid_size;
+
+	if ((off % DATA_ALIGN) ||
+	    (off + sizeof(struct bt_uuid_16) > dm->data_len)) {
+		return NULL;
+	}
+
+	uuid = (struct bt_uuid *)&dm->data[off];
+	uuid_size = get_uuid_size(uuid);
+	if (!uuid_size || (off + uuid_size > dm->data_len)) {
+		return NULL;
+	}
+
+	return uuid;
+}
+
+/* Replaces the UUID pointers of the parsed attributes with their offsets
+ * in dm->data, so that the attributes can be stored and loaded again.
+ */
+static void cache_attrs_pack(struct bt_gatt_dm *dm)
+{
+	for (size_t i = 0; i < dm->cur_attr_id; i++) {
+		struct bt_gatt_dm_attr *attr = &dm->attrs[i];
+		struct bt_gatt_service_val *service_val =
+			bt_gatt_dm_attr_service_val(attr);
+		struct bt_gatt_chrc *chrc = bt_gatt_dm_attr_chrc_val(attr);
+
+		if (service_val) {
+			service_val->uuid = uuid_to_offset(dm, service_val->uuid);
+		} else if (chrc) {
+			chrc->uuid = uuid_to_offset(dm, chrc->uuid);
+		}
+
+		attr->uuid = uuid_to_offset(dm, attr->uuid);
+	}
+}
+
+/* Reverts cache_attrs_pack, validating the loaded attributes on the way */
+static int cache_attrs_unpack(struct bt_gatt_dm *dm)
+{
+	for (size_t i = 0; i < dm->cur_attr_id; i++) {
+		struct bt_gatt_dm_attr *attr = &dm->attrs[i];
+		struct bt_gatt_service_val *service_val;
+		struct bt_gatt_chrc *chrc;
+
+		if (i && (attr->handle <= dm->attrs[i - 1].handle)) {
+			return -EINVAL;
+		}
+
+		attr->uuid = uuid_from_offset(dm, attr->uuid);
+		if (!attr->uuid) {
+			return -EINVAL;
+		}
+
+		service_val = bt_gatt_dm_attr_service_val(attr);
+		chrc = bt_gatt_dm_attr_chrc_val(attr);
+
+		/* The value is placed right before the UUID of the attribute */
+		if (service_val) {
+			if ((uint8_t *)attr->uuid - dm->data < sizeof(*service_val)) {
+				return -EINVAL;
+			}
+
+			service_val->uuid = uuid_from_offset(dm, service_val->uuid);
+			if (!service_val->uuid) {
+				return -EINVAL;
+			}
+		} else if (chrc) {
+			if ((uint8_t *)attr->uuid - dm->data < sizeof(*chrc)) {
+				return -EINVAL;
+			}
+
+			chrc->uuid = uuid_from_offset(dm, chrc->uuid);
+			if (!chrc->uuid) {
+				return -EINVAL;
+			}
+		}
+	}
+
+	return 0;
+}
+
+static void cache_store(struct bt_gatt_dm *dm)
+{
+	struct cache_hdr hdr = {
+		.attr_cnt = dm->cur_attr_id,
+		.data_len = dm->data_len,
+	};
+	char key[CACHE_ENTRY_KEY_SIZE];
+	int err;
+
+	if (!dm->cache.store) {
+		return;
+	}
+
+	dm->cache.store = false;
+	memcpy(hdr.hash, dm->cache.hash, sizeof(hdr.hash));
+
+	/* The header is written last, so that a partially written result
+	 * is never loaded.
+	 */
+	cache_entry_key(key, dm, CACHE_TAG_HDR);
+	err = settings_delete(key);
+
+	cache_attrs_pack(dm);
+
+	if (!err) {
+		cache_entry_key(key, dm, CACHE_TAG_ATTRS);
+		err = settings_save_one(key, dm->attrs,
+					dm->cur_attr_id * sizeof(dm->attrs[0]));
+	}
+
+	if (!err) {
+		cache_entry_key(key, dm, CACHE_TAG_DATA);
+		err = settings_save_one(key, dm->data, dm->data_len);
+	}
+
+	(void)cache_attrs_unpack(dm);
+
+	if (!err) {
+		cache_entry_key(key, dm, CACHE_TAG_HDR);
+		err = settings_save_one(key, &hdr, sizeof(hdr));
+	}
+
+	if (err) {
+		LOG_WRN("Failed to store discovery result, error: %d.", err);
+	}
+}
+
+#else
+
+static void cache_store(struct bt_gatt_dm *dm)
+{
+}
+
+#endif /* CONFIG_BT_GATT_DM_CACHE */
+
 static void discovery_complete(struct bt_gatt_dm *dm)
 {
 	LOG_DBG("Discovery complete.");
+	cache_store(dm);
 	atomic_set_bit(dm->state_flags, STATE_ATTRS_RELEASE_PENDING);
 	if (dm->callback->completed) {
 		dm->callback->completed(dm, dm->context);
@@ -443,24 +636,23 @@ static uint8_t discovery_callback(struct bt_conn *conn,
 		LOG_DBG("Attr: handle %u", attr->handle);
 	}
 
-	if (conn != bt_gatt_dm_inst.conn) {
+	struct bt_gatt_dm *dm =
+		CONTAINER_OF(params, struct bt_gatt_dm, discover_params);
+
+	if (conn != dm->conn) {
 		LOG_ERR("Unexpected conn object. Aborting.");
-		discovery_complete_error(&bt_gatt_dm_inst, -EFAULT);
+		discovery_complete_error(dm, -EFAULT);
 		return BT_GATT_ITER_STOP;
 	}
 
 	switch (params->type) {
 	case BT_GATT_DISCOVER_PRIMARY:
 	case BT_GATT_DISCOVER_SECONDARY:
-		return discovery_process_service(&bt_gatt_dm_inst,
-						 attr, params);
+		return discovery_process_service(dm, attr, params);
 	case BT_GATT_DISCOVER_ATTRIBUTE:
-		return discovery_process_attribute(&bt_gatt_dm_inst,
-						   attr, params);
+		return discovery_process_attribute(dm, attr, params);
 	case BT_GATT_DISCOVER_CHARACTERISTIC:
-		return discovery_process_characteristic(&bt_gatt_dm_inst,
-							attr,
-							params);
+		return discovery_process_characteristic(dm, attr, params);
 	default:
 		/* This should not be possible */
 		__ASSERT(false, "Unknown param type.");
@@ -599,6 +791,257 @@ const struct bt_gatt_dm_attr *bt_gatt_dm_desc_next(
 	return curr;
 }
 
+#if CONFIG_BT_GATT_DM_CACHE
+
+struct cache_load_ctx {
+	struct bt_gatt_dm *dm;
+	struct cache_hdr hdr;
+	bool hdr_loaded;
+};
+
+static int cache_load_cb(const char *key, size_t len, settings_read_cb read_cb,
+			 void *cb_arg, void *param)
+{
+	struct cache_load_ctx *ctx = param;
+	struct bt_gatt_dm *dm = ctx->dm;
+	ssize_t read_len;
+	size_t size;
+	void *buf;
+
+	if (!key || (key[0] == '\0') || (key[1] != '\0')) {
+		return 0;
+	}
+
+	switch (key[0]) {
+	case CACHE_TAG_HDR:
+		buf = &ctx->hdr;
+		size = sizeof(ctx->hdr);
+		break;
+	case CACHE_TAG_ATTRS:
+		buf = dm->attrs;
+		size = sizeof(dm->attrs);
+		break;
+	case CACHE_TAG_DATA:
+		buf = dm->data;
+		size = sizeof(dm->data);
+		break;
+	default:
+		return 0;
+	}
+
+	/* Stored with a larger configuration, cannot be used */
+	if (len > size) {
+		return 0;
+	}
+
+	read_len = read_cb(cb_arg, buf, len);
+	if (read_len < 0) {
+		return read_len;
+	}
+
+	switch (key[0]) {
+	case CACHE_TAG_HDR:
+		ctx->hdr_loaded = (read_len == sizeof(ctx->hdr));
+		break;
+	case CACHE_TAG_ATTRS:
+		dm->cur_attr_id = (read_len % sizeof(dm->attrs[0])) ?
+				  0 : read_len / sizeof(dm->attrs[0]);
+		break;
+	case CACHE_TAG_DATA:
+		dm->data_len = read_len;
+		break;
+	}
+
+	return 0;
+}
+
+static int cache_load(struct bt_gatt_dm *dm)
+{
+	struct cache_load_ctx ctx = { .dm = dm };
+	struct bt_gatt_service_val *service_val = NULL;
+	int err;
+
+	err = settings_load_subtree_direct(dm->cache.key, cache_load_cb, &ctx);
+	if (!err && (!ctx.hdr_loaded ||
+		     memcmp(ctx.hdr.hash, dm->cache.hash, sizeof(ctx.hdr.hash)) ||
+		     (ctx.hdr.attr_cnt != dm->cur_attr_id) ||
+		     (ctx.hdr.data_len != dm->data_len) ||
+		     !dm->cur_attr_id)) {
+		err = -ENOENT;
+	}
+
+	if (!err) {
+		err = cache_attrs_unpack(dm);
+	}
+
+	if (!err) {
+		service_val = bt_gatt_dm_attr_service_val(&dm->attrs[0]);
+		if (!service_val) {
+			err = -EINVAL;
+		}
+	}
+
+	if (err) {
+		svc_attr_memory_release(dm);
+		return err;
+	}
+
+	/* Continue after the cached service like after a discovered one */
+	dm->discover_params.uuid = NULL;
+	dm->discover_params.end_handle = service_val->end_handle;
+
+	return 0;
+}
+
+static uint8_t cache_hash_read_cb(struct bt_conn *conn, uint8_t err,
+				  struct bt_gatt_read_params *params,
+				  const void *data, uint16_t length)
+{
+	struct bt_gatt_dm *dm =
+		CONTAINER_OF(params, struct bt_gatt_dm, cache.read_params);
+	int ret;
+
+	if (!err && data && (length == sizeof(dm->cache.hash))) {
+		memcpy(dm->cache.hash, data, length);
+
+		if (!cache_load(dm)) {
+			LOG_DBG("Discovery result loaded from cache.");
+			discovery_complete(dm);
+			return BT_GATT_ITER_STOP;
+		}
+
+		dm->cache.store = true;
+	} else {
+		LOG_DBG("Database Hash not available, error: %u.", err);
+	}
+
+	ret = bt_gatt_discover(conn, &dm->discover_params);
+	if (ret) {
+		LOG_ERR("Discover failed, error: %d.", ret);
+		discovery_complete_error(dm, ret);
+	}
+
+	return BT_GATT_ITER_STOP;
+}
+
+/* Reads the Database Hash of a bonded peer before the discovery, to find out
+ * if the result stored for the peer is still valid.
+ */
+static int cache_hash_read(struct bt_gatt_dm *dm)
+{
+	struct bt_conn_info info;
+	int err;
+
+	dm->cache.store = false;
+
+	err = bt_conn_get_info(dm->conn, &info);
+	if (err) {
+		return err;
+	}
+
+	if ((info.type != BT_CONN_TYPE_LE) ||
+	    !bt_addr_le_is_bonded(info.id, info.le.dst)) {
+		return -ENOENT;
+	}
+
+	cache_key(dm->cache.key, info.le.dst,
+		  dm->search_svc_by_uuid ? &dm->svc_uuid.uuid : NULL);
+
+	dm->cache.read_params.func = cache_hash_read_cb;
+	dm->cache.read_params.handle_count = 0;
+	dm->cache.read_params.by_uuid.uuid = BT_UUID_GATT_DB_HASH;
+	dm->cache.read_params.by_uuid.start_handle = 0x0001;
+	dm->cache.read_params.by_uuid.end_handle = 0xffff;
+
+	return bt_gatt_read(dm->conn, &dm->cache.read_params);
+}
+
+static int cache_delete_cb(const char *key, size_t len,
+			   settings_read_cb read_cb, void *cb_arg,
+			   void *param)
+{
+	const char *subtree = param;
+	char name[CACHE_ENTRY_KEY_SIZE];
+
+	if (key) {
+		snprintk(name, sizeof(name), "%s/%s", subtree, key);
+		(void)settings_delete(name);
+	}
+
+	return 0;
+}
+
+int bt_gatt_dm_cache_clear(const bt_addr_le_t *addr)
+{
+	char subtree[CACHE_KEY_SIZE] = CACHE_KEY_PREFIX;
+
+	if (addr) {
+		(void)cache_addr_key(subtree, addr);
+	}
+
+	return settings_load_subtree_direct(subtree, cache_delete_cb, subtree);
+}
+
+/* Cached results are loaded on demand, when the discovery is started */
+static int cache_settings_set(const char *name, size_t len,
+			      settings_read_cb read_cb, void *cb_arg)
+{
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(bt_gatt_dm, CACHE_KEY_PREFIX, NULL,
+			       cache_settings_set, NULL, NULL);
+
+#else
+
+static int cache_hash_read(struct bt_gatt_dm *dm)
+{
+	return -ENOTSUP;
+}
+
+#endif /* CONFIG_BT_GATT_DM_CACHE */
+
+/* Returns a free instance, preferably the one last used with the connection.
+ * The instance is taken under the lock, so that only one of the discoveries
+ * started at the same time on a connection gets it.
+ */
+static struct bt_gatt_dm *dm_alloc(struct bt_conn *conn)
+{
+	struct bt_gatt_dm *free_dm = NULL;
+	k_spinlock_key_t key = k_spin_lock(&bt_gatt_dm_pool_lock);
+
+	for (size_t i = 0; i < ARRAY_SIZE(bt_gatt_dm_pool); i++) {
+		struct bt_gatt_dm *dm = &bt_gatt_dm_pool[i];
+
+		if (atomic_test_bit(dm->state_flags, STATE_ATTRS_LOCKED)) {
+			if (dm->conn == conn) {
+				/* One discovery per connection */
+				free_dm = NULL;
+				break;
+			}
+
+			continue;
+		}
+
+		if (!free_dm || (dm->conn == conn)) {
+			free_dm = dm;
+		}
+	}
+
+	if (free_dm) {
+		if (atomic_test_and_set_bit(free_dm->state_flags, STATE_ATTRS_LOCKED)) {
+			/* Taken by bt_gatt_dm_continue in the meantime */
+			free_dm = NULL;
+		} else {
+			free_dm->conn = conn;
+		}
+	}
+
+	k_spin_unlock(&bt_gatt_dm_pool_lock, key);
+
+	return free_dm;
+}
+
 int bt_gatt_dm_start(struct bt_conn *conn,
 		     const struct bt_uuid *svc_uuid,
 		     const struct bt_gatt_dm_cb *cb,
@@ -617,18 +1060,15 @@ int bt_gatt_dm_start(struct bt_conn *conn,
 		return -EINVAL;
 	}
 
-	dm = &bt_gatt_dm_inst;
-
-	if (atomic_test_and_set_bit(dm->state_flags, STATE_ATTRS_LOCKED)) {
+	dm = dm_alloc(conn);
+	if (!dm) {
 		return -EALREADY;
 	}
 
-	dm->conn = conn;
 	dm->context = context;
 	dm->callback = cb;
 	dm->cur_attr_id = 0;
-	sys_slist_init(&dm->chunk_list);
-	dm->cur_chunk_len = 0;
+	dm->data_len = 0;
 	dm->search_svc_by_uuid = (svc_uuid != NULL);
 
 	if (svc_uuid) {
@@ -644,6 +1084,11 @@ int bt_gatt_dm_start(struct bt_conn *conn,
 	dm->discover_params.end_handle = 0xffff;
 	dm->discover_params.type = BT_GATT_DISCOVER_PRIMARY;
 
+	/* The discovery starts when the Database Hash is read */
+	if (!cache_hash_read(dm)) {
+		return 0;
+	}
+
 	err = bt_gatt_discover(conn, &dm->discover_params);
 	if (err) {
 		LOG_ERR("Discover failed, error: %d.", err);
@@ -24,11 +24,10 @@ struct bt_mesh_plvl_srv_settings_data {
 } __packed;
 
 #if CONFIG_BT_SETTINGS
-static void store_timeout(struct k_work *work)
+static void store_write(struct bt_mesh_model_store *store)
 {
-	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
-	struct bt_mesh_plvl_srv *srv = CONTAINER_OF(
-		dwork, struct bt_mesh_plvl_srv, store_timer);
+	struct bt_mesh_plvl_srv *srv =
+		CONTAINER_OF(store, struct bt_mesh_plvl_srv, store);
 
 	struct bt_mesh_plvl_srv_settings_data data = {
 		.default_power = srv->default_power,
@@ -37,17 +36,15 @@ static void store_timeout(struct k_work *work)
 		.range = srv->range,
 	};
 
-	(void)bt_mesh_model_data_store(srv->plvl_model, false, NULL, &data,
-				       sizeof(data));
+	(void)model_store_write(srv->plvl_model, false, NULL, &data,
+				sizeof(data));
 }
 #endif
 
 static void store_state(struct bt_mesh_plvl_srv *srv)
 {
 #if CONFIG_BT_SETTINGS
-	k_work_schedule(
-		&srv->store_timer,
-		K_SECONDS(CONFIG_BT_MESH_MODEL_SRV_STORE_TIMEOUT));
+	model_store_mark_dirty(&srv->store);
 #endif
 }
 
@@ -658,10 +655,10 @@ static void bt_mesh_plvl_srv_reset(struct bt_mesh_model *model)
 
 	plvl_srv_reset(srv);
 	net_buf_simple_reset(model->pub->msg);
-	if (IS_ENABLED(CONFIG_BT_SETTINGS)) {
-		(void)bt_mesh_model_data_store(srv->plvl_model, false, NULL,
-					       NULL, 0);
-	}
+#if CONFIG_BT_SETTINGS
+	model_store_cancel(&srv->store);
+	(void)model_store_write(srv->plvl_model, false, NULL, NULL, 0);
+#endif
 }
 
 static int update_handler(struct bt_mesh_model *model)
@@ -688,7 +685,7 @@ static int bt_mesh_plvl_srv_init(struct bt_mesh_model *model)
 				      sizeof(srv->pub_data));
 
 #if CONFIG_BT_SETTINGS
-	k_work_init_delayable(&srv->store_timer, store_timeout);
+	model_store_init(&srv->store, store_write);
 #endif
 
 	err = bt_mesh_model_extend(model, srv->ponoff.ponoff_model);
@@ -56,18 +56,16 @@ static int store_data(struct bt_mesh_ponoff_srv *srv,
 		size = sizeof(data);
 	}
 
-	return bt_mesh_model_data_store(srv->ponoff_model, false, NULL, &data,
-					size);
+	return model_store_write(srv->ponoff_model, false, NULL, &data, size);
 
 }
 
-static void store_timeout(struct k_work *work)
+static void store_write(struct bt_mesh_model_store *store)
 {
 	int err;
 
-	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
-	struct bt_mesh_ponoff_srv *srv = CONTAINER_OF(
-		dwork, struct bt_mesh_ponoff_srv, store_timer);
+	struct bt_mesh_ponoff_srv *srv =
+		CONTAINER_OF(store, struct bt_mesh_ponoff_srv, store);
 
 	struct bt_mesh_onoff_status onoff_status = {0};
 
@@ -86,10 +84,7 @@ static void store_timeout(struct k_work *work)
 static void store_state(struct bt_mesh_ponoff_srv *srv)
 {
 #if CONFIG_BT_SETTINGS
-	k_work_schedule(
-		&srv->store_timer,
-		K_SECONDS(CONFIG_BT_MESH_MODEL_SRV_STORE_TIMEOUT));
-
+	model_store_mark_dirty(&srv->store);
 #endif
 }
 
@@ -294,7 +289,7 @@ static int bt_mesh_ponoff_srv_init(struct bt_mesh_model *model)
 				      sizeof(srv->pub_data));
 
 #if CONFIG_BT_SETTINGS
-	k_work_init_delayable(&srv->store_timer, store_timeout);
+	model_store_init(&srv->store, store_write);
 #endif
 
 	return bt_mesh_model_extend(model, srv->onoff.model);
@@ -306,10 +301,10 @@ static void bt_mesh_ponoff_srv_reset(struct bt_mesh_model *model)
 
 	srv->on_power_up = BT_MESH_ON_POWER_UP_OFF;
 	net_buf_simple_reset(srv->pub.msg);
-	if (IS_ENABLED(CONFIG_BT_SETTINGS)) {
-		(void)bt_mesh_model_data_store(srv->ponoff_model, false, NULL,
-					       NULL, 0);
-	}
+#if CONFIG_BT_SETTINGS
+	model_store_cancel(&srv->store);
+	(void)model_store_write(srv->ponoff_model, false, NULL, NULL, 0);
+#endif
 }
 
 #ifdef CONFIG_BT_SETTINGS
@@ -51,11 +51,10 @@ static struct bt_mesh_prop *prop_get(const struct bt_mesh_prop_srv *srv,
 }
 
 #if CONFIG_BT_SETTINGS
-static void store_timeout(struct k_work *work)
+static void store_write(struct bt_mesh_model_store *store)
 {
-	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
-	struct bt_mesh_prop_srv *srv = CONTAINER_OF(
-		dwork, struct bt_mesh_prop_srv, store_timer);
+	struct bt_mesh_prop_srv *srv =
+		CONTAINER_OF(store, struct bt_mesh_prop_srv, store);
 
 	uint8_t user_access[CONFIG_BT_MESH_PROP_MAXCOUNT];
 
@@ -63,8 +62,8 @@ static void store_timeout(struct k_work *work)
 		user_access[i] = srv->properties[i].user_access;
 	}
 
-	(void)bt_mesh_model_data_store(srv->model, false, NULL, user_access,
-				       srv->property_count);
+	(void)model_store_write(srv->model, false, NULL, user_access,
+				srv->property_count);
 
 }
 #endif
@@ -72,9 +71,7 @@ static void store_timeout(struct k_work *work)
 static void store_props(struct bt_mesh_prop_srv *srv)
 {
 #if CONFIG_BT_SETTINGS
-	k_work_schedule(
-		&srv->store_timer,
-		K_SECONDS(CONFIG_BT_MESH_MODEL_SRV_STORE_TIMEOUT));
+	model_store_mark_dirty(&srv->store);
 #endif
 }
 
@@ -623,7 +620,7 @@ static int bt_mesh_prop_srv_init(struct bt_mesh_model *model)
 	}
 
 #if CONFIG_BT_SETTINGS
-	k_work_init_delayable(&srv->store_timer, store_timeout);
+	model_store_init(&srv->store, store_write);
 #endif
 
 	if ((model->id == BT_MESH_MODEL_ID_GEN_MANUFACTURER_PROP_SRV ||
@@ -661,9 +658,10 @@ static void bt_mesh_prop_srv_reset(struct bt_mesh_model *model)
 
 	net_buf_simple_reset(srv->pub.msg);
 
-	if (IS_ENABLED(CONFIG_BT_SETTINGS)) {
-		(void)bt_mesh_model_data_store(srv->model, false, NULL, NULL, 0);
-	}
+#if CONFIG_BT_SETTINGS
+	model_store_cancel(&srv->store);
+	(void)model_store_write(srv->model, false, NULL, NULL, 0);
+#endif
 }
 
 #ifdef CONFIG_BT_SETTINGS
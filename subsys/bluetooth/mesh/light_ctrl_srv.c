@@ -91,9 +91,7 @@ static void store(struct bt_mesh_light_ctrl_srv *srv, enum flags kind)
 #if CONFIG_BT_SETTINGS
 	atomic_set_bit(&srv->flags, kind);
 
-	k_work_schedule(
-		&srv->store_timer,
-		K_SECONDS(CONFIG_BT_MESH_MODEL_SRV_STORE_TIMEOUT));
+	model_store_mark_dirty(&srv->store);
 #endif
 }
 
@@ -669,8 +667,8 @@ static void store_cfg_data(struct bt_mesh_light_ctrl_srv *srv)
 #endif
 		};
 
-		(void)bt_mesh_model_data_store(srv->setup_srv, false, NULL,
-					       &data, sizeof(data));
+		(void)model_store_write(srv->setup_srv, false, NULL, &data,
+					sizeof(data));
 	}
 }
 
@@ -685,23 +683,22 @@ static void store_state_data(struct bt_mesh_light_ctrl_srv *srv)
 		atomic_set_bit_to(&data, STORED_FLAG_OCC_MODE,
 				  atomic_test_bit(&srv->flags, FLAG_OCC_MODE));
 
-		(void)bt_mesh_model_data_store(srv->model, false, NULL, &data,
-					       sizeof(data));
+		(void)model_store_write(srv->model, false, NULL, &data,
+					sizeof(data));
 	}
 
 }
 
-static void store_timeout(struct k_work *work)
+static void store_write(struct bt_mesh_model_store *store)
 {
-	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
-	struct bt_mesh_light_ctrl_srv *srv = CONTAINER_OF(
-		dwork, struct bt_mesh_light_ctrl_srv, store_timer);
+	struct bt_mesh_light_ctrl_srv *srv =
+		CONTAINER_OF(store, struct bt_mesh_light_ctrl_srv, store);
 
 	store_cfg_data(srv);
 
 	store_state_data(srv);
 
-	BT_DBG("Store Timeout");
+	BT_DBG("Store");
 }
 #endif
 /*******************************************************************************
@@ -1507,7 +1504,7 @@ static int light_ctrl_srv_init(struct bt_mesh_model *model)
 	k_work_init_delayable(&srv->action_delay, delayed_action_timeout);
 
 #if CONFIG_BT_SETTINGS
-	k_work_init_delayable(&srv->store_timer, store_timeout);
+	model_store_init(&srv->store, store_write);
 #endif
 
 #if CONFIG_BT_MESH_LIGHT_CTRL_SRV_REG
@@ -1661,12 +1658,13 @@ static void light_ctrl_srv_reset(struct bt_mesh_model *model)
 	net_buf_simple_reset(srv->pub.msg);
 	srv->resume = CONFIG_BT_MESH_LIGHT_CTRL_SRV_RESUME_DELAY;
 
-	if (IS_ENABLED(CONFIG_BT_SETTINGS)) {
-		(void)bt_mesh_model_data_store(srv->setup_srv, false, NULL,
-					       NULL, 0);
-		(void)bt_mesh_model_data_store(srv->model, false, NULL,
-					       NULL, 0);
-	}
+#if CONFIG_BT_SETTINGS
+	model_store_cancel(&srv->store);
+	atomic_clear_bit(&srv->flags, FLAG_STORE_CFG);
+	atomic_clear_bit(&srv->flags, FLAG_STORE_STATE);
+	(void)model_store_write(srv->setup_srv, false, NULL, NULL, 0);
+	(void)model_store_write(srv->model, false, NULL, NULL, 0);
+#endif
 }
 
 const struct bt_mesh_model_cb _bt_mesh_light_ctrl_srv_cb = {
@@ -26,11 +26,10 @@ struct settings_data {
 } __packed;
 
 #if CONFIG_BT_SETTINGS
-static void store_timeout(struct k_work *work)
+static void store_write(struct bt_mesh_model_store *store)
 {
-	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
-	struct bt_mesh_light_sat_srv *srv = CONTAINER_OF(
-		dwork, struct bt_mesh_light_sat_srv, store_timer);
+	struct bt_mesh_light_sat_srv *srv =
+		CONTAINER_OF(store, struct bt_mesh_light_sat_srv, store);
 
 	struct settings_data data = {
 		.range = srv->range,
@@ -38,17 +37,14 @@ static void store_timeout(struct k_work *work)
 		.dflt = srv->dflt,
 	};
 
-	(void)bt_mesh_model_data_store(srv->model, false, NULL, &data,
-				       sizeof(data));
+	(void)model_store_write(srv->model, false, NULL, &data, sizeof(data));
 }
 #endif
 
 static void store(struct bt_mesh_light_sat_srv *srv)
 {
 #if CONFIG_BT_SETTINGS
-	k_work_schedule(
-		&srv->store_timer,
-		K_SECONDS(CONFIG_BT_MESH_MODEL_SRV_STORE_TIMEOUT));
+	model_store_mark_dirty(&srv->store);
 #endif
 }
 
@@ -388,7 +384,7 @@ static int sat_srv_init(struct bt_mesh_model *model)
 				      ARRAY_SIZE(srv->pub_data));
 
 #if CONFIG_BT_SETTINGS
-	k_work_init_delayable(&srv->store_timer, store_timeout);
+	model_store_init(&srv->store, store_write);
 #endif
 
 	return bt_mesh_model_extend(model, srv->lvl.model);
@@ -425,9 +421,10 @@ static void sat_srv_reset(struct bt_mesh_model *model)
 
 	net_buf_simple_reset(srv->pub.msg);
 
-	if (IS_ENABLED(CONFIG_BT_SETTINGS)) {
-		(void)bt_mesh_model_data_store(srv->model, false, NULL, NULL, 0);
-	}
+#if CONFIG_BT_SETTINGS
+	model_store_cancel(&srv->store);
+	(void)model_store_write(srv->model, false, NULL, NULL, 0);
+#endif
 }
 
 const struct bt_mesh_model_cb _bt_mesh_light_sat_srv_cb = {
@@ -30,11 +30,10 @@ static const char *const repr_str[] = { "Actual", "Linear" };
 #endif
 
 #if CONFIG_BT_SETTINGS
-static void store_timeout(struct k_work *work)
+static void store_write(struct bt_mesh_model_store *store)
 {
-	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
-	struct bt_mesh_lightness_srv *srv = CONTAINER_OF(
-		dwork, struct bt_mesh_lightness_srv, store_timer);
+	struct bt_mesh_lightness_srv *srv =
+		CONTAINER_OF(store, struct bt_mesh_lightness_srv, store);
 
 	struct bt_mesh_lightness_srv_settings_data data = {
 		.default_light = srv->default_light,
@@ -47,17 +46,15 @@ static void store_timeout(struct k_work *work)
 	       data.last, data.default_light, data.is_on ? "On" : "Off",
 	       data.range.min, data.range.max);
 
-	(void)bt_mesh_model_data_store(srv->lightness_model, false, NULL,
-				       &data, sizeof(data));
+	(void)model_store_write(srv->lightness_model, false, NULL, &data,
+				sizeof(data));
 }
 #endif
 
 static void store_state(struct bt_mesh_lightness_srv *srv)
 {
 #if CONFIG_BT_SETTINGS
-	k_work_schedule(
-		&srv->store_timer,
-		K_SECONDS(CONFIG_BT_MESH_MODEL_SRV_STORE_TIMEOUT));
+	model_store_mark_dirty(&srv->store);
 #endif
 }
 
@@ -769,10 +766,10 @@ static void bt_mesh_lightness_srv_reset(struct bt_mesh_model *model)
 
 	lightness_srv_reset(srv);
 	net_buf_simple_reset(srv->pub.msg);
-	if (IS_ENABLED(CONFIG_BT_SETTINGS)) {
-		(void)bt_mesh_model_data_store(srv->lightness_model, false,
-					       NULL, NULL, 0);
-	}
+#if CONFIG_BT_SETTINGS
+	model_store_cancel(&srv->store);
+	(void)model_store_write(srv->lightness_model, false, NULL, NULL, 0);
+#endif
 }
 
 static ssize_t scene_store(struct bt_mesh_model *model, uint8_t data[])
@@ -850,7 +847,7 @@ static int bt_mesh_lightness_srv_init(struct bt_mesh_model *model)
 				      sizeof(srv->pub_data));
 
 #if CONFIG_BT_SETTINGS
-	k_work_init_delayable(&srv->store_timer, store_timeout);
+	model_store_init(&srv->store, store_write);
 #endif
 
 	err = bt_mesh_model_extend(model, srv->ponoff.ponoff_model);
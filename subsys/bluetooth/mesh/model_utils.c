@@ -149,3 +149,121 @@ bool bt_mesh_model_pub_is_unicast(const struct bt_mesh_model *model)
 {
 	return model->pub && BT_MESH_ADDR_IS_UNICAST(model->pub->addr);
 }
+
+#if CONFIG_BT_SETTINGS
+static sys_slist_t store_list;
+static struct k_spinlock store_lock;
+static struct bt_mesh_model_store_stats store_stats;
+
+static struct bt_mesh_model_store *store_next(void)
+{
+	struct bt_mesh_model_store *store = NULL;
+	k_spinlock_key_t key = k_spin_lock(&store_lock);
+	sys_snode_t *node = sys_slist_get(&store_list);
+
+	if (node) {
+		store = CONTAINER_OF(node, struct bt_mesh_model_store, node);
+		/* Changes made during the write will be written again: */
+		store->pending = false;
+	}
+
+	k_spin_unlock(&store_lock, key);
+
+	return store;
+}
+
+static void store_flush(void)
+{
+	struct bt_mesh_model_store *store;
+
+	while ((store = store_next())) {
+		store->write(store);
+	}
+}
+
+static void store_timeout(struct k_work *work)
+{
+	store_flush();
+}
+
+static K_WORK_DELAYABLE_DEFINE(store_work, store_timeout);
+
+void model_store_init(struct bt_mesh_model_store *store,
+		      void (*write)(struct bt_mesh_model_store *store))
+{
+	store->write = write;
+	store->pending = false;
+}
+
+void model_store_mark_dirty(struct bt_mesh_model_store *store)
+{
+	k_spinlock_key_t key = k_spin_lock(&store_lock);
+
+	store_stats.marked++;
+
+	if (!store->pending) {
+		store->pending = true;
+		sys_slist_append(&store_list, &store->node);
+	}
+
+	k_spin_unlock(&store_lock, key);
+
+	/* Doesn't reschedule a pending write, so the first change is never
+	 * delayed by more than the timeout:
+	 */
+	k_work_schedule(&store_work,
+			K_SECONDS(CONFIG_BT_MESH_MODEL_SRV_STORE_TIMEOUT));
+}
+
+void model_store_cancel(struct bt_mesh_model_store *store)
+{
+	k_spinlock_key_t key = k_spin_lock(&store_lock);
+
+	if (store->pending) {
+		store->pending = false;
+		sys_slist_find_and_remove(&store_list, &store->node);
+	}
+
+	k_spin_unlock(&store_lock, key);
+}
+
+int model_store_write(struct bt_mesh_model *model, bool vnd, const char *name,
+		      const void *data, size_t len)
+{
+	k_spinlock_key_t key;
+	int err;
+
+	err = bt_mesh_model_data_store(model, vnd, name, data, len);
+
+	key = k_spin_lock(&store_lock);
+	store_stats.writes++;
+	if (err) {
+		store_stats.failed++;
+	}
+	k_spin_unlock(&store_lock, key);
+
+	return err;
+}
+#endif /* CONFIG_BT_SETTINGS */
+
+void bt_mesh_model_store_flush(void)
+{
+#if CONFIG_BT_SETTINGS
+	struct k_work_sync sync;
+
+	(void)k_work_cancel_delayable_sync(&store_work, &sync);
+	store_flush();
+#endif
+}
+
+void bt_mesh_model_store_stats_get(struct bt_mesh_model_store_stats *stats)
+{
+#if CONFIG_BT_SETTINGS
+	k_spinlock_key_t key = k_spin_lock(&store_lock);
+
+	*stats = store_stats;
+	k_spin_unlock(&store_lock, key);
+#else
+	memset(stats, 0, sizeof(*stats));
+#endif
+}
@@ -74,6 +74,46 @@ int model_ackd_send(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
 		    struct bt_mesh_msg_ack_ctx *ack, uint32_t rsp_op,
 		    void *user_data);
 
+/** @brief Initialize a pending model state write.
+ *
+ * @param store Model state write to initialize.
+ * @param write Function writing the model state to persistent storage. Called
+ * from the system workqueue, or from @ref bt_mesh_model_store_flush.
+ */
+void model_store_init(struct bt_mesh_model_store *store,
+		      void (*write)(struct bt_mesh_model_store *store));
+
+/** @brief Mark the model state as changed.
+ *
+ * The model state is written once for all the changes marked within
+ * @kconfig{CONFIG_BT_MESH_MODEL_SRV_STORE_TIMEOUT} seconds.
+ *
+ * @param store Model state write.
+ */
+void model_store_mark_dirty(struct bt_mesh_model_store *store);
+
+/** @brief Cancel a pending model state write.
+ *
+ * @param store Model state write.
+ */
+void model_store_cancel(struct bt_mesh_model_store *store);
+
+/** @brief Write model data to persistent storage.
+ *
+ * Wrapper for @ref bt_mesh_model_data_store that counts the writes in the
+ * model state storage statistics.
+ *
+ * @param model Model to write the data of.
+ * @param vnd Whether the model is a vendor model.
+ * @param name Name of the data entry, or NULL.
+ * @param data Data to write, or NULL to delete the entry.
+ * @param len Length of the data.
+ *
+ * @return 0 on success, or (negative) error code on failure.
+ */
+int model_store_write(struct bt_mesh_model *model, bool vnd, const char *name,
+		      const void *data, size_t len);
+
 /** @brief Compare the TID of an incoming message with the previous
  * transaction, and update it if it's new.
  *
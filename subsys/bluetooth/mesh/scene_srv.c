@@ -395,7 +395,7 @@ static void page_store(struct bt_mesh_scene_srv *srv, uint16_t scene,
 	scene_path(path, scene, vnd, page);
 	update_page_count(srv, vnd, page);
 
-	err = bt_mesh_model_data_store(srv->model, false, path, buf, len);
+	err = model_store_write(srv->model, false, path, buf, len);
 	if (err) {
 		BT_ERR("Failed storing %s: %d", log_strdup(path), err);
 	}
@@ -560,12 +560,12 @@ static void scene_delete(struct bt_mesh_scene_srv *srv, uint16_t *scene)
 
 	for (int i = 0; i < srv->sigpages; i++) {
 		scene_path(path, *scene, false, i);
-		(void)bt_mesh_model_data_store(srv->model, false, path, NULL, 0);
+		(void)model_store_write(srv->model, false, path, NULL, 0);
 	}
 
 	for (int i = 0; i < srv->vndpages; i++) {
 		scene_path(path, *scene, true, i);
-		(void)bt_mesh_model_data_store(srv->model, false, path, NULL, 0);
+		(void)model_store_write(srv->model, false, path, NULL, 0);
 	}
 
 	uint16_t target = target_scene(srv);
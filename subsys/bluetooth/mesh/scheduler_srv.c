@@ -51,20 +51,46 @@ typedef int (*stage_handler_t)(struct tm *sched_time,
 		struct bt_mesh_schedule_entry *entry,
 		struct tm_converter *info);
 
-static int store(struct bt_mesh_scheduler_srv *srv, uint8_t idx, bool store_ndel)
+static bool is_entry_defined(struct bt_mesh_scheduler_srv *srv, uint8_t idx)
+{
+	return srv->sch_reg[idx].action != BT_MESH_SCHEDULER_NO_ACTIONS;
+}
+
+#if CONFIG_BT_SETTINGS
+static void store_write(struct bt_mesh_model_store *store)
 {
-	char name[3] = {0};
-	const void *data = store_ndel ? &srv->sch_reg[idx] : NULL;
-	size_t len = store_ndel ? sizeof(srv->sch_reg[idx]) : 0;
+	struct bt_mesh_scheduler_srv *srv =
+		CONTAINER_OF(store, struct bt_mesh_scheduler_srv, store);
+	uint16_t bitmap = srv->store_bitmap;
+
+	srv->store_bitmap = 0;
 
-	snprintf(name, sizeof(name), "%x", idx);
+	for (uint8_t idx = 0; idx < BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT;
+	     ++idx) {
+		char name[3] = {0};
+		bool store_ndel;
 
-	return bt_mesh_model_data_store(srv->model, false, name, data, len);
+		if (!(bitmap & BIT(idx))) {
+			continue;
+		}
+
+		/* Undefined entries are deleted from the persistent storage */
+		store_ndel = is_entry_defined(srv, idx);
+		snprintf(name, sizeof(name), "%x", idx);
+
+		(void)model_store_write(srv->model, false, name,
+					store_ndel ? &srv->sch_reg[idx] : NULL,
+					store_ndel ? sizeof(srv->sch_reg[idx]) : 0);
+	}
 }
+#endif
 
-static bool is_entry_defined(struct bt_mesh_scheduler_srv *srv, uint8_t idx)
+static void store(struct bt_mesh_scheduler_srv *srv, uint8_t idx)
 {
-	return srv->sch_reg[idx].action != BT_MESH_SCHEDULER_NO_ACTIONS;
+#if CONFIG_BT_SETTINGS
+	WRITE_BIT(srv->store_bitmap, idx, 1);
+	model_store_mark_dirty(&srv->store);
+#endif
 }
 
 static int get_days_in_month(int year, int month)
@@ -654,9 +680,7 @@ static int action_set(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
 	}
 
 	if (is_entry_defined(srv, idx)) {
-		if (IS_ENABLED(CONFIG_BT_SETTINGS)) {
-			store(srv, idx, true);
-		}
+		store(srv, idx);
 
 		/* publish state changing */
 		send_scheduler_action_status(model, NULL, idx, false);
@@ -766,6 +790,10 @@ static int scheduler_srv_init(struct bt_mesh_model *model)
 		srv->sch_reg[i].action = BT_MESH_SCHEDULER_NO_ACTIONS;
 	}
 
+#if CONFIG_BT_SETTINGS
+	model_store_init(&srv->store, store_write);
+#endif
+
 	return 0;
 }
 
@@ -785,12 +813,14 @@ static void scheduler_srv_reset(struct bt_mesh_model *model)
 		srv->sch_reg[i].action = BT_MESH_SCHEDULER_NO_ACTIONS;
 	}
 
-	if (IS_ENABLED(CONFIG_BT_SETTINGS)) {
-		for (int idx = 0; idx < BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT;
-		     ++idx) {
-			store(srv, idx, false);
-		}
-	}
+#if CONFIG_BT_SETTINGS
+	/* Delete all the entries right away, as the device may be rebooted
+	 * after the reset:
+	 */
+	model_store_cancel(&srv->store);
+	srv->store_bitmap = BIT_MASK(BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT);
+	store_write(&srv->store);
+#endif
 }
 
 #ifdef CONFIG_BT_SETTINGS
@@ -288,6 +288,20 @@ int sensor_column_encode(struct net_buf_simple *buf,
 		return err;
 	}
 
+	/* Stored values are encoded in place, without letting
+	 * bt_mesh_sensor_srv_series_set() update the column halfway.
+	 */
+	if (sensor->series.store.values) {
+		k_sched_lock();
+		err = sensor_value_encode(
+			buf, sensor->type,
+			&sensor->series.store.values[(col - sensor->series.columns) *
+						     sensor->type->channel_count]);
+		k_sched_unlock();
+
+		return err;
+	}
+
 	err = sensor->series.get(srv, sensor, ctx, col, values);
 	if (err) {
 		return err;
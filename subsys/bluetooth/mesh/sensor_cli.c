@@ -59,6 +59,19 @@ static void unknown_type(struct bt_mesh_sensor_cli *cli,
 	}
 }
 
+static bool batch_enabled(const struct bt_mesh_sensor_cli *cli)
+{
+	return cli->batch && cli->batch_size && cli->cb && cli->cb->data_batch;
+}
+
+static void batch_flush(struct bt_mesh_sensor_cli *cli,
+			struct bt_mesh_msg_ctx *ctx, uint32_t count)
+{
+	if (count) {
+		cli->cb->data_batch(cli, ctx, cli->batch, count);
+	}
+}
+
 static int handle_descriptor_status(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
 				    struct net_buf_simple *buf)
 {
@@ -109,6 +122,9 @@ static int handle_status(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ct
 {
 	struct bt_mesh_sensor_cli *cli = model->user_data;
 	struct sensor_data_list_rsp *rsp = NULL;
+	struct bt_mesh_sensor_data single;
+	bool batch = batch_enabled(cli);
+	uint32_t batch_count = 0;
 	uint32_t count = 0;
 	int err;
 
@@ -117,6 +133,7 @@ static int handle_status(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ct
 
 	while (buf->len) {
 		const struct bt_mesh_sensor_type *type;
+		struct bt_mesh_sensor_data *data;
 		uint8_t length;
 		uint16_t id;
 
@@ -152,26 +169,38 @@ static int handle_status(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ct
 			return -EMSGSIZE;
 		}
 
-		struct sensor_value value[CONFIG_BT_MESH_SENSOR_CHANNELS_MAX];
+		/* Batched sensors are decoded straight into the batch buffer */
+		data = batch ? &cli->batch[batch_count] : &single;
 
-		err = sensor_value_decode(buf, type, value);
+		err = sensor_value_decode(buf, type, data->value);
 		if (err) {
 			BT_ERR("Invalid format, err=%d", err);
 			return err; /* Invalid format, should ignore message */
 		}
 
+		data->type = type;
+
 		if (cli->cb && cli->cb->data) {
-			cli->cb->data(cli, ctx, type, value);
+			cli->cb->data(cli, ctx, type, data->value);
 		}
 
-		if (rsp && count <= rsp->count) {
-			memcpy(rsp->sensors[count].value, value,
+		if (rsp && count < rsp->count) {
+			memcpy(rsp->sensors[count].value, data->value,
 			       sizeof(struct sensor_value) *
 				       type->channel_count);
 
 			rsp->sensors[count].type = type;
 			++count;
 		}
+
+		if (batch && ++batch_count == cli->batch_size) {
+			batch_flush(cli, ctx, batch_count);
+			batch_count = 0;
+		}
+	}
+
+	if (batch) {
+		batch_flush(cli, ctx, batch_count);
 	}
 
 	if (rsp) {
@@ -37,11 +37,10 @@ static struct bt_mesh_sensor *sensor_get(struct bt_mesh_sensor_srv *srv,
 }
 
 #if CONFIG_BT_SETTINGS
-static void store_timeout(struct k_work *work)
+static void store_write(struct bt_mesh_model_store *store)
 {
-	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
-	struct bt_mesh_sensor_srv *srv = CONTAINER_OF(
-		dwork, struct bt_mesh_sensor_srv, store_timer);
+	struct bt_mesh_sensor_srv *srv =
+		CONTAINER_OF(store, struct bt_mesh_sensor_srv, store);
 
 	/* Cadence is stored as a sequence of cadence status messages */
 	NET_BUF_SIMPLE_DEFINE(buf, (CONFIG_BT_MESH_SENSOR_SRV_SENSORS_MAX *
@@ -65,8 +64,7 @@ static void store_timeout(struct k_work *work)
 		}
 	}
 
-	(void)bt_mesh_model_data_store(srv->model, false, NULL, buf.data,
-				       buf.len);
+	(void)model_store_write(srv->model, false, NULL, buf.data, buf.len);
 
 }
 #endif
@@ -74,9 +72,7 @@ static void store_timeout(struct k_work *work)
 static void cadence_store(struct bt_mesh_sensor_srv *srv)
 {
 #if CONFIG_BT_SETTINGS
-	k_work_schedule(
-		&srv->store_timer,
-		K_SECONDS(CONFIG_BT_MESH_MODEL_SRV_STORE_TIMEOUT));
+	model_store_mark_dirty(&srv->store);
 #endif
 }
 
@@ -219,13 +215,79 @@ respond:
 	return 0;
 }
 
+static int sensor_value_cmp(const struct sensor_value *a,
+			    const struct sensor_value *b)
+{
+	if (a->val1 != b->val1) {
+		return (a->val1 < b->val1) ? -1 : 1;
+	}
+
+	if (a->val2 != b->val2) {
+		return (a->val2 < b->val2) ? -1 : 1;
+	}
+
+	return 0;
+}
+
+static bool series_sorted(const struct bt_mesh_sensor_series *series)
+{
+	for (uint32_t i = 1; i < series->column_count; ++i) {
+		if (sensor_value_cmp(&series->columns[i - 1].start,
+				     &series->columns[i].start) >= 0) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static bool series_supported(const struct bt_mesh_sensor *sensor)
+{
+	return sensor->series.columns &&
+	       (sensor->series.get || sensor->series.store.values);
+}
+
+/** Index of the first column that starts at or after the given value. Only
+ *  valid for sorted columns.
+ */
+static uint32_t column_lower_bound(const struct bt_mesh_sensor_series *series,
+				   const struct sensor_value *val)
+{
+	uint32_t lower = 0;
+	uint32_t upper = series->column_count;
+
+	while (lower < upper) {
+		uint32_t m = lower + (upper - lower) / 2;
+
+		if (sensor_value_cmp(&series->columns[m].start, val) < 0) {
+			lower = m + 1;
+		} else {
+			upper = m;
+		}
+	}
+
+	return lower;
+}
+
 static const struct bt_mesh_sensor_column *
-column_get(const struct bt_mesh_sensor_series *series,
+column_get(const struct bt_mesh_sensor *sensor,
 	   const struct sensor_value *val)
 {
+	const struct bt_mesh_sensor_series *series = &sensor->series;
+
+	if (sensor->state.series_sorted) {
+		uint32_t i = column_lower_bound(series, val);
+
+		if (i < series->column_count &&
+		    !sensor_value_cmp(&series->columns[i].start, val)) {
+			return &series->columns[i];
+		}
+
+		return NULL;
+	}
+
 	for (uint32_t i = 0; i < series->column_count; ++i) {
-		if (series->columns[i].start.val1 == val->val1 &&
-		    series->columns[i].start.val2 == val->val2) {
+		if (!sensor_value_cmp(&series->columns[i].start, val)) {
 			return &series->columns[i];
 		}
 	}
@@ -233,6 +295,25 @@ column_get(const struct bt_mesh_sensor_series *series,
 	return NULL;
 }
 
+/** Whether a stored column has no value, or a value older than the max age. */
+static bool column_unknown(const struct bt_mesh_sensor *sensor,
+			   const struct bt_mesh_sensor_column *col, int64_t now)
+{
+	const struct bt_mesh_sensor_series_store *store = &sensor->series.store;
+	uint32_t i = col - sensor->series.columns;
+
+	if (!store->values) {
+		return false;
+	}
+
+	if (!atomic_test_bit(store->valid, i)) {
+		return true;
+	}
+
+	return store->timestamps && store->max_age &&
+	       (now - store->timestamps[i] > store->max_age);
+}
+
 static int handle_column_get(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
 			     struct net_buf_simple *buf)
 {
@@ -261,7 +342,7 @@ static int handle_column_get(struct bt_mesh_model *model, struct bt_mesh_msg_ctx
 	struct sensor_value col_x;
 
 	col_format = bt_mesh_sensor_column_format_get(sensor->type);
-	if (!col_format || !sensor->series.columns || !sensor->series.get) {
+	if (!col_format || !series_supported(sensor)) {
 		BT_WARN("No series support in 0x%04x", sensor->type->id);
 		goto respond;
 	}
@@ -273,8 +354,8 @@ static int handle_column_get(struct bt_mesh_model *model, struct bt_mesh_msg_ctx
 
 	BT_DBG("Column %s", bt_mesh_sensor_ch_str(&col_x));
 
-	col = column_get(&sensor->series, &col_x);
-	if (!col) {
+	col = column_get(sensor, &col_x);
+	if (!col || column_unknown(sensor, col, k_uptime_get())) {
 		BT_WARN("Unknown column");
 		sensor_ch_encode(&rsp, col_format, &col_x);
 		goto respond;
@@ -315,13 +396,15 @@ static int handle_series_get(struct bt_mesh_model *model, struct bt_mesh_msg_ctx
 	}
 
 	col_format = bt_mesh_sensor_column_format_get(sensor->type);
-	if (!col_format || !sensor->series.columns || !sensor->series.get) {
+	if (!col_format || !series_supported(sensor)) {
 		BT_WARN("No series support in 0x%04x", sensor->type->id);
 		goto respond;
 	}
 
 	struct bt_mesh_sensor_column range;
 	bool ranged = (buf->len != 0);
+	uint32_t first = 0;
+	int64_t now = k_uptime_get();
 
 	if (buf->len == col_format->size * 2) {
 		int err;
@@ -343,19 +426,42 @@ static int handle_series_get(struct bt_mesh_model *model, struct bt_mesh_msg_ctx
 		return -EMSGSIZE;
 	}
 
-	for (uint32_t i = 0; i < sensor->series.column_count; ++i) {
+	/* Sorted columns in the range are consecutive */
+	if (ranged && sensor->state.series_sorted) {
+		first = column_lower_bound(&sensor->series, &range.start);
+	}
+
+	for (uint32_t i = first; i < sensor->series.column_count; ++i) {
 		const struct bt_mesh_sensor_column *col =
 			&sensor->series.columns[i];
+		struct net_buf_simple_state state;
 
 		if (ranged &&
 		    !bt_mesh_sensor_value_in_column(&col->start, &range)) {
+			if (sensor->state.series_sorted) {
+				break;
+			}
+
+			continue;
+		}
+
+		if (column_unknown(sensor, col, now)) {
 			continue;
 		}
 
 		BT_DBG("Column #%u", i);
 
+		net_buf_simple_save(&rsp, &state);
+
 		int err = sensor_column_encode(&rsp, srv, sensor, ctx, col);
 
+		if (err == -ENOMEM) {
+			/* Respond with the columns that fit in the message */
+			BT_WARN("Series truncated at column #%u", i);
+			net_buf_simple_restore(&rsp, &state);
+			break;
+		}
+
 		if (err) {
 			BT_WARN("Failed encoding: %d", err);
 			return err;
@@ -894,7 +1000,7 @@ static int sensor_srv_init(struct bt_mesh_model *model)
 	sys_slist_init(&srv->sensors);
 
 #if CONFIG_BT_SETTINGS
-	k_work_init_delayable(&srv->store_timer, store_timeout);
+	model_store_init(&srv->store, store_write);
 #endif
 
 	/* Establish a sorted list of sensors, as this is a requirement when
@@ -919,7 +1025,14 @@ static int sensor_srv_init(struct bt_mesh_model *model)
 			break;
 		}
 
+		if (best->series.store.values && !best->series.store.valid) {
+			BT_ERR("No valid bitmap in the series store of 0x%04x",
+			       best->type->id);
+			return -EINVAL;
+		}
+
 		sys_slist_append(&srv->sensors, &best->state.node);
+		best->state.series_sorted = series_sorted(&best->series);
 		BT_DBG("Sensor 0x%04x", best->type->id);
 		min_id = best->type->id + 1;
 	}
@@ -961,10 +1074,10 @@ static void sensor_srv_reset(struct bt_mesh_model *model)
 
 	srv->pub.period_div = 0;
 
-	if (IS_ENABLED(CONFIG_BT_SETTINGS)) {
-		(void)bt_mesh_model_data_store(srv->model, false, NULL, NULL,
-					       0);
-	}
+#if CONFIG_BT_SETTINGS
+	model_store_cancel(&srv->store);
+	(void)model_store_write(srv->model, false, NULL, NULL, 0);
+#endif
 }
 
 static int sensor_srv_settings_set(struct bt_mesh_model *model, const char *name,
@@ -1032,6 +1145,44 @@ const struct bt_mesh_model_cb _bt_mesh_sensor_srv_cb = {
 	.settings_set = sensor_srv_settings_set,
 };
 
+int bt_mesh_sensor_srv_series_set(struct bt_mesh_sensor *sensor,
+				  const struct sensor_value *column_start,
+				  const struct sensor_value *value)
+{
+	const struct bt_mesh_sensor_series_store *store = &sensor->series.store;
+	const struct bt_mesh_sensor_column *col;
+	uint32_t i;
+
+	if (!store->values) {
+		return -ENOTSUP;
+	}
+
+	col = column_get(sensor, column_start);
+	if (!col) {
+		return -ENOENT;
+	}
+
+	i = col - sensor->series.columns;
+
+	/* The column is encoded with the scheduler locked too, so a response
+	 * never holds a partly updated column.
+	 */
+	k_sched_lock();
+
+	memcpy(&store->values[i * sensor->type->channel_count], value,
+	       sizeof(*value) * sensor->type->channel_count);
+
+	if (store->timestamps) {
+		store->timestamps[i] = k_uptime_get();
+	}
+
+	atomic_set_bit(store->valid, i);
+
+	k_sched_unlock();
+
+	return 0;
+}
+
 int bt_mesh_sensor_srv_pub(struct bt_mesh_sensor_srv *srv,
 			   struct bt_mesh_msg_ctx *ctx,
 			   struct bt_mesh_sensor *sensor,
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Client side of the batched bluetooth API calls over nRF RPC.
+ */
+
+#include <zephyr.h>
+
+#include <nrf_rpc_cbor.h>
+
+#include "bt_rpc.h"
+#include "bt_rpc_batch_client.h"
+#include "bt_rpc_common.h"
+#include "serialize.h"
+
+#include <logging/log.h>
+
+LOG_MODULE_DECLARE(BT_RPC, CONFIG_BT_RPC_LOG_LEVEL);
+
+static uint8_t batch_buf[CONFIG_BT_RPC_BATCH_BUFFER_SIZE];
+static struct bt_rpc_batch batch;
+static K_MUTEX_DEFINE(batch_mutex);
+
+static void flush_work_handler(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(flush_work, flush_work_handler);
+
+static void report_decoding_error(uint8_t cmd_evt_id, void *data)
+{
+	nrf_rpc_err(-EBADMSG, NRF_RPC_ERR_SRC_RECV, &bt_rpc_grp, cmd_evt_id,
+		    NRF_RPC_PACKET_TYPE_EVT);
+}
+
+static void batch_reset(void)
+{
+	bt_rpc_batch_init(&batch, batch_buf, sizeof(batch_buf), CONFIG_BT_RPC_BATCH_MAX_CALLS);
+}
+
+/* Must be called with the batch locked */
+static int batch_send(void)
+{
+	struct nrf_rpc_cbor_ctx ctx;
+	size_t count = batch.count;
+	size_t buffer_size_max = 10;
+	size_t len;
+	int err;
+
+	if (count == 0) {
+		return 0;
+	}
+
+	(void)k_work_cancel_delayable(&flush_work);
+
+	len = bt_rpc_batch_finish(&batch);
+	buffer_size_max += len;
+
+	NRF_RPC_CBOR_ALLOC(ctx, buffer_size_max);
+
+	ser_encode_uint(&ctx.encoder, count);
+	ser_encode_buffer(&ctx.encoder, batch_buf, len);
+
+	LOG_DBG("Sending batch of %u calls, %u bytes", count, len);
+
+	err = nrf_rpc_cbor_evt(&bt_rpc_grp, BT_RPC_BATCH_RPC_EVT, &ctx);
+
+	batch_reset();
+
+	return err;
+}
+
+int bt_rpc_batch_call_begin(const struct bt_rpc_batch_call *call, size_t args_size_max,
+			    CborEncoder **encoder)
+{
+	int err;
+
+	k_mutex_lock(&batch_mutex, K_FOREVER);
+
+	if (!batch.buf) {
+		batch_reset();
+	}
+
+	err = bt_rpc_batch_add(&batch, call, args_size_max);
+	if (err == -ENOSPC) {
+		err = batch_send();
+		if (!err) {
+			err = bt_rpc_batch_add(&batch, call, args_size_max);
+		}
+	}
+
+	if (err) {
+		k_mutex_unlock(&batch_mutex);
+		return err;
+	}
+
+	*encoder = &batch.encoder;
+
+	return 0;
+}
+
+int bt_rpc_batch_call_end(void)
+{
+	int err = 0;
+
+	if (batch.count >= CONFIG_BT_RPC_BATCH_MAX_CALLS) {
+		err = batch_send();
+	} else if ((batch.count == 1) && (CONFIG_BT_RPC_BATCH_FLUSH_TIMEOUT_MS > 0)) {
+		k_work_schedule(&flush_work, K_MSEC(CONFIG_BT_RPC_BATCH_FLUSH_TIMEOUT_MS));
+	}
+
+	k_mutex_unlock(&batch_mutex);
+
+	return err;
+}
+
+int bt_rpc_batch_flush(void)
+{
+	int err;
+
+	k_mutex_lock(&batch_mutex, K_FOREVER);
+	err = batch_send();
+	k_mutex_unlock(&batch_mutex);
+
+	return err;
+}
+
+static void flush_work_handler(struct k_work *work)
+{
+	int err;
+
+	err = bt_rpc_batch_flush();
+	if (err) {
+		LOG_ERR("Sending batch failed: %d", err);
+	}
+}
+
+struct batch_result {
+	bt_rpc_batch_result_cb_t cb;
+	void *user_data;
+	int result;
+};
+
+static void bt_rpc_batch_results_rpc_handler(CborValue *value, void *handler_data)
+{
+	struct batch_result results[CONFIG_BT_RPC_BATCH_MAX_CALLS];
+	size_t count;
+
+	count = ser_decode_uint(value);
+	if (count > ARRAY_SIZE(results)) {
+		ser_decoder_invalid(value, CborErrorDataTooLarge);
+		count = 0;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		results[i].cb = (bt_rpc_batch_result_cb_t)(uintptr_t)ser_decode_uint(value);
+		results[i].user_data = (void *)(uintptr_t)ser_decode_uint(value);
+		results[i].result = ser_decode_int(value);
+	}
+
+	if (!ser_decoding_done_and_check(value)) {
+		goto decoding_error;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		if (results[i].cb) {
+			results[i].cb(results[i].result, results[i].user_data);
+		}
+	}
+
+	return;
+decoding_error:
+	report_decoding_error(BT_RPC_BATCH_RESULTS_RPC_EVT, handler_data);
+}
+
+NRF_RPC_CBOR_EVT_DECODER(bt_rpc_grp, bt_rpc_batch_results, BT_RPC_BATCH_RESULTS_RPC_EVT,
+			 bt_rpc_batch_results_rpc_handler, NULL);
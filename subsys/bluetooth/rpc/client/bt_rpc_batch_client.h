@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef BT_RPC_BATCH_CLIENT_H_
+#define BT_RPC_BATCH_CLIENT_H_
+
+#include "bt_rpc_batch.h"
+
+/**
+ * @file
+ * @defgroup bt_rpc_batch_client RPC batch client API
+ * @{
+ * @brief API for queuing calls in the RPC batch.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Start queuing a call in the batch.
+ *
+ * If the batch is full, it is sent to the host first. On success, the batch is locked
+ * until @ref bt_rpc_batch_call_end is called, and the arguments of the call must be
+ * encoded with the returned encoder.
+ *
+ * @param[in] call Call header.
+ * @param[in] args_size_max Maximum encoded size of the call arguments.
+ * @param[out] encoder Encoder for the call arguments.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int bt_rpc_batch_call_begin(const struct bt_rpc_batch_call *call, size_t args_size_max,
+			    CborEncoder **encoder);
+
+/** @brief Finish queuing a call in the batch.
+ *
+ * Sends the batch if it has reached the maximum number of calls, or schedules sending
+ * of the batch if this is its first call.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int bt_rpc_batch_call_end(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* BT_RPC_BATCH_CLIENT_H_ */
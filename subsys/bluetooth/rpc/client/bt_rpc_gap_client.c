@@ -13,6 +13,8 @@
 
 #include <nrf_rpc_cbor.h>
 
+#include "bt_rpc.h"
+#include "bt_rpc_batch_client.h"
 #include "bt_rpc_gatt_client.h"
 #include "bt_rpc_conn_client.h"
 #include "bt_rpc_common.h"
@@ -569,6 +571,54 @@ int bt_le_adv_update_data(const struct bt_data *ad, size_t ad_len,
 	return result;
 }
 
+#if defined(CONFIG_BT_RPC_BATCH)
+int bt_rpc_batch_le_adv_update_data(const struct bt_data *ad, size_t ad_len,
+				    const struct bt_data *sd, size_t sd_len,
+				    bt_rpc_batch_result_cb_t cb, void *user_data)
+{
+	const struct bt_rpc_batch_call call = {
+		.op = BT_RPC_BATCH_OP_LE_ADV_UPDATE_DATA,
+		.cb = (uintptr_t)cb,
+		.user_data = (uintptr_t)user_data,
+	};
+	CborEncoder *encoder;
+	size_t scratchpad_size = 0;
+	size_t buffer_size_max = 15;
+	int err;
+
+	for (size_t i = 0; i < ad_len; i++) {
+		buffer_size_max += bt_data_buf_size(&ad[i]);
+		scratchpad_size += SCRATCHPAD_ALIGN(sizeof(struct bt_data));
+		scratchpad_size += bt_data_sp_size(&ad[i]);
+	}
+	for (size_t i = 0; i < sd_len; i++) {
+		buffer_size_max += bt_data_buf_size(&sd[i]);
+		scratchpad_size += SCRATCHPAD_ALIGN(sizeof(struct bt_data));
+		scratchpad_size += bt_data_sp_size(&sd[i]);
+	}
+
+	err = bt_rpc_batch_call_begin(&call, buffer_size_max, &encoder);
+	if (err) {
+		return err;
+	}
+
+	ser_encode_uint(encoder, scratchpad_size);
+	ser_encode_uint(encoder, ad_len);
+
+	for (size_t i = 0; i < ad_len; i++) {
+		bt_data_enc(encoder, &ad[i]);
+	}
+
+	ser_encode_uint(encoder, sd_len);
+
+	for (size_t i = 0; i < sd_len; i++) {
+		bt_data_enc(encoder, &sd[i]);
+	}
+
+	return bt_rpc_batch_call_end();
+}
+#endif /* CONFIG_BT_RPC_BATCH */
+
 int bt_le_adv_stop(void)
 {
 	struct nrf_rpc_cbor_ctx ctx;
@@ -15,6 +15,8 @@
 #include "bluetooth/att.h"
 #include "bluetooth/gatt.h"
 
+#include "bt_rpc.h"
+#include "bt_rpc_batch_client.h"
 #include "bt_rpc_common.h"
 #include "bt_rpc_gatt_common.h"
 #include "serialize.h"
@@ -767,6 +769,42 @@ int bt_gatt_notify_cb(struct bt_conn *conn,
 	return result;
 }
 
+#if defined(CONFIG_BT_RPC_BATCH)
+int bt_rpc_batch_gatt_notify(struct bt_conn *conn, const struct bt_gatt_notify_params *params,
+			     bt_rpc_batch_result_cb_t cb, void *user_data)
+{
+	const struct bt_rpc_batch_call call = {
+		.op = BT_RPC_BATCH_OP_GATT_NOTIFY,
+		.cb = (uintptr_t)cb,
+		.user_data = (uintptr_t)user_data,
+	};
+	CborEncoder *encoder;
+	size_t scratchpad_size = 0;
+	size_t buffer_size_max = 8;
+	int err;
+
+	buffer_size_max += bt_gatt_notify_params_buf_size(params);
+	buffer_size_max += params->uuid ? bt_uuid_buf_size(params->uuid) : 0;
+
+	/* The host decodes the data in place from its copy of the batch,
+	 * only the UUID is copied.
+	 */
+	scratchpad_size += params->uuid ? SCRATCHPAD_ALIGN(bt_uuid_buf_size(params->uuid)) : 0;
+
+	err = bt_rpc_batch_call_begin(&call, buffer_size_max, &encoder);
+	if (err) {
+		return err;
+	}
+
+	ser_encode_uint(encoder, scratchpad_size);
+
+	bt_rpc_encode_bt_conn(encoder, conn);
+	bt_gatt_notify_params_enc(encoder, params);
+
+	return bt_rpc_batch_call_end();
+}
+#endif /* CONFIG_BT_RPC_BATCH */
+
 #if defined(CONFIG_BT_GATT_NOTIFY_MULTIPLE)
 int bt_gatt_notify_multiple(struct bt_conn *conn, uint16_t num_params,
 			    struct bt_gatt_notify_params *params)
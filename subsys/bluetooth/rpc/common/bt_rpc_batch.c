@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+
+#include "bt_rpc_batch.h"
+
+/* Size of the header and of the break byte of the array of calls */
+#define ARRAY_HEADER_SIZE 1
+#define BREAK_SIZE 1
+
+void bt_rpc_batch_init(struct bt_rpc_batch *batch, uint8_t *buf, size_t size, size_t max_calls)
+{
+	batch->buf = buf;
+	batch->size = size;
+	batch->count = 0;
+	batch->max_calls = max_calls;
+
+	cbor_buf_writer_init(&batch->writer, buf, size);
+	cbor_encoder_init(&batch->root, &batch->writer.enc, 0);
+	cbor_encoder_create_array(&batch->root, &batch->encoder, CborIndefiniteLength);
+}
+
+static size_t batch_len(const struct bt_rpc_batch *batch)
+{
+	return batch->writer.ptr - batch->buf;
+}
+
+size_t bt_rpc_batch_finish(struct bt_rpc_batch *batch)
+{
+	cbor_encoder_close_container(&batch->root, &batch->encoder);
+
+	return batch_len(batch);
+}
+
+int bt_rpc_batch_add(struct bt_rpc_batch *batch, const struct bt_rpc_batch_call *call,
+		     size_t args_size_max)
+{
+	size_t size_max = BT_RPC_BATCH_CALL_HEADER_SIZE + args_size_max + BREAK_SIZE;
+	CborError err;
+
+	if (size_max > batch->size - ARRAY_HEADER_SIZE) {
+		return -ENOMEM;
+	}
+
+	if ((batch->count >= batch->max_calls) ||
+	    (size_max > batch->size - batch_len(batch))) {
+		return -ENOSPC;
+	}
+
+	err = cbor_encode_uint(&batch->encoder, call->op);
+	if (err == CborNoError) {
+		err = cbor_encode_uint(&batch->encoder, call->cb);
+	}
+	if (err == CborNoError) {
+		err = cbor_encode_uint(&batch->encoder, call->user_data);
+	}
+	if (err != CborNoError) {
+		return -ENOMEM;
+	}
+
+	batch->count++;
+
+	return 0;
+}
+
+int bt_rpc_batch_decode_init(struct cbor_buf_reader *reader, CborParser *parser,
+			     CborValue *value, const uint8_t *buf, size_t len)
+{
+	CborValue array;
+
+	cbor_buf_reader_init(reader, buf, len);
+
+	if ((cbor_parser_init(&reader->r, 0, parser, &array) != CborNoError) ||
+	    !cbor_value_is_array(&array) ||
+	    (cbor_value_enter_container(&array, value) != CborNoError)) {
+		return -EBADMSG;
+	}
+
+	return 0;
+}
+
+static int decode_uint(CborValue *value, uint64_t *result)
+{
+	if (!cbor_value_is_unsigned_integer(value) ||
+	    (cbor_value_get_uint64(value, result) != CborNoError) ||
+	    (cbor_value_advance_fixed(value) != CborNoError)) {
+		return -EBADMSG;
+	}
+
+	return 0;
+}
+
+int bt_rpc_batch_call_decode(CborValue *value, struct bt_rpc_batch_call *call)
+{
+	uint64_t op;
+	uint64_t cb;
+	uint64_t user_data;
+
+	if (decode_uint(value, &op) || decode_uint(value, &cb) ||
+	    decode_uint(value, &user_data) || (op > UINT8_MAX)) {
+		return -EBADMSG;
+	}
+
+	call->op = op;
+	call->cb = cb;
+	call->user_data = user_data;
+
+	return 0;
+}
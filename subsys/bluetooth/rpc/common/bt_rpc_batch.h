@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/**
+ * @file
+ * @defgroup bt_rpc_batch Bluetooth RPC batch API
+ * @{
+ * @brief API for encoding and decoding batches of Bluetooth API calls.
+ *
+ * A batch is an indefinite length CBOR array of calls encoded into one buffer, which is
+ * sent to the host as a single byte string. Each call starts with a header, followed by
+ * the arguments of the call encoded in the same way as in the synchronous command.
+ */
+
+#ifndef BT_RPC_BATCH_H_
+#define BT_RPC_BATCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <tinycbor/cbor.h>
+#include <tinycbor/cbor_buf_reader.h>
+#include <tinycbor/cbor_buf_writer.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Maximum size of the encoded call header. */
+#define BT_RPC_BATCH_CALL_HEADER_SIZE (2 + 2 * (1 + sizeof(uintptr_t)))
+
+/** @brief Operations that can be batched. */
+enum bt_rpc_batch_op {
+	BT_RPC_BATCH_OP_GATT_NOTIFY,
+	BT_RPC_BATCH_OP_LE_ADV_UPDATE_DATA,
+};
+
+/** @brief Header of a batched call. */
+struct bt_rpc_batch_call {
+	/** Operation, one of @ref bt_rpc_batch_op. */
+	uint8_t op;
+
+	/** Client callback receiving the result, 0 if no result is needed. */
+	uintptr_t cb;
+
+	/** User data passed to the callback. */
+	uintptr_t user_data;
+};
+
+/** @brief Batch being encoded. */
+struct bt_rpc_batch {
+	/** Writer of the buffer. */
+	struct cbor_buf_writer writer;
+
+	/** Encoder of the whole buffer. */
+	CborEncoder root;
+
+	/** Encoder used to encode arguments of the last added call. */
+	CborEncoder encoder;
+
+	/** Buffer holding the batch. */
+	uint8_t *buf;
+
+	/** Buffer size. */
+	size_t size;
+
+	/** Number of calls in the batch. */
+	size_t count;
+
+	/** Maximum number of calls in the batch. */
+	size_t max_calls;
+};
+
+/** @brief Initialize an empty batch.
+ *
+ * @param[out] batch Batch.
+ * @param[in] buf Buffer for the encoded calls.
+ * @param[in] size Buffer size.
+ * @param[in] max_calls Maximum number of calls in the batch.
+ */
+void bt_rpc_batch_init(struct bt_rpc_batch *batch, uint8_t *buf, size_t size, size_t max_calls);
+
+/** @brief Finish encoding of the batch.
+ *
+ * No calls can be added to the batch afterwards.
+ *
+ * @param[in, out] batch Batch.
+ *
+ * @retval Length of the encoded batch.
+ */
+size_t bt_rpc_batch_finish(struct bt_rpc_batch *batch);
+
+/** @brief Add a call to the batch.
+ *
+ * Encodes the call header. On success, the arguments of the call must be encoded
+ * with the encoder of the batch, using no more than @p args_size_max bytes.
+ *
+ * @param[in, out] batch Batch.
+ * @param[in] call Call header.
+ * @param[in] args_size_max Maximum encoded size of the call arguments.
+ *
+ * @retval 0 If the call was added.
+ * @retval -ENOSPC If the batch is full. It must be sent and initialized again.
+ * @retval -ENOMEM If the call does not fit even into an empty batch.
+ */
+int bt_rpc_batch_add(struct bt_rpc_batch *batch, const struct bt_rpc_batch_call *call,
+		     size_t args_size_max);
+
+/** @brief Initialize decoding of a received batch.
+ *
+ * @param[out] reader Reader of the buffer.
+ * @param[out] parser Parser.
+ * @param[out] value Value used to decode the calls.
+ * @param[in] buf Encoded batch.
+ * @param[in] len Length of the encoded batch.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int bt_rpc_batch_decode_init(struct cbor_buf_reader *reader, CborParser *parser,
+			     CborValue *value, const uint8_t *buf, size_t len);
+
+/** @brief Decode the header of the next call in a batch.
+ *
+ * On success, the arguments of the call must be decoded from @p value.
+ *
+ * @param[in, out] value Value used to decode the calls.
+ * @param[out] call Call header.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EBADMSG If the header could not be decoded.
+ */
+int bt_rpc_batch_call_decode(CborValue *value, struct bt_rpc_batch_call *call);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* BT_RPC_BATCH_H_ */
@@ -225,7 +225,7 @@ static const CHECK_LIST_ENTRY_TYPE check_table[] = {
 		CONFIG_BT_SETTINGS,
 		CONFIG_BT_GATT_CLIENT,
 		CONFIG_BT_INTERNAL_FUNCTIONS,
-		0,
+		CONFIG_BT_RPC_BATCH,
 		0,
 		0,
 		0,
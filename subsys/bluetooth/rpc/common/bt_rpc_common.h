@@ -197,6 +197,18 @@ enum bt_rpc_cmd_from_host_to_cli {
 enum bt_rpc_evt_from_host_to_cli {
 	/* bluetooth.h API */
 	BT_READY_CB_T_CALLBACK_RPC_EVT,
+	/* bt_rpc.h API */
+	BT_RPC_BATCH_RESULTS_RPC_EVT,
+};
+
+/** @brief Client events IDs used in bluetooth API serialization.
+ *         Those events are sent from the client to the host. They follow
+ *         the host events, so that the client and the host can share one
+ *         nRF RPC instance, for example over the loopback transport.
+ */
+enum bt_rpc_evt_from_cli_to_host {
+	/* bt_rpc.h API */
+	BT_RPC_BATCH_RPC_EVT = BT_RPC_BATCH_RESULTS_RPC_EVT + 1,
 };
 
 /** @brief Pairing flags IDs. Those flags are used to setup valid callback sets on
@@ -277,4 +289,14 @@ struct bt_conn *bt_rpc_decode_bt_conn(CborValue *value);
 CBKPROXY_HANDLER_DECL(bt_gatt_complete_func_t_encoder,
 		 (struct bt_conn *conn, void *user_data), (conn, user_data));
 
+#if defined(CONFIG_BT_RPC_BATCH)
+/** @brief Decode and execute a batched @ref bt_le_adv_update_data call.
+ *
+ * @param[in] value Cbor Value to decode the call arguments from.
+ *
+ * @retval Result of the call.
+ */
+int bt_rpc_batch_le_adv_update_data_exec(CborValue *value);
+#endif
+
 #endif /* BT_RPC_COMMON_H_ */
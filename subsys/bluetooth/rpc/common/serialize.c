@@ -5,6 +5,7 @@
  */
 
 #include <nrf_rpc_cbor.h>
+#include <tinycbor/cbor_buf_reader.h>
 
 #include "cbkproxy.h"
 #include "serialize.h"
@@ -507,6 +508,58 @@ error_exit:
 	return NULL;
 }
 
+const void *ser_decode_buffer_in_place(CborValue *value)
+{
+	CborError err = CborErrorIllegalType;
+	const struct cbor_buf_reader *reader;
+	const void *result;
+	size_t len;
+
+	if (is_decoder_invalid(value)) {
+		return NULL;
+	}
+
+	if (cbor_value_is_byte_string(value)) {
+		/* Chunks of an indefinite length string are not contiguous */
+		if (!cbor_value_is_length_known(value)) {
+			err = CborErrorUnknownLength;
+			goto error_exit;
+		}
+
+		err = cbor_value_get_string_length(value, &len);
+		if (err != CborNoError) {
+			goto error_exit;
+		}
+
+		err = cbor_value_advance(value);
+		if (err != CborNoError) {
+			goto error_exit;
+		}
+
+		/* The stream is parsed with the buffer reader, the string data
+		 * directly precedes the next value.
+		 */
+		reader = CONTAINER_OF(value->parser->d, struct cbor_buf_reader, r);
+		result = reader->buffer + value->offset - len;
+
+	} else if (cbor_value_is_null(value)) {
+		err = cbor_value_advance_fixed(value);
+		if (err != CborNoError) {
+			goto error_exit;
+		}
+
+		result = NULL;
+	} else {
+		goto error_exit;
+	}
+
+	return result;
+
+error_exit:
+	ser_decoder_invalid(value, err);
+	return NULL;
+}
+
 void *ser_decode_callback_call(CborValue *value)
 {
 	int slot = ser_decode_uint(value);
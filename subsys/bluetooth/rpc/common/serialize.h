@@ -258,6 +258,20 @@ size_t ser_decode_buffer_size(CborValue *value);
  */
 void *ser_decode_buffer_into_scratchpad(struct ser_scratchpad *scratchpad);
 
+/** @brief Decode a buffer without copying it.
+ *
+ * The CBOR stream must be parsed with the tinycbor buffer reader, and the buffer must be
+ * a definite length byte string. The returned pointer references the data in the parsed
+ * buffer, so it is valid only as long as that buffer. It must not be used for the data of
+ * a received nRF RPC packet, which has to be released before calling the Bluetooth API.
+ * Use @ref ser_decode_buffer_size to get the buffer size.
+ *
+ * @param[in] value Value parsed from the CBOR stream.
+ *
+ * @retval Pointer to the buffer data in the parsed buffer.
+ */
+const void *ser_decode_buffer_in_place(CborValue *value);
+
 /** @brief Decode a callback.
  *
  * This function will use callback proxy module to associate decoded integer
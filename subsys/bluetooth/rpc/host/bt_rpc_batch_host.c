@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Host side of the batched bluetooth API calls over nRF RPC.
+ */
+
+#include <zephyr.h>
+
+#include <bluetooth/gatt.h>
+
+#include <nrf_rpc_cbor.h>
+
+#include "bt_rpc_batch.h"
+#include "bt_rpc_common.h"
+#include "bt_rpc_gatt_common.h"
+#include "serialize.h"
+
+#include <logging/log.h>
+
+LOG_MODULE_DECLARE(BT_RPC, CONFIG_BT_RPC_LOG_LEVEL);
+
+struct batch_result {
+	uintptr_t cb;
+	uintptr_t user_data;
+	int result;
+};
+
+/* Received batch, kept while its calls are executed */
+static uint8_t batch_buf[CONFIG_BT_RPC_BATCH_BUFFER_SIZE];
+static K_MUTEX_DEFINE(batch_mutex);
+
+static void report_decoding_error(uint8_t cmd_evt_id, void *data)
+{
+	nrf_rpc_err(-EBADMSG, NRF_RPC_ERR_SRC_RECV, &bt_rpc_grp, cmd_evt_id,
+		    NRF_RPC_PACKET_TYPE_EVT);
+}
+
+#if defined(CONFIG_BT_CONN)
+static int batch_gatt_notify_exec(CborValue *value)
+{
+	struct bt_conn *conn;
+	struct bt_gatt_notify_params params;
+	struct ser_scratchpad scratchpad;
+
+	SER_SCRATCHPAD_DECLARE(&scratchpad, value);
+
+	conn = bt_rpc_decode_bt_conn(value);
+
+	/* The data is referenced in the copy of the batch, only the UUID is copied */
+	params.attr = bt_rpc_decode_gatt_attr(value);
+	params.len = ser_decode_uint(value);
+	params.data = ser_decode_buffer_in_place(value);
+	params.func = (bt_gatt_complete_func_t)ser_decode_callback(value,
+								  bt_gatt_complete_func_t_encoder);
+	params.user_data = (void *)(uintptr_t)ser_decode_uint(value);
+	params.uuid = (struct bt_uuid *)ser_decode_buffer_into_scratchpad(&scratchpad);
+
+	if (!ser_decode_valid(value)) {
+		return -EBADMSG;
+	}
+
+	return bt_gatt_notify_cb(conn, &params);
+}
+#endif /* defined(CONFIG_BT_CONN) */
+
+static int batch_call_exec(CborValue *value, uint8_t op)
+{
+	switch (op) {
+#if defined(CONFIG_BT_CONN)
+	case BT_RPC_BATCH_OP_GATT_NOTIFY:
+		return batch_gatt_notify_exec(value);
+#endif /* defined(CONFIG_BT_CONN) */
+
+	case BT_RPC_BATCH_OP_LE_ADV_UPDATE_DATA:
+		return bt_rpc_batch_le_adv_update_data_exec(value);
+
+	default:
+		/* The arguments of an unknown call can not be skipped */
+		ser_decoder_invalid(value, CborErrorIllegalType);
+		return -ENOTSUP;
+	}
+}
+
+static void batch_results_send(const struct batch_result *results, size_t count)
+{
+	struct nrf_rpc_cbor_ctx ctx;
+	size_t buffer_size_max = 5;
+
+	buffer_size_max += count * 15;
+
+	NRF_RPC_CBOR_ALLOC(ctx, buffer_size_max);
+
+	ser_encode_uint(&ctx.encoder, count);
+
+	for (size_t i = 0; i < count; i++) {
+		ser_encode_uint(&ctx.encoder, results[i].cb);
+		ser_encode_uint(&ctx.encoder, results[i].user_data);
+		ser_encode_int(&ctx.encoder, results[i].result);
+	}
+
+	nrf_rpc_cbor_evt_no_err(&bt_rpc_grp, BT_RPC_BATCH_RESULTS_RPC_EVT, &ctx);
+}
+
+static void bt_rpc_batch_rpc_handler(CborValue *value, void *handler_data)
+{
+	struct batch_result results[CONFIG_BT_RPC_BATCH_MAX_CALLS];
+	struct bt_rpc_batch_call call;
+	size_t num_results = 0;
+	struct cbor_buf_reader reader;
+	CborParser parser;
+	CborValue calls;
+	size_t count;
+	size_t len;
+	size_t i;
+	int result;
+
+	k_mutex_lock(&batch_mutex, K_FOREVER);
+
+	count = ser_decode_uint(value);
+	len = ser_decode_buffer_size(value);
+	ser_decode_buffer(value, batch_buf, sizeof(batch_buf));
+
+	if (!ser_decoding_done_and_check(value) ||
+	    (count > CONFIG_BT_RPC_BATCH_MAX_CALLS) ||
+	    bt_rpc_batch_decode_init(&reader, &parser, &calls, batch_buf, len)) {
+		k_mutex_unlock(&batch_mutex);
+		goto decoding_error;
+	}
+
+	for (i = 0; i < count; i++) {
+		if (bt_rpc_batch_call_decode(&calls, &call)) {
+			break;
+		}
+
+		result = batch_call_exec(&calls, call.op);
+		if (!ser_decode_valid(&calls)) {
+			break;
+		}
+
+		if (call.cb) {
+			results[num_results].cb = call.cb;
+			results[num_results].user_data = call.user_data;
+			results[num_results].result = result;
+			num_results++;
+		}
+	}
+
+	k_mutex_unlock(&batch_mutex);
+
+	/* Results of the executed calls are delivered even if the batch is broken */
+	if (num_results > 0) {
+		batch_results_send(results, num_results);
+	}
+
+	if (i < count) {
+		LOG_ERR("Decoding call %u of %u in batch failed", i, count);
+		goto decoding_error;
+	}
+
+	return;
+decoding_error:
+	report_decoding_error(BT_RPC_BATCH_RPC_EVT, handler_data);
+}
+
+NRF_RPC_CBOR_EVT_DECODER(bt_rpc_grp, bt_rpc_batch, BT_RPC_BATCH_RPC_EVT,
+			 bt_rpc_batch_rpc_handler, NULL);
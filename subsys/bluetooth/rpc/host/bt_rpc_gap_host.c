@@ -516,6 +516,46 @@ decoding_error:
 NRF_RPC_CBOR_CMD_DECODER(bt_rpc_grp, bt_le_adv_update_data, BT_LE_ADV_UPDATE_DATA_RPC_CMD,
 			 bt_le_adv_update_data_rpc_handler, NULL);
 
+#if defined(CONFIG_BT_RPC_BATCH)
+int bt_rpc_batch_le_adv_update_data_exec(CborValue *value)
+{
+	size_t ad_len;
+	struct bt_data *ad;
+	size_t sd_len;
+	struct bt_data *sd;
+	struct ser_scratchpad scratchpad;
+
+	SER_SCRATCHPAD_DECLARE(&scratchpad, value);
+
+	ad_len = ser_decode_uint(value);
+	ad = ser_scratchpad_add(&scratchpad, ad_len * sizeof(struct bt_data));
+	if (ad == NULL) {
+		ser_decoder_invalid(value, CborErrorIO);
+		return -EBADMSG;
+	}
+
+	for (size_t i = 0; i < ad_len; i++) {
+		bt_data_dec(&scratchpad, &ad[i]);
+	}
+	sd_len = ser_decode_uint(value);
+	sd = ser_scratchpad_add(&scratchpad, sd_len * sizeof(struct bt_data));
+	if (sd == NULL) {
+		ser_decoder_invalid(value, CborErrorIO);
+		return -EBADMSG;
+	}
+
+	for (size_t i = 0; i < sd_len; i++) {
+		bt_data_dec(&scratchpad, &sd[i]);
+	}
+
+	if (!ser_decode_valid(value)) {
+		return -EBADMSG;
+	}
+
+	return bt_le_adv_update_data(ad, ad_len, sd, sd_len);
+}
+#endif /* CONFIG_BT_RPC_BATCH */
+
 static void bt_le_adv_stop_rpc_handler(CborValue *value, void *handler_data)
 {
 	int result;
@@ -7,6 +7,7 @@
 #ifndef BT_RPC_H_
 #define BT_RPC_H_
 
+#include "bluetooth/bluetooth.h"
 #include "bluetooth/gatt.h"
 
 /**
@@ -58,6 +59,61 @@ int bt_rpc_gatt_subscribe_flag_clear(struct bt_gatt_subscribe_params *params, ui
  */
 int bt_rpc_gatt_subscribe_flag_get(struct bt_gatt_subscribe_params *params, uint32_t flags_bit);
 
+/** @brief Callback for the result of a batched call.
+ *
+ * The callback is called from the nRF RPC thread that received the results of the batch.
+ *
+ * @param result    Value returned by the function on the host.
+ * @param user_data User data passed when the call was queued.
+ */
+typedef void (*bt_rpc_batch_result_cb_t)(int result, void *user_data);
+
+/** @brief Queue a @ref bt_gatt_notify_cb call in the batch.
+ *
+ * The notification data is copied into the batch, so the parameters can be reused
+ * as soon as this function returns. The batch is sent to the host when it is full,
+ * when the @kconfig{CONFIG_BT_RPC_BATCH_FLUSH_TIMEOUT_MS} timeout expires, or when
+ * @ref bt_rpc_batch_flush is called.
+ *
+ * @param conn      Connection object, or NULL to notify all connected peers.
+ * @param params    Notification parameters.
+ * @param cb        Callback for the result of the call, can be NULL.
+ * @param user_data User data passed to the callback.
+ *
+ * @retval 0 If the call was queued.
+ * @retval -ENOMEM If the call does not fit into the batch buffer.
+ *         Otherwise, a (negative) error code returned when sending the full batch.
+ */
+int bt_rpc_batch_gatt_notify(struct bt_conn *conn, const struct bt_gatt_notify_params *params,
+			     bt_rpc_batch_result_cb_t cb, void *user_data);
+
+/** @brief Queue a @ref bt_le_adv_update_data call in the batch.
+ *
+ * The advertising data is copied into the batch, so it can be reused as soon as this
+ * function returns.
+ *
+ * @param ad        Data to be used in advertisement packets.
+ * @param ad_len    Number of elements in ad.
+ * @param sd        Data to be used in scan response packets.
+ * @param sd_len    Number of elements in sd.
+ * @param cb        Callback for the result of the call, can be NULL.
+ * @param user_data User data passed to the callback.
+ *
+ * @retval 0 If the call was queued.
+ * @retval -ENOMEM If the call does not fit into the batch buffer.
+ *         Otherwise, a (negative) error code returned when sending the full batch.
+ */
+int bt_rpc_batch_le_adv_update_data(const struct bt_data *ad, size_t ad_len,
+				    const struct bt_data *sd, size_t sd_len,
+				    bt_rpc_batch_result_cb_t cb, void *user_data);
+
+/** @brief Send the queued calls to the host.
+ *
+ * @retval 0 If the batch was sent or if it was empty.
+ *         Otherwise, a (negative) error code is returned.
+ */
+int bt_rpc_batch_flush(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -6,6 +6,7 @@
 
 #include <zephyr.h>
 #include <sys/byteorder.h>
+#include <sys/math_extras.h>
 #include <string.h>
 #include <bluetooth/scan.h>
 
@@ -18,6 +19,28 @@ LOG_MODULE_REGISTER(nrf_bt_scan, CONFIG_BT_SCAN_LOG_LEVEL);
 	BT_SCAN_SHORT_NAME_FILTER | BT_SCAN_APPEARANCE_FILTER | \
 	BT_SCAN_UUID_FILTER | BT_SCAN_MANUFACTURER_DATA_FILTER)
 
+/* Number of slots in the address and UUID hash sets. At least half of
+ * the slots are always empty, which keeps the probe sequences short.
+ */
+#define ADDR_HASH_SIZE MAX(1, 2 * CONFIG_BT_SCAN_ADDRESS_CNT)
+#define UUID_HASH_SIZE MAX(1, 2 * CONFIG_BT_SCAN_UUID_CNT)
+
+/* Number of nodes in the name tries. The names are added to the trie
+ * with their terminating null character, because it can be advertised.
+ */
+#define NAME_TRIE_SIZE \
+	(1 + CONFIG_BT_SCAN_NAME_CNT * (CONFIG_BT_SCAN_NAME_MAX_LEN + 1))
+#define SHORT_NAME_TRIE_SIZE \
+	(1 + CONFIG_BT_SCAN_SHORT_NAME_CNT * \
+	 (CONFIG_BT_SCAN_SHORT_NAME_MAX_LEN + 1))
+
+/* Filters of the name, short name and UUID types are matched as bitmasks. */
+BUILD_ASSERT(CONFIG_BT_SCAN_NAME_CNT <= 32);
+BUILD_ASSERT(CONFIG_BT_SCAN_SHORT_NAME_CNT <= 32);
+BUILD_ASSERT(CONFIG_BT_SCAN_UUID_CNT <= 32);
+BUILD_ASSERT(NAME_TRIE_SIZE <= UINT16_MAX);
+BUILD_ASSERT(SHORT_NAME_TRIE_SIZE <= UINT16_MAX);
+
 /* Scan filter mutex. */
 K_MUTEX_DEFINE(scan_mutex);
 
@@ -25,14 +48,8 @@ K_MUTEX_DEFINE(scan_mutex);
  * compare matching filters, their mode and event generation.
  */
 struct bt_scan_control {
-	/* Number of active filters. */
-	uint8_t filter_cnt;
-
-	/* Number of matched filters. */
-	uint8_t filter_match_cnt;
-
-	/* Indicates whether at least one filter has been fitted. */
-	bool filter_match;
+	/* Types of the matched filters. */
+	uint8_t filter_match_mask;
 
 	/* Indicates in which mode filters operate. */
 	bool all_mode;
@@ -47,6 +64,25 @@ struct bt_scan_control {
 	struct bt_scan_filter_match filter_status;
 };
 
+/* Node of a name trie. The root node has index 0, so index 0 is also
+ * used to mark the end of the child and sibling lists.
+ */
+struct name_trie_node {
+	/* Filters whose names continue with this node. */
+	uint32_t mask;
+
+	/* Index of the first child node. */
+	uint16_t child;
+
+	/* Index of the next sibling node. */
+	uint16_t next;
+
+	/* Character of the name. Unsigned, as the advertised names are
+	 * compared as bytes.
+	 */
+	uint8_t c;
+};
+
 /* Name filter structure.
  */
 struct bt_scan_name_filter {
@@ -55,6 +91,12 @@ struct bt_scan_name_filter {
 	 */
 	char target_name[CONFIG_BT_SCAN_NAME_CNT][CONFIG_BT_SCAN_NAME_MAX_LEN];
 
+	/* Trie of the names. */
+	struct name_trie_node trie[NAME_TRIE_SIZE];
+
+	/* Number of used trie nodes, without the root node. */
+	uint16_t trie_cnt;
+
 	/* Name filter counter. */
 	uint8_t cnt;
 
@@ -76,6 +118,12 @@ struct bt_scan_short_name_filter {
 		uint8_t min_len;
 	} name[CONFIG_BT_SCAN_SHORT_NAME_CNT];
 
+	/* Trie of the short names. */
+	struct name_trie_node trie[SHORT_NAME_TRIE_SIZE];
+
+	/* Number of used trie nodes, without the root node. */
+	uint16_t trie_cnt;
+
 	/* Short name filter counter. */
 	uint8_t cnt;
 
@@ -89,6 +137,11 @@ struct bt_scan_addr_filter {
 	/* Addresses advertised by the peripherals. */
 	bt_addr_le_t target_addr[CONFIG_BT_SCAN_ADDRESS_CNT];
 
+	/* Hash set of the addresses. Each slot holds the index of
+	 * the address increased by one, or 0 if the slot is empty.
+	 */
+	uint8_t slot[ADDR_HASH_SIZE];
+
 	/* Address filter counter. */
 	uint8_t cnt;
 
@@ -112,6 +165,22 @@ struct bt_scan_uuid {
 	} uuid_data;
 };
 
+/* UUID in the form used for matching. UUIDs derived from the Bluetooth
+ * Base UUID are compared by their 32-bit value, because bt_uuid_cmp()
+ * treats the 16-bit, 32-bit and 128-bit forms of such UUIDs as equal.
+ */
+struct bt_scan_uuid_key {
+	/* 32-bit value of the UUID. For other 128-bit UUIDs, it is
+	 * only used as the hash key.
+	 */
+	uint32_t val;
+
+	/* 128-bit value of the UUID, or NULL if the UUID is derived
+	 * from the Bluetooth Base UUID.
+	 */
+	const uint8_t *val_128;
+};
+
 /* UUIDs filter structure.
  */
 struct bt_scan_uuid_filter {
@@ -120,6 +189,14 @@ struct bt_scan_uuid_filter {
 	 */
 	struct bt_scan_uuid uuid[CONFIG_BT_SCAN_UUID_CNT];
 
+	/* Keys of the UUIDs. */
+	struct bt_scan_uuid_key key[CONFIG_BT_SCAN_UUID_CNT];
+
+	/* Hash set of the UUIDs. Each slot holds the index of
+	 * the UUID increased by one, or 0 if the slot is empty.
+	 */
+	uint8_t slot[UUID_HASH_SIZE];
+
 	/* UUID filter counter. */
 	uint8_t cnt;
 
@@ -194,6 +271,9 @@ struct bt_scan_filters {
 	 * matched to generate an event.
 	 */
 	bool all_mode;
+
+	/* Types of the enabled filters. */
+	uint8_t enabled_mask;
 };
 
 #if CONFIG_BT_SCAN_CONN_ATTEMPTS_FILTER
@@ -501,22 +581,67 @@ static void scan_connect_with_target(struct bt_scan_control *control,
 	}
 }
 
-static bool adv_addr_compare(const bt_addr_le_t *target_addr,
-			     struct bt_scan_control *control)
+static uint32_t hash_u32(uint32_t key)
 {
-	const bt_addr_le_t *addr =
-			bt_scan.scan_filters.addr.target_addr;
-	uint8_t counter = bt_scan.scan_filters.addr.cnt;
+	/* Multiplicative hash, the upper bits are the best mixed. */
+	return (key * 2654435761U) >> 16;
+}
 
-	for (size_t i = 0; i < counter; i++) {
-		if (bt_addr_le_cmp(target_addr, &addr[i]) == 0) {
-			control->filter_status.addr.addr = &addr[i];
+static size_t addr_hash(const bt_addr_le_t *addr)
+{
+	uint32_t key = sys_get_le32(&addr->a.val[0]) ^
+		       ((uint32_t)sys_get_le16(&addr->a.val[4]) << 8) ^
+		       addr->type;
 
-			return true;
+	return hash_u32(key) % ADDR_HASH_SIZE;
+}
+
+static int addr_filter_find(const bt_addr_le_t *target_addr)
+{
+	const struct bt_scan_addr_filter *addr_filter =
+			&bt_scan.scan_filters.addr;
+	size_t i = addr_hash(target_addr);
+
+	/* There is always an empty slot that ends the search. */
+	while (addr_filter->slot[i]) {
+		uint8_t idx = addr_filter->slot[i] - 1;
+
+		if (bt_addr_le_cmp(target_addr,
+				   &addr_filter->target_addr[idx]) == 0) {
+			return idx;
 		}
+
+		i = (i + 1) % ADDR_HASH_SIZE;
 	}
 
-	return false;
+	return -ENOENT;
+}
+
+static void addr_filter_slot_set(const bt_addr_le_t *target_addr, uint8_t idx)
+{
+	struct bt_scan_addr_filter *addr_filter = &bt_scan.scan_filters.addr;
+	size_t i = addr_hash(target_addr);
+
+	while (addr_filter->slot[i]) {
+		i = (i + 1) % ADDR_HASH_SIZE;
+	}
+
+	addr_filter->slot[i] = idx + 1;
+}
+
+static bool adv_addr_compare(const bt_addr_le_t *target_addr,
+			     struct bt_scan_control *control)
+{
+	int idx = addr_filter_find(target_addr);
+
+	if (idx < 0) {
+		return false;
+	}
+
+	control->filter_status.addr.addr =
+		&bt_scan.scan_filters.addr.target_addr[idx];
+
+	return true;
 }
 
 static bool is_addr_filter_enabled(void)
@@ -529,11 +654,10 @@ static void check_addr(struct bt_scan_control *control,
 {
 	if (is_addr_filter_enabled()) {
 		if (adv_addr_compare(addr, control)) {
-			control->filter_match_cnt++;
+			control->filter_match_mask |= BT_SCAN_ADDR_FILTER;
 
 			/* Information about the filters matched. */
 			control->filter_status.addr.match = true;
-			control->filter_match = true;
 		}
 	}
 }
@@ -551,14 +675,13 @@ static int scan_addr_filter_add(const bt_addr_le_t *target_addr)
 	}
 
 	/* Check for duplicated filter. */
-	for (size_t i = 0; i < counter; i++) {
-		if (bt_addr_le_cmp(target_addr, &addr_filter[i]) == 0) {
-			return 0;
-		}
+	if (addr_filter_find(target_addr) >= 0) {
+		return 0;
 	}
 
 	/* Add target address to filter. */
 	bt_addr_le_copy(&addr_filter[counter], target_addr);
+	addr_filter_slot_set(target_addr, counter);
 
 	LOG_DBG("Filter set on address type %i",
 		addr_filter[counter].type);
@@ -573,11 +696,64 @@ static int scan_addr_filter_add(const bt_addr_le_t *target_addr)
 	return 0;
 }
 
-static bool adv_name_cmp(const uint8_t *data,
-			 uint8_t data_len,
-			 const char *target_name)
+static void name_trie_add(struct name_trie_node *trie, uint16_t *trie_cnt,
+			  const char *name, size_t name_len, uint8_t idx)
 {
-	return strncmp(target_name, data, data_len) == 0;
+	uint16_t node = 0;
+
+	trie[node].mask |= BIT(idx);
+
+	for (size_t i = 0; i <= name_len; i++) {
+		uint8_t c = (i < name_len) ? (uint8_t)name[i] : '\0';
+		uint16_t child = trie[node].child;
+
+		while (child && (trie[child].c != c)) {
+			child = trie[child].next;
+		}
+
+		if (!child) {
+			child = ++(*trie_cnt);
+
+			trie[child].c = c;
+			trie[child].mask = 0;
+			trie[child].child = 0;
+			trie[child].next = trie[node].child;
+			trie[node].child = child;
+		}
+
+		trie[child].mask |= BIT(idx);
+		node = child;
+	}
+}
+
+/* Get the filters whose names start with the advertised name. The names
+ * are compared in the same way as by strncmp() limited to the advertised
+ * name length.
+ */
+static uint32_t name_trie_match(const struct name_trie_node *trie,
+				const uint8_t *data, uint8_t data_len)
+{
+	uint16_t node = 0;
+
+	for (size_t i = 0; i < data_len; i++) {
+		uint16_t child = trie[node].child;
+
+		while (child && (trie[child].c != data[i])) {
+			child = trie[child].next;
+		}
+
+		if (!child) {
+			return 0;
+		}
+
+		node = child;
+
+		if (data[i] == '\0') {
+			break;
+		}
+	}
+
+	return trie[node].mask;
 }
 
 static bool adv_name_compare(const struct bt_data *data,
@@ -585,24 +761,23 @@ static bool adv_name_compare(const struct bt_data *data,
 {
 	struct bt_scan_name_filter const *name_filter =
 			&bt_scan.scan_filters.name;
-	uint8_t counter = bt_scan.scan_filters.name.cnt;
 	uint8_t data_len = data->data_len;
+	uint32_t match;
+	size_t i;
 
 	/* Compare the name found with the name filter. */
-	for (size_t i = 0; i < counter; i++) {
-		if (adv_name_cmp(data->data,
-				 data_len,
-				 name_filter->target_name[i])) {
+	match = name_trie_match(name_filter->trie, data->data, data_len);
+	if (!match) {
+		return false;
+	}
 
-			control->filter_status.name.name =
-				name_filter->target_name[i];
-			control->filter_status.name.len = data_len;
+	/* Report the first matching filter. */
+	i = u32_count_trailing_zeros(match);
 
-			return true;
-		}
-	}
+	control->filter_status.name.name = name_filter->target_name[i];
+	control->filter_status.name.len = data_len;
 
-	return false;
+	return true;
 }
 
 static inline bool is_name_filter_enabled(void)
@@ -615,11 +790,10 @@ static void name_check(struct bt_scan_control *control,
 {
 	if (is_name_filter_enabled()) {
 		if (adv_name_compare(data, control)) {
-			control->filter_match_cnt++;
+			control->filter_match_mask |= BT_SCAN_NAME_FILTER;
 
 			/* Information about the filters matched. */
 			control->filter_status.name.match = true;
-			control->filter_match = true;
 		}
 	}
 }
@@ -651,6 +825,9 @@ static int scan_name_filter_add(const char *name)
 	/* Add name to filter. */
 	memcpy(bt_scan.scan_filters.name.target_name[counter],
 	       name, name_len);
+	name_trie_add(bt_scan.scan_filters.name.trie,
+		      &bt_scan.scan_filters.name.trie_cnt,
+		      name, name_len, counter);
 
 	bt_scan.scan_filters.name.cnt++;
 
@@ -659,40 +836,30 @@ static int scan_name_filter_add(const char *name)
 	return 0;
 }
 
-static bool adv_short_name_cmp(const uint8_t *data,
-			       uint8_t data_len,
-			       const char *target_name,
-			       uint8_t short_name_min_len)
-{
-	if ((data_len >= short_name_min_len) &&
-	    (strncmp(target_name, data, data_len) == 0)) {
-		return true;
-	}
-
-	return false;
-}
-
 static bool adv_short_name_compare(const struct bt_data *data,
 				   struct bt_scan_control *control)
 {
 	const struct bt_scan_short_name_filter *name_filter =
 			&bt_scan.scan_filters.short_name;
-	uint8_t counter = bt_scan.scan_filters.short_name.cnt;
 	uint8_t data_len = data->data_len;
+	uint32_t match;
 
 	/* Compare the name found with the name filters. */
-	for (size_t i = 0; i < counter; i++) {
-		if (adv_short_name_cmp(data->data,
-				       data_len,
-				       name_filter->name[i].target_name,
-				       name_filter->name[i].min_len)) {
+	match = name_trie_match(name_filter->trie, data->data, data_len);
+
+	/* Report the first matching filter that accepts the name length. */
+	while (match) {
+		size_t i = u32_count_trailing_zeros(match);
 
+		if (data_len >= name_filter->name[i].min_len) {
 			control->filter_status.short_name.name =
 				name_filter->name[i].target_name;
 			control->filter_status.short_name.len = data_len;
 
 			return true;
 		}
+
+		match &= match - 1;
 	}
 
 	return false;
@@ -708,11 +875,10 @@ static void short_name_check(struct bt_scan_control *control,
 {
 	if (is_short_name_filter_enabled()) {
 		if (adv_short_name_compare(data, control)) {
-			control->filter_match_cnt++;
+			control->filter_match_mask |= BT_SCAN_SHORT_NAME_FILTER;
 
 			/* Information about the filters matched. */
 			control->filter_status.short_name.match = true;
-			control->filter_match = true;
 		}
 	}
 }
@@ -751,6 +917,8 @@ static int scan_short_name_filter_add(const struct bt_scan_short_name *short_nam
 	memcpy(short_name_filter->name[counter].target_name,
 	       short_name->name,
 	       name_len);
+	name_trie_add(short_name_filter->trie, &short_name_filter->trie_cnt,
+		      short_name->name, name_len, counter);
 
 	bt_scan.scan_filters.short_name.cnt++;
 
@@ -759,43 +927,88 @@ static int scan_short_name_filter_add(const struct bt_scan_short_name *short_nam
 	return 0;
 }
 
-static bool find_uuid(const uint8_t *data,
-		      uint8_t data_len,
-		      uint8_t uuid_type,
-		      const struct bt_scan_uuid *target_uuid)
+static void uuid_key_get(struct bt_scan_uuid_key *key, const uint8_t *data,
+			 uint8_t uuid_len)
 {
-	uint8_t uuid_len;
-
-	switch (uuid_type) {
-	case BT_UUID_TYPE_16:
-		uuid_len = sizeof(uint16_t);
+	/* Bluetooth Base UUID, without the 32-bit value in the last bytes. */
+	static const uint8_t uuid_base[] = {
+		BT_UUID_128_ENCODE(0x00000000, 0x0000, 0x1000, 0x8000,
+				   0x00805F9B34FB)
+	};
+
+	switch (uuid_len) {
+	case sizeof(uint16_t):
+		key->val = sys_get_le16(data);
+		key->val_128 = NULL;
 		break;
 
-	case BT_UUID_TYPE_32:
-		uuid_len = sizeof(uint32_t);
+	case sizeof(uint32_t):
+		key->val = sys_get_le32(data);
+		key->val_128 = NULL;
 		break;
 
-	case BT_UUID_TYPE_128:
-		uuid_len = BT_SCAN_UUID_128_SIZE * sizeof(uint8_t);
+	default:
+		key->val = sys_get_le32(&data[BT_SCAN_UUID_128_SIZE - sizeof(uint32_t)]);
+
+		if (memcmp(data, uuid_base,
+			   BT_SCAN_UUID_128_SIZE - sizeof(uint32_t)) == 0) {
+			key->val_128 = NULL;
+		} else {
+			key->val ^= sys_get_le32(data);
+			key->val_128 = data;
+		}
 		break;
+	}
+}
 
-	default:
+static bool uuid_key_cmp(const struct bt_scan_uuid_key *key1,
+			 const struct bt_scan_uuid_key *key2)
+{
+	if ((key1->val != key2->val) || (!key1->val_128 != !key2->val_128)) {
 		return false;
 	}
 
-	for (size_t i = 0; i < data_len; i += uuid_len) {
-		struct bt_uuid_128 uuid;
+	return !key1->val_128 ||
+	       (memcmp(key1->val_128, key2->val_128, BT_SCAN_UUID_128_SIZE) == 0);
+}
 
-		if (!bt_uuid_create(&uuid.uuid, &data[i], uuid_len)) {
-			return false;
+static int uuid_filter_find(const struct bt_scan_uuid_key *key)
+{
+	const struct bt_scan_uuid_filter *uuid_filter =
+			&bt_scan.scan_filters.uuid;
+	size_t i = hash_u32(key->val) % UUID_HASH_SIZE;
+
+	/* There is always an empty slot that ends the search. */
+	while (uuid_filter->slot[i]) {
+		uint8_t idx = uuid_filter->slot[i] - 1;
+
+		if (uuid_key_cmp(key, &uuid_filter->key[idx])) {
+			return idx;
 		}
 
-		if (bt_uuid_cmp(&uuid.uuid, target_uuid->uuid) == 0) {
-			return true;
+		i = (i + 1) % UUID_HASH_SIZE;
+	}
+
+	return -ENOENT;
+}
+
+static uint32_t find_uuids(const uint8_t *data, uint8_t data_len,
+			   uint8_t uuid_len)
+{
+	struct bt_scan_uuid_key key;
+	uint32_t found = 0;
+	int idx;
+
+	for (size_t i = 0; i + uuid_len <= data_len; i += uuid_len) {
+		uuid_key_get(&key, &data[i], uuid_len);
+
+		idx = uuid_filter_find(&key);
+		if (idx >= 0) {
+			found |= BIT(idx);
 		}
 	}
 
-	return false;
+	return found;
 }
 
 static bool adv_uuid_compare(const struct bt_data *data, uint8_t uuid_type,
@@ -805,41 +1018,57 @@ static bool adv_uuid_compare(const struct bt_data *data, uint8_t uuid_type,
 			&bt_scan.scan_filters.uuid;
 	const bool all_filters_mode = bt_scan.scan_filters.all_mode;
 	const uint8_t counter = bt_scan.scan_filters.uuid.cnt;
-	uint8_t data_len = data->data_len;
-	uint8_t uuid_match_cnt = 0;
-
-	for (size_t i = 0; i < counter; i++) {
+	uint8_t uuid_match_cnt;
+	uint8_t uuid_len;
+	uint32_t found;
 
-		if (find_uuid(data->data, data_len, uuid_type,
-			      &uuid_filter->uuid[i])) {
-			control->filter_status.uuid.uuid[uuid_match_cnt] =
-				uuid_filter->uuid[i].uuid;
+	switch (uuid_type) {
+	case BT_UUID_TYPE_16:
+		uuid_len = sizeof(uint16_t);
+		break;
 
-			uuid_match_cnt++;
+	case BT_UUID_TYPE_32:
+		uuid_len = sizeof(uint32_t);
+		break;
 
-			/* In the normal filter mode,
-			 * only one UUID is needed to match.
-			 */
-			if (!all_filters_mode) {
-				break;
-			}
+	case BT_UUID_TYPE_128:
+		uuid_len = BT_SCAN_UUID_128_SIZE * sizeof(uint8_t);
+		break;
 
-		} else if (all_filters_mode) {
-			break;
-		}
+	default:
+		return false;
 	}
 
-	control->filter_status.uuid.count = uuid_match_cnt;
+	/* Filters with UUIDs found in the advertisement packet. */
+	found = find_uuids(data->data, data->data_len, uuid_len);
 
 	/* In the multifilter mode, all UUIDs must be found in
-	 * the advertisement packets.
+	 * the advertisement packets. In the normal filter mode,
+	 * only one UUID is needed to match.
 	 */
-	if ((all_filters_mode && (uuid_match_cnt == counter)) ||
-	    ((!all_filters_mode) && (uuid_match_cnt > 0))) {
-		return true;
+	if (all_filters_mode) {
+		uuid_match_cnt = u32_count_trailing_zeros(~found);
+		if (uuid_match_cnt < counter) {
+			return false;
+		}
+
+		for (size_t i = 0; i < uuid_match_cnt; i++) {
+			control->filter_status.uuid.uuid[i] =
+				uuid_filter->uuid[i].uuid;
+		}
+	} else {
+		if (!found) {
+			return false;
+		}
+
+		uuid_match_cnt = 1;
+		control->filter_status.uuid.uuid[0] =
+			uuid_filter->uuid[u32_count_trailing_zeros(found)].uuid;
 	}
 
-	return false;
+	control->filter_status.uuid.count = uuid_match_cnt;
+
+	return true;
 }
 
 static bool is_uuid_filter_enabled(void)
@@ -853,11 +1082,10 @@ static void uuid_check(struct bt_scan_control *control,
 {
 	if (is_uuid_filter_enabled()) {
 		if (adv_uuid_compare(data, type, control)) {
-			control->filter_match_cnt++;
+			control->filter_match_mask |= BT_SCAN_UUID_FILTER;
 
 			/* Information about the filters matched. */
 			control->filter_status.uuid.match = true;
-			control->filter_match = true;
 		}
 	}
 }
@@ -866,9 +1094,11 @@ static int scan_uuid_filter_add(struct bt_uuid *uuid)
 {
 	struct bt_scan_uuid *uuid_filter = bt_scan.scan_filters.uuid.uuid;
 	uint8_t counter = bt_scan.scan_filters.uuid.cnt;
+	struct bt_scan_uuid_key *key = &bt_scan.scan_filters.uuid.key[counter];
 	struct bt_uuid_16 *uuid_16;
 	struct bt_uuid_32 *uuid_32;
 	struct bt_uuid_128 *uuid_128;
+	size_t slot;
 
 	/* If no memory. */
 	if (counter >= CONFIG_BT_SCAN_UUID_CNT) {
@@ -890,6 +1120,8 @@ static int scan_uuid_filter_add(struct bt_uuid *uuid)
 		uuid_filter[counter].uuid_data.uuid_16 = *uuid_16;
 		uuid_filter[counter].uuid =
 				(struct bt_uuid *)&uuid_filter[counter].uuid_data.uuid_16;
+		key->val = uuid_16->val;
+		key->val_128 = NULL;
 		break;
 
 	case BT_UUID_TYPE_32:
@@ -898,6 +1130,8 @@ static int scan_uuid_filter_add(struct bt_uuid *uuid)
 		uuid_filter[counter].uuid_data.uuid_32 = *uuid_32;
 		uuid_filter[counter].uuid =
 				(struct bt_uuid *)&uuid_filter[counter].uuid_data.uuid_32;
+		key->val = uuid_32->val;
+		key->val_128 = NULL;
 		break;
 
 	case BT_UUID_TYPE_128:
@@ -906,12 +1140,21 @@ static int scan_uuid_filter_add(struct bt_uuid *uuid)
 		uuid_filter[counter].uuid_data.uuid_128 = *uuid_128;
 		uuid_filter[counter].uuid =
 				(struct bt_uuid *)&uuid_filter[counter].uuid_data.uuid_128;
+		uuid_key_get(key, uuid_filter[counter].uuid_data.uuid_128.val,
+			     BT_SCAN_UUID_128_SIZE);
 		break;
 
 	default:
 		return -EINVAL;
 	}
 
+	/* Add UUID to the hash set. */
+	slot = hash_u32(key->val) % UUID_HASH_SIZE;
+	while (bt_scan.scan_filters.uuid.slot[slot]) {
+		slot = (slot + 1) % UUID_HASH_SIZE;
+	}
+
+	bt_scan.scan_filters.uuid.slot[slot] = counter + 1;
 	bt_scan.scan_filters.uuid.cnt++;
 	LOG_DBG("Added filter on UUID type %x", uuid->type);
 
@@ -973,11 +1216,10 @@ static void appearance_check(struct bt_scan_control *control,
 {
 	if (is_appearance_filter_enabled()) {
 		if (adv_appearance_compare(data, control)) {
-			control->filter_match_cnt++;
+			control->filter_match_mask |= BT_SCAN_APPEARANCE_FILTER;
 
 			/* Information about the filters matched. */
 			control->filter_status.appearance.match = true;
-			control->filter_match = true;
 		}
 	}
 }
@@ -1060,11 +1302,10 @@ static void manufacturer_data_check(struct bt_scan_control *control,
 {
 	if (is_manufacturer_data_filter_enabled()) {
 		if (adv_manufacturer_data_compare(data, control)) {
-			control->filter_match_cnt++;
+			control->filter_match_mask |= BT_SCAN_MANUFACTURER_DATA_FILTER;
 
 			/* Information about the filters matched. */
 			control->filter_status.manufacturer_data.match = true;
-			control->filter_match = true;
 		}
 	}
 }
@@ -1215,18 +1456,26 @@ void bt_scan_filter_remove_all(void)
 
 	struct bt_scan_name_filter *name_filter =
 			&bt_scan.scan_filters.name;
+	memset(name_filter->target_name, 0, sizeof(name_filter->target_name));
+	memset(name_filter->trie, 0, sizeof(name_filter->trie));
+	name_filter->trie_cnt = 0;
 	name_filter->cnt = 0;
 
 	struct bt_scan_short_name_filter *short_name_filter =
 			&bt_scan.scan_filters.short_name;
+	memset(short_name_filter->name, 0, sizeof(short_name_filter->name));
+	memset(short_name_filter->trie, 0, sizeof(short_name_filter->trie));
+	short_name_filter->trie_cnt = 0;
 	short_name_filter->cnt = 0;
 
 	struct bt_scan_addr_filter *addr_filter =
 			&bt_scan.scan_filters.addr;
+	memset(addr_filter->slot, 0, sizeof(addr_filter->slot));
 	addr_filter->cnt = 0;
 
 	struct bt_scan_uuid_filter *uuid_filter =
 			&bt_scan.scan_filters.uuid;
+	memset(uuid_filter->slot, 0, sizeof(uuid_filter->slot));
 	uuid_filter->cnt = 0;
 
 	struct bt_scan_appearance_filter *appearance_filter =
@@ -1249,6 +1498,7 @@ void bt_scan_filter_disable(void)
 	bt_scan.scan_filters.uuid.enabled = false;
 	bt_scan.scan_filters.appearance.enabled = false;
 	bt_scan.scan_filters.manufacturer_data.enabled = false;
+	bt_scan.scan_filters.enabled_mask = 0;
 }
 
 int bt_scan_filter_enable(uint8_t mode, bool match_all)
@@ -1291,6 +1541,33 @@ int bt_scan_filter_enable(uint8_t mode, bool match_all)
 	/* Select the filter mode. */
 	filters->all_mode = match_all;
 
+	/* Filter types that must match in the multifilter mode. */
+	filters->enabled_mask = 0;
+
+	if (is_addr_filter_enabled()) {
+		filters->enabled_mask |= BT_SCAN_ADDR_FILTER;
+	}
+
+	if (is_name_filter_enabled()) {
+		filters->enabled_mask |= BT_SCAN_NAME_FILTER;
+	}
+
+	if (is_short_name_filter_enabled()) {
+		filters->enabled_mask |= BT_SCAN_SHORT_NAME_FILTER;
+	}
+
+	if (is_uuid_filter_enabled()) {
+		filters->enabled_mask |= BT_SCAN_UUID_FILTER;
+	}
+
+	if (is_appearance_filter_enabled()) {
+		filters->enabled_mask |= BT_SCAN_APPEARANCE_FILTER;
+	}
+
+	if (is_manufacturer_data_filter_enabled()) {
+		filters->enabled_mask |= BT_SCAN_MANUFACTURER_DATA_FILTER;
+	}
+
 	return 0;
 }
 
@@ -1369,35 +1646,6 @@ void bt_scan_update_init_conn_params(struct bt_le_conn_param *new_conn_param)
 	bt_scan.conn_param = *new_conn_param;
 }
 
-static void check_enabled_filters(struct bt_scan_control *control)
-{
-	control->filter_cnt = 0;
-
-	if (is_addr_filter_enabled()) {
-		control->filter_cnt++;
-	}
-
-	if (is_name_filter_enabled()) {
-		control->filter_cnt++;
-	}
-
-	if (is_short_name_filter_enabled()) {
-		control->filter_cnt++;
-	}
-
-	if (is_uuid_filter_enabled()) {
-		control->filter_cnt++;
-	}
-
-	if (is_appearance_filter_enabled()) {
-		control->filter_cnt++;
-	}
-
-	if (is_manufacturer_data_filter_enabled()) {
-		control->filter_cnt++;
-	}
-}
-
 static bool adv_data_found(struct bt_data *data, void *user_data)
 {
 	struct bt_scan_control *scan_control =
@@ -1456,7 +1704,7 @@ static void filter_state_check(struct bt_scan_control *control,
 	}
 
 	if (control->all_mode &&
-	    (control->filter_match_cnt == control->filter_cnt)) {
+	    (control->filter_match_mask == bt_scan.scan_filters.enabled_mask)) {
 		notify_filter_matched(&control->device_info,
 				      &control->filter_status,
 				      control->connectable);
@@ -1466,7 +1714,7 @@ static void filter_state_check(struct bt_scan_control *control,
 	/* In the normal filter mode, only one filter match is
 	 * needed to generate the notification to the main application.
 	 */
-	else if ((!control->all_mode) && control->filter_match) {
+	else if ((!control->all_mode) && control->filter_match_mask) {
 		notify_filter_matched(&control->device_info,
 				      &control->filter_status,
 				      control->connectable);
@@ -1487,8 +1735,6 @@ static void scan_recv(const struct bt_le_scan_recv_info *info,
 
 	scan_control.all_mode = bt_scan.scan_filters.all_mode;
 
-	check_enabled_filters(&scan_control);
-
 	/* Check id device is connectable. */
 	scan_control.connectable =
 		(info->adv_props & BT_GAP_ADV_PROP_CONNECTABLE) != 0;
@@ -1496,12 +1742,15 @@ static void scan_recv(const struct bt_le_scan_recv_info *info,
 	/* Check the address filter. */
 	check_addr(&scan_control, info->addr);
 
-	/* Save advertising buffer state to transfer it
+	/* The advertising data is parsed only if it can match a filter.
+	 * Save advertising buffer state to transfer it
 	 * data to application if futher processing is needed.
 	 */
-	net_buf_simple_save(ad, &state);
-	bt_data_parse(ad, adv_data_found, (void *)&scan_control);
-	net_buf_simple_restore(ad, &state);
+	if (bt_scan.scan_filters.enabled_mask & ~BT_SCAN_ADDR_FILTER) {
+		net_buf_simple_save(ad, &state);
+		bt_data_parse(ad, adv_data_found, (void *)&scan_control);
+		net_buf_simple_restore(ad, &state);
+	}
 
 	scan_control.device_info.recv_info = info;
 	scan_control.device_info.conn_param = &bt_scan.conn_param;
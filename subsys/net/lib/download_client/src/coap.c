@@ -200,22 +200,17 @@ int coap_parse(struct download_client *client, size_t len)
 	return 0;
 }
 
-int coap_request_send(struct download_client *client)
+/* Create a GET request for the block of the file described by block_ctx */
+int coap_block_request_create(struct download_client *client, struct coap_packet *request,
+			      uint8_t *buf, size_t len, uint16_t id,
+			      struct coap_block_context *block_ctx)
 {
 	int err;
-	uint16_t id;
 	char file[FILENAME_SIZE];
 	char *path_elem;
 	char *path_elem_saveptr;
-	struct coap_packet request;
-
-	if (has_pending(client)) {
-		id = client->coap.pending.id;
-	} else {
-		id = coap_next_id();
-	}
 
-	err = coap_packet_init(&request, client->buf, CONFIG_DOWNLOAD_CLIENT_BUF_SIZE, COAP_VER,
+	err = coap_packet_init(request, buf, len, COAP_VER,
 			       COAP_TYPE_CON, 8, coap_next_token(), COAP_METHOD_GET, id);
 	if (err) {
 		LOG_ERR("Failed to init CoAP message, err %d", err);
@@ -230,7 +225,7 @@ int coap_request_send(struct download_client *client)
 
 	path_elem = strtok_r(file, COAP_PATH_ELEM_DELIM, &path_elem_saveptr);
 	do {
-		err = coap_packet_append_option(&request, COAP_OPTION_URI_PATH,
+		err = coap_packet_append_option(request, COAP_OPTION_URI_PATH,
 			path_elem, strlen(path_elem));
 		if (err) {
 			LOG_ERR("Unable add option to request");
@@ -238,18 +233,40 @@ int coap_request_send(struct download_client *client)
 		}
 	} while ((path_elem = strtok_r(NULL, COAP_PATH_ELEM_DELIM, &path_elem_saveptr)));
 
-	err = coap_append_block2_option(&request, &client->coap.block_ctx);
+	err = coap_append_block2_option(request, block_ctx);
 	if (err) {
 		LOG_ERR("Unable to add block2 option");
 		return err;
 	}
 
-	err = coap_append_size2_option(&request, &client->coap.block_ctx);
+	err = coap_append_size2_option(request, block_ctx);
 	if (err) {
 		LOG_ERR("Unable to add size2 option");
 		return err;
 	}
 
+	return 0;
+}
+
+int coap_request_send(struct download_client *client)
+{
+	int err;
+	uint16_t id;
+	struct coap_packet request;
+
+	if (has_pending(client)) {
+		id = client->coap.pending.id;
+	} else {
+		id = coap_next_id();
+	}
+
+	err = coap_block_request_create(client, &request, (uint8_t *)client->buf,
+					CONFIG_DOWNLOAD_CLIENT_BUF_SIZE, id,
+					&client->coap.block_ctx);
+	if (err) {
+		return err;
+	}
+
 	if (!has_pending(client)) {
 		err = coap_pending_init(&client->coap.pending, &request, &client->remote_addr,
 					CONFIG_DOWNLOAD_CLIENT_COAP_MAX_RETRANSMIT_REQUEST_COUNT);
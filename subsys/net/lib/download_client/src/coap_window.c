@@ -0,0 +1,513 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Windowed CoAP block-wise transfer.
+ *
+ * Up to CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW_SIZE Block2 requests are
+ * outstanding, each in its own confirmable message with its own
+ * retransmission timer, so a lost datagram only delays its own block.
+ *
+ * Every datagram is received into a free buffer of the pool, and kept
+ * there until the blocks before it have been delivered. Fragments point
+ * to the payload within the datagram, so nothing is copied. As there are
+ * as many buffers as outstanding requests, a free buffer is always left
+ * for the block that is next in order.
+ */
+
+#include <string.h>
+#include <zephyr.h>
+#if defined(CONFIG_POSIX_API)
+#include <posix/poll.h>
+#include <posix/sys/socket.h>
+#else
+#include <net/socket.h>
+#endif
+#include <net/coap.h>
+#include <net/download_client.h>
+#include <logging/log.h>
+
+LOG_MODULE_DECLARE(download_client, CONFIG_DOWNLOAD_CLIENT_LOG_LEVEL);
+
+#define WINDOW CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW_SIZE
+
+int coap_block_request_create(struct download_client *client, struct coap_packet *request,
+			      uint8_t *buf, size_t len, uint16_t id,
+			      struct coap_block_context *block_ctx);
+int error_evt_send(const struct download_client *dl, int error);
+int reconnect(struct download_client *dl);
+
+bool coap_window_in_use(const struct download_client *client)
+{
+	return client->proto == IPPROTO_UDP || client->proto == IPPROTO_DTLS_1_2;
+}
+
+static size_t block_size(const struct download_client *client)
+{
+	return coap_block_size_to_bytes(client->coap.block_ctx.block_size);
+}
+
+static uint8_t *buf_get(struct download_client *client, size_t i)
+{
+	return i == 0 ? (uint8_t *)client->buf : client->coap_win_buf[i - 1];
+}
+
+/* Get a buffer that does not hold a received block */
+static uint8_t *buf_free_get(struct download_client *client)
+{
+	for (size_t i = 0; i < WINDOW; i++) {
+		uint8_t *buf = buf_get(client, i);
+		bool used = false;
+
+		for (size_t j = 0; j < WINDOW; j++) {
+			if (client->coap.slot[j].buf == buf) {
+				used = true;
+				break;
+			}
+		}
+
+		if (!used) {
+			return buf;
+		}
+	}
+
+	__ASSERT(false, "No free buffer");
+	return NULL;
+}
+
+static void slots_init(struct download_client *client)
+{
+	memset(client->coap.slot, 0, sizeof(client->coap.slot));
+	client->coap.next = ROUND_DOWN(client->progress, block_size(client));
+}
+
+/* Send the request of a slot, or retransmit it with the same message ID */
+static int slot_request_send(struct download_client *client,
+			     struct download_client_coap_slot *slot)
+{
+	struct coap_block_context block_ctx = client->coap.block_ctx;
+	struct coap_packet request;
+	bool retransmission = slot->pending.timeout > 0;
+	uint16_t id = retransmission ? slot->pending.id : coap_next_id();
+	ssize_t sent;
+	int err;
+
+	block_ctx.current = slot->from;
+	block_ctx.total_size = client->file_size;
+
+	err = coap_block_request_create(client, &request, buf_free_get(client),
+					CONFIG_DOWNLOAD_CLIENT_BUF_SIZE, id, &block_ctx);
+	if (err) {
+		return err;
+	}
+
+	if (!retransmission) {
+		err = coap_pending_init(&slot->pending, &request, &client->remote_addr,
+					CONFIG_DOWNLOAD_CLIENT_COAP_MAX_RETRANSMIT_REQUEST_COUNT);
+		if (err < 0) {
+			return -EINVAL;
+		}
+
+		coap_pending_cycle(&slot->pending);
+	}
+
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_LOG_HEADERS)) {
+		LOG_HEXDUMP_DBG(request.data, request.offset, "CoAP request");
+	}
+
+	LOG_DBG("CoAP request for block at %u, id %d", slot->from, id);
+
+	sent = send(client->fd, request.data, request.offset, 0);
+	if (sent < 0) {
+		LOG_ERR("Failed to send CoAP request, errno %d", errno);
+		return -errno;
+	}
+
+	return 0;
+}
+
+static int slot_open(struct download_client *client, struct download_client_coap_slot *slot)
+{
+	memset(slot, 0, sizeof(*slot));
+	slot->from = client->coap.next;
+	slot->in_use = true;
+
+	client->coap.next += block_size(client);
+
+	return slot_request_send(client, slot);
+}
+
+static bool request_allowed(const struct download_client *client)
+{
+	if (client->file_size == 0) {
+		/* Only one request until the file size is known */
+		for (size_t i = 0; i < WINDOW; i++) {
+			if (client->coap.slot[i].in_use) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	return client->coap.next < client->file_size;
+}
+
+static int requests_send(struct download_client *client)
+{
+	int err;
+
+	for (size_t i = 0; i < WINDOW; i++) {
+		struct download_client_coap_slot *slot = &client->coap.slot[i];
+
+		if (slot->in_use || !request_allowed(client)) {
+			continue;
+		}
+
+		err = slot_open(client, slot);
+		if (err) {
+			return err;
+		}
+	}
+
+	return 0;
+}
+
+/* Retransmit the requests that have timed out */
+static int requests_resend(struct download_client *client)
+{
+	int err;
+
+	for (size_t i = 0; i < WINDOW; i++) {
+		struct download_client_coap_slot *slot = &client->coap.slot[i];
+		int32_t left;
+
+		if (!slot->in_use || slot->buf) {
+			continue;
+		}
+
+		left = slot->pending.t0 + slot->pending.timeout - k_uptime_get_32();
+		if (left > 0) {
+			continue;
+		}
+
+		if (!coap_pending_cycle(&slot->pending)) {
+			LOG_ERR("CoAP max-retransmissions exceeded");
+			return -ETIMEDOUT;
+		}
+
+		LOG_DBG("Block at %u timed out, resending", slot->from);
+
+		err = slot_request_send(client, slot);
+		if (err) {
+			return err;
+		}
+	}
+
+	return 0;
+}
+
+/* Time until the first retransmission is due */
+static int recv_timeout_get(const struct download_client *client)
+{
+	int timeout = SYS_FOREVER_MS;
+
+	for (size_t i = 0; i < WINDOW; i++) {
+		const struct download_client_coap_slot *slot = &client->coap.slot[i];
+		int32_t left;
+
+		if (!slot->in_use || slot->buf) {
+			continue;
+		}
+
+		left = MAX(slot->pending.t0 + slot->pending.timeout - k_uptime_get_32(), 0);
+		if (timeout == SYS_FOREVER_MS || left < timeout) {
+			timeout = left;
+		}
+	}
+
+	return timeout;
+}
+
+static struct download_client_coap_slot *slot_find(struct download_client *client, uint16_t id)
+{
+	for (size_t i = 0; i < WINDOW; i++) {
+		struct download_client_coap_slot *slot = &client->coap.slot[i];
+
+		if (slot->in_use && !slot->buf && slot->pending.id == id) {
+			return slot;
+		}
+	}
+
+	return NULL;
+}
+
+/* Match a response to its request, and keep it in its buffer.
+ * Returns 0 on success or for a duplicate response, -1 on error.
+ */
+static int response_parse(struct download_client *client, uint8_t *buf, size_t len)
+{
+	struct download_client_coap_slot *slot;
+	struct coap_packet response;
+	const uint8_t *payload;
+	uint16_t payload_len;
+	uint8_t response_code;
+	size_t bytes;
+	size_t from;
+	int block;
+	int size;
+	int err;
+
+	err = coap_packet_parse(&response, buf, len, NULL, 0);
+	if (err) {
+		LOG_ERR("Failed to parse CoAP packet, err %d", err);
+		return -1;
+	}
+
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_LOG_HEADERS)) {
+		LOG_HEXDUMP_DBG(buf, len, "CoAP response");
+	}
+
+	slot = slot_find(client, coap_header_get_id(&response));
+	if (!slot) {
+		/* Response to a retransmission, or to a request of a previous download */
+		LOG_DBG("Response is not pending, id %d", coap_header_get_id(&response));
+		return 0;
+	}
+
+	if (coap_header_get_type(&response) != COAP_TYPE_ACK) {
+		LOG_ERR("Response must be of coap type ACK");
+		return -1;
+	}
+
+	response_code = coap_header_get_code(&response);
+	if (response_code != COAP_RESPONSE_CODE_OK &&
+	    response_code != COAP_RESPONSE_CODE_CONTENT) {
+		LOG_ERR("Server responded with code 0x%x", response_code);
+		return -1;
+	}
+
+	block = coap_get_option_int(&response, COAP_OPTION_BLOCK2);
+	if (block < 0) {
+		LOG_ERR("Failed to get Block2 option, err %d", block);
+		return -1;
+	}
+
+	if (GET_BLOCK_SIZE(block) != client->coap.block_ctx.block_size) {
+		/* The server may only choose a smaller block size in its first response,
+		 * the following requests are sent with that size.
+		 */
+		if (client->file_size || GET_BLOCK_SIZE(block) > client->coap.block_ctx.block_size) {
+			LOG_ERR("Unexpected block size %d", GET_BLOCK_SIZE(block));
+			return -1;
+		}
+
+		client->coap.block_ctx.block_size = GET_BLOCK_SIZE(block);
+		client->coap.next = GET_BLOCK_NUM(block) * block_size(client);
+		client->coap.next += block_size(client);
+	}
+
+	bytes = block_size(client);
+	from = GET_BLOCK_NUM(block) * bytes;
+
+	/* With a smaller block size, the block contains the requested offset */
+	if (from > slot->from || from + bytes <= slot->from) {
+		LOG_ERR("Block out of order %d, expected %d", from, slot->from);
+		return -1;
+	}
+
+	payload = coap_packet_get_payload(&response, &payload_len);
+	if (!payload) {
+		payload_len = 0;
+	}
+
+	if (GET_MORE(block) && payload_len != bytes) {
+		LOG_ERR("Unexpected block length %d", payload_len);
+		return -1;
+	}
+
+	slot->from = from;
+	slot->buf = buf;
+	slot->payload = payload;
+	slot->payload_len = payload_len;
+	slot->more = GET_MORE(block);
+
+	if (client->file_size == 0) {
+		size = coap_get_option_int(&response, COAP_OPTION_SIZE2);
+		if (size > 0) {
+			client->file_size = size;
+		} else if (!slot->more) {
+			client->file_size = slot->from + payload_len;
+		}
+
+		if (client->file_size) {
+			LOG_DBG("Total size: %d", client->file_size);
+		}
+	}
+
+	return 0;
+}
+
+/* Deliver the blocks that are next in order.
+ * Returns 0 on success and 1 if the application stopped the download.
+ */
+static int blocks_deliver(struct download_client *client)
+{
+	bool delivered;
+
+	do {
+		delivered = false;
+
+		for (size_t i = 0; i < WINDOW; i++) {
+			struct download_client_coap_slot *slot = &client->coap.slot[i];
+			size_t skip;
+
+			if (!slot->buf || slot->from > client->progress) {
+				continue;
+			}
+
+			if (slot->from + slot->payload_len <= client->progress &&
+			    slot->payload_len) {
+				/* Already downloaded, before the block size was changed */
+				slot->in_use = false;
+				slot->buf = NULL;
+				continue;
+			}
+
+			skip = client->progress - slot->from;
+
+			const struct download_client_evt evt = {
+				.id = DOWNLOAD_CLIENT_EVT_FRAGMENT,
+				.fragment = {
+					.buf = slot->payload + skip,
+					.len = slot->payload_len - skip,
+				}
+			};
+
+			client->progress += slot->payload_len - skip;
+
+			if (!slot->more) {
+				client->file_size = client->progress;
+			}
+
+			if (client->file_size) {
+				LOG_INF("Downloaded %u/%u bytes (%d%%)", client->progress,
+					client->file_size,
+					(client->progress * 100) / client->file_size);
+			} else {
+				LOG_INF("Downloaded %u bytes", client->progress);
+			}
+
+			if (client->callback(&evt)) {
+				LOG_INF("Fragment refused, download stopped.");
+				return 1;
+			}
+
+			slot->in_use = false;
+			slot->buf = NULL;
+			delivered = true;
+		}
+	} while (delivered);
+
+	return 0;
+}
+
+static int response_recv(struct download_client *client)
+{
+	struct pollfd fds = {
+		.fd = client->fd,
+		.events = POLLIN,
+	};
+	uint8_t *buf;
+	ssize_t len;
+	int rc;
+
+	rc = poll(&fds, 1, recv_timeout_get(client));
+	if (rc < 0) {
+		return -errno;
+	}
+
+	if (rc == 0) {
+		/* Retransmission due */
+		return 0;
+	}
+
+	buf = buf_free_get(client);
+
+	len = recv(client->fd, buf, CONFIG_DOWNLOAD_CLIENT_BUF_SIZE, 0);
+	if (len < 0) {
+		LOG_ERR("Error in recv(), errno %d", errno);
+		return -ECONNRESET;
+	}
+
+	LOG_DBG("Read %d bytes from socket", len);
+
+	if (response_parse(client, buf, len)) {
+		return -EBADMSG;
+	}
+
+	return 0;
+}
+
+int coap_window_download(struct download_client *client)
+{
+	int err;
+
+restart:
+	slots_init(client);
+
+	while (true) {
+		if (blocks_deliver(client)) {
+			break;
+		}
+
+		if (client->file_size && client->progress >= client->file_size) {
+			LOG_INF("Download complete");
+			const struct download_client_evt evt = {
+				.id = DOWNLOAD_CLIENT_EVT_DONE,
+			};
+			client->callback(&evt);
+			break;
+		}
+
+		err = requests_send(client);
+		if (!err) {
+			err = requests_resend(client);
+		}
+
+		if (!err) {
+			err = response_recv(client);
+		}
+
+		if (err == -EBADMSG) {
+			/* Something was wrong with the packet */
+			error_evt_send(client, EBADMSG);
+			break;
+		} else if (err == -ETIMEDOUT) {
+			error_evt_send(client, ETIMEDOUT);
+			break;
+		} else if (!err) {
+			continue;
+		}
+
+		/* Notify the application of the error via an event.
+		 * Attempt to reconnect and resume the download
+		 * if the application returns Zero via the event.
+		 */
+		if (error_evt_send(client, -err)) {
+			break;
+		}
+
+		err = reconnect(client);
+		if (err) {
+			error_evt_send(client, EHOSTDOWN);
+			break;
+		}
+
+		goto restart;
+	}
+
+	return 0;
+}
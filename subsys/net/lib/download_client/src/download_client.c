@@ -41,6 +41,11 @@ int coap_initiate_retransmission(struct download_client *dl);
 int coap_parse(struct download_client *client, size_t len);
 int coap_request_send(struct download_client *client);
 
+bool http_pipeline_in_use(const struct download_client *client);
+int http_pipeline_download(struct download_client *client);
+bool coap_window_in_use(const struct download_client *client);
+int coap_window_download(struct download_client *client);
+
 static const char *str_family(int family)
 {
 	switch (family) {
@@ -209,7 +214,10 @@ static int host_lookup(const char *host, int family, uint8_t pdn_id,
 	return 0;
 }
 
-static int client_connect(struct download_client *dl)
+/* Connect a new socket to the server. This is not static so that
+ * the HTTP pipeline can open additional connections.
+ */
+int client_connect(struct download_client *dl, int *fd)
 {
 	int err;
 	int type;
@@ -285,14 +293,14 @@ static int client_connect(struct download_client *dl)
 	LOG_DBG("family: %d, type: %d, proto: %d",
 		dl->remote_addr.sa_family, type, dl->proto);
 
-	dl->fd = socket(dl->remote_addr.sa_family, type, dl->proto);
-	if (dl->fd < 0) {
+	*fd = socket(dl->remote_addr.sa_family, type, dl->proto);
+	if (*fd < 0) {
 		LOG_ERR("Failed to create socket, err %d", errno);
 		return -errno;
 	}
 
 	if (dl->config.pdn_id) {
-		err = socket_pdn_id_set(dl->fd, dl->config.pdn_id);
+		err = socket_pdn_id_set(*fd, dl->config.pdn_id);
 		if (err) {
 			goto cleanup;
 		}
@@ -300,13 +308,13 @@ static int client_connect(struct download_client *dl)
 
 	if ((dl->proto == IPPROTO_TLS_1_2 || dl->proto == IPPROTO_DTLS_1_2)
 	     && (dl->config.sec_tag != -1)) {
-		err = socket_sectag_set(dl->fd, dl->config.sec_tag);
+		err = socket_sectag_set(*fd, dl->config.sec_tag);
 		if (err) {
 			goto cleanup;
 		}
 
 		if (dl->config.set_tls_hostname) {
-			err = socket_tls_hostname_set(dl->fd, dl->host);
+			err = socket_tls_hostname_set(*fd, dl->host);
 			if (err) {
 				goto cleanup;
 			}
@@ -315,9 +323,9 @@ static int client_connect(struct download_client *dl)
 
 	LOG_INF("Connecting to %s", log_strdup(dl->host));
 	LOG_DBG("fd %d, addrlen %d, fam %s, port %d",
-		dl->fd, addrlen, str_family(dl->remote_addr.sa_family), port);
+		*fd, addrlen, str_family(dl->remote_addr.sa_family), port);
 
-	err = connect(dl->fd, &dl->remote_addr, addrlen);
+	err = connect(*fd, &dl->remote_addr, addrlen);
 	if (err) {
 		LOG_ERR("Unable to connect, errno %d", errno);
 		err = -errno;
@@ -326,8 +334,8 @@ static int client_connect(struct download_client *dl)
 cleanup:
 	if (err) {
 		/* Unable to connect, close socket */
-		close(dl->fd);
-		dl->fd = -1;
+		close(*fd);
+		*fd = -1;
 	}
 
 	return err;
@@ -389,7 +397,7 @@ static int fragment_evt_send(const struct download_client *client)
 	return client->callback(&evt);
 }
 
-static int error_evt_send(const struct download_client *dl, int error)
+int error_evt_send(const struct download_client *dl, int error)
 {
 	/* Error will be sent as negative. */
 	__ASSERT_NO_MSG(error > 0);
@@ -402,7 +410,7 @@ static int error_evt_send(const struct download_client *dl, int error)
 	return dl->callback(&evt);
 }
 
-static int reconnect(struct download_client *dl)
+int reconnect(struct download_client *dl)
 {
 	int err;
 
@@ -483,6 +491,18 @@ void download_thread(void *client, void *a, void *b)
 restart_and_suspend:
 	k_thread_suspend(dl->tid);
 
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE) && http_pipeline_in_use(dl)) {
+		/* Returns when the download is complete or stopped */
+		(void)http_pipeline_download(dl);
+		goto restart_and_suspend;
+	}
+
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW) && coap_window_in_use(dl)) {
+		/* Returns when the download is complete or stopped */
+		(void)coap_window_download(dl);
+		goto restart_and_suspend;
+	}
+
 	while (true) {
 		__ASSERT(dl->offset < sizeof(dl->buf), "Buffer overflow");
 
@@ -651,6 +671,13 @@ int download_client_init(struct download_client *const client,
 	client->fd = -1;
 	client->callback = callback;
 
+#if defined(CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE)
+	/* The additional connections are closed before each download */
+	for (size_t i = 0; i < ARRAY_SIZE(client->http.conn); i++) {
+		client->http.conn[i].fd = -1;
+	}
+#endif
+
 	/* The thread is spawned now, but it will suspend itself;
 	 * it is resumed when the download is started via the API.
 	 */
@@ -700,7 +727,7 @@ int download_client_connect(struct download_client *client, const char *host,
 	client->config = *config;
 	client->host = host;
 
-	err = client_connect(client);
+	err = client_connect(client, &client->fd);
 	if (client->fd < 0) {
 		return err;
 	}
@@ -753,9 +780,13 @@ int download_client_start(struct download_client *client, const char *file,
 		}
 	}
 
-	err = request_send(client);
-	if (err) {
-		return err;
+	/* Pipelined and windowed requests are sent from the download thread */
+	if (!(IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE) && http_pipeline_in_use(client)) &&
+	    !(IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW) && coap_window_in_use(client))) {
+		err = request_send(client);
+		if (err) {
+			return err;
+		}
 	}
 
 	LOG_INF("Downloading: %s [%u]", log_strdup(client->file),
@@ -4,14 +4,14 @@
  * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
  */
 
-#include <ctype.h>
 #include <stdio.h>
-#include <stdlib.h>
 #include <string.h>
 #include <logging/log.h>
 #include <sys/__assert.h>
 #include <net/download_client.h>
 
+#include "http_parser.h"
+
 LOG_MODULE_DECLARE(download_client, CONFIG_DOWNLOAD_CLIENT_LOG_LEVEL);
 
 #define HOSTNAME_SIZE CONFIG_DOWNLOAD_CLIENT_MAX_HOSTNAME_SIZE
@@ -108,72 +108,28 @@ int http_get_request_send(struct download_client *client)
 		return err;
 	}
 
+	http_parser_init(&client->http.parser);
+	client->http.has_header = false;
+
 	return 0;
 }
 
-/* Returns:
- *  1 while the header is being received
- *  0 if the header has been fully received
- * -1 on error
- */
-static int http_header_parse(struct download_client *client, size_t *hdr_len)
+/* The progress is that of the request until the body is received */
+static bool using_range_requests(const struct download_client *client)
 {
-	char *p;
-	char *q;
-	unsigned int http_status;
-	const bool using_range_requests =
-		(client->proto == IPPROTO_TLS_1_2 ||
-		 IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_RANGE_REQUESTS) ||
-		 client->progress);
-
-	const unsigned int expected_status = using_range_requests ? 206 : 200;
-
-	p = strstr(client->buf, "\r\n\r\n");
-	if (!p || p > client->buf + client->offset) {
-		/* Waiting full HTTP header */
-		LOG_DBG("Waiting full header in response");
-		return 1;
-	}
-
-	/* Offset of the end of the HTTP header in the buffer */
-	*hdr_len = p + strlen("\r\n\r\n") - client->buf;
-
-	LOG_DBG("GET header size: %u", *hdr_len);
-	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_LOG_HEADERS)) {
-		LOG_HEXDUMP_DBG(client->buf, *hdr_len, "HTTP response");
-	}
-
-	for (size_t i = 0; i < *hdr_len; i++) {
-		client->buf[i] = tolower(client->buf[i]);
-	}
-
-	/* Look for the status code just after "http/1.1 " */
-	p = strstr(client->buf, "http/1.1 ");
-	if (!p) {
-		LOG_ERR("Server response missing HTTP/1.1");
-		return -1;
-	}
-	p += strlen("http/1.1 ");
-
-	http_status = strtoul(p, &q, 10);
-	if (!q) {
-		LOG_ERR("Server response malformed: status code not found");
-		return -1;
-	}
+	return client->proto == IPPROTO_TLS_1_2 ||
+	       IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_RANGE_REQUESTS) ||
+	       client->progress;
+}
 
-	if (http_status != expected_status) {
-		/* Truncate the server response at the first CR or LF after the
-		 * status and message so we can log it. Normally we can't
-		 * modify the response like this since we'd need to look at
-		 * data beyond this point, but we're already in a failing
-		 * condition.
-		 */
-		while ((*q != '\0') && (*q != '\r') && (*q != '\n')) {
-			q++;
-		}
-		*q = '\0';
+/* Check the status and read the file size, once the header has been parsed */
+static int http_header_check(struct download_client *client)
+{
+	const struct download_client_http_parser *parser = &client->http.parser;
+	const unsigned int expected_status = using_range_requests(client) ? 206 : 200;
 
-		LOG_ERR("Unexpected HTTP response: %s", log_strdup(p));
+	if (parser->status != expected_status) {
+		LOG_ERR("Unexpected HTTP response: %d", parser->status);
 		return -1;
 	}
 
@@ -181,42 +137,30 @@ static int http_header_parse(struct download_client *client, size_t *hdr_len)
 	 * and via "Content-Range" in case of HTTPS with range requests.
 	 */
 	if (client->file_size == 0) {
-		if (using_range_requests) {
-			p = strstr(client->buf, "content-range");
-			if (!p) {
+		if (using_range_requests(client)) {
+			if (!parser->has_range) {
 				LOG_ERR("Server did not send "
 					"\"Content-Range\" in response");
 				return -1;
 			}
-			p = strstr(p, "/");
-			if (!p) {
-				LOG_ERR("No file size in response");
-				return -1;
-			}
-		} else { /* proto == PROTO_HTTP */
-			p = strstr(client->buf, "content-length");
-			if (!p) {
-				LOG_WRN("Server did not send "
-					"\"Content-Length\" in response");
-					return -1;
-			}
-			p = strstr(p, ":");
-			if (!p) {
-				LOG_ERR("No file size in response");
-				return -1;
-			}
+
+			client->file_size = parser->range_total;
+		} else if (parser->has_length) {
 			/* Accumulate any eventual progress (starting offset)
 			 * when reading the file size from Content-Length
 			 */
-			client->file_size = client->progress;
+			client->file_size = client->progress + parser->content_length;
+		} else if (!parser->chunked) {
+			LOG_WRN("Server did not send "
+				"\"Content-Length\" in response");
+			return -1;
 		}
 
-		client->file_size += atoi(p + 1);
+		/* With chunked transfer encoding, the size is only known at the end */
 		LOG_DBG("File size = %u", client->file_size);
 	}
 
-	p = strstr(client->buf, "connection: close");
-	if (p) {
+	if (parser->connection_close) {
 		LOG_WRN("Peer closed connection, will re-connect");
 		client->http.connection_close = true;
 	}
@@ -226,63 +170,70 @@ static int http_header_parse(struct download_client *client, size_t *hdr_len)
 	return 0;
 }
 
-/* Returns:
+static size_t frag_size(const struct download_client *client)
+{
+	return client->config.frag_size_override ? client->config.frag_size_override :
+						   CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE;
+}
+
+/* Parse the received data, and accumulate the body at the start of the
+ * buffer, after the body received before.
+ *
+ * Returns:
  *  1 if more data is expected
- *  0 if a whole fragment has been received
+ *  0 if a whole fragment or the whole response has been received
  * -1 on error
  */
 int http_parse(struct download_client *client, size_t len)
 {
+	const char *data = client->buf + client->offset;
+	const char *body;
+	size_t body_len;
+	size_t consumed;
 	int rc;
-	size_t hdr_len;
 
-	/* Accumulate buffer offset */
-	client->offset += len;
+	do {
+		rc = http_parser_feed(&client->http.parser, data, len, &consumed,
+				      &body, &body_len);
 
-	if (!client->http.has_header) {
-		rc = http_header_parse(client, &hdr_len);
-		if (rc > 0) {
-			/* Wait for header */
-			return 1;
-		}
-		if (rc < 0) {
-			/* Something is wrong with the header */
-			return -1;
+		if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_LOG_HEADERS) && !client->http.has_header) {
+			LOG_HEXDUMP_DBG(data, consumed, "HTTP response");
 		}
 
-		if (client->offset != hdr_len) {
-			/* The buffer contains some payload bytes,
-			 * copy them at the beginning of the buffer
-			 * and update the offset.
-			 */
-			LOG_DBG("Copying %u payload bytes",
-				client->offset - hdr_len);
-			memcpy(client->buf, client->buf + hdr_len,
-			       client->offset - hdr_len);
-
-			client->offset -= hdr_len;
-		} else {
-			/* Reset the offset.
-			 * The payload is received in an empty buffer.
-			 */
-			client->offset = 0;
-		}
-	}
+		data += consumed;
+		len -= consumed;
 
-	/* Accumulate overall file progress.
-	 * If the last recv() call read an HTTP header,
-	 * `offset` has been moved at the end of any trailing
-	 * payload bytes by http_header_parse(). In this case,
-	 * `offset` is less than `len` and it represents
-	 * the actual payload bytes.
-	 */
-	client->progress += MIN(client->offset, len);
+		switch (rc) {
+		case HTTP_PARSER_MORE:
+			break;
+		case HTTP_PARSER_HEADER:
+			if (http_header_check(client)) {
+				return -1;
+			}
+			break;
+		case HTTP_PARSER_BODY:
+			/* The body is never before the end of the accumulated one */
+			memmove(client->buf + client->offset, body, body_len);
+			client->offset += body_len;
+			client->progress += body_len;
+			break;
+		case HTTP_PARSER_DONE:
+			if (len) {
+				LOG_WRN("Ignoring %d bytes after the response", len);
+			}
+
+			if (client->file_size == 0) {
+				/* End of a chunked body */
+				client->file_size = client->progress;
+			}
+			break;
+		default:
+			return -1;
+		}
+	} while (rc != HTTP_PARSER_MORE && rc != HTTP_PARSER_DONE);
 
-	/* Have we received a whole fragment or the whole file? */
-	if (client->progress != client->file_size &&
-	    client->offset < (client->config.frag_size_override != 0 ?
-			      client->config.frag_size_override :
-			      CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE)) {
+	/* Have we received a whole fragment or the whole response? */
+	if (rc == HTTP_PARSER_MORE && client->offset < frag_size(client)) {
 		return 1;
 	}
 
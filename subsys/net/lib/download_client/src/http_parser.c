@@ -0,0 +1,440 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Incremental HTTP/1.1 response parser.
+ *
+ * The header is parsed one byte at a time, and only the values of the header
+ * fields the download client needs are kept, so the header never has to be
+ * kept whole in a buffer. Field names are matched against all the known
+ * names at once, one character at a time. The body is returned as spans of
+ * the data that is fed, without copying it.
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr.h>
+#include <logging/log.h>
+
+#include "http_parser.h"
+
+LOG_MODULE_DECLARE(download_client, CONFIG_DOWNLOAD_CLIENT_LOG_LEVEL);
+
+enum state {
+	STATUS_LINE,
+	FIELD_NAME,
+	FIELD_VALUE,
+	BODY,
+	CHUNK_SIZE,
+	CHUNK_EXT,
+	CHUNK_DATA,
+	CHUNK_DATA_END,
+	TRAILER,
+	DONE,
+};
+
+enum field {
+	CONTENT_LENGTH,
+	CONTENT_RANGE,
+	TRANSFER_ENCODING,
+	CONNECTION,
+	FIELD_COUNT,
+	FIELD_NONE = FIELD_COUNT,
+};
+
+static const char *const field_names[] = {
+	[CONTENT_LENGTH] = "content-length",
+	[CONTENT_RANGE] = "content-range",
+	[TRANSFER_ENCODING] = "transfer-encoding",
+	[CONNECTION] = "connection",
+};
+
+#define FIELDS_ALL (BIT(FIELD_COUNT) - 1)
+
+BUILD_ASSERT(ARRAY_SIZE(field_names) == FIELD_COUNT);
+BUILD_ASSERT(FIELD_COUNT <= 8, "Field candidates do not fit");
+
+static void field_name_reset(struct download_client_http_parser *p)
+{
+	p->state = FIELD_NAME;
+	p->candidates = FIELDS_ALL;
+	p->name_len = 0;
+}
+
+void http_parser_init(struct download_client_http_parser *p)
+{
+	memset(p, 0, sizeof(*p));
+	p->state = STATUS_LINE;
+}
+
+bool http_parser_done(const struct download_client_http_parser *p)
+{
+	return p->state == DONE;
+}
+
+/* Parse an unsigned decimal number that takes the whole string */
+static int number_parse(const char *str, size_t *num)
+{
+	char *end;
+
+	if (!isdigit((int)*str)) {
+		return -EBADMSG;
+	}
+
+	errno = 0;
+	*num = strtoul(str, &end, 10);
+	if (errno || *end != '\0') {
+		return -EBADMSG;
+	}
+
+	return 0;
+}
+
+static int status_line_parse(struct download_client_http_parser *p)
+{
+	const char *str = p->value;
+
+	/* HTTP/1.x 206 */
+	if (strncmp(str, "http/1.", strlen("http/1.")) != 0 || !isdigit((int)str[7]) ||
+	    str[8] != ' ' || !isdigit((int)str[9]) || !isdigit((int)str[10]) ||
+	    !isdigit((int)str[11])) {
+		LOG_ERR("Malformed HTTP status line");
+		return -EBADMSG;
+	}
+
+	p->status = (str[9] - '0') * 100 + (str[10] - '0') * 10 + (str[11] - '0');
+
+	return 0;
+}
+
+/* Content-Range: bytes first-last/total */
+static int content_range_parse(struct download_client_http_parser *p)
+{
+	char *str = p->value;
+	char *end;
+
+	if (strncmp(str, "bytes ", strlen("bytes ")) != 0) {
+		return -EBADMSG;
+	}
+
+	str += strlen("bytes ");
+
+	p->range_first = strtoul(str, &end, 10);
+	if (end == str || *end != '-') {
+		return -EBADMSG;
+	}
+
+	str = end + 1;
+	p->range_last = strtoul(str, &end, 10);
+	if (end == str || *end != '/' || p->range_last < p->range_first) {
+		return -EBADMSG;
+	}
+
+	/* The total size may be unknown, "*" */
+	return number_parse(end + 1, &p->range_total);
+}
+
+static int field_value_parse(struct download_client_http_parser *p)
+{
+	int err = 0;
+
+	if (p->field == FIELD_NONE) {
+		return 0;
+	}
+
+	p->value[p->value_len] = '\0';
+
+	/* Remove trailing whitespace */
+	while (p->value_len && (p->value[p->value_len - 1] == ' ' ||
+				p->value[p->value_len - 1] == '\t')) {
+		p->value[--p->value_len] = '\0';
+	}
+
+	switch (p->field) {
+	case CONTENT_LENGTH:
+		err = number_parse(p->value, &p->content_length);
+		p->has_length = true;
+		break;
+	case CONTENT_RANGE:
+		err = content_range_parse(p);
+		p->has_range = true;
+		break;
+	case TRANSFER_ENCODING:
+		/* Chunked must be the last encoding */
+		p->chunked = strstr(p->value, "chunked") != NULL;
+		break;
+	case CONNECTION:
+		p->connection_close = strstr(p->value, "close") != NULL;
+		break;
+	}
+
+	if (err) {
+		LOG_ERR("Malformed \"%s\" in response", field_names[p->field]);
+	}
+
+	return err;
+}
+
+/* Pick the body framing. Returns true for an interim (1xx) response */
+static bool header_end(struct download_client_http_parser *p)
+{
+	if (p->status >= 100 && p->status < 200) {
+		/* Skip it, the final response follows */
+		http_parser_init(p);
+		return true;
+	}
+
+	p->chunk_digits = 0;
+	p->left = 0;
+
+	if (p->status == 204 || p->status == 304) {
+		p->state = DONE;
+	} else if (p->chunked) {
+		p->state = CHUNK_SIZE;
+	} else if (p->has_length) {
+		p->left = p->content_length;
+		p->state = p->left ? BODY : DONE;
+	} else if (p->has_range) {
+		p->left = p->range_last - p->range_first + 1;
+		p->state = BODY;
+	} else {
+		/* Delimited by the end of the connection */
+		p->left = SIZE_MAX;
+		p->state = BODY;
+	}
+
+	return false;
+}
+
+static void value_append(struct download_client_http_parser *p, char c)
+{
+	if (p->value_len < sizeof(p->value) - 1) {
+		p->value[p->value_len++] = tolower((int)c);
+	} else {
+		/* Only numbers are parsed in full, they are bound to fail */
+		p->value_truncated = true;
+	}
+}
+
+static void field_name_match(struct download_client_http_parser *p, char c)
+{
+	c = tolower((int)c);
+
+	for (size_t i = 0; i < FIELD_COUNT; i++) {
+		if ((p->candidates & BIT(i)) &&
+		    (p->name_len >= strlen(field_names[i]) ||
+		     field_names[i][p->name_len] != c)) {
+			p->candidates &= ~BIT(i);
+		}
+	}
+
+	if (p->name_len < UINT8_MAX) {
+		p->name_len++;
+	}
+}
+
+static void field_value_start(struct download_client_http_parser *p)
+{
+	p->field = FIELD_NONE;
+
+	for (size_t i = 0; i < FIELD_COUNT; i++) {
+		if ((p->candidates & BIT(i)) && p->name_len == strlen(field_names[i])) {
+			p->field = i;
+			break;
+		}
+	}
+
+	p->value_len = 0;
+	p->value_truncated = false;
+	p->state = FIELD_VALUE;
+}
+
+static int chunk_size_end(struct download_client_http_parser *p)
+{
+	if (p->chunk_digits == 0) {
+		LOG_ERR("Malformed chunk size");
+		return -EBADMSG;
+	}
+
+	p->chunk_digits = 0;
+
+	if (p->left == 0) {
+		/* Last chunk, the trailer follows */
+		p->name_len = 0;
+		p->state = TRAILER;
+	} else {
+		p->state = CHUNK_DATA;
+	}
+
+	return 0;
+}
+
+static int chunk_size_digit(struct download_client_http_parser *p, char c)
+{
+	int digit;
+
+	if (c >= '0' && c <= '9') {
+		digit = c - '0';
+	} else if (c >= 'a' && c <= 'f') {
+		digit = c - 'a' + 10;
+	} else if (c >= 'A' && c <= 'F') {
+		digit = c - 'A' + 10;
+	} else {
+		return -EBADMSG;
+	}
+
+	if (p->left > (SIZE_MAX >> 4)) {
+		return -EBADMSG;
+	}
+
+	p->left = (p->left << 4) | digit;
+	p->chunk_digits++;
+
+	return 0;
+}
+
+int http_parser_feed(struct download_client_http_parser *p, const char *data, size_t len,
+		     size_t *consumed, const char **body, size_t *body_len)
+{
+	size_t i = 0;
+	size_t n;
+	int err = 0;
+
+	while (i < len && !err) {
+		const char c = data[i];
+
+		switch (p->state) {
+		case BODY:
+		case CHUNK_DATA:
+			n = MIN(len - i, p->left);
+			*body = data + i;
+			*body_len = n;
+			*consumed = i + n;
+
+			if (p->left != SIZE_MAX) {
+				p->left -= n;
+			}
+
+			if (p->left == 0) {
+				p->state = (p->state == BODY) ? DONE : CHUNK_DATA_END;
+			}
+
+			return HTTP_PARSER_BODY;
+
+		case DONE:
+			*consumed = i;
+			return HTTP_PARSER_DONE;
+
+		case STATUS_LINE:
+			i++;
+			if (c == '\n') {
+				p->value[p->value_len] = '\0';
+				err = status_line_parse(p);
+				field_name_reset(p);
+			} else if (c != '\r') {
+				value_append(p, c);
+			}
+			break;
+
+		case FIELD_NAME:
+			i++;
+			if (c == '\n') {
+				if (p->name_len) {
+					/* Not a header field, ignore it */
+					field_name_reset(p);
+					break;
+				}
+
+				if (header_end(p)) {
+					break;
+				}
+
+				*consumed = i;
+				return HTTP_PARSER_HEADER;
+			} else if (c == ':') {
+				field_value_start(p);
+			} else if (c != '\r') {
+				field_name_match(p, c);
+			}
+			break;
+
+		case FIELD_VALUE:
+			i++;
+			if (c == '\n') {
+				if (p->value_truncated &&
+				    (p->field == CONTENT_LENGTH || p->field == CONTENT_RANGE)) {
+					LOG_ERR("Malformed \"%s\" in response",
+						field_names[p->field]);
+					err = -EBADMSG;
+					break;
+				}
+
+				err = field_value_parse(p);
+				field_name_reset(p);
+			} else if (c == '\r' || p->field == FIELD_NONE) {
+				/* Skip */
+			} else if (p->value_len || (c != ' ' && c != '\t')) {
+				value_append(p, c);
+			}
+			break;
+
+		case CHUNK_SIZE:
+			i++;
+			if (c == '\n') {
+				err = chunk_size_end(p);
+			} else if (c == ';' || c == ' ' || c == '\t') {
+				p->state = CHUNK_EXT;
+			} else if (c != '\r') {
+				err = chunk_size_digit(p, c);
+				if (err) {
+					LOG_ERR("Malformed chunk size");
+				}
+			}
+			break;
+
+		case CHUNK_EXT:
+			i++;
+			if (c == '\n') {
+				err = chunk_size_end(p);
+			}
+			break;
+
+		case CHUNK_DATA_END:
+			i++;
+			if (c == '\n') {
+				p->state = CHUNK_SIZE;
+			} else if (c != '\r') {
+				LOG_ERR("Chunk longer than its size");
+				err = -EBADMSG;
+			}
+			break;
+
+		case TRAILER:
+			i++;
+			if (c == '\n') {
+				if (p->name_len == 0) {
+					p->state = DONE;
+					*consumed = i;
+					return HTTP_PARSER_DONE;
+				}
+
+				p->name_len = 0;
+			} else if (c != '\r') {
+				p->name_len = 1;
+			}
+			break;
+		}
+	}
+
+	*consumed = i;
+
+	if (err) {
+		return err;
+	}
+
+	return (p->state == DONE) ? HTTP_PARSER_DONE : HTTP_PARSER_MORE;
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef HTTP_PARSER_H__
+#define HTTP_PARSER_H__
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <net/download_client.h>
+
+/** Results of @ref http_parser_feed. */
+enum http_parser_result {
+	/** All data consumed, more is needed. */
+	HTTP_PARSER_MORE,
+	/** The header has been parsed, the fields can be read from the parser. */
+	HTTP_PARSER_HEADER,
+	/** Body bytes are available. */
+	HTTP_PARSER_BODY,
+	/** The response is complete. Any following data is the next response. */
+	HTTP_PARSER_DONE,
+};
+
+/**
+ * @brief Prepare the parser for a new response.
+ *
+ * @param parser Parser.
+ */
+void http_parser_init(struct download_client_http_parser *parser);
+
+/**
+ * @brief Parse response data.
+ *
+ * Every byte is looked at once, so the data can be fed in pieces of any
+ * size, and does not need to be kept once it has been consumed.
+ * Parsing stops at each result other than @ref HTTP_PARSER_MORE,
+ * call again with the remaining data to continue.
+ *
+ * @param parser   Parser.
+ * @param data     Response data.
+ * @param len      Length of data.
+ * @param consumed Number of bytes consumed.
+ * @param body     Body bytes, within data, on @ref HTTP_PARSER_BODY.
+ *		   The chunk framing of a chunked body is removed.
+ * @param body_len Number of body bytes, on @ref HTTP_PARSER_BODY.
+ *
+ * @return A value of @ref http_parser_result, or -EBADMSG
+ *	   if the response is malformed.
+ */
+int http_parser_feed(struct download_client_http_parser *parser, const char *data, size_t len,
+		     size_t *consumed, const char **body, size_t *body_len);
+
+/**
+ * @brief Check whether the whole response has been parsed.
+ *
+ * @param parser Parser.
+ *
+ * @return true if the response is complete.
+ */
+bool http_parser_done(const struct download_client_http_parser *parser);
+
+#endif /* HTTP_PARSER_H__ */
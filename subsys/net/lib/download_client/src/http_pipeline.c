@@ -0,0 +1,578 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Pipelined and parallel HTTP range requests.
+ *
+ * Each connection keeps up to CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE_DEPTH range
+ * requests outstanding. The server answers them in order, so a connection
+ * always receives the response to its oldest request. Disjoint ranges are
+ * requested in file order, round-robin over the connections.
+ *
+ * A connection that has received a whole fragment stops reading until all
+ * the preceding fragments have been delivered. The response buffers of the
+ * connections are thus the reassembly buffer, and fragments are delivered
+ * to the application in order, without copying.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <zephyr.h>
+#if defined(CONFIG_POSIX_API)
+#include <posix/unistd.h>
+#include <posix/poll.h>
+#include <posix/sys/socket.h>
+#else
+#include <net/socket.h>
+#endif
+#include <net/download_client.h>
+#include <logging/log.h>
+
+#include "http_parser.h"
+
+LOG_MODULE_DECLARE(download_client, CONFIG_DOWNLOAD_CLIENT_LOG_LEVEL);
+
+#define HOSTNAME_SIZE CONFIG_DOWNLOAD_CLIENT_MAX_HOSTNAME_SIZE
+#define FILENAME_SIZE CONFIG_DOWNLOAD_CLIENT_MAX_FILENAME_SIZE
+#define CONNECTIONS CONFIG_DOWNLOAD_CLIENT_HTTP_CONNECTIONS
+#define DEPTH CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE_DEPTH
+
+#define HTTP_GET_RANGE                                                         \
+	"GET /%s HTTP/1.1\r\n"                                                 \
+	"Host: %s\r\n"                                                         \
+	"Range: bytes=%u-%u\r\n"                                               \
+	"Connection: keep-alive\r\n"                                           \
+	"\r\n"
+
+int url_parse_host(const char *url, char *host, size_t len);
+int url_parse_file(const char *url, char *file, size_t len);
+int client_connect(struct download_client *dl, int *fd);
+int error_evt_send(const struct download_client *dl, int error);
+int reconnect(struct download_client *dl);
+
+bool http_pipeline_in_use(const struct download_client *client)
+{
+	return client->proto == IPPROTO_TLS_1_2 ||
+	       (client->proto == IPPROTO_TCP &&
+		IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_RANGE_REQUESTS));
+}
+
+static size_t frag_size(const struct download_client *client)
+{
+	return client->config.frag_size_override ? client->config.frag_size_override :
+						   CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE;
+}
+
+static bool conn_frag_complete(const struct download_client_http_conn *conn)
+{
+	return conn->req_cnt && http_parser_done(&conn->parser);
+}
+
+static void conns_init(struct download_client *client)
+{
+	for (size_t i = 0; i < CONNECTIONS; i++) {
+		struct download_client_http_conn *conn = &client->http.conn[i];
+
+		conn->fd = -1;
+		conn->offset = 0;
+		conn->parsed = 0;
+		http_parser_init(&conn->parser);
+		conn->connection_close = false;
+		conn->req_cnt = 0;
+	}
+
+	client->http.conn[0].fd = client->fd;
+	client->http.conn[0].buf = client->buf;
+#if CONNECTIONS > 1
+	for (size_t i = 1; i < CONNECTIONS; i++) {
+		client->http.conn[i].buf = client->http_conn_buf[i - 1];
+	}
+#endif
+
+	client->http.next = client->progress;
+}
+
+/* Close the additional connections. The first one belongs to the client. */
+static void conns_close(struct download_client *client)
+{
+	for (size_t i = 1; i < CONNECTIONS; i++) {
+		struct download_client_http_conn *conn = &client->http.conn[i];
+
+		if (conn->fd >= 0) {
+			close(conn->fd);
+			conn->fd = -1;
+		}
+	}
+}
+
+static int conn_send(const struct download_client_http_conn *conn, const char *buf, size_t len)
+{
+	ssize_t sent;
+
+	while (len) {
+		sent = send(conn->fd, buf, len, 0);
+		if (sent < 0) {
+			return -errno;
+		}
+
+		buf += sent;
+		len -= sent;
+	}
+
+	return 0;
+}
+
+static int conn_request_send(struct download_client *client,
+			     struct download_client_http_conn *conn,
+			     const char *host, const char *file)
+{
+	size_t from = client->http.next;
+	size_t len = frag_size(client);
+	int err;
+	int n;
+
+	if (client->file_size) {
+		len = MIN(len, client->file_size - from);
+	}
+
+	n = snprintf(client->http.req_buf, sizeof(client->http.req_buf), HTTP_GET_RANGE, file,
+		     host, from, from + len - 1);
+	if (n < 0 || n >= sizeof(client->http.req_buf)) {
+		LOG_ERR("Cannot create GET request, buffer too small");
+		return -ENOMEM;
+	}
+
+	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_LOG_HEADERS)) {
+		LOG_HEXDUMP_DBG(client->http.req_buf, n, "HTTP request");
+	}
+
+	err = conn_send(conn, client->http.req_buf, n);
+	if (err) {
+		LOG_ERR("Failed to send HTTP request, err %d", err);
+		return err;
+	}
+
+	conn->req[conn->req_cnt].from = from;
+	conn->req[conn->req_cnt].len = len;
+	conn->req_cnt++;
+	client->http.next += len;
+
+	return 0;
+}
+
+static bool request_allowed(const struct download_client *client)
+{
+	if (client->file_size == 0) {
+		/* Only one request until the file size is known */
+		for (size_t i = 0; i < CONNECTIONS; i++) {
+			if (client->http.conn[i].req_cnt) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	return client->http.next < client->file_size;
+}
+
+/* Keep the pipelines of all connections full, in round-robin order
+ * so that consecutive fragments arrive over different connections.
+ */
+static int requests_send(struct download_client *client, const char *host, const char *file,
+			 struct download_client_http_conn **failed)
+{
+	bool sent;
+	int err;
+
+	do {
+		sent = false;
+
+		for (size_t i = 0; i < CONNECTIONS; i++) {
+			struct download_client_http_conn *conn = &client->http.conn[i];
+
+			if (conn->fd < 0 || conn->req_cnt == DEPTH || conn->connection_close ||
+			    !request_allowed(client)) {
+				continue;
+			}
+
+			err = conn_request_send(client, conn, host, file);
+			if (err) {
+				*failed = conn;
+				return err;
+			}
+
+			sent = true;
+		}
+	} while (sent);
+
+	return 0;
+}
+
+/* Check the header of the response to the oldest request */
+static int conn_header_check(struct download_client *client,
+			     struct download_client_http_conn *conn)
+{
+	const struct download_client_http_parser *parser = &conn->parser;
+
+	if (parser->status != 206) {
+		LOG_ERR("Unexpected HTTP response: %d", parser->status);
+		return -1;
+	}
+
+	if (!parser->has_range || parser->chunked) {
+		LOG_ERR("Server did not send \"Content-Range\" in response");
+		return -1;
+	}
+
+	if (parser->range_first != conn->req[0].from ||
+	    parser->range_last - parser->range_first + 1 > conn->req[0].len ||
+	    (parser->has_length &&
+	     parser->content_length != parser->range_last - parser->range_first + 1)) {
+		LOG_ERR("Unexpected range %u-%u/%u", parser->range_first, parser->range_last,
+			parser->range_total);
+		return -1;
+	}
+
+	if (client->file_size == 0) {
+		client->file_size = parser->range_total;
+		LOG_DBG("File size = %u", client->file_size);
+	}
+
+	/* The first range may have been clamped to the end of the file */
+	conn->req[0].len = parser->range_last - parser->range_first + 1;
+
+	if (parser->connection_close) {
+		LOG_WRN("Peer closed connection, will re-connect");
+		conn->connection_close = true;
+	}
+
+	return 0;
+}
+
+/* Parse the received data of the oldest response. The header is removed from
+ * the buffer as it is parsed, so that the body starts the buffer, and parsing
+ * stops at the end of the body. Data of the next response stays in the buffer.
+ * Returns 0 on success or when more data is needed, -1 on error.
+ */
+static int conn_parse(struct download_client *client, struct download_client_http_conn *conn)
+{
+	const char *body;
+	size_t body_len;
+	size_t consumed;
+	int rc;
+
+	while (conn->req_cnt && conn->parsed < conn->offset && !http_parser_done(&conn->parser)) {
+		rc = http_parser_feed(&conn->parser, conn->buf + conn->parsed,
+				      conn->offset - conn->parsed, &consumed, &body, &body_len);
+		if (rc < 0) {
+			return -1;
+		}
+
+		if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_LOG_HEADERS) && rc != HTTP_PARSER_BODY) {
+			LOG_HEXDUMP_DBG(conn->buf + conn->parsed, consumed, "HTTP response");
+		}
+
+		conn->parsed += consumed;
+
+		if (rc == HTTP_PARSER_MORE) {
+			/* The header is incomplete, its parsed part is not needed */
+			conn->offset = 0;
+			conn->parsed = 0;
+		} else if (rc == HTTP_PARSER_HEADER) {
+			if (conn_header_check(client, conn)) {
+				return -1;
+			}
+
+			memmove(conn->buf, conn->buf + conn->parsed, conn->offset - conn->parsed);
+			conn->offset -= conn->parsed;
+			conn->parsed = 0;
+		}
+	}
+
+	return 0;
+}
+
+/* Remove the delivered fragment, and parse any data of the next response */
+static int conn_frag_consume(struct download_client *client,
+			     struct download_client_http_conn *conn)
+{
+	memmove(conn->buf, conn->buf + conn->parsed, conn->offset - conn->parsed);
+	conn->offset -= conn->parsed;
+	conn->parsed = 0;
+	http_parser_init(&conn->parser);
+
+	conn->req_cnt--;
+	memmove(&conn->req[0], &conn->req[1], conn->req_cnt * sizeof(conn->req[0]));
+
+	return conn_parse(client, conn);
+}
+
+static int frag_evt_send(struct download_client *client,
+			 const struct download_client_http_conn *conn)
+{
+	const struct download_client_evt evt = {
+		.id = DOWNLOAD_CLIENT_EVT_FRAGMENT,
+		.fragment = {
+			.buf = conn->buf,
+			.len = conn->req[0].len,
+		}
+	};
+
+	return client->callback(&evt);
+}
+
+/* Deliver the fragments that are next in order.
+ * Returns 0 on success, 1 if the application stopped the download
+ * and -1 on a malformed response.
+ */
+static int frags_deliver(struct download_client *client, bool *restart)
+{
+	bool delivered;
+
+	do {
+		delivered = false;
+
+		for (size_t i = 0; i < CONNECTIONS; i++) {
+			struct download_client_http_conn *conn = &client->http.conn[i];
+			bool close;
+
+			if (!conn_frag_complete(conn) || conn->req[0].from != client->progress) {
+				continue;
+			}
+
+			client->progress += conn->req[0].len;
+
+			LOG_INF("Downloaded %u/%u bytes (%d%%)", client->progress,
+				client->file_size,
+				(client->progress * 100) / client->file_size);
+
+			if (frag_evt_send(client, conn)) {
+				LOG_INF("Fragment refused, download stopped.");
+				return 1;
+			}
+
+			close = conn->connection_close;
+
+			if (conn_frag_consume(client, conn)) {
+				return -1;
+			}
+
+			if (close) {
+				/* Requests after the closing response are lost */
+				*restart = true;
+				return 0;
+			}
+
+			delivered = true;
+		}
+	} while (delivered);
+
+	return 0;
+}
+
+static int conns_open(struct download_client *client)
+{
+	int err;
+
+	for (size_t i = 1; i < CONNECTIONS; i++) {
+		struct download_client_http_conn *conn = &client->http.conn[i];
+
+		if (conn->fd >= 0) {
+			continue;
+		}
+
+		err = client_connect(client, &conn->fd);
+		if (err) {
+			LOG_WRN("Failed to open connection %d, err %d", i, err);
+			return err;
+		}
+	}
+
+	return 0;
+}
+
+static int conns_poll(struct download_client *client, struct download_client_http_conn **ready)
+{
+	struct pollfd fds[CONNECTIONS];
+	struct download_client_http_conn *conns[CONNECTIONS];
+	int nfds = 0;
+	int rc;
+
+	for (size_t i = 0; i < CONNECTIONS; i++) {
+		struct download_client_http_conn *conn = &client->http.conn[i];
+
+		/* A complete fragment waits for the ones before it */
+		if (conn->fd < 0 || conn->req_cnt == 0 || conn_frag_complete(conn)) {
+			continue;
+		}
+
+		fds[nfds].fd = conn->fd;
+		fds[nfds].events = POLLIN;
+		fds[nfds].revents = 0;
+		conns[nfds] = conn;
+		nfds++;
+	}
+
+	__ASSERT(nfds > 0, "No connection to receive from");
+
+	rc = poll(fds, nfds, CONFIG_DOWNLOAD_CLIENT_TCP_SOCK_TIMEO_MS);
+	if (rc < 0) {
+		return -errno;
+	}
+
+	if (rc == 0) {
+		return -ETIMEDOUT;
+	}
+
+	for (int i = 0; i < nfds; i++) {
+		if (fds[i].revents) {
+			*ready = conns[i];
+			return 0;
+		}
+	}
+
+	return -ETIMEDOUT;
+}
+
+static int conn_recv(struct download_client *client, struct download_client_http_conn *conn)
+{
+	ssize_t len;
+
+	if (conn->offset == CONFIG_DOWNLOAD_CLIENT_BUF_SIZE) {
+		LOG_ERR("Could not fit HTTP response from server (> %d)",
+			CONFIG_DOWNLOAD_CLIENT_BUF_SIZE);
+		return -E2BIG;
+	}
+
+	len = recv(conn->fd, conn->buf + conn->offset,
+		   CONFIG_DOWNLOAD_CLIENT_BUF_SIZE - conn->offset, 0);
+	if (len < 0) {
+		LOG_ERR("Error in recv(), errno %d", errno);
+		return (errno == EAGAIN || errno == EWOULDBLOCK) ? -ETIMEDOUT : -ECONNRESET;
+	}
+
+	if (len == 0) {
+		LOG_WRN("Peer closed connection!");
+		return -ECONNRESET;
+	}
+
+	LOG_DBG("Read %d bytes from socket", len);
+
+	conn->offset += len;
+
+	if (conn_parse(client, conn)) {
+		return -EBADMSG;
+	}
+
+	return 0;
+}
+
+int http_pipeline_download(struct download_client *client)
+{
+	struct download_client_http_conn *conn;
+	char host[HOSTNAME_SIZE];
+	char file[FILENAME_SIZE];
+	bool conns_opened;
+	bool restart;
+	int err;
+	int rc;
+
+	err = url_parse_host(client->host, host, sizeof(host));
+	if (!err) {
+		err = url_parse_file(client->file, file, sizeof(file));
+	}
+
+	if (err) {
+		error_evt_send(client, EINVAL);
+		return err;
+	}
+
+restart:
+	conns_close(client);
+	conns_init(client);
+	conns_opened = false;
+
+	while (true) {
+		conn = NULL;
+		restart = false;
+
+		rc = frags_deliver(client, &restart);
+		if (rc > 0) {
+			break;
+		} else if (rc < 0) {
+			error_evt_send(client, EBADMSG);
+			break;
+		}
+
+		if (client->file_size && client->progress == client->file_size) {
+			LOG_INF("Download complete");
+			const struct download_client_evt evt = {
+				.id = DOWNLOAD_CLIENT_EVT_DONE,
+			};
+			client->callback(&evt);
+			break;
+		}
+
+		if (restart) {
+			err = reconnect(client);
+			if (err) {
+				error_evt_send(client, EHOSTDOWN);
+				break;
+			}
+
+			goto restart;
+		}
+
+		/* Open the additional connections once there is enough to download.
+		 * The download continues with fewer connections if that fails.
+		 */
+		if (CONNECTIONS > 1 && !conns_opened && client->file_size &&
+		    client->file_size - client->http.next > frag_size(client) * DEPTH) {
+			(void)conns_open(client);
+			conns_opened = true;
+		}
+
+		/* Refill the pipelines that delivering has freed */
+		err = requests_send(client, host, file, &conn);
+		if (err) {
+			err = -ECONNRESET;
+			goto conn_error;
+		}
+
+		err = conns_poll(client, &conn);
+		if (!err) {
+			err = conn_recv(client, conn);
+		}
+
+		if (err == -EBADMSG || err == -E2BIG) {
+			error_evt_send(client, -err);
+			break;
+		} else if (!err) {
+			continue;
+		}
+
+conn_error:
+		/* Notify the application of the error via an event.
+		 * Attempt to reconnect and resume the download
+		 * if the application returns Zero via the event.
+		 */
+		if (error_evt_send(client, -err)) {
+			break;
+		}
+
+		err = reconnect(client);
+		if (err) {
+			error_evt_send(client, EHOSTDOWN);
+			break;
+		}
+
+		goto restart;
+	}
+
+	conns_close(client);
+
+	return 0;
+}
@@ -85,6 +85,13 @@ extern "C" {
 #define NRF_CLOUD_CELL_POS_TYPE_VAL_SCELL	"SCELL"
 #define NRF_CLOUD_CELL_POS_TYPE_VAL_MCELL	"MCELL"
 
+/* Modem returns RSRP and RSRQ as index values which require
+ * a conversion to dBm and dB respectively. See modem AT
+ * command reference guide for more information.
+ */
+#define RSRP_ADJ(rsrp) (rsrp - ((rsrp <= 0) ? 140 : 141))
+#define RSRQ_ADJ(rsrq) (((double)rsrq * 0.5) - 19.5)
+
 /* P-GPS */
 #define NRF_CLOUD_JSON_PGPS_PRED_COUNT		"predictionCount"
 #define NRF_CLOUD_JSON_PGPS_INT_MIN		"predictionIntervalMinutes"
@@ -173,6 +180,12 @@ int nrf_cloud_parse_pgps_response(const char *const response,
 /** @brief Adds common [network] modem info to the provided cJSON object */
 int nrf_cloud_json_add_modem_info(cJSON * const data_obj);
 
+/** @brief Obtains the serving cell info from the modem, for a [single-cell]
+ * cellular positioning request. Items that the modem does not report are
+ * set to the values that omit them from the request.
+ */
+int nrf_cloud_get_single_cell_modem_info(struct lte_lc_cells_info *const cell_inf);
+
 /** @brief Builds a cellular positioning request string using the provided cell info.
  * If successful, memory will be allocated for the output string and the user is
  * responsible for freeing it using @ref cJSON_free.
@@ -210,6 +223,22 @@ int get_string_from_array(const cJSON * const array, const int index,
 int get_string_from_obj(const cJSON * const obj, const char *const key,
 			char **string_out);
 
+/** @brief Encodes a sensor data message in CBOR, with the same content as the
+ * JSON message. If successful, memory will be allocated for the output and the
+ * user is responsible for freeing it using @ref nrf_cloud_free.
+ */
+int nrf_cloud_cbor_encode_sensor_data(const char *const app_id,
+				      const struct nrf_cloud_data *const data,
+				      struct nrf_cloud_data *const output);
+
+/** @brief Encodes a cellular positioning request message in CBOR, with the same
+ * content as the JSON message. If successful, memory will be allocated for the
+ * output and the user is responsible for freeing it using @ref nrf_cloud_free.
+ */
+int nrf_cloud_cbor_encode_cell_pos_req(const struct lte_lc_cells_info *const inf,
+				       const bool request_loc,
+				       struct nrf_cloud_data *const output);
+
 /** @brief Sends the cJSON object to nRF Cloud on the d2c topic */
 int json_send_to_cloud(cJSON * const request);
 
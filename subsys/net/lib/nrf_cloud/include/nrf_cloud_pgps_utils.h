@@ -42,13 +42,35 @@ struct gps_location {
 	int64_t gps_sec;
 };
 
+#define NPGPS_INDEX_VERSION		1
+
+/* Entry of the flash index, for one block of the storage */
+struct npgps_index_entry {
+	/* GPS time of the stored prediction in seconds, same as its sentinel;
+	 * 0 if the block does not hold a prediction
+	 */
+	uint32_t sentinel;
+	/* CRC-32 of the stored prediction */
+	uint32_t crc;
+} __packed;
+
+/* Flash index of the stored predictions, saved with the settings */
+struct npgps_index {
+	uint8_t version;
+	uint8_t num_blocks;
+	struct npgps_index_entry entries[NUM_BLOCKS];
+} __packed;
+
 struct nrf_cloud_pgps_header;
+struct nrf_cloud_pgps_prediction;
 
 typedef int (*npgps_buffer_handler_t)(uint8_t *buf, size_t len);
 
 /* settings functions */
 int npgps_save_header(struct nrf_cloud_pgps_header *header);
 const struct nrf_cloud_pgps_header *npgps_get_saved_header(void);
+int npgps_save_index(const struct npgps_index *index);
+const struct npgps_index *npgps_get_saved_index(void);
 const struct gps_location *npgps_get_saved_location(void);
 int npgps_settings_init(void);
 
@@ -74,6 +96,20 @@ uint32_t npgps_block_to_offset(int block);
 int npgps_pointer_to_block(uint8_t *p);
 void *npgps_block_to_pointer(int block);
 
+/* flash index functions */
+void npgps_index_reset(void);
+int npgps_index_restore(const struct npgps_index *saved);
+const struct npgps_index *npgps_index_get(void);
+void npgps_index_set(int block, uint32_t sentinel, uint32_t crc);
+void npgps_index_clear(int block);
+int npgps_index_map(int64_t start_sec, uint32_t period_sec, int count, int *blocks);
+/* Build the catalog of predictions from a saved index, without reading them.
+ * Returns the number of predictions found, or -ENOENT if the index is not valid.
+ */
+int npgps_index_catalog(const struct npgps_index *saved, int64_t start_sec, uint32_t period_sec,
+			int count, struct nrf_cloud_pgps_prediction **predictions);
+int npgps_index_verify(int block, const uint8_t *data, size_t len);
+
 /* download functions */
 int npgps_download_init(npgps_buffer_handler_t handler);
 int npgps_download_start(const char *host, const char *file, int sec_tag,
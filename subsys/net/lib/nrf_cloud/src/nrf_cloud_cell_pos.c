@@ -24,9 +24,50 @@ int nrf_cloud_cell_pos_request_json_get(const struct lte_lc_cells_info *const ce
 
 #include "nrf_cloud_codec.h"
 #include "nrf_cloud_transport.h"
+#include "nrf_cloud_mem.h"
 
 #define CELL_POS_JSON_CELL_LOC_KEY_DOREPLY	"doReply"
 
+static int cell_pos_request_cbor_send(const struct lte_lc_cells_info *cells_inf,
+				      const bool request_loc, nrf_cloud_cell_pos_response_t cb)
+{
+	struct lte_lc_cells_info modem_inf;
+	struct nct_dc_data msg = {
+		.message_id = NCT_MSG_ID_USE_NEXT_INCREMENT
+	};
+	int err;
+
+	if (!cells_inf) {
+		/* Fetch modem info for a single-cell request */
+		err = nrf_cloud_get_single_cell_modem_info(&modem_inf);
+		if (err) {
+			return err;
+		}
+
+		cells_inf = &modem_inf;
+	}
+
+	err = nrf_cloud_cbor_encode_cell_pos_req(cells_inf, request_loc, &msg.data);
+	if (err) {
+		LOG_ERR("Failed to encode location request, error: %d", err);
+		return err;
+	}
+
+	LOG_HEXDUMP_DBG(msg.data.ptr, msg.data.len, "Created request");
+
+	if (request_loc) {
+		nfsm_set_cell_pos_response_cb(cb);
+	}
+
+	err = nct_dc_send(&msg);
+	if (err) {
+		LOG_ERR("Failed to send request, error: %d", err);
+	}
+
+	nrf_cloud_free((void *)msg.data.ptr);
+	return err;
+}
+
 int nrf_cloud_cell_pos_request(const struct lte_lc_cells_info *const cells_inf,
 			       const bool request_loc, nrf_cloud_cell_pos_response_t cb)
 {
@@ -34,6 +75,10 @@ int nrf_cloud_cell_pos_request(const struct lte_lc_cells_info *const cells_inf,
 		return -EACCES;
 	}
 
+	if (IS_ENABLED(CONFIG_NRF_CLOUD_CODEC_CBOR)) {
+		return cell_pos_request_cbor_send(cells_inf, request_loc, cb);
+	}
+
 	int err = 0;
 	cJSON *cell_pos_req_obj = NULL;
 
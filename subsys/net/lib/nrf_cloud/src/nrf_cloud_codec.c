@@ -23,13 +23,6 @@ LOG_MODULE_REGISTER(nrf_cloud_codec, CONFIG_NRF_CLOUD_LOG_LEVEL);
 #define TIMEOUT_STR "timeout"
 #define PAIRED_STR "paired"
 
-/* Modem returns RSRP and RSRQ as index values which require
- * a conversion to dBm and dB respectively. See modem AT
- * command reference guide for more information.
- */
-#define RSRP_ADJ(rsrp) (rsrp - ((rsrp <= 0) ? 140 : 141))
-#define RSRQ_ADJ(rsrq) (((double)rsrq * 0.5) - 19.5)
-
 bool initialized;
 
 #if defined(CONFIG_NRF_CLOUD_MQTT)
@@ -198,6 +191,34 @@ int nrf_cloud_json_add_modem_info(cJSON *const data_obj)
 	return json_format_modem_info_data_obj(data_obj, &modem_info);
 }
 
+int nrf_cloud_get_single_cell_modem_info(struct lte_lc_cells_info *const cell_inf)
+{
+	__ASSERT_NO_MSG(cell_inf != NULL);
+
+	struct modem_param_info modem_info = {0};
+	int err;
+
+	err = get_modem_info(&modem_info);
+	if (err) {
+		return err;
+	}
+
+	*cell_inf = (struct lte_lc_cells_info) {
+		.current_cell = {
+			.mcc = modem_info.network.mcc.value,
+			.mnc = modem_info.network.mnc.value,
+			.id = (uint32_t)modem_info.network.cellid_dec,
+			.tac = modem_info.network.area_code.value,
+			.earfcn = NRF_CLOUD_CELL_POS_OMIT_EARFCN,
+			.timing_advance = NRF_CLOUD_CELL_POS_OMIT_TIME_ADV,
+			.rsrp = modem_info.network.rsrp.value,
+			.rsrq = NRF_CLOUD_CELL_POS_OMIT_RSRQ,
+		},
+	};
+
+	return 0;
+}
+
 static int json_add_obj_cs(cJSON *parent, const char *str, cJSON *item)
 {
 	if (!parent || !str || !item) {
@@ -336,6 +357,11 @@ int nrf_cloud_encode_sensor_data(const struct nrf_cloud_sensor_data *sensor,
 	__ASSERT_NO_MSG(output != NULL);
 	__ASSERT_NO_MSG(sensor->type < SENSOR_TYPE_ARRAY_SIZE);
 
+	if (IS_ENABLED(CONFIG_NRF_CLOUD_CODEC_CBOR)) {
+		return nrf_cloud_cbor_encode_sensor_data(sensor_type_str[sensor->type],
+							 &sensor->data, output);
+	}
+
 	cJSON *root_obj = cJSON_CreateObject();
 
 	if (root_obj == NULL) {
@@ -0,0 +1,319 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <errno.h>
+#include <math.h>
+#include <string.h>
+#include <logging/log.h>
+#include <zcbor_encode.h>
+
+#include "nrf_cloud_codec.h"
+#include "nrf_cloud_mem.h"
+
+LOG_MODULE_REGISTER(nrf_cloud_codec_cbor, CONFIG_NRF_CLOUD_LOG_LEVEL);
+
+/* Deepest nesting of lists and maps, in the cellular positioning request */
+#define STATE_BACKUPS	6
+
+/* Upper bounds of the encoded sizes, used to allocate the messages */
+#define HEAD_SIZE_MAX			9
+#define TEXT_SIZE_MAX(len)		(HEAD_SIZE_MAX + (len))
+#define LIT_SIZE_MAX(lit)		TEXT_SIZE_MAX(sizeof(lit) - 1)
+#define KEY_NUMBER_SIZE_MAX(key)	(LIT_SIZE_MAX(key) + HEAD_SIZE_MAX)
+
+#define CELL_POS_KEY_DOREPLY	"doReply"
+
+#define NCELL_SIZE_MAX (HEAD_SIZE_MAX +						\
+	KEY_NUMBER_SIZE_MAX(NRF_CLOUD_CELL_POS_JSON_KEY_EARFCN) +		\
+	KEY_NUMBER_SIZE_MAX(NRF_CLOUD_CELL_POS_JSON_KEY_PCI) +			\
+	KEY_NUMBER_SIZE_MAX(NRF_CLOUD_CELL_POS_JSON_KEY_RSRP) +			\
+	KEY_NUMBER_SIZE_MAX(NRF_CLOUD_CELL_POS_JSON_KEY_RSRQ))
+
+#define CELL_SIZE_MAX (HEAD_SIZE_MAX +						\
+	KEY_NUMBER_SIZE_MAX(NRF_CLOUD_CELL_POS_JSON_KEY_ECI) +			\
+	KEY_NUMBER_SIZE_MAX(NRF_CLOUD_CELL_POS_JSON_KEY_MCC) +			\
+	KEY_NUMBER_SIZE_MAX(NRF_CLOUD_CELL_POS_JSON_KEY_MNC) +			\
+	KEY_NUMBER_SIZE_MAX(NRF_CLOUD_CELL_POS_JSON_KEY_TAC) +			\
+	KEY_NUMBER_SIZE_MAX(NRF_CLOUD_CELL_POS_JSON_KEY_EARFCN) +		\
+	KEY_NUMBER_SIZE_MAX(NRF_CLOUD_CELL_POS_JSON_KEY_RSRP) +			\
+	KEY_NUMBER_SIZE_MAX(NRF_CLOUD_CELL_POS_JSON_KEY_RSRQ) +			\
+	KEY_NUMBER_SIZE_MAX(NRF_CLOUD_CELL_POS_JSON_KEY_T_ADV) +		\
+	LIT_SIZE_MAX(NRF_CLOUD_CELL_POS_JSON_KEY_NBORS) + HEAD_SIZE_MAX)
+
+/* Without neighbor cells */
+#define CELL_POS_REQ_SIZE_MAX (HEAD_SIZE_MAX +					\
+	LIT_SIZE_MAX(NRF_CLOUD_JSON_APPID_KEY) +				\
+	LIT_SIZE_MAX(NRF_CLOUD_JSON_APPID_VAL_CELL_POS) +			\
+	LIT_SIZE_MAX(NRF_CLOUD_JSON_MSG_TYPE_KEY) +				\
+	LIT_SIZE_MAX(NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA) +			\
+	LIT_SIZE_MAX(NRF_CLOUD_JSON_DATA_KEY) + HEAD_SIZE_MAX +			\
+	LIT_SIZE_MAX(NRF_CLOUD_CELL_POS_JSON_KEY_LTE) + HEAD_SIZE_MAX +		\
+	CELL_SIZE_MAX + KEY_NUMBER_SIZE_MAX(CELL_POS_KEY_DOREPLY))
+
+/* The maps are encoded with a definite length */
+#if !defined(ZCBOR_CANONICAL)
+#error "CONFIG_ZCBOR_CANONICAL is required"
+#endif
+
+static bool text_put(zcbor_state_t *state, const char *str, size_t len)
+{
+	const struct zcbor_string text = {
+		.value = (const uint8_t *)str,
+		.len = len,
+	};
+
+	return zcbor_tstr_encode(state, &text);
+}
+
+static bool str_put(zcbor_state_t *state, const char *str)
+{
+	return text_put(state, str, strlen(str));
+}
+
+/* Integral values are encoded as integers, others as the smallest lossless float */
+static bool number_put(zcbor_state_t *state, double value)
+{
+	if (value == floor(value) && fabs(value) < 0x1p63) {
+		return zcbor_int64_put(state, (int64_t)value);
+	}
+
+	if ((double)(float)value == value) {
+		return zcbor_float32_put(state, (float)value);
+	}
+
+	return zcbor_float64_put(state, value);
+}
+
+static bool key_str_put(zcbor_state_t *state, const char *key, const char *str)
+{
+	return str_put(state, key) && str_put(state, str);
+}
+
+static bool key_number_put(zcbor_state_t *state, const char *key, double value)
+{
+	return str_put(state, key) && number_put(state, value);
+}
+
+/* Encode a message into a buffer of at most size bytes, which is then owned by the output */
+static int encode(bool (*encoder)(zcbor_state_t *state, const void *ctx), const void *ctx,
+		  size_t size, struct nrf_cloud_data *output)
+{
+	uint8_t *buf = nrf_cloud_malloc(size);
+
+	if (!buf) {
+		return -ENOMEM;
+	}
+
+	ZCBOR_STATE_E(states, STATE_BACKUPS, buf, size, 1);
+
+	if (!encoder(states, ctx)) {
+		LOG_ERR("Failed to encode message");
+		nrf_cloud_free(buf);
+		return -ENOMEM;
+	}
+
+	output->ptr = buf;
+	output->len = states[0].payload - buf;
+
+	return 0;
+}
+
+struct sensor_data_ctx {
+	const char *app_id;
+	const struct nrf_cloud_data *data;
+};
+
+static bool sensor_data_encode(zcbor_state_t *state, const void *ctx)
+{
+	const struct sensor_data_ctx *sensor = ctx;
+
+	return zcbor_map_start_encode(state, 3) &&
+	       key_str_put(state, NRF_CLOUD_JSON_APPID_KEY, sensor->app_id) &&
+	       str_put(state, NRF_CLOUD_JSON_DATA_KEY) &&
+	       text_put(state, sensor->data->ptr, sensor->data->len) &&
+	       key_str_put(state, NRF_CLOUD_JSON_MSG_TYPE_KEY, NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA) &&
+	       zcbor_map_end_encode(state, 3);
+}
+
+int nrf_cloud_cbor_encode_sensor_data(const char *const app_id,
+				      const struct nrf_cloud_data *const data,
+				      struct nrf_cloud_data *const output)
+{
+	__ASSERT_NO_MSG(app_id != NULL);
+	__ASSERT_NO_MSG(data != NULL);
+	__ASSERT_NO_MSG(data->ptr != NULL);
+	__ASSERT_NO_MSG(output != NULL);
+
+	const struct sensor_data_ctx ctx = {
+		.app_id = app_id,
+		.data = data,
+	};
+	const size_t size = HEAD_SIZE_MAX +
+			    LIT_SIZE_MAX(NRF_CLOUD_JSON_APPID_KEY) + TEXT_SIZE_MAX(strlen(app_id)) +
+			    LIT_SIZE_MAX(NRF_CLOUD_JSON_DATA_KEY) + TEXT_SIZE_MAX(data->len) +
+			    LIT_SIZE_MAX(NRF_CLOUD_JSON_MSG_TYPE_KEY) +
+			    LIT_SIZE_MAX(NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
+
+	return encode(sensor_data_encode, &ctx, size, output);
+}
+
+struct cell_pos_ctx {
+	const struct lte_lc_cells_info *inf;
+	bool request_loc;
+};
+
+static bool ncells_valid(const struct lte_lc_cells_info *const lte)
+{
+	if (lte->ncells_count && !lte->neighbor_cells) {
+		LOG_WRN("Neighbor cell count is %u, but buffer is NULL", lte->ncells_count);
+		return false;
+	}
+
+	return lte->ncells_count != 0;
+}
+
+static bool ncell_encode(zcbor_state_t *state, const struct lte_lc_ncell *const ncell)
+{
+	const bool rsrp = ncell->rsrp != NRF_CLOUD_CELL_POS_OMIT_RSRP;
+	const bool rsrq = ncell->rsrq != NRF_CLOUD_CELL_POS_OMIT_RSRQ;
+	const size_t count = 2 + rsrp + rsrq;
+
+	if (!zcbor_map_start_encode(state, count)) {
+		return false;
+	}
+
+	/* required items */
+	if (!key_number_put(state, NRF_CLOUD_CELL_POS_JSON_KEY_EARFCN, ncell->earfcn) ||
+	    !key_number_put(state, NRF_CLOUD_CELL_POS_JSON_KEY_PCI, ncell->phys_cell_id)) {
+		return false;
+	}
+
+	/* optional */
+	if (rsrp &&
+	    !key_number_put(state, NRF_CLOUD_CELL_POS_JSON_KEY_RSRP, RSRP_ADJ(ncell->rsrp))) {
+		return false;
+	}
+
+	if (rsrq &&
+	    !key_number_put(state, NRF_CLOUD_CELL_POS_JSON_KEY_RSRQ, RSRQ_ADJ(ncell->rsrq))) {
+		return false;
+	}
+
+	return zcbor_map_end_encode(state, count);
+}
+
+static bool cell_encode(zcbor_state_t *state, const struct lte_lc_cells_info *const lte)
+{
+	const struct lte_lc_cell *const cur = &lte->current_cell;
+	const bool earfcn = cur->earfcn != NRF_CLOUD_CELL_POS_OMIT_EARFCN;
+	const bool rsrp = cur->rsrp != NRF_CLOUD_CELL_POS_OMIT_RSRP;
+	const bool rsrq = cur->rsrq != NRF_CLOUD_CELL_POS_OMIT_RSRQ;
+	const bool t_adv = cur->timing_advance != NRF_CLOUD_CELL_POS_OMIT_TIME_ADV;
+	const bool nmr = ncells_valid(lte);
+	const size_t count = 4 + earfcn + rsrp + rsrq + t_adv + nmr;
+
+	if (!zcbor_map_start_encode(state, count)) {
+		return false;
+	}
+
+	/* required items */
+	if (!key_number_put(state, NRF_CLOUD_CELL_POS_JSON_KEY_ECI, cur->id) ||
+	    !key_number_put(state, NRF_CLOUD_CELL_POS_JSON_KEY_MCC, cur->mcc) ||
+	    !key_number_put(state, NRF_CLOUD_CELL_POS_JSON_KEY_MNC, cur->mnc) ||
+	    !key_number_put(state, NRF_CLOUD_CELL_POS_JSON_KEY_TAC, cur->tac)) {
+		return false;
+	}
+
+	/* optional */
+	if (earfcn && !key_number_put(state, NRF_CLOUD_CELL_POS_JSON_KEY_EARFCN, cur->earfcn)) {
+		return false;
+	}
+
+	if (rsrp && !key_number_put(state, NRF_CLOUD_CELL_POS_JSON_KEY_RSRP, RSRP_ADJ(cur->rsrp))) {
+		return false;
+	}
+
+	if (rsrq && !key_number_put(state, NRF_CLOUD_CELL_POS_JSON_KEY_RSRQ, RSRQ_ADJ(cur->rsrq))) {
+		return false;
+	}
+
+	if (t_adv && !key_number_put(state, NRF_CLOUD_CELL_POS_JSON_KEY_T_ADV,
+				     MIN(cur->timing_advance, NRF_CLOUD_CELL_POS_TIME_ADV_MAX))) {
+		return false;
+	}
+
+	if (nmr) {
+		if (!str_put(state, NRF_CLOUD_CELL_POS_JSON_KEY_NBORS) ||
+		    !zcbor_list_start_encode(state, lte->ncells_count)) {
+			return false;
+		}
+
+		for (size_t i = 0; i < lte->ncells_count; i++) {
+			if (!ncell_encode(state, &lte->neighbor_cells[i])) {
+				return false;
+			}
+		}
+
+		if (!zcbor_list_end_encode(state, lte->ncells_count)) {
+			return false;
+		}
+	}
+
+	return zcbor_map_end_encode(state, count);
+}
+
+static bool cell_pos_req_encode(zcbor_state_t *state, const void *ctx)
+{
+	const struct cell_pos_ctx *req = ctx;
+	const size_t data_count = req->request_loc ? 1 : 2;
+
+	if (!zcbor_map_start_encode(state, 3) ||
+	    !key_str_put(state, NRF_CLOUD_JSON_APPID_KEY, NRF_CLOUD_JSON_APPID_VAL_CELL_POS) ||
+	    !key_str_put(state, NRF_CLOUD_JSON_MSG_TYPE_KEY, NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA)) {
+		return false;
+	}
+
+	if (!str_put(state, NRF_CLOUD_JSON_DATA_KEY) ||
+	    !zcbor_map_start_encode(state, data_count)) {
+		return false;
+	}
+
+	if (!str_put(state, NRF_CLOUD_CELL_POS_JSON_KEY_LTE) ||
+	    !zcbor_list_start_encode(state, 1) ||
+	    !cell_encode(state, req->inf) ||
+	    !zcbor_list_end_encode(state, 1)) {
+		return false;
+	}
+
+	/* By default, nRF Cloud will send the location to the device */
+	if (!req->request_loc && !key_number_put(state, CELL_POS_KEY_DOREPLY, 0)) {
+		return false;
+	}
+
+	return zcbor_map_end_encode(state, data_count) && zcbor_map_end_encode(state, 3);
+}
+
+int nrf_cloud_cbor_encode_cell_pos_req(const struct lte_lc_cells_info *const inf,
+				       const bool request_loc,
+				       struct nrf_cloud_data *const output)
+{
+	if (!inf || !output) {
+		return -EINVAL;
+	}
+
+	const struct cell_pos_ctx ctx = {
+		.inf = inf,
+		.request_loc = request_loc,
+	};
+	size_t size = CELL_POS_REQ_SIZE_MAX;
+
+	if (ncells_valid(inf)) {
+		size += inf->ncells_count * NCELL_SIZE_MAX;
+	}
+
+	return encode(cell_pos_req_encode, &ctx, size, output);
+}
@@ -8,6 +8,7 @@
 #include <nrfx_nvmc.h>
 #include <device.h>
 #include <storage/stream_flash.h>
+#include <sys/crc.h>
 
 #include <cJSON.h>
 #include <cJSON_os.h>
@@ -245,16 +246,22 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 	int64_t start_gps_sec = index.start_sec;
 	int64_t gps_sec;
 	int pnum;
-
-	/* reset catalog of predictions */
-	for (pnum = 0; pnum < count; pnum++) {
-		index.predictions[pnum] = NULL;
-	}
+	bool indexed;
 
 	npgps_reset_block_pool();
 
+	/* build catalog of predictions from the flash index, without
+	 * reading them; each is checked when it is first used
+	 */
+	i = npgps_index_catalog(npgps_get_saved_index(), start_gps_sec,
+				period_min * SEC_PER_MIN, count, index.predictions);
+	indexed = (i >= 0);
+	if (indexed) {
+		LOG_INF("Flash index has %d of %u predictions", i, count);
+	}
+
 	/* build catalog of predictions by block */
-	for (i = 0; i < count; i++) {
+	for (i = 0; !indexed && (i < count); i++) {
 		pred = (struct nrf_cloud_pgps_prediction *)p;
 
 		pnum = determine_prediction_num(&index.header, pred);
@@ -287,24 +294,35 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 			break;
 		}
 
-		err = validate_prediction(pred, gps_day, gps_time_of_day,
-					  period_min, true, false);
-		if (err) {
-			LOG_ERR("Prediction num:%u, gps_day:%u, "
-				"gps_time_of_day:%u is bad:%d; loc:%p",
-				pnum, gps_day, gps_time_of_day, err, pred);
-			/* request partial data; download interrupted? */
-			*first_bad_day = gps_day;
-			*first_bad_time = gps_time_of_day;
-			break;
-		}
-
 		i = npgps_pointer_to_block((uint8_t *)pred);
 		LOG_DBG("Prediction num:%u, loc:%p, blk:%d", pnum, pred, i);
 		__ASSERT(i != -1, "unexpected pointer value %p", pred);
+
+		if (!indexed) {
+			err = validate_prediction(pred, gps_day, gps_time_of_day,
+						  period_min, true, false);
+			if (err) {
+				LOG_ERR("Prediction num:%u, gps_day:%u, "
+					"gps_time_of_day:%u is bad:%d; loc:%p",
+					pnum, gps_day, gps_time_of_day, err, pred);
+				/* request partial data; download interrupted? */
+				*first_bad_day = gps_day;
+				*first_bad_time = gps_time_of_day;
+				break;
+			}
+
+			npgps_index_set(i, pred->sentinel,
+					crc32_ieee((uint8_t *)pred, sizeof(*pred)));
+		}
+
 		npgps_mark_block_used(i, true);
 	}
 
+	if (!indexed) {
+		/* index what was found, so the next boot does not need to scan */
+		(void)npgps_save_index(npgps_index_get());
+	}
+
 	/* find first free block in flash, if any, after chronologicaly
 	 * last good prediction, if any; this is where any new downloads
 	 * should begin, to maintain a circularly arranged flash
@@ -354,7 +372,9 @@ static void discard_oldest_predictions(int num)
 		__ASSERT((block != -1), "unexpected ptr:%p for Prediction num:%d",
 			 index.predictions[pnum], pnum);
 		npgps_free_block(block);
+		npgps_index_clear(block);
 	}
+	(void)npgps_save_index(npgps_index_get());
 
 	/* move predictions we are keeping to the start */
 	for (i = last; i < index.header.prediction_count; i++) {
@@ -499,6 +519,26 @@ static void print_time_details(const char *info,
 		tow, tow / 16);
 }
 
+/* check the CRC of a prediction the first time it is used after boot */
+static int verify_stored_prediction(int pnum)
+{
+	uint8_t *p = (uint8_t *)index.predictions[pnum];
+	int block = npgps_pointer_to_block(p);
+	int err;
+
+	err = npgps_index_verify(block, p, sizeof(struct nrf_cloud_pgps_prediction));
+	if (err) {
+		LOG_ERR("Prediction num:%d in block:%d is bad:%d", pnum, block, err);
+		index.predictions[pnum] = NULL;
+		if (block != NO_BLOCK) {
+			npgps_free_block(block);
+			npgps_index_clear(block);
+			(void)npgps_save_index(npgps_index_get());
+		}
+	}
+	return err;
+}
+
 int nrf_cloud_pgps_find_prediction(struct nrf_cloud_pgps_prediction **prediction)
 {
 	int64_t cur_gps_sec;
@@ -586,6 +626,11 @@ int nrf_cloud_pgps_find_prediction(struct nrf_cloud_pgps_prediction **prediction
 	index.cur_pnum = pnum;
 	*prediction = index.predictions[pnum];
 	if (*prediction) {
+		err = verify_stored_prediction(pnum);
+		if (err) {
+			*prediction = NULL;
+			return err;
+		}
 		err = validate_prediction(*prediction,
 					  cur_gps_day, cur_gps_time_of_day,
 					  period_min, false, margin);
@@ -764,6 +809,7 @@ static int pgps_request_all(void)
 	}
 
 	npgps_reset_block_pool();
+	npgps_index_reset();
 
 	index.stale_server_data = false;
 	err = npgps_get_time(NULL, &gps_day, &gps_time_of_day);
@@ -1050,6 +1096,13 @@ static int store_prediction(uint8_t *p, size_t len, uint32_t sentinel, bool last
 	int err;
 	uint8_t schema = NRF_CLOUD_AGPS_BIN_SCHEMA_VERSION;
 	size_t schema_offset = ((size_t) &((struct nrf_cloud_pgps_prediction *)0)->schema_version);
+	uint32_t crc;
+
+	/* CRC of the prediction as it is stored */
+	crc = crc32_ieee_update(0, p, schema_offset);
+	crc = crc32_ieee_update(crc, &schema, sizeof(schema));
+	crc = crc32_ieee_update(crc, p + schema_offset, len - schema_offset);
+	crc = crc32_ieee_update(crc, (uint8_t *)&sentinel, sizeof(sentinel));
 
 	if (first) {
 		memset(pad, 0xff, PGPS_PREDICTION_PAD);
@@ -1081,6 +1134,16 @@ static int store_prediction(uint8_t *p, size_t len, uint32_t sentinel, bool last
 	err = stream_flash_buffered_write(&stream, pad, PGPS_PREDICTION_PAD, last);
 	if (err) {
 		LOG_ERR("Error writing sentinel:%d", err);
+		return err;
+	}
+
+	npgps_index_set(index.store_block, sentinel, crc);
+	if (last) {
+		/* the index only refers to predictions that have been written */
+		err = npgps_save_index(npgps_index_get());
+		if (err) {
+			LOG_ERR("Error saving flash index:%d", err);
+		}
 	}
 	return err;
 }
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <sys/crc.h>
+
+#include "nrf_cloud_pgps_utils.h"
+
+#include <logging/log.h>
+
+LOG_MODULE_DECLARE(nrf_cloud_pgps, CONFIG_NRF_CLOUD_GPS_LOG_LEVEL);
+
+/* The index maps each block of the storage to the prediction it holds, so the
+ * predictions do not need to be read from flash on boot. The CRC of a
+ * prediction is checked the first time it is used after boot instead.
+ */
+static struct npgps_index flash_index = {
+	.version = NPGPS_INDEX_VERSION,
+	.num_blocks = NUM_BLOCKS,
+};
+
+/* Blocks whose contents are known to match the index */
+static bool verified[NUM_BLOCKS];
+
+static bool block_valid(int block)
+{
+	if ((block < 0) || (block >= NUM_BLOCKS)) {
+		LOG_ERR("invalid block:%d", block);
+		return false;
+	}
+	return true;
+}
+
+void npgps_index_reset(void)
+{
+	LOG_DBG("resetting flash index");
+	memset(flash_index.entries, 0, sizeof(flash_index.entries));
+	memset(verified, 0, sizeof(verified));
+}
+
+int npgps_index_restore(const struct npgps_index *saved)
+{
+	npgps_index_reset();
+
+	if ((saved->version != NPGPS_INDEX_VERSION) ||
+	    (saved->num_blocks != NUM_BLOCKS)) {
+		LOG_WRN("No valid flash index; version:%u, blocks:%u",
+			saved->version, saved->num_blocks);
+		return -ENOENT;
+	}
+
+	memcpy(flash_index.entries, saved->entries, sizeof(flash_index.entries));
+	return 0;
+}
+
+const struct npgps_index *npgps_index_get(void)
+{
+	return &flash_index;
+}
+
+void npgps_index_set(int block, uint32_t sentinel, uint32_t crc)
+{
+	if (!block_valid(block)) {
+		return;
+	}
+
+	flash_index.entries[block].sentinel = sentinel;
+	flash_index.entries[block].crc = crc;
+	/* the CRC was calculated from the data that was written */
+	verified[block] = true;
+	LOG_DBG("index block:%d = sentinel:0x%08X, crc:0x%08X", block, sentinel, crc);
+}
+
+void npgps_index_clear(int block)
+{
+	if (!block_valid(block)) {
+		return;
+	}
+
+	flash_index.entries[block].sentinel = 0;
+	flash_index.entries[block].crc = 0;
+	verified[block] = false;
+}
+
+int npgps_index_map(int64_t start_sec, uint32_t period_sec, int count, int *blocks)
+{
+	int64_t end_sec = start_sec + (int64_t)period_sec * count;
+	int num = 0;
+	int block;
+	int pnum;
+
+	for (pnum = 0; pnum < count; pnum++) {
+		blocks[pnum] = NO_BLOCK;
+	}
+
+	if (!period_sec) {
+		return 0;
+	}
+
+	for (block = 0; block < NUM_BLOCKS; block++) {
+		int64_t sec = flash_index.entries[block].sentinel;
+
+		if (!sec) {
+			continue;
+		}
+
+		/* entries outside of the current set are stale; their blocks are free */
+		if ((sec < start_sec) || (sec >= end_sec) ||
+		    ((sec - start_sec) % period_sec)) {
+			LOG_DBG("block:%d, gps sec:%d not in set", block, (int32_t)sec);
+			npgps_index_clear(block);
+			continue;
+		}
+
+		pnum = (sec - start_sec) / period_sec;
+		if (blocks[pnum] != NO_BLOCK) {
+			LOG_WRN("Prediction num:%u stored more than once!", pnum);
+			npgps_index_clear(block);
+			continue;
+		}
+
+		blocks[pnum] = block;
+		num++;
+	}
+
+	return num;
+}
+
+int npgps_index_catalog(const struct npgps_index *saved, int64_t start_sec, uint32_t period_sec,
+			int count, struct nrf_cloud_pgps_prediction **predictions)
+{
+	int blocks[NUM_PREDICTIONS];
+	int num;
+	int pnum;
+
+	for (pnum = 0; pnum < count; pnum++) {
+		predictions[pnum] = NULL;
+	}
+
+	if (npgps_index_restore(saved)) {
+		return -ENOENT;
+	}
+
+	num = npgps_index_map(start_sec, period_sec, count, blocks);
+	for (pnum = 0; pnum < count; pnum++) {
+		if (blocks[pnum] != NO_BLOCK) {
+			predictions[pnum] = npgps_block_to_pointer(blocks[pnum]);
+		}
+	}
+
+	return num;
+}
+
+int npgps_index_verify(int block, const uint8_t *data, size_t len)
+{
+	uint32_t crc;
+
+	if (!block_valid(block)) {
+		return -EINVAL;
+	}
+	if (!flash_index.entries[block].sentinel) {
+		return -ENOENT;
+	}
+	if (verified[block]) {
+		return 0;
+	}
+
+	crc = crc32_ieee(data, len);
+	if (crc != flash_index.entries[block].crc) {
+		LOG_ERR("block:%d has crc:0x%08X, expected:0x%08X",
+			block, crc, flash_index.entries[block].crc);
+		npgps_index_clear(block);
+		return -EBADMSG;
+	}
+
+	verified[block] = true;
+	return 0;
+}
@@ -25,6 +25,8 @@ LOG_MODULE_DECLARE(nrf_cloud_pgps, CONFIG_NRF_CLOUD_GPS_LOG_LEVEL);
 #define SETTINGS_NAME				"nrf_cloud_pgps"
 #define SETTINGS_KEY_PGPS_HEADER		"pgps_header"
 #define SETTINGS_FULL_PGPS_HEADER		SETTINGS_NAME "/" SETTINGS_KEY_PGPS_HEADER
+#define SETTINGS_KEY_INDEX			"pgps_index"
+#define SETTINGS_FULL_INDEX			SETTINGS_NAME "/" SETTINGS_KEY_INDEX
 #define SETTINGS_KEY_LOCATION			"location"
 #define SETTINGS_FULL_LOCATION			SETTINGS_NAME "/" SETTINGS_KEY_LOCATION
 #define SETTINGS_KEY_LEAP_SEC			"g2u_leap_sec"
@@ -44,6 +46,7 @@ static int num_blocks;
 static int gps_leap_seconds = GPS_TO_UTC_LEAP_SECONDS;
 static struct gps_location saved_location;
 static struct nrf_cloud_pgps_header saved_header;
+static struct npgps_index saved_index;
 
 static K_SEM_DEFINE(pgps_active, 1, 1);
 static struct download_client dlc;
@@ -77,6 +80,15 @@ static int settings_set(const char *key, size_t len_rd,
 			return 0;
 		}
 	}
+	if (!strncmp(key, SETTINGS_KEY_INDEX,
+		     strlen(SETTINGS_KEY_INDEX)) &&
+	    (len_rd == sizeof(saved_index))) {
+		if (read_cb(cb_arg, (void *)&saved_index, len_rd) == len_rd) {
+			LOG_DBG("Read pgps_index: version:%u, blocks:%u",
+				saved_index.version, saved_index.num_blocks);
+			return 0;
+		}
+	}
 	if (!strncmp(key, SETTINGS_KEY_LOCATION,
 		     strlen(SETTINGS_KEY_LOCATION)) &&
 	    (len_rd == sizeof(saved_location))) {
@@ -113,6 +125,20 @@ const struct nrf_cloud_pgps_header *npgps_get_saved_header(void)
 	return &saved_header;
 }
 
+int npgps_save_index(const struct npgps_index *index)
+{
+	int ret = 0;
+
+	LOG_DBG("Saving pgps index");
+	ret = settings_save_one(SETTINGS_FULL_INDEX, index, sizeof(*index));
+	return ret;
+}
+
+const struct npgps_index *npgps_get_saved_index(void)
+{
+	return &saved_index;
+}
+
 /* @TODO: consider rate-limiting these updates to reduce Flash wear */
 static int save_location(void)
 {
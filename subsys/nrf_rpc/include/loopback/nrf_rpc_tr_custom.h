@@ -0,0 +1,13 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef NRF_RPC_TR_CUSTOM_H_
+#define NRF_RPC_TR_CUSTOM_H_
+
+/* Selects the loopback transport as the custom nRF RPC transport. */
+#include <nrf_rpc_loopback.h>
+
+#endif /* NRF_RPC_TR_CUSTOM_H_ */
@@ -93,6 +93,38 @@ static inline void nrf_rpc_os_remote_release(void)
 	k_sem_give(&_nrf_rpc_os_remote_counter);
 }
 
+/** @brief Statistics of the thread pool and the command contexts. */
+struct nrf_rpc_os_stats {
+	/** Number of packets dispatched to the thread pool. */
+	uint32_t dispatched;
+
+	/** Maximum number of packets waiting for a thread of the pool. */
+	uint32_t queue_depth_max;
+
+	/** Maximum number of threads of the pool handling packets at once. */
+	uint32_t threads_busy_max;
+
+	/** Number of reserved command contexts. */
+	uint32_t ctx_reserved;
+
+	/** Total time spent waiting for a free command context, in cycles. */
+	uint64_t ctx_wait_cycles_total;
+
+	/** Longest wait for a free command context, in cycles. */
+	uint32_t ctx_wait_cycles_max;
+};
+
+/** @brief Get the statistics of the thread pool and the command contexts.
+ *
+ * Available if @kconfig{CONFIG_NRF_RPC_OS_STATS} is enabled.
+ *
+ * @param[out] stats Statistics since the last reset.
+ */
+void nrf_rpc_os_stats_get(struct nrf_rpc_os_stats *stats);
+
+/** @brief Reset the statistics of the thread pool and the command contexts. */
+void nrf_rpc_os_stats_reset(void);
+
 #ifdef __cplusplus
 }
 #endif
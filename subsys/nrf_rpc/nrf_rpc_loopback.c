@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#define NRF_RPC_LOG_MODULE NRF_RPC_TR
+#include <nrf_rpc_log.h>
+
+#include <zephyr.h>
+
+#include "nrf_rpc.h"
+#include "nrf_rpc_loopback.h"
+
+/* Packet waiting in the receive queue */
+struct loopback_packet {
+	void *fifo_reserved;
+	size_t len;
+	uint8_t data[];
+};
+
+/* Upper level callbacks */
+static nrf_rpc_tr_receive_handler_t receive_callback;
+
+/* Packets are copied to the heap, like to the shared memory of the IPC service */
+static K_HEAP_DEFINE(loopback_heap, CONFIG_NRF_RPC_TR_LOOPBACK_HEAP_SIZE);
+static K_FIFO_DEFINE(loopback_fifo);
+
+static K_THREAD_STACK_DEFINE(loopback_stack, CONFIG_NRF_RPC_TR_LOOPBACK_STACK_SIZE);
+static struct k_thread loopback_thread;
+
+static struct nrf_rpc_loopback_stats stats;
+static atomic_t pending;
+
+static void loopback_thread_entry(void *p1, void *p2, void *p3)
+{
+	struct loopback_packet *packet;
+
+	do {
+		packet = k_fifo_get(&loopback_fifo, K_FOREVER);
+		atomic_dec(&pending);
+
+		NRF_RPC_DBG("Received %u bytes.", packet->len);
+
+		/* The buffer is freed as soon as the callback returns */
+		receive_callback(packet->data, packet->len);
+
+		k_heap_free(&loopback_heap, packet);
+	} while (1);
+}
+
+int nrf_rpc_tr_init(nrf_rpc_tr_receive_handler_t callback)
+{
+	NRF_RPC_ASSERT(callback != NULL);
+	receive_callback = callback;
+
+	k_thread_create(&loopback_thread, loopback_stack,
+			K_THREAD_STACK_SIZEOF(loopback_stack),
+			loopback_thread_entry, NULL, NULL, NULL,
+			CONFIG_NRF_RPC_TR_LOOPBACK_PRIORITY, 0, K_NO_WAIT);
+	k_thread_name_set(&loopback_thread, "nrf_rpc_loopback");
+
+	return 0;
+}
+
+int nrf_rpc_tr_send(uint8_t *buf, size_t len)
+{
+	struct loopback_packet *packet;
+	atomic_val_t count;
+
+	NRF_RPC_ASSERT(buf != NULL);
+	NRF_RPC_DBG("Send %u bytes.", len);
+
+	/* Waiting for a packet that never fits would block forever */
+	if (sizeof(*packet) + len > CONFIG_NRF_RPC_TR_LOOPBACK_HEAP_SIZE) {
+		return -NRF_ENOMEM;
+	}
+
+	packet = k_heap_alloc(&loopback_heap, sizeof(*packet) + len, K_FOREVER);
+	if (!packet) {
+		return -NRF_ENOMEM;
+	}
+
+	packet->len = len;
+	memcpy(packet->data, buf, len);
+
+	count = atomic_inc(&pending) + 1;
+
+	k_sched_lock();
+	stats.packets++;
+	stats.bytes += len;
+	stats.max_pending = MAX(stats.max_pending, count);
+	k_sched_unlock();
+
+	k_fifo_put(&loopback_fifo, packet);
+
+	return 0;
+}
+
+void nrf_rpc_loopback_stats_get(struct nrf_rpc_loopback_stats *out)
+{
+	k_sched_lock();
+	*out = stats;
+	k_sched_unlock();
+}
+
+void nrf_rpc_loopback_stats_reset(void)
+{
+	k_sched_lock();
+	memset(&stats, 0, sizeof(stats));
+	k_sched_unlock();
+}
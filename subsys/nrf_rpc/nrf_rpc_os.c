@@ -7,17 +7,15 @@
 #define NRF_RPC_LOG_MODULE NRF_RPC_OS
 #include <nrf_rpc_log.h>
 
+#include <string.h>
+
 #include "nrf_rpc_os.h"
 
 /* Maximum number of remote thread that this implementation allows. */
 #define MAX_REMOTE_THREADS 255
 
-/* Initial value contains ones (context free) on the
- * CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE most significant bits.
- */
-#define CONTEXT_MASK_INIT_VALUE						       \
-	(~(((atomic_val_t)1 << (8 * sizeof(atomic_val_t) -		       \
-				CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE)) - 1))
+/* Context number 0xFF is reserved by the protocol for an unknown context. */
+#define MAX_CONTEXTS 255
 
 struct pool_start_msg {
 	const uint8_t *data;
@@ -26,11 +24,24 @@ struct pool_start_msg {
 
 static nrf_rpc_os_work_t thread_pool_callback;
 
-static struct pool_start_msg pool_start_msg_buf[2];
+/* The queue holds packets waiting for a thread of the pool. By default it
+ * has room for a packet for each thread, so the transport does not stall
+ * when all threads are busy.
+ */
+static struct pool_start_msg
+	pool_start_msg_buf[CONFIG_NRF_RPC_OS_DISPATCH_QUEUE_SIZE];
 static struct k_msgq pool_start_msg;
 
+/* Set bits mark free contexts */
 static struct k_sem context_reserved;
-static atomic_t context_mask;
+static ATOMIC_DEFINE(context_free, CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE);
+
+static atomic_t threads_idle;
+
+#if defined(CONFIG_NRF_RPC_OS_STATS)
+static struct nrf_rpc_os_stats stats;
+static struct k_spinlock stats_lock;
+#endif
 
 static uint32_t remote_thread_total;
 
@@ -44,10 +55,62 @@ static struct k_thread pool_threads[CONFIG_NRF_RPC_THREAD_POOL_SIZE];
 
 BUILD_ASSERT(CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE > 0,
 	     "CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE must be greaten than zero");
-BUILD_ASSERT(CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE <= 8 * sizeof(atomic_val_t),
+BUILD_ASSERT(CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE <= MAX_CONTEXTS,
 	     "CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE too big");
-BUILD_ASSERT(sizeof(uint32_t) == sizeof(atomic_val_t),
-	     "Only atomic_val_t is implemented that is the same as uint32_t");
+
+#if defined(CONFIG_NRF_RPC_OS_STATS)
+static void stats_dispatched(uint32_t depth)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	stats.dispatched++;
+	stats.queue_depth_max = MAX(stats.queue_depth_max, depth);
+
+	k_spin_unlock(&stats_lock, key);
+}
+
+static void stats_busy(uint32_t busy)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	stats.threads_busy_max = MAX(stats.threads_busy_max, busy);
+
+	k_spin_unlock(&stats_lock, key);
+}
+
+static void stats_ctx_wait(uint32_t cycles)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	stats.ctx_reserved++;
+	stats.ctx_wait_cycles_total += cycles;
+	stats.ctx_wait_cycles_max = MAX(stats.ctx_wait_cycles_max, cycles);
+
+	k_spin_unlock(&stats_lock, key);
+}
+
+void nrf_rpc_os_stats_get(struct nrf_rpc_os_stats *out)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	*out = stats;
+
+	k_spin_unlock(&stats_lock, key);
+}
+
+void nrf_rpc_os_stats_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	memset(&stats, 0, sizeof(stats));
+
+	k_spin_unlock(&stats_lock, key);
+}
+#else
+static inline void stats_dispatched(uint32_t depth) {}
+static inline void stats_busy(uint32_t busy) {}
+static inline void stats_ctx_wait(uint32_t cycles) {}
+#endif /* defined(CONFIG_NRF_RPC_OS_STATS) */
 
 static void thread_pool_entry(void *p1, void *p2, void *p3)
 {
@@ -55,7 +118,13 @@ static void thread_pool_entry(void *p1, void *p2, void *p3)
 
 	do {
 		k_msgq_get(&pool_start_msg, &msg, K_FOREVER);
+		atomic_dec(&threads_idle);
+
+		stats_busy(CONFIG_NRF_RPC_THREAD_POOL_SIZE -
+			   atomic_get(&threads_idle));
+
 		thread_pool_callback(msg.data, msg.len);
+		atomic_inc(&threads_idle);
 	} while (1);
 }
 
@@ -80,12 +149,16 @@ int nrf_rpc_os_init(nrf_rpc_os_work_t callback)
 	}
 	remote_thread_total = 0;
 
-	atomic_set(&context_mask, CONTEXT_MASK_INIT_VALUE);
+	for (i = 0; i < CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE; i++) {
+		atomic_set_bit(context_free, i);
+	}
 
 	k_msgq_init(&pool_start_msg, (char *)pool_start_msg_buf,
 		    sizeof(struct pool_start_msg),
 		    ARRAY_SIZE(pool_start_msg_buf));
 
+	atomic_set(&threads_idle, CONFIG_NRF_RPC_THREAD_POOL_SIZE);
+
 	for (i = 0; i < CONFIG_NRF_RPC_THREAD_POOL_SIZE; i++) {
 		k_thread_create(&pool_threads[i], pool_stacks[i],
 			K_THREAD_STACK_SIZEOF(pool_stacks[i]),
@@ -104,6 +177,8 @@ void nrf_rpc_os_thread_pool_send(const uint8_t *data, size_t len)
 	msg.data = data;
 	msg.len = len;
 	k_msgq_put(&pool_start_msg, &msg, K_FOREVER);
+
+	stats_dispatched(k_msgq_num_used_get(&pool_start_msg));
 }
 
 void nrf_rpc_os_msg_set(struct nrf_rpc_os_msg *msg, const uint8_t *data,
@@ -128,26 +203,44 @@ void nrf_rpc_os_msg_get(struct nrf_rpc_os_msg *msg, const uint8_t **data,
 
 uint32_t nrf_rpc_os_ctx_pool_reserve(void)
 {
-	uint32_t number;
+	uint32_t start = 0;
 	atomic_val_t old_mask;
-	atomic_val_t new_mask;
+	uint32_t bit;
+	size_t i;
+
+	if (IS_ENABLED(CONFIG_NRF_RPC_OS_STATS)) {
+		start = k_cycle_get_32();
+	}
 
 	k_sem_take(&context_reserved, K_FOREVER);
 
-	do {
-		old_mask = atomic_get(&context_mask);
-		number = __CLZ(old_mask);
-		new_mask = old_mask & ~(0x80000000u >> number);
-	} while (!atomic_cas(&context_mask, old_mask, new_mask));
+	if (IS_ENABLED(CONFIG_NRF_RPC_OS_STATS)) {
+		stats_ctx_wait(k_cycle_get_32() - start);
+	}
 
-	return number;
+	/* The semaphore guarantees that a free context exists, but it may be
+	 * taken by another thread in the word being scanned.
+	 */
+	do {
+		for (i = 0; i < ARRAY_SIZE(context_free); i++) {
+			old_mask = atomic_get(&context_free[i]);
+			while (old_mask != 0) {
+				bit = __builtin_ctzl(old_mask);
+				if (atomic_cas(&context_free[i], old_mask,
+					       old_mask & ~BIT(bit))) {
+					return i * ATOMIC_BITS + bit;
+				}
+				old_mask = atomic_get(&context_free[i]);
+			}
+		}
+	} while (1);
 }
 
 void nrf_rpc_os_ctx_pool_release(uint32_t number)
 {
 	__ASSERT_NO_MSG(number < CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE);
 
-	atomic_or(&context_mask, 0x80000000u >> number);
+	atomic_set_bit(context_free, number);
 	k_sem_give(&context_reserved);
 }
 
@@ -8,12 +8,17 @@
 #include <ztest.h>
 #include <stdio.h>
 #include <string.h>
+#include <ctype.h>
 #include <kernel.h>
 #include <sys/util.h>
 
 #include <modem/at_cmd_parser.h>
 #include <modem/at_params.h>
 
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+#include <native_rtc.h>
+#endif
+
 #define TEST_PARAMS  4
 #define TEST_PARAMS2 10
 
@@ -780,6 +785,237 @@ static void test_at_cmd_test_teardown(void)
 	at_params_list_free(&test_list2);
 }
 
+AT_SCHEMA_DEFINE(cereg_schema, "+CEREG",
+		 AT_SCHEMA_PARAM_NUM, AT_SCHEMA_PARAM_NUM, AT_SCHEMA_PARAM_STRING,
+		 AT_SCHEMA_PARAM_STRING, AT_SCHEMA_PARAM_NUM, AT_SCHEMA_PARAM_NUM,
+		 AT_SCHEMA_PARAM_NUM, AT_SCHEMA_PARAM_STRING, AT_SCHEMA_PARAM_STRING);
+
+AT_SCHEMA_DEFINE(xmonitor_schema, "%XMONITOR",
+		 AT_SCHEMA_PARAM_NUM, AT_SCHEMA_PARAM_STRING, AT_SCHEMA_PARAM_STRING,
+		 AT_SCHEMA_PARAM_STRING, AT_SCHEMA_PARAM_STRING, AT_SCHEMA_PARAM_NUM,
+		 AT_SCHEMA_PARAM_NUM, AT_SCHEMA_PARAM_STRING, AT_SCHEMA_PARAM_NUM,
+		 AT_SCHEMA_PARAM_NUM, AT_SCHEMA_PARAM_NUM, AT_SCHEMA_PARAM_NUM,
+		 AT_SCHEMA_PARAM_STRING, AT_SCHEMA_PARAM_STRING, AT_SCHEMA_PARAM_STRING,
+		 AT_SCHEMA_PARAM_STRING);
+
+AT_SCHEMA_DEFINE(ncellmeas_schema, "%NCELLMEAS",
+		 AT_SCHEMA_PARAM_NUM, AT_SCHEMA_PARAM_STRING, AT_SCHEMA_PARAM_STRING,
+		 AT_SCHEMA_PARAM_STRING, AT_SCHEMA_PARAM_NUM, AT_SCHEMA_PARAM_NUM,
+		 AT_SCHEMA_PARAM_NUM, AT_SCHEMA_PARAM_NUM, AT_SCHEMA_PARAM_NUM,
+		 AT_SCHEMA_PARAM_NUM, AT_SCHEMA_PARAM_NUM, AT_SCHEMA_PARAM_NUM,
+		 AT_SCHEMA_PARAM_NUM, AT_SCHEMA_PARAM_NUM, AT_SCHEMA_PARAM_NUM,
+		 AT_SCHEMA_PARAM_NUM, AT_SCHEMA_PARAM_NUM, AT_SCHEMA_PARAM_NUM,
+		 AT_SCHEMA_PARAM_NUM, AT_SCHEMA_PARAM_NUM, AT_SCHEMA_PARAM_NUM);
+
+AT_SCHEMA_DEFINE(cmt_schema, "+CMT", AT_SCHEMA_PARAM_STRING, AT_SCHEMA_PARAM_NUM);
+
+AT_SCHEMA_DEFINE(array_schema, "+CIND", AT_SCHEMA_PARAM_ARRAY, AT_SCHEMA_PARAM_RAW);
+
+static const char cereg_notif[] =
+	"+CEREG: 5,1,\"0A0B\",\"01020304\",9,0,0,\"00100110\",\"01011111\"\r\n";
+static const char xmonitor_rsp[] =
+	"%XMONITOR: 1,\"EDAV\",\"EDAV\",\"26295\",\"00B7\",7,4,\"00011B07\",7,2300,63,39,"
+	"\"\",\"11100000\",\"00010011\",\"01001001\"\r\nOK\r\n";
+static const char ncellmeas_notif[] =
+	"%NCELLMEAS: 0,\"00011B07\",\"26295\",\"00B7\",10512,9034,2300,7,63,31,150344527,"
+	"2300,8,60,29,0,2400,11,53,26,184\r\n";
+
+static void verify_schema_against_list(const struct at_schema *schema, const char *str,
+				       struct at_param_slice *slices, int count)
+{
+	char buf[32];
+	char buf2[32];
+	size_t len;
+	size_t len2;
+	int32_t val;
+	int32_t val2;
+
+	for (int i = 0; i < count; i++) {
+		if (slices[i].len == 0) {
+			zassert_true(at_params_type_get(&test_list2, i + 1) == AT_PARAM_TYPE_EMPTY ||
+				     at_params_size_get(&test_list2, i + 1, &len2) ||
+				     len2 == 0, "Param %d should be empty", i);
+			continue;
+		}
+
+		if (schema->types[i] == AT_SCHEMA_PARAM_NUM) {
+			zassert_equal(0, at_param_slice_int_get(str, &slices[i], &val),
+				      "Param %d is not an integer", i);
+			zassert_equal(0, at_params_int_get(&test_list2, i + 1, &val2),
+				      "Param %d is not an integer", i);
+			zassert_equal(val, val2, "Param %d differs", i);
+		} else {
+			len = sizeof(buf);
+			len2 = sizeof(buf2);
+			zassert_equal(0, at_param_slice_string_get(str, &slices[i], buf, &len),
+				      "Param %d could not be read", i);
+			zassert_equal(0, at_params_string_get(&test_list2, i + 1, buf2, &len2),
+				      "Param %d could not be read", i);
+			zassert_equal(len, len2, "Param %d length differs", i);
+			zassert_equal(0, memcmp(buf, buf2, len), "Param %d differs", i);
+		}
+	}
+}
+
+static void test_schema_parse_setup(void)
+{
+	at_params_list_init(&test_list2, 32);
+}
+
+static void test_schema_parse_teardown(void)
+{
+	at_params_list_free(&test_list2);
+}
+
+static void test_schema_parse(void)
+{
+	struct at_param_slice slices[32];
+	const struct {
+		const struct at_schema *schema;
+		const char *str;
+		int count;
+	} cases[] = {
+		{ &cereg_schema, cereg_notif, 9 },
+		{ &xmonitor_schema, xmonitor_rsp, 16 },
+		{ &ncellmeas_schema, ncellmeas_notif, 21 },
+	};
+	int ret;
+
+	for (size_t i = 0; i < ARRAY_SIZE(cases); i++) {
+		ret = at_parser_schema_parse(cases[i].schema, cases[i].str, slices, NULL);
+		zassert_equal(ret, cases[i].count, "Case %d: parsed %d params", i, ret);
+
+		/* The result must match the list based parser */
+		ret = at_parser_params_from_str(cases[i].str, NULL, &test_list2);
+		zassert_equal(ret, 0, "Case %d: at_parser_params_from_str failed", i);
+
+		verify_schema_against_list(cases[i].schema, cases[i].str, slices,
+					   cases[i].count);
+	}
+}
+
+static void test_schema_parse_optional(void)
+{
+	struct at_param_slice slices[9];
+	const char *next;
+	int32_t val;
+	int ret;
+
+	/* Omitted and missing trailing parameters */
+	ret = at_parser_schema_parse(&cereg_schema, "+CEREG: 5,0,,,9,0,0,,\r\n+CEREG: 1\r\n",
+				     slices, &next);
+	zassert_equal(ret, 9, "Parsed %d params", ret);
+	zassert_equal(slices[2].len, 0, "Omitted param should be empty");
+	zassert_equal(slices[2].offset, 0, "Omitted param should have offset 0");
+	zassert_equal(at_param_slice_int_get(cereg_notif, &slices[8], &val), -ENODATA,
+		      "Omitted param should not have data");
+	zassert_equal(strcmp(next, "+CEREG: 1\r\n"), 0, "next should point to next line");
+
+	ret = at_parser_schema_parse(&cereg_schema, next, slices, NULL);
+	zassert_equal(ret, 1, "Parsed %d params", ret);
+	zassert_equal(0, at_param_slice_int_get(next, &slices[0], &val), "Get int failed");
+	zassert_equal(val, 1, "Wrong value");
+	zassert_equal(slices[1].len, 0, "Missing param should be empty");
+
+	/* Arrays and raw text */
+	ret = at_parser_schema_parse(&array_schema, "+CIND: (1,2,3), some text\r\n", slices,
+				     NULL);
+	zassert_equal(ret, 2, "Parsed %d params", ret);
+	zassert_equal(slices[0].len, strlen("1,2,3"), "Wrong array length");
+	zassert_equal(slices[1].len, strlen("some text"), "Wrong raw length");
+
+	/* Negative numbers and SMS header */
+	ret = at_parser_schema_parse(&cmt_schema, pduline[0], slices, &next);
+	zassert_equal(ret, 2, "Parsed %d params", ret);
+	zassert_equal(0, at_param_slice_int_get(pduline[0], &slices[1], &val), "Get int failed");
+	zassert_equal(val, 24, "Wrong value");
+	zassert_true(isxdigit((int)*next), "next should point to the PDU");
+}
+
+static void test_schema_parse_errors(void)
+{
+	struct at_param_slice slices[9];
+	int32_t val;
+	int ret;
+
+	ret = at_parser_schema_parse(NULL, cereg_notif, slices, NULL);
+	zassert_equal(ret, -EINVAL, "NULL schema should return -EINVAL");
+	ret = at_parser_schema_parse(&cereg_schema, NULL, slices, NULL);
+	zassert_equal(ret, -EINVAL, "NULL string should return -EINVAL");
+
+	ret = at_parser_schema_parse(&cereg_schema, xmonitor_rsp, slices, NULL);
+	zassert_equal(ret, -ENOMSG, "Wrong prefix should return -ENOMSG");
+	ret = at_parser_schema_parse(&cereg_schema, "+CEREGX: 1\r\n", slices, NULL);
+	zassert_equal(ret, -ENOMSG, "Longer prefix should return -ENOMSG");
+
+	ret = at_parser_schema_parse(&cereg_schema, "+CEREG: \"5\"\r\n", slices, NULL);
+	zassert_equal(ret, -EBADMSG, "String for number should return -EBADMSG");
+	ret = at_parser_schema_parse(&cereg_schema, "+CEREG: 5,1,\"0A0B\r\n", slices, NULL);
+	zassert_equal(ret, -EBADMSG, "Unterminated string should return -EBADMSG");
+	ret = at_parser_schema_parse(&cereg_schema, "+CEREG: 5 6\r\n", slices, NULL);
+	zassert_equal(ret, -EBADMSG, "Missing separator should return -EBADMSG");
+
+	ret = at_parser_schema_parse(&cmt_schema, "+CMT: \"1\",2,3\r\n", slices, NULL);
+	zassert_equal(ret, -E2BIG, "Too many params should return -E2BIG");
+
+	ret = at_parser_schema_parse(&cereg_schema, "+CEREG: 2147483648\r\n", slices, NULL);
+	zassert_equal(ret, 1, "Parsed %d params", ret);
+	zassert_equal(at_param_slice_int_get("+CEREG: 2147483648", &slices[0], &val), -ERANGE,
+		      "Too large value should return -ERANGE");
+}
+
+#define BENCHMARK_ITERATIONS 1000
+
+static uint64_t benchmark_time_us(void)
+{
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+	/* Parsing takes no simulated time, so measure with the host clock */
+	return native_rtc_gettime_us(RTC_CLOCK_REAL);
+#else
+	return k_cyc_to_us_floor64(k_cycle_get_32());
+#endif
+}
+
+static void test_schema_parse_benchmark(void)
+{
+	struct at_param_slice slices[32];
+	const struct {
+		const char *name;
+		const struct at_schema *schema;
+		const char *str;
+	} cases[] = {
+		{ "+CEREG", &cereg_schema, cereg_notif },
+		{ "%XMONITOR", &xmonitor_schema, xmonitor_rsp },
+		{ "%NCELLMEAS", &ncellmeas_schema, ncellmeas_notif },
+	};
+	uint64_t start;
+	uint32_t list_us;
+	uint32_t schema_us;
+	int ret;
+
+	for (size_t i = 0; i < ARRAY_SIZE(cases); i++) {
+		start = benchmark_time_us();
+
+		for (int j = 0; j < BENCHMARK_ITERATIONS; j++) {
+			ret = at_parser_params_from_str(cases[i].str, NULL, &test_list2);
+			zassert_equal(ret, 0, "at_parser_params_from_str failed");
+		}
+
+		list_us = benchmark_time_us() - start;
+		start = benchmark_time_us();
+
+		for (int j = 0; j < BENCHMARK_ITERATIONS; j++) {
+			ret = at_parser_schema_parse(cases[i].schema, cases[i].str, slices, NULL);
+			zassert_true(ret > 0, "at_parser_schema_parse failed");
+		}
+
+		schema_us = benchmark_time_us() - start;
+
+		TC_PRINT("%-10s %d iterations: at_params list %u us, schema %u us\n",
+			 cases[i].name, BENCHMARK_ITERATIONS, list_us, schema_us);
+	}
+}
+
 void test_main(void)
 {
 	ztest_test_suite(at_cmd_parser,
@@ -810,7 +1046,17 @@ void test_main(void)
 			 ztest_unit_test_setup_teardown(
 				test_at_cmd_test,
 				test_at_cmd_test_setup,
-				test_at_cmd_test_teardown)
+				test_at_cmd_test_teardown),
+			 ztest_unit_test_setup_teardown(
+				test_schema_parse,
+				test_schema_parse_setup,
+				test_schema_parse_teardown),
+			 ztest_unit_test(test_schema_parse_optional),
+			 ztest_unit_test(test_schema_parse_errors),
+			 ztest_unit_test_setup_teardown(
+				test_schema_parse_benchmark,
+				test_schema_parse_setup,
+				test_schema_parse_teardown)
 			);
 
 	ztest_run_test_suite(at_cmd_parser);
@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <unity.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <kernel.h>
+#include <device.h>
+#include <modem/at_monitor.h>
+#include <mock_nrf_modem_at.h>
+
+/* at_monitor_dispatch() is implemented in at_monitor library and
+ * we'll call it directly to fake received notifications
+ */
+extern void at_monitor_dispatch(const char *at_notif);
+
+static int cereg_cnt;
+static int cereg_paused_cnt;
+static int cmt_cnt;
+static int any_cnt;
+static int cesq_cnt;
+static int isr_cnt;
+static char last_cereg[64];
+
+AT_MONITOR(test_cereg, "+CEREG", on_cereg);
+AT_MONITOR(test_cereg_paused, "+CEREG", on_cereg_paused, PAUSED);
+AT_MONITOR(test_cmt, "+CMT", on_cmt);
+AT_MONITOR(test_any, ANY, on_any);
+AT_MONITOR(test_cesq, "CESQ", on_cesq);
+AT_MONITOR_ISR(test_isr, "%XTIME", on_isr);
+
+static void on_cereg(const char *notif)
+{
+	cereg_cnt++;
+	strncpy(last_cereg, notif, sizeof(last_cereg) - 1);
+}
+
+static void on_cereg_paused(const char *notif)
+{
+	cereg_paused_cnt++;
+}
+
+static void on_cmt(const char *notif)
+{
+	cmt_cnt++;
+}
+
+static void on_any(const char *notif)
+{
+	any_cnt++;
+}
+
+static void on_cesq(const char *notif)
+{
+	cesq_cnt++;
+}
+
+static void on_isr(const char *notif)
+{
+	isr_cnt++;
+}
+
+static void dispatch_and_wait(const char *notif)
+{
+	at_monitor_dispatch(notif);
+	/* Let the workqueue dispatch the notification */
+	k_sleep(K_MSEC(1));
+}
+
+void setUp(void)
+{
+	cereg_cnt = 0;
+	cereg_paused_cnt = 0;
+	cmt_cnt = 0;
+	any_cnt = 0;
+	cesq_cnt = 0;
+	isr_cnt = 0;
+	memset(last_cereg, 0, sizeof(last_cereg));
+
+	mock_nrf_modem_at_Init();
+}
+
+void tearDown(void)
+{
+	at_monitor_pause(test_cereg_paused);
+
+	mock_nrf_modem_at_Verify();
+}
+
+void test_dispatch_prefix(void)
+{
+	dispatch_and_wait("+CEREG: 1,\"0A0B\"\r\n");
+
+	TEST_ASSERT_EQUAL(1, cereg_cnt);
+	TEST_ASSERT_EQUAL_STRING("+CEREG: 1,\"0A0B\"\r\n", last_cereg);
+	TEST_ASSERT_EQUAL(0, cereg_paused_cnt);
+	TEST_ASSERT_EQUAL(0, cmt_cnt);
+	TEST_ASSERT_EQUAL(1, any_cnt);
+	TEST_ASSERT_EQUAL(0, isr_cnt);
+
+	/* A filter matches notifications that start with it */
+	dispatch_and_wait("+CMTI: \"SM\",1\r\n");
+
+	TEST_ASSERT_EQUAL(1, cmt_cnt);
+	TEST_ASSERT_EQUAL(1, cereg_cnt);
+	TEST_ASSERT_EQUAL(2, any_cnt);
+}
+
+void test_dispatch_substring(void)
+{
+	/* Filters that do not start with '+' or '%' match anywhere */
+	dispatch_and_wait("%CESQ: 54,2,16,2\r\n");
+
+	TEST_ASSERT_EQUAL(1, cesq_cnt);
+	TEST_ASSERT_EQUAL(0, cereg_cnt);
+	TEST_ASSERT_EQUAL(1, any_cnt);
+}
+
+void test_dispatch_paused(void)
+{
+	at_monitor_resume(test_cereg_paused);
+
+	dispatch_and_wait("+CEREG: 5\r\n");
+
+	TEST_ASSERT_EQUAL(1, cereg_cnt);
+	TEST_ASSERT_EQUAL(1, cereg_paused_cnt);
+
+	at_monitor_pause(test_cereg_paused);
+
+	dispatch_and_wait("+CEREG: 1\r\n");
+
+	TEST_ASSERT_EQUAL(2, cereg_cnt);
+	TEST_ASSERT_EQUAL(1, cereg_paused_cnt);
+}
+
+void test_dispatch_isr(void)
+{
+	at_monitor_dispatch("%XTIME: ,\"22101611005521\",\"00\"\r\n");
+
+	/* Dispatched directly, without the workqueue */
+	TEST_ASSERT_EQUAL(1, isr_cnt);
+
+	k_sleep(K_MSEC(1));
+
+	TEST_ASSERT_EQUAL(1, isr_cnt);
+	TEST_ASSERT_EQUAL(1, any_cnt);
+}
+
+void test_dispatch_short_notif(void)
+{
+	dispatch_and_wait("+");
+
+	TEST_ASSERT_EQUAL(0, cereg_cnt);
+	TEST_ASSERT_EQUAL(1, any_cnt);
+}
+
+void test_dropped(void)
+{
+	const char *notif = "+CEREG: 1,\"0A0B\",\"01020304\"\r\n";
+	uint32_t cereg_dropped = at_monitor_dropped_get(test_cereg);
+	uint32_t any_dropped = at_monitor_dropped_get(test_any);
+	uint32_t cmt_dropped = at_monitor_dropped_get(test_cmt);
+	const int count = 5;
+
+	/* Keep the workqueue from emptying the buffer */
+	k_sched_lock();
+
+	for (int i = 0; i < count; i++) {
+		at_monitor_dispatch(notif);
+	}
+
+	k_sched_unlock();
+	k_sleep(K_MSEC(1));
+
+	TEST_ASSERT_GREATER_THAN(0, at_monitor_dropped_get(test_cereg) - cereg_dropped);
+	TEST_ASSERT_EQUAL(count, cereg_cnt + at_monitor_dropped_get(test_cereg) - cereg_dropped);
+	TEST_ASSERT_EQUAL(count, any_cnt + at_monitor_dropped_get(test_any) - any_dropped);
+	TEST_ASSERT_EQUAL(cmt_dropped, at_monitor_dropped_get(test_cmt));
+
+	/* Buffer is usable again */
+	dispatch_and_wait(notif);
+
+	TEST_ASSERT_EQUAL(count + 1, cereg_cnt + at_monitor_dropped_get(test_cereg) -
+				     cereg_dropped);
+}
+
+void test_buffer_wrap(void)
+{
+	char notif[32];
+
+	for (int i = 0; i < 100; i++) {
+		snprintf(notif, sizeof(notif), "+CEREG: %d%s\r\n", i, (i % 3) ? ",\"0A0B\"" : "");
+		dispatch_and_wait(notif);
+
+		TEST_ASSERT_EQUAL_STRING(notif, last_cereg);
+	}
+
+	TEST_ASSERT_EQUAL(100, cereg_cnt);
+}
+
+/* This is needed because AT Monitor library is initialized in SYS_INIT. */
+static int at_monitor_test_sys_init(const struct device *unused)
+{
+	__wrap_nrf_modem_at_notif_handler_set_ExpectAnyArgsAndReturn(0);
+
+	return 0;
+}
+
+/* It is required to be added to each test. That is because unity is using
+ * different main signature (returns int) and zephyr expects main which does
+ * not return value.
+ */
+extern int unity_main(void);
+
+void main(void)
+{
+	(void)unity_main();
+}
+
+SYS_INIT(at_monitor_test_sys_init, POST_KERNEL, 0);
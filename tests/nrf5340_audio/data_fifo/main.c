@@ -41,19 +41,17 @@ void test_data_fifo_init_ok(void)
 	zassert_equal(ret, 0, "init did not return 0");
 }
 
-void test_data_fifo_data_put_get_ok(void)
-{
 #define DATA_SIZE 5
-	DATA_FIFO_DEFINE(data_fifo, 8, 128);
-
+static void internal_test_data_put_get(struct data_fifo *data_fifo)
+{
 	int ret;
 
-	ret = data_fifo_init(&data_fifo);
+	ret = data_fifo_init(data_fifo);
 	zassert_equal(ret, 0, "init did not return 0");
 
 	uint8_t *data_ptr;
 
-	ret = data_fifo_pointer_first_vacant_get(&data_fifo, (void **)&data_ptr, K_NO_WAIT);
+	ret = data_fifo_pointer_first_vacant_get(data_fifo, (void **)&data_ptr, K_NO_WAIT);
 	zassert_equal(ret, 0, "first_vacant_get did not return 0");
 
 	data_ptr[0] = 0xa1;
@@ -63,14 +61,14 @@ void test_data_fifo_data_put_get_ok(void)
 	data_ptr[4] = 0xa5;
 	uint8_t data_1[DATA_SIZE] = { 0xa1, 0xa2, 0xa3, 0xa4, 0xa5 };
 
-	internal_test_remaining_elements(&data_fifo, 1, 0, __LINE__);
+	internal_test_remaining_elements(data_fifo, 1, 0, __LINE__);
 
-	ret = data_fifo_block_lock(&data_fifo, (void **)&data_ptr, DATA_SIZE);
+	ret = data_fifo_block_lock(data_fifo, (void **)&data_ptr, DATA_SIZE);
 	zassert_equal(ret, 0, "block_lock did not return 0");
 
-	internal_test_remaining_elements(&data_fifo, 1, 1, __LINE__);
+	internal_test_remaining_elements(data_fifo, 1, 1, __LINE__);
 
-	ret = data_fifo_pointer_first_vacant_get(&data_fifo, (void **)&data_ptr, K_NO_WAIT);
+	ret = data_fifo_pointer_first_vacant_get(data_fifo, (void **)&data_ptr, K_NO_WAIT);
 	zassert_equal(ret, 0, "first_vacant_get did not return 0");
 
 	data_ptr[0] = 0xb1;
@@ -81,58 +79,70 @@ void test_data_fifo_data_put_get_ok(void)
 	data_ptr[5] = 0xb6;
 	uint8_t data_2[DATA_SIZE + 1] = { 0xb1, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6 };
 
-	internal_test_remaining_elements(&data_fifo, 2, 1, __LINE__);
+	internal_test_remaining_elements(data_fifo, 2, 1, __LINE__);
 
-	ret = data_fifo_block_lock(&data_fifo, (void **)&data_ptr, DATA_SIZE + 1);
+	ret = data_fifo_block_lock(data_fifo, (void **)&data_ptr, DATA_SIZE + 1);
 	zassert_equal(ret, 0, "block_lock did not return 0");
 
-	internal_test_remaining_elements(&data_fifo, 2, 2, __LINE__);
+	internal_test_remaining_elements(data_fifo, 2, 2, __LINE__);
 
 	void *data_ptr_read;
 	size_t data_size;
 
-	ret = data_fifo_pointer_last_filled_get(&data_fifo, &data_ptr_read, &data_size, K_NO_WAIT);
+	ret = data_fifo_pointer_last_filled_get(data_fifo, &data_ptr_read, &data_size, K_NO_WAIT);
 	zassert_equal(ret, 0, "_last_filled_get did not return 0");
 	zassert_equal(memcmp(data_ptr_read, data_1, DATA_SIZE), 0,
 		      "data contents are not identical");
 	zassert_equal(data_size, DATA_SIZE, "data size incorrect");
 
-	internal_test_remaining_elements(&data_fifo, 2, 1, __LINE__);
+	internal_test_remaining_elements(data_fifo, 2, 1, __LINE__);
 
-	ret = data_fifo_block_free(&data_fifo, &data_ptr_read);
+	ret = data_fifo_block_free(data_fifo, &data_ptr_read);
 	zassert_equal(ret, 0, "block_free did not return 0");
 
-	internal_test_remaining_elements(&data_fifo, 1, 1, __LINE__);
+	internal_test_remaining_elements(data_fifo, 1, 1, __LINE__);
 
-	ret = data_fifo_pointer_last_filled_get(&data_fifo, &data_ptr_read, &data_size, K_NO_WAIT);
+	ret = data_fifo_pointer_last_filled_get(data_fifo, &data_ptr_read, &data_size, K_NO_WAIT);
 	zassert_equal(ret, 0, "_last_filled_get did not return 0");
 	zassert_equal(memcmp(data_ptr_read, data_2, DATA_SIZE), 0,
 		      "data contents are not identical");
 	zassert_equal(data_size, DATA_SIZE + 1, "data size incorrect");
 
-	internal_test_remaining_elements(&data_fifo, 1, 0, __LINE__);
+	internal_test_remaining_elements(data_fifo, 1, 0, __LINE__);
 
-	ret = data_fifo_block_free(&data_fifo, &data_ptr_read);
+	ret = data_fifo_block_free(data_fifo, &data_ptr_read);
 	zassert_equal(ret, 0, "block_free did not return 0");
 
-	internal_test_remaining_elements(&data_fifo, 0, 0, __LINE__);
+	internal_test_remaining_elements(data_fifo, 0, 0, __LINE__);
 }
 
-void test_data_fifo_data_put_too_many(void)
+void test_data_fifo_data_put_get_ok(void)
 {
-#define BLOCKS_NUM 10
-	DATA_FIFO_DEFINE(data_fifo, 10, 128);
+	DATA_FIFO_DEFINE(data_fifo, 8, 128);
+
+	internal_test_data_put_get(&data_fifo);
+}
+
+void test_data_fifo_spsc_data_put_get_ok(void)
+{
+	DATA_FIFO_SPSC_DEFINE(data_fifo, 8, 128);
+
+	internal_test_data_put_get(&data_fifo);
+}
 
+#define BLOCKS_NUM 10
+static void internal_test_data_put_too_many(struct data_fifo *data_fifo)
+{
 	int ret;
 
-	ret = data_fifo_init(&data_fifo);
+	ret = data_fifo_init(data_fifo);
 	zassert_equal(ret, 0, "init did not return 0");
 
 	uint8_t *data_ptr;
 	size_t data_size = 5;
 
 	for (uint32_t i = 0; i < BLOCKS_NUM; i++) {
-		ret = data_fifo_pointer_first_vacant_get(&data_fifo, (void **)&data_ptr, K_NO_WAIT);
+		ret = data_fifo_pointer_first_vacant_get(data_fifo, (void **)&data_ptr, K_NO_WAIT);
 		zassert_equal(ret, 0, "first_vacant_get did not return 0");
 		data_ptr[0] = 0xa1;
 		data_ptr[1] = 0xa2;
@@ -140,19 +150,42 @@ void test_data_fifo_data_put_too_many(void)
 		data_ptr[3] = 0xa4;
 		data_ptr[4] = 0xa5;
 
-		internal_test_remaining_elements(&data_fifo, i + 1, i, __LINE__);
+		internal_test_remaining_elements(data_fifo, i + 1, i, __LINE__);
 
-		ret = data_fifo_block_lock(&data_fifo, (void **)&data_ptr, data_size);
+		ret = data_fifo_block_lock(data_fifo, (void **)&data_ptr, data_size);
 		zassert_equal(ret, 0, "block_lock did not return 0");
 
-		internal_test_remaining_elements(&data_fifo, i + 1, i + 1, __LINE__);
+		internal_test_remaining_elements(data_fifo, i + 1, i + 1, __LINE__);
 	}
 
 	/* Add one too many elements */
-	ret = data_fifo_pointer_first_vacant_get(&data_fifo, (void **)&data_ptr, K_NO_WAIT);
+	ret = data_fifo_pointer_first_vacant_get(data_fifo, (void **)&data_ptr, K_NO_WAIT);
 	zassert_equal(ret, -ENOMEM, "first_vacant_get did not ENOMEM");
 }
 
+void test_data_fifo_data_put_too_many(void)
+{
+	DATA_FIFO_DEFINE(data_fifo, BLOCKS_NUM, 128);
+
+	internal_test_data_put_too_many(&data_fifo);
+}
+
+void test_data_fifo_spsc_data_put_too_many(void)
+{
+	DATA_FIFO_SPSC_DEFINE(data_fifo, BLOCKS_NUM, 128);
+	struct data_fifo_stats stats;
+	int ret;
+
+	internal_test_data_put_too_many(&data_fifo);
+
+	ret = data_fifo_stats_get(&data_fifo, &stats);
+	zassert_equal(ret, 0, "stats_get did not return 0");
+	zassert_equal(stats.alloced_max, BLOCKS_NUM, "alloced_max %d", stats.alloced_max);
+	zassert_equal(stats.locked_max, BLOCKS_NUM, "locked_max %d", stats.locked_max);
+	zassert_equal(stats.lock_cnt, BLOCKS_NUM, "lock_cnt %d", stats.lock_cnt);
+	zassert_equal(stats.full_cnt, 1, "full_cnt %d", stats.full_cnt);
+}
+
 void test_data_fifo_data_put_too_much_data(void)
 {
 	DATA_FIFO_DEFINE(data_fifo, 10, 128);
@@ -191,6 +224,171 @@ void test_data_fifo_data_put_size_zero(void)
 	zassert_equal(ret, -EINVAL, "block_lock did not return -EINVAL");
 }
 
+void test_data_fifo_spsc_wrong_order(void)
+{
+	DATA_FIFO_SPSC_DEFINE(data_fifo, 4, 128);
+
+	int ret;
+	void *data_ptr_1;
+	void *data_ptr_2;
+	size_t data_size;
+
+	ret = data_fifo_init(&data_fifo);
+	zassert_equal(ret, 0, "init did not return 0");
+
+	ret = data_fifo_pointer_first_vacant_get(&data_fifo, &data_ptr_1, K_NO_WAIT);
+	zassert_equal(ret, 0, "first_vacant_get did not return 0");
+	ret = data_fifo_pointer_first_vacant_get(&data_fifo, &data_ptr_2, K_NO_WAIT);
+	zassert_equal(ret, 0, "first_vacant_get did not return 0");
+
+	/* Blocks must be locked in allocation order */
+	ret = data_fifo_block_lock(&data_fifo, &data_ptr_2, DATA_SIZE);
+	zassert_equal(ret, -ESPIPE, "block_lock did not return -ESPIPE");
+
+	ret = data_fifo_block_lock(&data_fifo, &data_ptr_1, DATA_SIZE);
+	zassert_equal(ret, 0, "block_lock did not return 0");
+	ret = data_fifo_block_lock(&data_fifo, &data_ptr_2, DATA_SIZE);
+	zassert_equal(ret, 0, "block_lock did not return 0");
+
+	/* Blocks can not be freed before they are fetched */
+	ret = data_fifo_block_free(&data_fifo, &data_ptr_1);
+	zassert_equal(ret, -EPERM, "block_free did not return -EPERM");
+
+	ret = data_fifo_pointer_last_filled_get(&data_fifo, &data_ptr_1, &data_size, K_NO_WAIT);
+	zassert_equal(ret, 0, "_last_filled_get did not return 0");
+	ret = data_fifo_pointer_last_filled_get(&data_fifo, &data_ptr_2, &data_size, K_NO_WAIT);
+	zassert_equal(ret, 0, "_last_filled_get did not return 0");
+	ret = data_fifo_pointer_last_filled_get(&data_fifo, &data_ptr_2, &data_size, K_NO_WAIT);
+	zassert_equal(ret, -ENOMSG, "_last_filled_get did not return -ENOMSG");
+
+	/* Blocks must be freed in read order */
+	ret = data_fifo_block_free(&data_fifo, &data_ptr_2);
+	zassert_equal(ret, -EPERM, "block_free did not return -EPERM");
+
+	ret = data_fifo_block_free(&data_fifo, &data_ptr_1);
+	zassert_equal(ret, 0, "block_free did not return 0");
+	ret = data_fifo_block_free(&data_fifo, &data_ptr_2);
+	zassert_equal(ret, 0, "block_free did not return 0");
+
+	internal_test_remaining_elements(&data_fifo, 0, 0, __LINE__);
+}
+
+void test_data_fifo_stats_not_supported(void)
+{
+	DATA_FIFO_DEFINE(data_fifo, 4, 128);
+
+	struct data_fifo_stats stats;
+	int ret;
+
+	ret = data_fifo_init(&data_fifo);
+	zassert_equal(ret, 0, "init did not return 0");
+
+	ret = data_fifo_stats_get(&data_fifo, &stats);
+	zassert_equal(ret, -ENOTSUP, "stats_get did not return -ENOTSUP");
+}
+
+#define STRESS_BLOCKS_NUM 4
+#define STRESS_BLOCK_SIZE 64
+#define STRESS_ITERATIONS 20000
+#define STRESS_STACK_SIZE 1024
+
+K_THREAD_STACK_DEFINE(stress_producer_stack, STRESS_STACK_SIZE);
+static struct k_thread stress_producer_thread;
+
+/* The producer polls without waiting while the consumer blocks, so both
+ * the non-blocking and the blocking paths are exercised.
+ */
+static void stress_producer(void *p1, void *p2, void *p3)
+{
+	struct data_fifo *data_fifo = p1;
+	uint32_t *data_ptr;
+	int ret;
+
+	for (uint32_t i = 0; i < STRESS_ITERATIONS; i++) {
+		while (true) {
+			ret = data_fifo_pointer_first_vacant_get(data_fifo, (void **)&data_ptr,
+								 K_NO_WAIT);
+			if (ret != -ENOMEM) {
+				break;
+			}
+
+			k_yield();
+		}
+		zassert_equal(ret, 0, "first_vacant_get returned %d", ret);
+
+		data_ptr[0] = i;
+		data_ptr[1] = ~i;
+
+		ret = data_fifo_block_lock(data_fifo, (void **)&data_ptr,
+					   sizeof(uint32_t) * (2 + i % (STRESS_BLOCK_SIZE / 4 - 2)));
+		zassert_equal(ret, 0, "block_lock returned %d", ret);
+	}
+}
+
+static uint32_t internal_test_stress(struct data_fifo *data_fifo)
+{
+	uint32_t *data_ptr;
+	size_t data_size;
+	uint32_t start;
+	int ret;
+
+	ret = data_fifo_init(data_fifo);
+	zassert_equal(ret, 0, "init did not return 0");
+
+	start = k_cycle_get_32();
+
+	/* Same priority as the consumer so the two interleave on full and empty */
+	k_thread_create(&stress_producer_thread, stress_producer_stack,
+			K_THREAD_STACK_SIZEOF(stress_producer_stack), stress_producer, data_fifo,
+			NULL, NULL, k_thread_priority_get(k_current_get()), 0, K_NO_WAIT);
+
+	for (uint32_t i = 0; i < STRESS_ITERATIONS; i++) {
+		ret = data_fifo_pointer_last_filled_get(data_fifo, (void **)&data_ptr, &data_size,
+							K_FOREVER);
+		zassert_equal(ret, 0, "_last_filled_get returned %d", ret);
+		zassert_equal(data_ptr[0], i, "Block %d out of order", i);
+		zassert_equal(data_ptr[1], ~i, "Block %d corrupted", i);
+		zassert_equal(data_size, sizeof(uint32_t) * (2 + i % (STRESS_BLOCK_SIZE / 4 - 2)),
+			      "Block %d has wrong size", i);
+
+		ret = data_fifo_block_free(data_fifo, (void **)&data_ptr);
+		zassert_equal(ret, 0, "block_free returned %d", ret);
+	}
+
+	k_thread_join(&stress_producer_thread, K_FOREVER);
+
+	internal_test_remaining_elements(data_fifo, 0, 0, __LINE__);
+
+	return k_cycle_get_32() - start;
+}
+
+void test_data_fifo_stress(void)
+{
+	DATA_FIFO_DEFINE(data_fifo, STRESS_BLOCKS_NUM, STRESS_BLOCK_SIZE);
+	DATA_FIFO_SPSC_DEFINE(data_fifo_spsc, STRESS_BLOCKS_NUM, STRESS_BLOCK_SIZE);
+
+	struct data_fifo_stats stats;
+	uint32_t cycles;
+	uint32_t cycles_spsc;
+	int ret;
+
+	cycles = internal_test_stress(&data_fifo);
+	cycles_spsc = internal_test_stress(&data_fifo_spsc);
+
+	ret = data_fifo_stats_get(&data_fifo_spsc, &stats);
+	zassert_equal(ret, 0, "stats_get did not return 0");
+	zassert_equal(stats.lock_cnt, STRESS_ITERATIONS, "lock_cnt %d", stats.lock_cnt);
+	zassert_true(stats.alloced_max <= STRESS_BLOCKS_NUM, "alloced_max %d", stats.alloced_max);
+	zassert_true(stats.locked_max <= STRESS_BLOCKS_NUM, "locked_max %d", stats.locked_max);
+
+	TC_PRINT("%d blocks: msgq/slab %u cycles, SPSC %u cycles\n", STRESS_ITERATIONS, cycles,
+		 cycles_spsc);
+	TC_PRINT("SPSC fill: max alloced %u, max locked %u, avg locked %u/100, full %u, empty %u\n",
+		 stats.alloced_max, stats.locked_max,
+		 (uint32_t)(stats.locked_sum * 100 / stats.lock_cnt), stats.full_cnt,
+		 stats.empty_cnt);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_suite_data_fifo,
@@ -198,7 +396,12 @@ void test_main(void)
 		ztest_unit_test(test_data_fifo_data_put_get_ok),
 		ztest_unit_test(test_data_fifo_data_put_too_many),
 		ztest_unit_test(test_data_fifo_data_put_too_much_data),
-		ztest_unit_test(test_data_fifo_data_put_size_zero)
+		ztest_unit_test(test_data_fifo_data_put_size_zero),
+		ztest_unit_test(test_data_fifo_spsc_data_put_get_ok),
+		ztest_unit_test(test_data_fifo_spsc_data_put_too_many),
+		ztest_unit_test(test_data_fifo_spsc_wrong_order),
+		ztest_unit_test(test_data_fifo_stats_not_supported),
+		ztest_unit_test(test_data_fifo_stress)
 	);
 
 	ztest_run_test_suite(test_suite_data_fifo);
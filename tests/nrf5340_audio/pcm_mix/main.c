@@ -8,6 +8,10 @@
 #include <errno.h>
 #include "pcm_mix.h"
 
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+#include <native_rtc.h>
+#endif
+
 #define ZEQ(a, b) zassert_equal(a, b, "fail")
 
 void verify_array_eq(int16_t *p1, int16_t *p2, uint32_t elements)
@@ -127,6 +131,156 @@ void test_mono_into_stereo_r(void)
 	verify_array_eq(sample_a, sample_r, ARRAY_SIZE(sample_r));
 }
 
+/* Scalar reference mix used to verify the packed implementation */
+static void ref_mix(int16_t *a, int16_t const *b, uint32_t num_b, enum pcm_mix_mode mix_mode)
+{
+	for (uint32_t i = 0; i < num_b; i++) {
+		uint32_t idx[2];
+		uint32_t cnt = 1;
+
+		switch (mix_mode) {
+		case B_MONO_INTO_A_STEREO_LR:
+			idx[0] = i * 2;
+			idx[1] = i * 2 + 1;
+			cnt = 2;
+			break;
+		case B_MONO_INTO_A_STEREO_L:
+			idx[0] = i * 2;
+			break;
+		case B_MONO_INTO_A_STEREO_R:
+			idx[0] = i * 2 + 1;
+			break;
+		default:
+			idx[0] = i;
+			break;
+		}
+
+		for (uint32_t j = 0; j < cnt; j++) {
+			int32_t res = a[idx[j]] + b[i];
+
+			a[idx[j]] = (int16_t)CLAMP(res, INT16_MIN, INT16_MAX);
+		}
+	}
+}
+
+static uint32_t rand_state = 0x12345678;
+
+static int16_t rand_sample(void)
+{
+	/* Simple LCG, values biased towards the edges to exercise clipping */
+	rand_state = rand_state * 1664525 + 1013904223;
+
+	switch (rand_state >> 30) {
+	case 0:
+		return INT16_MAX - (int16_t)((rand_state >> 8) & 0xFF);
+	case 1:
+		return INT16_MIN + (int16_t)((rand_state >> 8) & 0xFF);
+	default:
+		return (int16_t)(rand_state >> 8);
+	}
+}
+
+#define RAND_MAX_SAMPLES 64
+
+static void verify_mode_against_ref(enum pcm_mix_mode mix_mode, bool mono_into_stereo)
+{
+	/* One extra sample so buffers can be tested misaligned by 2 bytes */
+	static int16_t buf_a[RAND_MAX_SAMPLES * 2 + 1];
+	static int16_t buf_r[RAND_MAX_SAMPLES * 2 + 1];
+	static int16_t buf_b[RAND_MAX_SAMPLES + 1];
+	int ret;
+
+	for (uint32_t offset = 0; offset < 2; offset++) {
+		for (uint32_t num_b = 1; num_b <= RAND_MAX_SAMPLES; num_b++) {
+			uint32_t num_a = mono_into_stereo ? num_b * 2 : num_b;
+			int16_t *a = &buf_a[offset];
+			int16_t *b = &buf_b[offset];
+
+			for (uint32_t i = 0; i < num_a; i++) {
+				a[i] = rand_sample();
+				buf_r[i] = a[i];
+			}
+
+			for (uint32_t i = 0; i < num_b; i++) {
+				b[i] = rand_sample();
+			}
+
+			ref_mix(buf_r, b, num_b, mix_mode);
+
+			ret = pcm_mix(a, num_a * sizeof(int16_t), b, num_b * sizeof(int16_t),
+				      mix_mode);
+			ZEQ(ret, 0);
+
+			verify_array_eq(a, buf_r, num_a);
+		}
+	}
+}
+
+void test_mix_matches_reference(void)
+{
+	verify_mode_against_ref(B_STEREO_INTO_A_STEREO, false);
+	verify_mode_against_ref(B_MONO_INTO_A_MONO, false);
+	verify_mode_against_ref(B_MONO_INTO_A_STEREO_LR, true);
+	verify_mode_against_ref(B_MONO_INTO_A_STEREO_L, true);
+	verify_mode_against_ref(B_MONO_INTO_A_STEREO_R, true);
+}
+
+/* 10 ms of 48 kHz mono audio, i.e. one audio frame */
+#define BENCH_MONO_SAMPLES 480
+#define BENCH_ITERATIONS 1000
+
+static uint64_t bench_time_us(void)
+{
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+	/* Simulated time does not advance while the CPU is busy */
+	return native_rtc_gettime_us(RTC_CLOCK_REAL);
+#else
+	return k_cyc_to_us_floor64(k_cycle_get_32());
+#endif
+}
+
+static void bench_mode(char const *name, enum pcm_mix_mode mix_mode, bool mono_into_stereo)
+{
+	static int16_t bench_a[BENCH_MONO_SAMPLES * 2];
+	static int16_t bench_b[BENCH_MONO_SAMPLES];
+	uint32_t num_a = mono_into_stereo ? BENCH_MONO_SAMPLES * 2 : BENCH_MONO_SAMPLES;
+	uint64_t start;
+	uint64_t elapsed;
+
+	for (uint32_t i = 0; i < ARRAY_SIZE(bench_b); i++) {
+		bench_b[i] = rand_sample() / 4;
+	}
+
+	for (uint32_t i = 0; i < ARRAY_SIZE(bench_a); i++) {
+		bench_a[i] = rand_sample() / 4;
+	}
+
+	start = bench_time_us();
+
+	for (uint32_t i = 0; i < BENCH_ITERATIONS; i++) {
+		(void)pcm_mix(bench_a, num_a * sizeof(int16_t), bench_b, sizeof(bench_b),
+			      mix_mode);
+	}
+
+	elapsed = bench_time_us() - start;
+
+	TC_PRINT("%-24s %u frames in %u us (%u ns/frame, %u Msamples/s)\n", name,
+		 BENCH_ITERATIONS, (uint32_t)elapsed,
+		 (uint32_t)(elapsed * 1000 / BENCH_ITERATIONS),
+		 elapsed ? (uint32_t)((uint64_t)num_a * BENCH_ITERATIONS / elapsed) : 0);
+}
+
+void test_mix_throughput(void)
+{
+	TC_PRINT("Packed 2x16-bit DSP mixing: %s\n",
+		 IS_ENABLED(__ARM_FEATURE_SIMD32) ? "yes" : "no");
+
+	bench_mode("stereo into stereo", B_STEREO_INTO_A_STEREO, false);
+	bench_mode("mono into stereo LR", B_MONO_INTO_A_STEREO_LR, true);
+	bench_mode("mono into stereo L", B_MONO_INTO_A_STEREO_L, true);
+	bench_mode("mono into stereo R", B_MONO_INTO_A_STEREO_R, true);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_suite_pcm_mix,
@@ -137,7 +291,9 @@ void test_main(void)
 		ztest_unit_test(test_high_values),
 		ztest_unit_test(test_mono_into_stereo_lr),
 		ztest_unit_test(test_mono_into_stereo_l),
-		ztest_unit_test(test_mono_into_stereo_r)
+		ztest_unit_test(test_mono_into_stereo_r),
+		ztest_unit_test(test_mix_matches_reference),
+		ztest_unit_test(test_mix_throughput)
 	);
 
 	ztest_run_test_suite(test_suite_pcm_mix);
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <errno.h>
+#include <limits.h>
+#include "sample_rate_conv.h"
+
+#define TEST_PI 3.14159265358979323846
+#define TEST_TONE_HZ 1000
+#define TEST_AMPLITUDE 16000
+/* Minimum signal to noise ratio for an in-band tone */
+#define TEST_SNR_MIN_DB 70
+#define TEST_BLOCK_MS 10
+#define TEST_NUM_BLOCKS 20
+#define TEST_MAX_RATE_HZ 48000
+#define TEST_BLOCK_FRAMES_MAX (TEST_MAX_RATE_HZ * TEST_BLOCK_MS / 1000)
+#define TEST_OUT_FRAMES_MAX (TEST_BLOCK_FRAMES_MAX * TEST_NUM_BLOCKS + TEST_NUM_BLOCKS)
+
+static struct sample_rate_conv_ctx ctx;
+static int16_t in_buf[TEST_BLOCK_FRAMES_MAX * SAMPLE_RATE_CONV_CHANNELS_MAX];
+static int16_t out_buf[TEST_OUT_FRAMES_MAX * SAMPLE_RATE_CONV_CHANNELS_MAX];
+
+/* Reference sine, avoids depending on a math library */
+static double sin_ref(double x)
+{
+	double term;
+	double sum;
+
+	while (x > TEST_PI) {
+		x -= 2 * TEST_PI;
+	}
+
+	while (x < -TEST_PI) {
+		x += 2 * TEST_PI;
+	}
+
+	term = x;
+	sum = x;
+
+	for (int k = 1; k < 12; k++) {
+		term *= -x * x / ((2 * k) * (2 * k + 1));
+		sum += term;
+	}
+
+	return sum;
+}
+
+static double cos_ref(double x)
+{
+	return sin_ref(x + TEST_PI / 2);
+}
+
+/* Power ratio in whole dB, avoids depending on a math library */
+static int power_ratio_db(double ratio)
+{
+	/* 10^(1/10) */
+	const double one_db = 1.2589254117941673;
+	int db = 0;
+
+	while (ratio >= one_db) {
+		ratio /= one_db;
+		db++;
+	}
+
+	return db;
+}
+
+/* Convert a tone in blocks and return the number of output frames */
+static size_t convert_tone(uint32_t in_rate_hz, uint32_t out_rate_hz, uint8_t channels,
+			   int32_t drift_ppm)
+{
+	size_t in_frames = in_rate_hz * TEST_BLOCK_MS / 1000;
+	size_t out_total = 0;
+	size_t out_frames;
+	int ret;
+
+	ret = sample_rate_conv_init(&ctx, in_rate_hz, out_rate_hz, channels);
+	zassert_equal(ret, 0, "init failed %d", ret);
+
+	ret = sample_rate_conv_drift_set(&ctx, drift_ppm);
+	zassert_equal(ret, 0, "drift_set failed %d", ret);
+
+	for (uint32_t blk = 0; blk < TEST_NUM_BLOCKS; blk++) {
+		for (size_t i = 0; i < in_frames; i++) {
+			uint32_t n = blk * in_frames + i;
+			double phase = 2 * TEST_PI * TEST_TONE_HZ * (double)n / in_rate_hz;
+
+			for (uint8_t ch = 0; ch < channels; ch++) {
+				/* Different phase per channel to catch channel mix-ups */
+				in_buf[i * channels + ch] =
+					(int16_t)(TEST_AMPLITUDE * sin_ref(phase + ch * TEST_PI / 3));
+			}
+		}
+
+		ret = sample_rate_conv_process(&ctx, in_buf, in_frames,
+					       &out_buf[out_total * channels],
+					       TEST_OUT_FRAMES_MAX - out_total, &out_frames);
+		zassert_equal(ret, 0, "process failed %d", ret);
+
+		out_total += out_frames;
+	}
+
+	return out_total;
+}
+
+/* Fit a tone at the given frequency to one output channel by least squares
+ * and return the SNR of the fit in dB.
+ */
+static int channel_snr_db(size_t frames, uint8_t channels, uint8_t ch, double freq_norm)
+{
+	/* Skip the filter settling time */
+	size_t start = SAMPLE_RATE_CONV_TAPS * SAMPLE_RATE_CONV_RATIO_MAX;
+	double ss = 0, cc = 0, sc = 0, ys = 0, yc = 0;
+	double a, b, det;
+	double sig = 0, err = 0;
+
+	for (size_t m = start; m < frames; m++) {
+		double s = sin_ref(2 * TEST_PI * freq_norm * m);
+		double c = cos_ref(2 * TEST_PI * freq_norm * m);
+		double y = out_buf[m * channels + ch];
+
+		ss += s * s;
+		cc += c * c;
+		sc += s * c;
+		ys += y * s;
+		yc += y * c;
+	}
+
+	det = ss * cc - sc * sc;
+	a = (ys * cc - yc * sc) / det;
+	b = (yc * ss - ys * sc) / det;
+
+	for (size_t m = start; m < frames; m++) {
+		double fit = a * sin_ref(2 * TEST_PI * freq_norm * m) +
+			     b * cos_ref(2 * TEST_PI * freq_norm * m);
+		double y = out_buf[m * channels + ch];
+
+		sig += fit * fit;
+		err += (y - fit) * (y - fit);
+	}
+
+	zassert_true(sig > 0, "No signal");
+
+	if (err == 0) {
+		return INT_MAX;
+	}
+
+	return power_ratio_db(sig / err);
+}
+
+static void verify_conversion(uint32_t in_rate_hz, uint32_t out_rate_hz, uint8_t channels,
+			      int32_t drift_ppm)
+{
+	size_t frames = convert_tone(in_rate_hz, out_rate_hz, channels, drift_ppm);
+	/* Positive drift consumes input faster, raising the output tone */
+	double freq_norm = (double)TEST_TONE_HZ / out_rate_hz * (1.0 + drift_ppm / 1000000.0);
+	size_t expected = (size_t)((uint64_t)TEST_NUM_BLOCKS * out_rate_hz * TEST_BLOCK_MS / 1000 *
+				   1000000 / (1000000 + drift_ppm));
+
+	zassert_within(frames, expected, 2, "%d -> %d: %zu frames, expected %zu", in_rate_hz,
+		       out_rate_hz, frames, expected);
+
+	for (uint8_t ch = 0; ch < channels; ch++) {
+		int snr = channel_snr_db(frames, channels, ch, freq_norm);
+
+		TC_PRINT("%5d -> %5d Hz, %d ch, %5d ppm: ch %d SNR %d dB\n", in_rate_hz,
+			 out_rate_hz, channels, drift_ppm, ch, snr);
+		zassert_true(snr > TEST_SNR_MIN_DB, "SNR %d dB too low", snr);
+	}
+}
+
+void test_sample_rate_conv_snr(void)
+{
+	verify_conversion(48000, 48000, 1, 0);
+	verify_conversion(44100, 48000, 1, 0);
+	verify_conversion(48000, 44100, 1, 0);
+	verify_conversion(16000, 48000, 1, 0);
+	verify_conversion(24000, 48000, 1, 0);
+	verify_conversion(48000, 16000, 1, 0);
+	verify_conversion(48000, 24000, 1, 0);
+}
+
+void test_sample_rate_conv_stereo(void)
+{
+	verify_conversion(44100, 48000, 2, 0);
+	verify_conversion(48000, 16000, 2, 0);
+}
+
+void test_sample_rate_conv_drift(void)
+{
+	verify_conversion(48000, 48000, 2, 500);
+	verify_conversion(48000, 48000, 2, -500);
+	verify_conversion(16000, 48000, 1, 100);
+}
+
+void test_sample_rate_conv_illegal_arguments(void)
+{
+	size_t out_frames;
+	int ret;
+
+	ret = sample_rate_conv_init(NULL, 48000, 48000, 1);
+	zassert_equal(ret, -ENXIO, "NULL ctx accepted");
+
+	ret = sample_rate_conv_init(&ctx, 0, 48000, 1);
+	zassert_equal(ret, -EINVAL, "Zero rate accepted");
+
+	ret = sample_rate_conv_init(&ctx, 48000, 8000, 1);
+	zassert_equal(ret, -EINVAL, "Too large ratio accepted");
+
+	ret = sample_rate_conv_init(&ctx, 48000, 48000, SAMPLE_RATE_CONV_CHANNELS_MAX + 1);
+	zassert_equal(ret, -EINVAL, "Too many channels accepted");
+
+	ret = sample_rate_conv_init(&ctx, 16000, 48000, 1);
+	zassert_equal(ret, 0, "init failed %d", ret);
+
+	ret = sample_rate_conv_drift_set(&ctx, SAMPLE_RATE_CONV_DRIFT_PPM_MAX + 1);
+	zassert_equal(ret, -EINVAL, "Too large drift accepted");
+
+	/* 160 input frames give 480 output frames */
+	ret = sample_rate_conv_process(&ctx, in_buf, 160, out_buf, 480 - 1, &out_frames);
+	zassert_equal(ret, -ENOMEM, "Too small output buffer accepted");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_suite_sample_rate_conv,
+		ztest_unit_test(test_sample_rate_conv_snr),
+		ztest_unit_test(test_sample_rate_conv_stereo),
+		ztest_unit_test(test_sample_rate_conv_drift),
+		ztest_unit_test(test_sample_rate_conv_illegal_arguments)
+	);
+
+	ztest_run_test_suite(test_suite_sample_rate_conv);
+}
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _REFCNT_EVENT_H_
+#define _REFCNT_EVENT_H_
+
+/**
+ * @brief Reference Counted Event
+ * @defgroup refcnt_event Event used to test event references
+ * @{
+ */
+
+#include <app_event_manager.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct refcnt_event {
+	struct app_event_header header;
+
+	struct event_dyndata dyndata;
+};
+
+APP_EVENT_TYPE_DYNDATA_DECLARE(refcnt_event);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _REFCNT_EVENT_H_ */
@@ -28,6 +28,8 @@ enum test_id {
 	TEST_SUBSCRIBER_ORDER,
 	TEST_OOM_RESET,
 	TEST_MULTICONTEXT,
+	TEST_EVENT_PRIO,
+	TEST_EVENT_REFCNT,
 
 	TEST_CNT
 };
@@ -73,6 +73,11 @@ static void test_multicontext(void)
 	test_start(TEST_MULTICONTEXT);
 }
 
+static void test_event_prio(void)
+{
+	test_start(TEST_EVENT_PRIO);
+}
+
 static void test_event_size_static(void)
 {
 	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PROVIDE_EVENT_SIZE)) {
@@ -174,6 +179,127 @@ static void test_event_size_disabled(void)
 	app_event_manager_free(ev_s1);
 }
 
+static void test_event_slab_static(void)
+{
+	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_SLAB)) {
+		ztest_test_skip();
+		return;
+	}
+
+	struct test_size1_event *ev_tab[CONFIG_APP_EVENT_MANAGER_EVENT_SLAB_BLOCK_CNT + 1];
+	struct app_event_manager_slab_stats stats;
+	const struct event_type *et = &__event_type_test_size1_event;
+
+	app_event_manager_slab_stats_get(et, &stats);
+	zassert_equal(stats.block_cnt, CONFIG_APP_EVENT_MANAGER_EVENT_SLAB_BLOCK_CNT,
+		      "Unexpected number of slab blocks");
+	zassert_true(stats.block_size >= sizeof(struct test_size1_event),
+		     "Slab block too small");
+	zassert_equal(stats.used_cnt, 0, "Slab blocks not released");
+	zassert_equal(stats.fallback_cnt, 0, "Unexpected fallback allocation");
+
+	for (size_t i = 0; i < ARRAY_SIZE(ev_tab); i++) {
+		ev_tab[i] = new_test_size1_event();
+		zassert_not_null(ev_tab[i], "Failed to allocate event");
+	}
+
+	app_event_manager_slab_stats_get(et, &stats);
+	zassert_equal(stats.used_cnt, CONFIG_APP_EVENT_MANAGER_EVENT_SLAB_BLOCK_CNT,
+		      "Slab not exhausted");
+	zassert_equal(stats.max_used_cnt, CONFIG_APP_EVENT_MANAGER_EVENT_SLAB_BLOCK_CNT,
+		      "Unexpected slab high-water mark");
+	zassert_equal(stats.fallback_cnt, 1, "Fallback allocation not recorded");
+
+	for (size_t i = 0; i < ARRAY_SIZE(ev_tab); i++) {
+		app_event_manager_free(ev_tab[i]);
+	}
+
+	app_event_manager_slab_stats_get(et, &stats);
+	zassert_equal(stats.used_cnt, 0, "Slab blocks not released");
+	zassert_equal(stats.max_used_cnt, CONFIG_APP_EVENT_MANAGER_EVENT_SLAB_BLOCK_CNT,
+		      "High-water mark should not decrease");
+}
+
+static void test_event_slab_dynamic(void)
+{
+	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_SLAB)) {
+		ztest_test_skip();
+		return;
+	}
+
+	struct test_dynamic_event *ev_small;
+	struct test_dynamic_event *ev_big;
+	struct app_event_manager_slab_stats stats;
+	const struct event_type *et = &__event_type_test_dynamic_event;
+
+	ev_small = new_test_dynamic_event(CONFIG_APP_EVENT_MANAGER_EVENT_SLAB_DYNDATA_SIZE);
+	zassert_not_null(ev_small, "Failed to allocate event");
+	ev_big = new_test_dynamic_event(CONFIG_APP_EVENT_MANAGER_EVENT_SLAB_DYNDATA_SIZE + 100);
+	zassert_not_null(ev_big, "Failed to allocate event");
+
+	app_event_manager_slab_stats_get(et, &stats);
+	zassert_equal(stats.used_cnt, 1, "Event with small dyndata not in slab");
+	zassert_equal(stats.fallback_cnt, 1, "Event with big dyndata not in heap");
+
+	app_event_manager_free(ev_small);
+	app_event_manager_free(ev_big);
+
+	app_event_manager_slab_stats_get(et, &stats);
+	zassert_equal(stats.used_cnt, 0, "Slab blocks not released");
+}
+
+static void test_listener_stats(void)
+{
+	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LISTENER_STATS)) {
+		ztest_test_skip();
+		return;
+	}
+
+	extern struct event_listener __event_listener_test_main;
+
+	struct event_subscriber_stats stats;
+	uint32_t hist_sum = 0;
+	int err;
+
+	app_event_manager_listener_stats_reset();
+	test_start(TEST_BASIC);
+
+	/* Let the event processor finish the notification. */
+	k_sleep(K_MSEC(10));
+
+	err = app_event_manager_listener_stats_get(&__event_type_test_end_event,
+						   &__event_listener_test_main, &stats);
+	zassert_equal(err, 0, "Listener statistics not found");
+	zassert_equal(stats.call_cnt, 1, "Unexpected number of notifications");
+	zassert_true(stats.total_cycles >= stats.max_cycles, "Inconsistent cycle count");
+
+	for (size_t i = 0; i < ARRAY_SIZE(stats.hist); i++) {
+		hist_sum += stats.hist[i];
+	}
+	zassert_equal(hist_sum, stats.call_cnt, "Histogram does not match notifications");
+
+	err = app_event_manager_listener_stats_get(&__event_type_test_start_event,
+						   &__event_listener_test_main, &stats);
+	zassert_equal(err, -ENOENT, "Listener is not subscribed to the event");
+}
+
+void test_refcnt_release(void);
+
+static void test_event_refcnt(void)
+{
+	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_REFCNT)) {
+		ztest_test_skip();
+		return;
+	}
+
+	test_start(TEST_EVENT_REFCNT);
+
+	/* Let the event processor release its reference. */
+	k_sleep(K_MSEC(10));
+
+	test_refcnt_release();
+}
+
 void test_oom_reset(void);
 
 void test_main(void)
@@ -186,10 +312,15 @@ void test_main(void)
 			 ztest_unit_test(test_subs_order),
 			 ztest_unit_test(test_oom_reset),
 			 ztest_unit_test(test_multicontext),
+			 ztest_unit_test(test_event_prio),
+			 ztest_unit_test(test_listener_stats),
+			 ztest_unit_test(test_event_refcnt),
 			 ztest_unit_test(test_event_size_static),
 			 ztest_unit_test(test_event_size_dynamic),
 			 ztest_unit_test(test_event_size_dynamic_with_data),
-			 ztest_unit_test(test_event_size_disabled)
+			 ztest_unit_test(test_event_size_disabled),
+			 ztest_unit_test(test_event_slab_static),
+			 ztest_unit_test(test_event_slab_dynamic)
 			 );
 
 	ztest_run_test_suite(app_event_manager_tests);
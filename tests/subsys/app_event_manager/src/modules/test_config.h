@@ -19,3 +19,11 @@
 
 /* TEST_EVENT_ORDER */
 #define TEST_EVENT_ORDER_CNT 20
+
+
+/* TEST_EVENT_PRIO */
+#define TEST_EVENT_PRIO_CNT 5
+
+
+/* TEST_EVENT_REFCNT */
+#define TEST_EVENT_REFCNT_DATA_SIZE 32
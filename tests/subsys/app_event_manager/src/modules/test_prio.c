@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <test_events.h>
+#include <prio_event.h>
+
+#include "test_config.h"
+
+#define MODULE test_prio
+
+/* Events are submitted in the order: low, normal, high, low, normal, high...
+ * With priority classes enabled all high events are expected first, then all
+ * normal events and then all low events. Otherwise, events are expected in
+ * the submission order.
+ */
+static int recv_cnt;
+
+static void check_event(enum app_event_prio prio, int val)
+{
+	int expected_idx;
+
+	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_PRIO)) {
+		expected_idx = (APP_EVENT_PRIO_HIGH - prio) * TEST_EVENT_PRIO_CNT + val;
+	} else {
+		expected_idx = val * APP_EVENT_PRIO_COUNT + prio;
+	}
+
+	zassert_equal(recv_cnt, expected_idx, "Incorrect event order");
+	recv_cnt++;
+
+	if (recv_cnt == TEST_EVENT_PRIO_CNT * APP_EVENT_PRIO_COUNT) {
+		struct test_end_event *te = new_test_end_event();
+
+		zassert_not_null(te, "Failed to allocate event");
+		te->test_id = TEST_EVENT_PRIO;
+		APP_EVENT_SUBMIT(te);
+	}
+}
+
+static bool app_event_handler(const struct app_event_header *aeh)
+{
+	if (is_test_start_event(aeh)) {
+		struct test_start_event *st = cast_test_start_event(aeh);
+
+		if (st->test_id != TEST_EVENT_PRIO) {
+			return false;
+		}
+
+		recv_cnt = 0;
+
+		for (int i = 0; i < TEST_EVENT_PRIO_CNT; i++) {
+			struct prio_low_event *le = new_prio_low_event();
+			struct prio_normal_event *ne = new_prio_normal_event();
+			struct prio_high_event *he = new_prio_high_event();
+
+			zassert_not_null(le, "Failed to allocate event");
+			zassert_not_null(ne, "Failed to allocate event");
+			zassert_not_null(he, "Failed to allocate event");
+
+			le->val = i;
+			ne->val = i;
+			he->val = i;
+
+			APP_EVENT_SUBMIT(le);
+			APP_EVENT_SUBMIT(ne);
+			APP_EVENT_SUBMIT(he);
+		}
+
+		return false;
+	}
+
+	if (is_prio_low_event(aeh)) {
+		check_event(APP_EVENT_PRIO_LOW, cast_prio_low_event(aeh)->val);
+		return false;
+	}
+
+	if (is_prio_normal_event(aeh)) {
+		check_event(APP_EVENT_PRIO_NORMAL, cast_prio_normal_event(aeh)->val);
+		return false;
+	}
+
+	if (is_prio_high_event(aeh)) {
+		check_event(APP_EVENT_PRIO_HIGH, cast_prio_high_event(aeh)->val);
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+
+	return false;
+}
+
+APP_EVENT_LISTENER(MODULE, app_event_handler);
+APP_EVENT_SUBSCRIBE(MODULE, test_start_event);
+APP_EVENT_SUBSCRIBE(MODULE, prio_low_event);
+APP_EVENT_SUBSCRIBE(MODULE, prio_normal_event);
+APP_EVENT_SUBSCRIBE(MODULE, prio_high_event);
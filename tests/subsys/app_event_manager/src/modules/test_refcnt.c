@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <test_events.h>
+#include <refcnt_event.h>
+
+#include "test_config.h"
+#include "test_event_allocator.h"
+
+#define MODULE test_refcnt
+
+/* Both listeners keep a reference to the same event. */
+static const struct refcnt_event *held_events[2];
+
+static void hold_event(size_t idx, const struct app_event_header *aeh)
+{
+	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_REFCNT)) {
+		return;
+	}
+
+	app_event_manager_event_ref(aeh);
+	held_events[idx] = cast_refcnt_event(aeh);
+}
+
+static bool app_event_handler_producer(const struct app_event_header *aeh)
+{
+	if (is_test_start_event(aeh)) {
+		struct test_start_event *st = cast_test_start_event(aeh);
+
+		if (st->test_id != TEST_EVENT_REFCNT) {
+			return false;
+		}
+
+		struct refcnt_event *event = new_refcnt_event(TEST_EVENT_REFCNT_DATA_SIZE);
+
+		zassert_not_null(event, "Failed to allocate event");
+
+		for (size_t i = 0; i < event->dyndata.size; i++) {
+			event->dyndata.data[i] = i;
+		}
+
+		test_event_allocator_watch(event);
+		APP_EVENT_SUBMIT(event);
+
+		return false;
+	}
+
+	if (is_refcnt_event(aeh)) {
+		hold_event(0, aeh);
+
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+
+	return false;
+}
+
+APP_EVENT_LISTENER(test_refcnt_producer, app_event_handler_producer);
+APP_EVENT_SUBSCRIBE(test_refcnt_producer, test_start_event);
+APP_EVENT_SUBSCRIBE(test_refcnt_producer, refcnt_event);
+
+static bool app_event_handler_consumer(const struct app_event_header *aeh)
+{
+	if (is_refcnt_event(aeh)) {
+		hold_event(1, aeh);
+
+		struct test_end_event *te = new_test_end_event();
+
+		zassert_not_null(te, "Failed to allocate event");
+		te->test_id = TEST_EVENT_REFCNT;
+		APP_EVENT_SUBMIT(te);
+
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+
+	return false;
+}
+
+APP_EVENT_LISTENER(test_refcnt_consumer, app_event_handler_consumer);
+APP_EVENT_SUBSCRIBE(test_refcnt_consumer, refcnt_event);
+
+void test_refcnt_release(void)
+{
+	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_REFCNT)) {
+		return;
+	}
+
+	zassert_not_null(held_events[0], "Event reference not taken");
+	zassert_equal_ptr(held_events[0], held_events[1], "Event was copied");
+	zassert_false(test_event_allocator_is_freed(), "Referenced event was freed");
+
+	for (size_t i = 0; i < held_events[0]->dyndata.size; i++) {
+		zassert_equal(held_events[0]->dyndata.data[i], i, "Event data corrupted");
+	}
+
+	app_event_manager_event_unref(&held_events[0]->header);
+	zassert_false(test_event_allocator_is_freed(), "Event freed with reference held");
+
+	app_event_manager_event_unref(&held_events[1]->header);
+	zassert_true(test_event_allocator_is_freed(), "Event not freed");
+
+	held_events[0] = NULL;
+	held_events[1] = NULL;
+}
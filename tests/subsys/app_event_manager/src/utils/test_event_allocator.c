@@ -5,7 +5,9 @@
  */
 
 #include "test_oom.h"
+#include "test_event_allocator.h"
 #include <zephyr.h>
+#include <app_event_manager.h>
 
 void *app_event_manager_alloc(size_t size)
 {
@@ -18,7 +20,30 @@ void *app_event_manager_alloc(size_t size)
 	return event;
 }
 
+static const void *watched_addr;
+static bool watched_addr_freed;
+
+void test_event_allocator_watch(const void *addr)
+{
+	watched_addr = addr;
+	watched_addr_freed = false;
+}
+
+bool test_event_allocator_is_freed(void)
+{
+	return watched_addr_freed;
+}
+
 void app_event_manager_free(void *addr)
 {
+	if (addr == watched_addr) {
+		watched_addr_freed = true;
+	}
+
+	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_SLAB) &&
+	    app_event_manager_slab_free(addr)) {
+		return;
+	}
+
 	k_free(addr);
 }
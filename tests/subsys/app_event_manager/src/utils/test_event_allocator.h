@@ -0,0 +1,13 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdbool.h>
+
+/* Watch if the memory under given address is freed. */
+void test_event_allocator_watch(const void *addr);
+
+/* Check if the watched memory was freed. */
+bool test_event_allocator_is_freed(void);
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <string.h>
+#include <bluetooth/conn.h>
+#include <bluetooth/gatt.h>
+#include <bluetooth/uuid.h>
+#include <settings/settings.h>
+#include <kernel.h>
+#include <ztest.h>
+#include <sys/util.h>
+
+#include "gatt_cache_mock.h"
+
+/* Number of entries the settings storage can hold */
+#define SETTINGS_MOCK_ENTRY_CNT 16
+
+/* Settings storage in RAM, used as the custom settings backend */
+static struct settings_mock_entry settings_mock_entries[SETTINGS_MOCK_ENTRY_CNT];
+static size_t settings_mock_saves;
+
+/* Settings of the cache mock */
+static struct bt_gatt_cache_mock {
+	bool bonded;
+	uint8_t hash[16];
+	struct bt_conn *conn;
+	struct bt_gatt_read_params *params;
+	struct k_work_delayable work;
+} cache_mock_data;
+
+static const bt_addr_le_t peer_addr = {
+	.type = BT_ADDR_LE_RANDOM,
+	.a.val = { 0x01, 0x02, 0x03, 0x04, 0x05, 0xc6 },
+};
+
+static struct settings_mock_entry *settings_mock_entry_get(const char *name)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(settings_mock_entries); i++) {
+		if (settings_mock_entries[i].len &&
+		    !strcmp(settings_mock_entries[i].name, name)) {
+			return &settings_mock_entries[i];
+		}
+	}
+
+	return NULL;
+}
+
+static ssize_t settings_mock_read(void *cb_arg, void *data, size_t len)
+{
+	struct settings_mock_entry *entry = cb_arg;
+
+	len = MIN(len, entry->len);
+	memcpy(data, entry->val, len);
+
+	return len;
+}
+
+static int settings_mock_load(struct settings_store *cs,
+			      const struct settings_load_arg *arg)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(settings_mock_entries); i++) {
+		struct settings_mock_entry *entry = &settings_mock_entries[i];
+
+		if (entry->len) {
+			(void)settings_call_set_handler(entry->name, entry->len,
+							settings_mock_read, entry,
+							arg);
+		}
+	}
+
+	return 0;
+}
+
+static int settings_mock_save(struct settings_store *cs, const char *name,
+			      const char *value, size_t val_len)
+{
+	struct settings_mock_entry *entry = settings_mock_entry_get(name);
+
+	/* Entries are deleted by saving an empty value */
+	if (!val_len) {
+		if (entry) {
+			entry->len = 0;
+		}
+
+		return 0;
+	}
+
+	for (size_t i = 0; !entry && (i < ARRAY_SIZE(settings_mock_entries)); i++) {
+		if (!settings_mock_entries[i].len) {
+			entry = &settings_mock_entries[i];
+		}
+	}
+
+	zassert_not_null(entry, "Settings storage is full");
+	zassert_true(val_len <= sizeof(entry->val), "Value too long: %u", val_len);
+	zassert_true(strlen(name) < sizeof(entry->name), "Name too long: %s", name);
+
+	strcpy(entry->name, name);
+	memcpy(entry->val, value, val_len);
+	entry->len = val_len;
+	settings_mock_saves++;
+
+	return 0;
+}
+
+static const struct settings_store_itf settings_mock_itf = {
+	.csi_load = settings_mock_load,
+	.csi_save = settings_mock_save,
+};
+
+static struct settings_store settings_mock_store = {
+	.cs_itf = &settings_mock_itf,
+};
+
+/* The custom settings backend */
+int settings_backend_init(void)
+{
+	settings_dst_register(&settings_mock_store);
+	settings_src_register(&settings_mock_store);
+
+	return 0;
+}
+
+struct settings_mock_entry *settings_mock_find(const char *prefix, const char *suffix)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(settings_mock_entries); i++) {
+		struct settings_mock_entry *entry = &settings_mock_entries[i];
+		size_t name_len = strlen(entry->name);
+		size_t suffix_len = strlen(suffix);
+
+		if (entry->len &&
+		    !strncmp(entry->name, prefix, strlen(prefix)) &&
+		    (name_len >= suffix_len) &&
+		    !strcmp(&entry->name[name_len - suffix_len], suffix)) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+size_t settings_mock_count(const char *prefix)
+{
+	size_t count = 0;
+
+	for (size_t i = 0; i < ARRAY_SIZE(settings_mock_entries); i++) {
+		if (settings_mock_entries[i].len &&
+		    !strncmp(settings_mock_entries[i].name, prefix, strlen(prefix))) {
+			count++;
+		}
+	}
+
+	return count;
+}
+
+size_t settings_mock_save_count(void)
+{
+	return settings_mock_saves;
+}
+
+static void bt_gatt_read_work(struct k_work *work)
+{
+	printk("Running simulated Database Hash read\n");
+
+	(void)cache_mock_data.params->func(cache_mock_data.conn, 0,
+					   cache_mock_data.params,
+					   cache_mock_data.hash,
+					   sizeof(cache_mock_data.hash));
+}
+
+void bt_gatt_cache_mock_setup(bool bonded, const uint8_t *hash)
+{
+	memset(settings_mock_entries, 0, sizeof(settings_mock_entries));
+	settings_mock_saves = 0;
+
+	k_work_init_delayable(&cache_mock_data.work, bt_gatt_read_work);
+	cache_mock_data.bonded = bonded;
+	bt_gatt_cache_mock_hash_set(hash);
+}
+
+void bt_gatt_cache_mock_hash_set(const uint8_t *hash)
+{
+	memcpy(cache_mock_data.hash, hash, sizeof(cache_mock_data.hash));
+}
+
+const bt_addr_le_t *bt_gatt_cache_mock_peer(void)
+{
+	return &peer_addr;
+}
+
+/* Mocked version of the bt_conn_get_info */
+int bt_conn_get_info(const struct bt_conn *conn, struct bt_conn_info *info)
+{
+	memset(info, 0, sizeof(*info));
+	info->type = BT_CONN_TYPE_LE;
+	info->id = BT_ID_DEFAULT;
+	info->le.dst = &peer_addr;
+
+	return 0;
+}
+
+/* Mocked version of the bt_addr_le_is_bonded */
+bool bt_addr_le_is_bonded(uint8_t id, const bt_addr_le_t *addr)
+{
+	return cache_mock_data.bonded && !bt_addr_le_cmp(addr, &peer_addr);
+}
+
+/* Mocked version of the bt_gatt_read, reading the Database Hash only */
+int bt_gatt_read(struct bt_conn *conn, struct bt_gatt_read_params *params)
+{
+	printk("Running %s mock\n", __func__);
+
+	zassert_equal(0, params->handle_count, "Not a read by UUID");
+	zassert_true(!bt_uuid_cmp(BT_UUID_GATT_DB_HASH, params->by_uuid.uuid),
+		     "Not a Database Hash read");
+
+	cache_mock_data.conn = conn;
+	cache_mock_data.params = params;
+
+	k_work_schedule(&cache_mock_data.work, K_MSEC(5));
+	return 0;
+}
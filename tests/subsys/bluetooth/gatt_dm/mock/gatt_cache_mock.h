@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef BT_GATT_CACHE_MOCK_H_
+#define BT_GATT_CACHE_MOCK_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <bluetooth/addr.h>
+
+/**
+ * @file
+ * @defgroup bt_gatt_cache_mock API
+ * @{
+ * @brief The API used to setup the mocks for the discovery cache
+ *
+ * The mocks replace the settings storage with one in RAM, and the bonding
+ * information and the Database Hash of the peer.
+ */
+
+/** @brief Settings entry stored by the mock */
+struct settings_mock_entry {
+	/** Name of the entry */
+	char name[64];
+	/** Value of the entry */
+	uint8_t val[1024];
+	/** Length of the value, 0 if the entry is not used */
+	size_t len;
+};
+
+/**
+ * @brief Cache mock setup
+ *
+ * Clears the settings storage and sets the peer state.
+ *
+ * @param bonded Whether the peer is bonded.
+ * @param hash   Database Hash of the peer, 16 bytes.
+ */
+void bt_gatt_cache_mock_setup(bool bonded, const uint8_t *hash);
+
+/**
+ * @brief Change the Database Hash of the peer.
+ *
+ * @param hash Database Hash of the peer, 16 bytes.
+ */
+void bt_gatt_cache_mock_hash_set(const uint8_t *hash);
+
+/** @brief Get the address of the peer. */
+const bt_addr_le_t *bt_gatt_cache_mock_peer(void);
+
+/**
+ * @brief Find a stored settings entry.
+ *
+ * @param prefix Prefix of the entry name.
+ * @param suffix Suffix of the entry name.
+ *
+ * @return The first entry with the prefix and the suffix, or NULL.
+ */
+struct settings_mock_entry *settings_mock_find(const char *prefix, const char *suffix);
+
+/**
+ * @brief Count the stored settings entries.
+ *
+ * @param prefix Prefix of the entry names.
+ */
+size_t settings_mock_count(const char *prefix);
+
+/** @brief Get the number of values written to the settings storage. */
+size_t settings_mock_save_count(void);
+
+/** @} */
+#endif /* BT_GATT_CACHE_MOCK_H_ */
@@ -12,22 +12,41 @@
 #include <sys/util.h>
 
 
+/* Number of discoveries the mock can run at the same time */
+#define DISCOVER_MOCK_REQ_CNT 2
+
+/* Single discovery run by the mock */
+struct bt_discover_mock_req {
+	struct bt_conn *conn;
+	struct bt_gatt_discover_params *params;
+	struct k_work_delayable work;
+};
+
 /* Settings of the discover mock */
 static struct bt_discover_mock {
 	const struct bt_gatt_attr *attr;
 	size_t len;
-	struct bt_conn *conn;
-	struct bt_gatt_discover_params *params;
-	struct k_work_delayable work;
+	struct bt_discover_mock_req req[DISCOVER_MOCK_REQ_CNT];
+	size_t cnt;
 } discover_mock_data;
 
 static void bt_gatt_discover_work(struct k_work *work);
 
 void bt_gatt_discover_mock_setup(const struct bt_gatt_attr *attr, size_t len)
 {
-	k_work_init_delayable(&discover_mock_data.work, bt_gatt_discover_work);
+	for (size_t i = 0; i < ARRAY_SIZE(discover_mock_data.req); i++) {
+		k_work_init_delayable(&discover_mock_data.req[i].work,
+				      bt_gatt_discover_work);
+		discover_mock_data.req[i].params = NULL;
+	}
 	discover_mock_data.attr = attr;
 	discover_mock_data.len  = len;
+	discover_mock_data.cnt  = 0;
+}
+
+size_t bt_gatt_discover_mock_cnt(void)
+{
+	return discover_mock_data.cnt;
 }
 
 static bool bt_gatt_primary_check(const struct bt_gatt_attr *attr_cur,
@@ -46,8 +65,8 @@ static bool bt_gatt_primary_check(const struct bt_gatt_attr *attr_cur,
 static void bt_gatt_discover_work(struct k_work *work)
 {
 	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
-	struct bt_discover_mock *mock_data =
-		CONTAINER_OF(dwork, struct bt_discover_mock, work);
+	struct bt_discover_mock_req *mock_data =
+		CONTAINER_OF(dwork, struct bt_discover_mock_req, work);
 	const struct bt_gatt_attr *const attr_end =
 		discover_mock_data.attr + discover_mock_data.len;
 	const struct bt_gatt_attr *attr_cur;
@@ -125,10 +144,26 @@ static void bt_gatt_discover_work(struct k_work *work)
 int bt_gatt_discover(struct bt_conn *conn,
 		     struct bt_gatt_discover_params *params)
 {
+	struct bt_discover_mock_req *req = NULL;
+
 	printk("Running %s mock\n", __func__);
-	discover_mock_data.conn = conn;
-	discover_mock_data.params = params;
 
-	k_work_schedule(&discover_mock_data.work, K_MSEC(5));
+	/* Each discovery instance reuses its parameters */
+	for (size_t i = 0; i < ARRAY_SIZE(discover_mock_data.req); i++) {
+		if (discover_mock_data.req[i].params == params) {
+			req = &discover_mock_data.req[i];
+			break;
+		}
+		if (!req && !discover_mock_data.req[i].params) {
+			req = &discover_mock_data.req[i];
+		}
+	}
+	zassert_not_null(req, "Too many simultaneous discoveries");
+
+	req->conn = conn;
+	req->params = params;
+	discover_mock_data.cnt++;
+
+	k_work_schedule(&req->work, K_MSEC(5));
 	return 0;
 }
@@ -90,5 +90,10 @@
  */
 void bt_gatt_discover_mock_setup(const struct bt_gatt_attr *attr, size_t len);
 
+/**
+ * @brief Get the number of @ref bt_gatt_discover calls since the setup.
+ */
+size_t bt_gatt_discover_mock_cnt(void);
+
 /** @} */
 #endif /* #define BT_GATT_DISCOVERY_MOCK_H_ */
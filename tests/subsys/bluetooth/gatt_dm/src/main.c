@@ -10,6 +10,10 @@
 #include <bluetooth/uuid.h>
 #include <bluetooth/gatt_dm.h>
 #include "../mock/gatt_discover_mock.h"
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+#include <settings/settings.h>
+#include "../mock/gatt_cache_mock.h"
+#endif
 
 /* Timeout for the discovery in ms */
 #define SERVICE_DISCOVERY_TIMEOUT 2000
@@ -18,7 +22,8 @@
 #define BT_UUID_EMPTY_CHR BT_UUID_DECLARE_16(0x1235)
 
 static char dummy_conn;
-K_SEM_DEFINE(discovery_finished, 0, 1);
+static char dummy_conn_2;
+K_SEM_DEFINE(discovery_finished, 0, 2);
 
 
 const struct bt_gatt_attr discover_sim[] = {
@@ -467,7 +472,305 @@ void test_gatt_many_serv_by_uuid(void)
 		      bt_gatt_dm_attr_cnt(dm),
 		      "Unexpected number of attributes detected: %d",
 		      bt_gatt_dm_attr_cnt(dm));
+
+	bt_gatt_dm_data_release(dm);
+}
+
+/* Discoveries on different connections run at the same time */
+void test_gatt_concurrent(void)
+{
+	struct bt_gatt_dm *dm_hids = NULL;
+	struct bt_gatt_dm *dm_dis = NULL;
+	int err;
+
+	err = bt_gatt_dm_start((struct bt_conn *)&dummy_conn, BT_UUID_HIDS,
+			       &test_hids_cb, &dm_hids);
+	zassert_equal(0, err, "bt_gatt_dm_start finished with error: %d", err);
+
+	err = bt_gatt_dm_start((struct bt_conn *)&dummy_conn, BT_UUID_DIS,
+			       &test_hids_cb, &dm_dis);
+	zassert_equal(-EALREADY, err, "Second discovery on the same connection: %d", err);
+
+	err = bt_gatt_dm_start((struct bt_conn *)&dummy_conn_2, BT_UUID_DIS,
+			       &test_hids_cb, &dm_dis);
+	zassert_equal(0, err, "bt_gatt_dm_start finished with error: %d", err);
+
+	for (int i = 0; i < 2; i++) {
+		err = k_sem_take(&discovery_finished, K_MSEC(SERVICE_DISCOVERY_TIMEOUT));
+		zassert_equal(0, err, "It seems that no callback function was called: %d", err);
+	}
+
+	zassert_not_null(dm_hids, "Device Manager pointer not set");
+	zassert_not_null(dm_dis, "Device Manager pointer not set");
+	zassert_not_equal(dm_hids, dm_dis, "Discoveries share the instance");
+
+	zassert_equal_ptr(&dummy_conn, bt_gatt_dm_conn_get(dm_hids), "Invalid connection");
+	zassert_equal_ptr(&dummy_conn_2, bt_gatt_dm_conn_get(dm_dis), "Invalid connection");
+
+	zassert_equal(11, bt_gatt_dm_attr_cnt(dm_hids),
+		      "Unexpected number of attributes detected: %d",
+		      bt_gatt_dm_attr_cnt(dm_hids));
+	zassert_equal(5, bt_gatt_dm_attr_cnt(dm_dis),
+		      "Unexpected number of attributes detected: %d",
+		      bt_gatt_dm_attr_cnt(dm_dis));
+	zassert_true(!bt_uuid_cmp(BT_UUID_HIDS,
+				  bt_gatt_dm_attr_service_val(
+					bt_gatt_dm_service_get(dm_hids))->uuid),
+		     "Invalid service detected");
+	zassert_true(!bt_uuid_cmp(BT_UUID_DIS,
+				  bt_gatt_dm_attr_service_val(
+					bt_gatt_dm_service_get(dm_dis))->uuid),
+		     "Invalid service detected");
+
+	zassert_equal(0, bt_gatt_dm_data_release(dm_hids), "Release failed");
+	zassert_equal(0, bt_gatt_dm_data_release(dm_dis), "Release failed");
+}
+
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+/* Prefix of the settings keys of the cached discovery results */
+#define CACHE_KEY_PREFIX "bt/dm/"
+
+static const uint8_t db_hash[16] = {
+	0x6e, 0x2d, 0x1a, 0x3c, 0x88, 0x51, 0x04, 0x9f,
+	0xe2, 0x37, 0xb0, 0x45, 0x19, 0xca, 0x7d, 0x60,
+};
+
+static const uint8_t db_hash_changed[16] = {
+	0x6e, 0x2d, 0x1a, 0x3c, 0x88, 0x51, 0x04, 0x9f,
+	0xe2, 0x37, 0xb0, 0x45, 0x19, 0xca, 0x7d, 0x61,
+};
+
+void test_cache_setup(void)
+{
+	test_setup();
+	bt_gatt_cache_mock_setup(true, db_hash);
+}
+
+/* Runs the HIDS discovery and checks its result.
+ * Returns the number of GATT discovery procedures that were used.
+ */
+static size_t run_dm_hids(void)
+{
+	size_t discover_cnt = bt_gatt_discover_mock_cnt();
+	const struct bt_gatt_dm_attr *attr_chrc;
+	const struct bt_gatt_dm_attr *attr_desc;
+	const struct bt_gatt_service_val *serv_val;
+	struct bt_gatt_dm *dm;
+
+	dm = run_dm(BT_UUID_HIDS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+
+	serv_val = bt_gatt_dm_attr_service_val(bt_gatt_dm_service_get(dm));
+	zassert_not_null(serv_val, "Unexpected NULL instead of the service value");
+	zassert_true(!bt_uuid_cmp(BT_UUID_HIDS, serv_val->uuid), "Invalid service detected");
+	zassert_equal(11, serv_val->end_handle, "Unexpected end handle");
+	zassert_equal(11,
+		      bt_gatt_dm_attr_cnt(dm),
+		      "Unexpected number of attributes detected: %d",
+		      bt_gatt_dm_attr_cnt(dm));
+
+	attr_chrc = bt_gatt_dm_char_by_uuid(dm, BT_UUID_HIDS_REPORT);
+	zassert_not_null(attr_chrc, "Unexpected NULL");
+	zassert_equal(6, attr_chrc->handle, "Unexpected handle: %d", attr_chrc->handle);
+	zassert_equal(BT_GATT_CHRC_READ | BT_GATT_CHRC_NOTIFY,
+		      bt_gatt_dm_attr_chrc_val(attr_chrc)->properties,
+		      "Unexpected HIDS_REPORT properties");
+	attr_desc = bt_gatt_dm_desc_by_uuid(dm, attr_chrc, BT_UUID_GATT_CCC);
+	zassert_not_null(attr_desc, "Unexpected NULL");
+	zassert_equal(8, attr_desc->handle, "Unexpected handle: %d", attr_desc->handle);
+
+	zassert_equal(0, bt_gatt_dm_data_release(dm), "Release failed");
+
+	return bt_gatt_discover_mock_cnt() - discover_cnt;
+}
+
+static void run_dm_dis(void)
+{
+	struct bt_gatt_dm *dm = run_dm(BT_UUID_DIS);
+
+	zassert_not_null(dm, "Device Manager pointer not set");
+	zassert_equal(5,
+		      bt_gatt_dm_attr_cnt(dm),
+		      "Unexpected number of attributes detected: %d",
+		      bt_gatt_dm_attr_cnt(dm));
+	zassert_equal(0, bt_gatt_dm_data_release(dm), "Release failed");
+}
+
+/* Result of a bonded peer is loaded while the Database Hash is unchanged */
+void test_cache_hit(void)
+{
+	size_t save_cnt;
+
+	zassert_not_equal(0, run_dm_hids(), "Peer database not discovered");
+	zassert_equal(3, settings_mock_count(CACHE_KEY_PREFIX),
+		      "Discovery result not stored");
+
+	save_cnt = settings_mock_save_count();
+	zassert_equal(0, run_dm_hids(), "Stored discovery result not used");
+	zassert_equal(save_cnt, settings_mock_save_count(),
+		      "Loaded discovery result stored again");
+
+	/* Results of other services are stored separately */
+	run_dm_dis();
+	zassert_equal(6, settings_mock_count(CACHE_KEY_PREFIX),
+		      "Discovery result not stored");
+	zassert_equal(0, run_dm_hids(), "Stored discovery result not used");
+}
+
+/* Discovery by UUID continues after a result loaded from the cache */
+void test_cache_continue(void)
+{
+	const struct bt_gatt_service_val *serv_val;
+	struct bt_gatt_dm *dm;
+	struct bt_gatt_dm *dm_next;
+	size_t discover_cnt;
+	int err;
+
+	dm = run_dm(BT_UUID_HRS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	zassert_equal(0, bt_gatt_dm_data_release(dm), "Release failed");
+
+	discover_cnt = bt_gatt_discover_mock_cnt();
+	dm = run_dm(BT_UUID_HRS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	zassert_equal(discover_cnt, bt_gatt_discover_mock_cnt(),
+		      "Stored discovery result not used");
+	zassert_equal(20, bt_gatt_dm_service_get(dm)->handle, "Unexpected handle");
+
+	zassert_equal(0, bt_gatt_dm_data_release(dm), "Release failed");
+	err = bt_gatt_dm_continue(dm, &dm_next);
+	zassert_equal(0, err, "Return value %d is wrong", err);
+
+	err = k_sem_take(&discovery_finished, K_MSEC(SERVICE_DISCOVERY_TIMEOUT));
+	zassert_equal(0, err, "It seems that no callback function was called: %d", err);
+
+	/* The next instance of the service is discovered */
+	zassert_not_null(dm_next, "Next service not found");
+	serv_val = bt_gatt_dm_attr_service_val(bt_gatt_dm_service_get(dm_next));
+	zassert_not_null(serv_val, "Unexpected NULL instead of the service value");
+	zassert_true(!bt_uuid_cmp(BT_UUID_HRS, serv_val->uuid), "Invalid service detected");
+	zassert_equal(22, bt_gatt_dm_service_get(dm_next)->handle, "Unexpected handle");
+	zassert_equal(0, bt_gatt_dm_data_release(dm_next), "Release failed");
+}
+
+void test_cache_hash_mismatch(void)
+{
+	struct settings_mock_entry *hdr;
+
+	zassert_not_equal(0, run_dm_hids(), "Peer database not discovered");
+
+	bt_gatt_cache_mock_hash_set(db_hash_changed);
+	zassert_not_equal(0, run_dm_hids(), "Result of a changed database used");
+
+	/* The header of the stored result starts with the Database Hash */
+	hdr = settings_mock_find(CACHE_KEY_PREFIX, "/h");
+	zassert_not_null(hdr, "Discovery result not stored");
+	zassert_mem_equal(hdr->val, db_hash_changed, sizeof(db_hash_changed),
+			  "Database Hash of the stored result not updated");
+
+	zassert_equal(0, run_dm_hids(), "Stored discovery result not used");
+}
+
+void test_cache_corrupt(void)
+{
+	struct settings_mock_entry *entry;
+	struct bt_gatt_dm_attr *attrs;
+
+	zassert_not_equal(0, run_dm_hids(), "Peer database not discovered");
+
+	/* Truncated data */
+	entry = settings_mock_find(CACHE_KEY_PREFIX, "/d");
+	zassert_not_null(entry, "Discovery result not stored");
+	entry->len -= sizeof(uint32_t);
+	zassert_not_equal(0, run_dm_hids(), "Truncated result used");
+
+	/* Truncated header */
+	entry = settings_mock_find(CACHE_KEY_PREFIX, "/h");
+	zassert_not_null(entry, "Discovery result not stored");
+	entry->len--;
+	zassert_not_equal(0, run_dm_hids(), "Truncated result used");
+
+	/* Attributes out of the handle order */
+	entry = settings_mock_find(CACHE_KEY_PREFIX, "/a");
+	zassert_not_null(entry, "Discovery result not stored");
+	attrs = (struct bt_gatt_dm_attr *)entry->val;
+	attrs[2].handle = attrs[1].handle;
+	zassert_not_equal(0, run_dm_hids(), "Corrupt result used");
+
+	/* UUID outside of the stored data */
+	entry = settings_mock_find(CACHE_KEY_PREFIX, "/a");
+	zassert_not_null(entry, "Discovery result not stored");
+	attrs = (struct bt_gatt_dm_attr *)entry->val;
+	attrs[3].uuid = (struct bt_uuid *)(uintptr_t)CONFIG_BT_GATT_DM_DATA_SIZE;
+	zassert_not_equal(0, run_dm_hids(), "Corrupt result used");
+
+	/* Each discovery stored a valid result again */
+	zassert_equal(0, run_dm_hids(), "Stored discovery result not used");
+}
+
+void test_cache_not_bonded(void)
+{
+	bt_gatt_cache_mock_setup(false, db_hash);
+
+	zassert_not_equal(0, run_dm_hids(), "Peer database not discovered");
+	zassert_equal(0, settings_mock_count(CACHE_KEY_PREFIX),
+		      "Discovery result of a peer without bond stored");
+	zassert_not_equal(0, run_dm_hids(), "Peer database not discovered");
+}
+
+void test_cache_clear(void)
+{
+	bt_addr_le_t other_peer;
+	int err;
+
+	zassert_not_equal(0, run_dm_hids(), "Peer database not discovered");
+	run_dm_dis();
+	zassert_equal(6, settings_mock_count(CACHE_KEY_PREFIX),
+		      "Discovery result not stored");
+
+	/* Results of other peers are kept */
+	bt_addr_le_copy(&other_peer, bt_gatt_cache_mock_peer());
+	other_peer.a.val[0]++;
+	err = bt_gatt_dm_cache_clear(&other_peer);
+	zassert_equal(0, err, "Return value %d is wrong", err);
+	zassert_equal(6, settings_mock_count(CACHE_KEY_PREFIX), "Results cleared");
+
+	err = bt_gatt_dm_cache_clear(bt_gatt_cache_mock_peer());
+	zassert_equal(0, err, "Return value %d is wrong", err);
+	zassert_equal(0, settings_mock_count(CACHE_KEY_PREFIX), "Results not cleared");
+	zassert_not_equal(0, run_dm_hids(), "Cleared result used");
+
+	err = bt_gatt_dm_cache_clear(NULL);
+	zassert_equal(0, err, "Return value %d is wrong", err);
+	zassert_equal(0, settings_mock_count(CACHE_KEY_PREFIX), "Results not cleared");
+	zassert_not_equal(0, run_dm_hids(), "Cleared result used");
+}
+
+static void test_cache_run(void)
+{
+	int err;
+
+	err = settings_subsys_init();
+	zassert_equal(0, err, "Settings initialization failed: %d", err);
+
+	ztest_test_suite(
+		test_gatt_cache,
+		ztest_unit_test_setup_teardown(test_cache_hit, test_cache_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_cache_continue, test_cache_setup,
+					       unit_test_noop),
+		ztest_unit_test_setup_teardown(test_cache_hash_mismatch, test_cache_setup,
+					       unit_test_noop),
+		ztest_unit_test_setup_teardown(test_cache_corrupt, test_cache_setup,
+					       unit_test_noop),
+		ztest_unit_test_setup_teardown(test_cache_not_bonded, test_cache_setup,
+					       unit_test_noop),
+		ztest_unit_test_setup_teardown(test_cache_clear, test_cache_setup,
+					       unit_test_noop)
+	);
+
+	ztest_run_test_suite(test_gatt_cache);
 }
+#endif /* defined(CONFIG_BT_GATT_DM_CACHE) */
 
 void test_main(void)
 {
@@ -488,8 +791,13 @@ void test_main(void)
 					       unit_test_noop),
 		ztest_unit_test_setup_teardown(test_gatt_generic_serv, test_setup, unit_test_noop),
 		ztest_unit_test_setup_teardown(test_gatt_many_serv_by_uuid, test_setup,
-					       unit_test_noop)
+					       unit_test_noop),
+		ztest_unit_test_setup_teardown(test_gatt_concurrent, test_setup, unit_test_noop)
 	);
 
 	ztest_run_test_suite(test_gatt);
+
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+	test_cache_run();
+#endif
 }
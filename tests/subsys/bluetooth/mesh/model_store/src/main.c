@@ -0,0 +1,362 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdint.h>
+#include <ztest.h>
+#include <kernel.h>
+#include <bluetooth/mesh/models.h>
+#include <bluetooth/mesh/light_ctrl_srv.h>
+#include <bluetooth/mesh/scheduler_srv.h>
+#include <scheduler_internal.h>
+#include <model_utils.h>
+
+#define STORE_TIMEOUT K_SECONDS(CONFIG_BT_MESH_MODEL_SRV_STORE_TIMEOUT)
+#define STORE_HALF_TIMEOUT                                                     \
+	K_MSEC(CONFIG_BT_MESH_MODEL_SRV_STORE_TIMEOUT * MSEC_PER_SEC / 2)
+/* Margin for the system workqueue to run the pending writes */
+#define STORE_MARGIN K_MSEC(100)
+
+static struct bt_mesh_time_srv time_srv = BT_MESH_TIME_SRV_INIT(NULL);
+static struct bt_mesh_scheduler_srv scheduler_srv =
+	BT_MESH_SCHEDULER_SRV_INIT(NULL, &time_srv);
+
+static struct bt_mesh_model mock_lightness_model = { .elem_idx = 0 };
+static struct bt_mesh_lightness_srv lightness_srv = {
+	.lightness_model = &mock_lightness_model
+};
+static struct bt_mesh_light_ctrl_srv light_ctrl_srv =
+	BT_MESH_LIGHT_CTRL_SRV_INIT(&lightness_srv);
+
+static struct bt_mesh_model mock_sched_model = {
+	.user_data = &scheduler_srv,
+	.elem_idx = 1,
+};
+
+static struct bt_mesh_model mock_light_ctrl_model = {
+	.user_data = &light_ctrl_srv,
+	.elem_idx = 2,
+};
+
+static struct bt_mesh_model mock_light_ctrl_setup_model = {
+	.user_data = &light_ctrl_srv,
+	.elem_idx = 2,
+};
+
+static struct bt_mesh_elem dummy_elem;
+
+/* Writes to the persistent storage, per model */
+static struct {
+	uint32_t sched;
+	uint32_t light_ctrl;
+	uint32_t light_ctrl_setup;
+	int err;
+} writes;
+
+static struct bt_mesh_model_store_stats start_stats;
+
+/* redefined mocks */
+int bt_mesh_model_data_store(struct bt_mesh_model *mod, bool vnd,
+			     const char *name, const void *data,
+			     size_t data_len)
+{
+	if (mod == &mock_sched_model) {
+		writes.sched++;
+	} else if (mod == &mock_light_ctrl_model) {
+		writes.light_ctrl++;
+	} else if (mod == &mock_light_ctrl_setup_model) {
+		writes.light_ctrl_setup++;
+	} else {
+		zassert_unreachable("Write of an unknown model");
+	}
+
+	return writes.err;
+}
+
+int bt_mesh_model_send(struct bt_mesh_model *model,
+		       struct bt_mesh_msg_ctx *ctx,
+		       struct net_buf_simple *msg,
+		       const struct bt_mesh_send_cb *cb, void *cb_data)
+{
+	return 0;
+}
+
+int bt_mesh_model_publish(struct bt_mesh_model *model)
+{
+	return 0;
+}
+
+int model_send(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
+	       struct net_buf_simple *buf)
+{
+	return 0;
+}
+
+struct bt_mesh_elem *bt_mesh_model_elem(struct bt_mesh_model *mod)
+{
+	return &dummy_elem;
+}
+
+struct bt_mesh_elem *bt_mesh_elem_find(uint16_t addr)
+{
+	return NULL;
+}
+
+struct bt_mesh_model *bt_mesh_model_find(const struct bt_mesh_elem *elem,
+					 uint16_t id)
+{
+	return NULL;
+}
+
+void bt_mesh_model_msg_init(struct net_buf_simple *msg, uint32_t opcode)
+{
+	net_buf_simple_init(msg, 0);
+}
+
+int bt_mesh_model_extend(struct bt_mesh_model *mod,
+			 struct bt_mesh_model *base_mod)
+{
+	return 0;
+}
+
+int bt_mesh_scene_srv_set(struct bt_mesh_scene_srv *srv, uint16_t scene,
+			  struct bt_mesh_model_transition *transition)
+{
+	return 0;
+}
+
+int bt_mesh_scene_srv_pub(struct bt_mesh_scene_srv *srv,
+			  struct bt_mesh_msg_ctx *ctx)
+{
+	return 0;
+}
+
+int bt_mesh_onoff_srv_pub(struct bt_mesh_onoff_srv *srv,
+			  struct bt_mesh_msg_ctx *ctx,
+			  const struct bt_mesh_onoff_status *status)
+{
+	return 0;
+}
+
+void lightness_srv_change_lvl(struct bt_mesh_lightness_srv *srv,
+			      struct bt_mesh_msg_ctx *ctx,
+			      struct bt_mesh_lightness_set *set,
+			      struct bt_mesh_lightness_status *status,
+			      bool publish)
+{
+}
+
+int lightness_on_power_up(struct bt_mesh_lightness_srv *srv)
+{
+	return 0;
+}
+
+void bt_mesh_lightness_srv_set(struct bt_mesh_lightness_srv *srv,
+			       struct bt_mesh_msg_ctx *ctx,
+			       struct bt_mesh_lightness_set *set,
+			       struct bt_mesh_lightness_status *status)
+{
+}
+
+void bt_mesh_time_encode_time_params(struct net_buf_simple *buf,
+				     const struct bt_mesh_time_status *status)
+{
+}
+
+int _bt_mesh_time_srv_update_handler(struct bt_mesh_model *model)
+{
+	return 0;
+}
+
+int64_t bt_mesh_time_srv_mktime(struct bt_mesh_time_srv *srv, struct tm *timeptr)
+{
+	return 0;
+}
+
+struct tm *bt_mesh_time_srv_localtime(struct bt_mesh_time_srv *srv,
+				      int64_t uptime)
+{
+	static struct tm timeptr;
+
+	return &timeptr;
+}
+/* redefined mocks */
+
+static void setup(void)
+{
+	/* Start from a clean slate, without any pending writes */
+	bt_mesh_model_store_flush();
+	memset(&writes, 0, sizeof(writes));
+	bt_mesh_model_store_stats_get(&start_stats);
+}
+
+static void stats_check(uint32_t marked, uint32_t written, uint32_t failed)
+{
+	struct bt_mesh_model_store_stats stats;
+
+	bt_mesh_model_store_stats_get(&stats);
+
+	zassert_equal(stats.marked - start_stats.marked, marked,
+		      "Invalid number of changes: %u",
+		      stats.marked - start_stats.marked);
+	zassert_equal(stats.writes - start_stats.writes, written,
+		      "Invalid number of writes: %u",
+		      stats.writes - start_stats.writes);
+	zassert_equal(stats.failed - start_stats.failed, failed,
+		      "Invalid number of failed writes: %u",
+		      stats.failed - start_stats.failed);
+}
+
+static void writes_check(uint32_t sched, uint32_t light_ctrl,
+			 uint32_t light_ctrl_setup)
+{
+	zassert_equal(writes.sched, sched, "Invalid Scheduler writes: %u",
+		      writes.sched);
+	zassert_equal(writes.light_ctrl, light_ctrl,
+		      "Invalid Light LC writes: %u", writes.light_ctrl);
+	zassert_equal(writes.light_ctrl_setup, light_ctrl_setup,
+		      "Invalid Light LC Setup writes: %u",
+		      writes.light_ctrl_setup);
+}
+
+static void action_put(uint8_t idx)
+{
+	/* Scene 0 is never scheduled, so the entry is only stored */
+	struct bt_mesh_schedule_entry entry = {
+		.action = BT_MESH_SCHEDULER_SCENE_RECALL,
+	};
+	BT_MESH_MODEL_BUF_DEFINE(buf, BT_MESH_SCHEDULER_OP_ACTION_SET_UNACK,
+			BT_MESH_SCHEDULER_MSG_LEN_ACTION_SET);
+
+	net_buf_simple_init(&buf, 0);
+	scheduler_action_pack(&buf, idx, &entry);
+
+	zassert_ok(_bt_mesh_scheduler_setup_srv_op[1].func(&mock_sched_model,
+							   NULL, &buf),
+		   "Cannot set the action");
+}
+
+/* Change the Light LC state, which is stored for every change */
+static void light_ctrl_toggle(void)
+{
+	if (lightness_srv.ctrl == &light_ctrl_srv) {
+		zassert_ok(bt_mesh_light_ctrl_srv_disable(&light_ctrl_srv),
+			   "Disable failed");
+	} else {
+		zassert_ok(bt_mesh_light_ctrl_srv_enable(&light_ctrl_srv),
+			   "Enable failed");
+	}
+}
+
+static void test_coalesce(void)
+{
+	setup();
+
+	for (int i = 0; i < 3; i++) {
+		action_put(0);
+		light_ctrl_toggle();
+	}
+
+	/* Nothing is written until the timeout */
+	k_sleep(STORE_HALF_TIMEOUT);
+	writes_check(0, 0, 0);
+	stats_check(6, 0, 0);
+
+	/* The changes are written together, once per model */
+	k_sleep(STORE_TIMEOUT);
+	writes_check(1, 1, 0);
+	stats_check(6, 2, 0);
+
+	/* Changes during the timeout don't delay the first one */
+	action_put(1);
+	k_sleep(STORE_HALF_TIMEOUT);
+	light_ctrl_toggle();
+	k_sleep(STORE_HALF_TIMEOUT);
+	k_sleep(STORE_MARGIN);
+	writes_check(2, 2, 0);
+	stats_check(8, 4, 0);
+}
+
+static void test_flush(void)
+{
+	setup();
+
+	action_put(2);
+	action_put(3);
+	light_ctrl_toggle();
+
+	/* Every changed Scheduler entry is written separately */
+	bt_mesh_model_store_flush();
+	writes_check(2, 1, 0);
+	stats_check(3, 3, 0);
+
+	/* The flush cancels the timeout */
+	k_sleep(STORE_TIMEOUT);
+	k_sleep(STORE_MARGIN);
+	writes_check(2, 1, 0);
+	stats_check(3, 3, 0);
+
+	/* Nothing is pending */
+	bt_mesh_model_store_flush();
+	writes_check(2, 1, 0);
+}
+
+static void test_reset(void)
+{
+	setup();
+
+	action_put(4);
+	light_ctrl_toggle();
+
+	/* The entries and the Light LC state are deleted right away, and the
+	 * pending writes are cancelled.
+	 */
+	_bt_mesh_scheduler_srv_cb.reset(&mock_sched_model);
+	writes_check(BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT, 0, 0);
+
+	_bt_mesh_light_ctrl_srv_cb.reset(&mock_light_ctrl_model);
+	writes_check(BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT, 1, 1);
+
+	k_sleep(STORE_TIMEOUT);
+	k_sleep(STORE_MARGIN);
+	bt_mesh_model_store_flush();
+	writes_check(BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT, 1, 1);
+	stats_check(2, BT_MESH_SCHEDULER_ACTION_ENTRY_COUNT + 2, 0);
+}
+
+static void test_failed(void)
+{
+	setup();
+
+	writes.err = -EIO;
+	action_put(5);
+	light_ctrl_toggle();
+	bt_mesh_model_store_flush();
+	writes.err = 0;
+
+	writes_check(1, 1, 0);
+	stats_check(2, 2, 2);
+}
+
+void test_main(void)
+{
+	zassert_ok(_bt_mesh_scheduler_srv_cb.init(&mock_sched_model),
+		   "Scheduler init failed");
+	zassert_ok(_bt_mesh_light_ctrl_srv_cb.init(&mock_light_ctrl_model),
+		   "Light LC init failed");
+	zassert_ok(_bt_mesh_light_ctrl_setup_srv_cb.init(&mock_light_ctrl_setup_model),
+		   "Light LC Setup init failed");
+	zassert_ok(_bt_mesh_light_ctrl_srv_cb.start(&mock_light_ctrl_model),
+		   "Light LC start failed");
+
+	ztest_test_suite(model_store_test,
+			 ztest_unit_test(test_coalesce),
+			 ztest_unit_test(test_flush),
+			 ztest_unit_test(test_reset),
+			 ztest_unit_test(test_failed)
+			 );
+
+	ztest_run_test_suite(model_store_test);
+}
@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <bluetooth/mesh/sensor_cli.h>
+#include <bluetooth/mesh/sensor_types.h>
+#include <sensor.h> // private header from the source folder
+
+#define BATCH_SIZE 2
+#define SRV_ADDR 0x0002
+/* Not a defined sensor property */
+#define UNKNOWN_ID 0x07ff
+
+static const struct {
+	const struct bt_mesh_sensor_type *type;
+	struct sensor_value value;
+} test_sensors[] = {
+	{ &bt_mesh_sensor_present_amb_temp, { .val1 = 21 } },
+	{ &bt_mesh_sensor_people_count, { .val1 = 7 } },
+	{ &bt_mesh_sensor_motion_sensed, { .val1 = 50 } },
+	{ &bt_mesh_sensor_time_since_motion_sensed, { .val1 = 120 } },
+	{ &bt_mesh_sensor_present_indoor_amb_temp, { .val1 = 19 } },
+};
+
+static struct {
+	uint32_t data_cnt;
+	uint32_t batch_cnt;
+	uint32_t batched;
+	uint32_t batch_sizes[ARRAY_SIZE(test_sensors)];
+} rx;
+
+static struct bt_mesh_msg_ctx test_ctx = { .addr = SRV_ADDR };
+
+/* Sensor Status message the server responds with */
+NET_BUF_SIMPLE_DEFINE_STATIC(status_buf, BT_MESH_TX_SDU_MAX);
+
+static void sensor_check(const struct bt_mesh_sensor_type *type,
+			 const struct sensor_value *value, uint32_t i)
+{
+	zassert_equal_ptr(type, test_sensors[i].type, "Invalid type of sensor %u", i);
+	zassert_equal(value[0].val1, test_sensors[i].value.val1,
+		      "Invalid value of sensor %u: %d", i, value[0].val1);
+	zassert_equal(value[0].val2, 0, "Invalid fraction of sensor %u: %d", i,
+		      value[0].val2);
+}
+
+static void data_cb(struct bt_mesh_sensor_cli *cli, struct bt_mesh_msg_ctx *ctx,
+		    const struct bt_mesh_sensor_type *sensor,
+		    const struct sensor_value *value)
+{
+	zassert_true(rx.data_cnt < ARRAY_SIZE(test_sensors), "Too many sensors");
+
+	sensor_check(sensor, value, rx.data_cnt++);
+}
+
+static void data_batch_cb(struct bt_mesh_sensor_cli *cli, struct bt_mesh_msg_ctx *ctx,
+			  const struct bt_mesh_sensor_data *sensors, uint32_t count)
+{
+	zassert_equal_ptr(sensors, cli->batch, "Not decoded into the batch buffer");
+	zassert_true(count > 0, "Empty batch");
+	zassert_true(count <= cli->batch_size, "Batch overflow: %u", count);
+	zassert_true(rx.batched + count <= ARRAY_SIZE(test_sensors), "Too many sensors");
+
+	for (uint32_t i = 0; i < count; i++) {
+		sensor_check(sensors[i].type, sensors[i].value, rx.batched++);
+	}
+
+	rx.batch_sizes[rx.batch_cnt++] = count;
+}
+
+static const struct bt_mesh_sensor_cli_handlers handlers = {
+	.data = data_cb,
+	.data_batch = data_batch_cb,
+};
+
+static struct bt_mesh_sensor_data batch[BATCH_SIZE];
+static struct bt_mesh_sensor_cli batch_cli =
+	BT_MESH_SENSOR_CLI_BATCH_INIT(&handlers, batch, BATCH_SIZE);
+static struct bt_mesh_sensor_cli plain_cli = BT_MESH_SENSOR_CLI_INIT(&handlers);
+
+static struct bt_mesh_model batch_model = { .user_data = &batch_cli };
+static struct bt_mesh_model plain_model = { .user_data = &plain_cli };
+
+static void status_rx(struct bt_mesh_model *model)
+{
+	const struct bt_mesh_model_op *op;
+	struct net_buf_simple buf;
+
+	net_buf_simple_init_with_data(&buf, status_buf.data, status_buf.len);
+
+	for (op = _bt_mesh_sensor_cli_op; op->func; op++) {
+		if (op->opcode == BT_MESH_SENSOR_OP_STATUS) {
+			zassert_ok(op->func(model, &test_ctx, &buf), "Handler failed");
+			return;
+		}
+	}
+
+	zassert_unreachable("No Sensor Status handler");
+}
+
+/****************** mock section **********************************/
+
+int model_send(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
+	       struct net_buf_simple *buf)
+{
+	return 0;
+}
+
+int model_ackd_send(struct bt_mesh_model *model, struct bt_mesh_msg_ctx *ctx,
+		    struct net_buf_simple *buf, struct bt_mesh_msg_ack_ctx *ack,
+		    uint32_t rsp_op, void *user_data)
+{
+	zassert_not_null(ack, "No response expected");
+	zassert_equal(rsp_op, BT_MESH_SENSOR_OP_STATUS, "Invalid response opcode");
+	zassert_ok(bt_mesh_msg_ack_ctx_prepare(ack, rsp_op, ctx->addr, user_data),
+		   "Response already pending");
+
+	/* The server responds right away */
+	status_rx(model);
+
+	return bt_mesh_msg_ack_ctx_wait(ack, K_NO_WAIT);
+}
+
+/****************** mock section **********************************/
+
+static void status_encode(uint32_t count)
+{
+	net_buf_simple_reset(&status_buf);
+
+	for (uint32_t i = 0; i < count; i++) {
+		struct bt_mesh_sensor sensor = { .type = test_sensors[i].type };
+
+		zassert_ok(sensor_status_encode(&status_buf, &sensor, &test_sensors[i].value),
+			   "Encoding sensor %u failed", i);
+	}
+}
+
+static void setup(void)
+{
+	memset(&rx, 0, sizeof(rx));
+	memset(batch, 0, sizeof(batch));
+}
+
+static void test_batch_split(void)
+{
+	for (uint32_t count = 1; count <= ARRAY_SIZE(test_sensors); count++) {
+		uint32_t batches = DIV_ROUND_UP(count, BATCH_SIZE);
+
+		setup();
+		status_encode(count);
+		status_rx(&batch_model);
+
+		zassert_equal(rx.data_cnt, count, "Invalid number of data callbacks: %u",
+			      rx.data_cnt);
+		zassert_equal(rx.batched, count, "Invalid number of batched sensors: %u",
+			      rx.batched);
+		/* A full buffer is flushed right away, the rest at the end of
+		 * the message, and a message that fills the last batch exactly
+		 * does not cause an empty flush.
+		 */
+		zassert_equal(rx.batch_cnt, batches, "Invalid number of batches: %u",
+			      rx.batch_cnt);
+		for (uint32_t i = 0; i < batches - 1; i++) {
+			zassert_equal(rx.batch_sizes[i], BATCH_SIZE, "Invalid size of batch %u",
+				      i);
+		}
+
+		zassert_equal(rx.batch_sizes[batches - 1],
+			      count - (batches - 1) * BATCH_SIZE, "Invalid size of last batch");
+	}
+}
+
+static void test_batch_skipped(void)
+{
+	struct bt_mesh_sensor sensor;
+
+	setup();
+	net_buf_simple_reset(&status_buf);
+
+	/* Sensors without data and sensors of unknown types are left out of
+	 * the batches.
+	 */
+	sensor.type = test_sensors[0].type;
+	zassert_ok(sensor_status_encode(&status_buf, &sensor, &test_sensors[0].value),
+		   "Encoding failed");
+	zassert_ok(sensor_status_id_encode(&status_buf, 0, test_sensors[3].type->id),
+		   "Encoding failed");
+	zassert_ok(sensor_status_id_encode(&status_buf, 2, UNKNOWN_ID), "Encoding failed");
+	net_buf_simple_add_le16(&status_buf, 0);
+	sensor.type = test_sensors[1].type;
+	zassert_ok(sensor_status_encode(&status_buf, &sensor, &test_sensors[1].value),
+		   "Encoding failed");
+
+	status_rx(&batch_model);
+
+	zassert_equal(rx.data_cnt, 2, "Invalid number of data callbacks: %u", rx.data_cnt);
+	zassert_equal(rx.batch_cnt, 1, "Invalid number of batches: %u", rx.batch_cnt);
+	zassert_equal(rx.batch_sizes[0], 2, "Invalid size of batch: %u", rx.batch_sizes[0]);
+}
+
+static void test_batch_disabled(void)
+{
+	setup();
+	status_encode(ARRAY_SIZE(test_sensors));
+	status_rx(&plain_model);
+
+	zassert_equal(rx.data_cnt, ARRAY_SIZE(test_sensors),
+		      "Invalid number of data callbacks: %u", rx.data_cnt);
+	zassert_equal(rx.batch_cnt, 0, "Batch callback without a batch buffer");
+}
+
+static void test_all_get_count(void)
+{
+	struct bt_mesh_sensor_data sensors[3];
+	uint32_t count = 2;
+	int err;
+
+	setup();
+	status_encode(ARRAY_SIZE(test_sensors));
+
+	/* The entry after the requested count must not be written */
+	sensors[2].type = NULL;
+	sensors[2].value[0].val1 = -1;
+
+	err = bt_mesh_sensor_cli_all_get(&plain_cli, &test_ctx, sensors, &count);
+	zassert_ok(err, "Get failed: %d", err);
+	zassert_equal(count, 2, "Invalid count: %u", count);
+
+	for (uint32_t i = 0; i < count; i++) {
+		sensor_check(sensors[i].type, sensors[i].value, i);
+	}
+
+	zassert_is_null(sensors[2].type, "Wrote past the response buffer");
+	zassert_equal(sensors[2].value[0].val1, -1, "Wrote past the response buffer");
+
+	/* The data callback still gets every sensor in the message */
+	zassert_equal(rx.data_cnt, ARRAY_SIZE(test_sensors),
+		      "Invalid number of data callbacks: %u", rx.data_cnt);
+
+	/* A large enough buffer gets all the sensors */
+	setup();
+	count = ARRAY_SIZE(sensors);
+	err = bt_mesh_sensor_cli_all_get(&plain_cli, &test_ctx, sensors, &count);
+	zassert_ok(err, "Get failed: %d", err);
+	zassert_equal(count, ARRAY_SIZE(sensors), "Invalid count: %u", count);
+	sensor_check(sensors[2].type, sensors[2].value, 2);
+}
+
+void test_main(void)
+{
+	zassert_ok(_bt_mesh_sensor_cli_cb.init(&batch_model), "Init failed");
+	zassert_ok(_bt_mesh_sensor_cli_cb.init(&plain_model), "Init failed");
+
+	ztest_test_suite(sensor_cli_test,
+			 ztest_unit_test(test_batch_split),
+			 ztest_unit_test(test_batch_skipped),
+			 ztest_unit_test(test_batch_disabled),
+			 ztest_unit_test(test_all_get_count)
+			 );
+
+	ztest_run_test_suite(sensor_cli_test);
+}
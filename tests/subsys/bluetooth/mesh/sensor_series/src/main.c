@@ -0,0 +1,469 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <bluetooth/mesh/sensor_srv.h>
+#include <bluetooth/mesh/sensor_types.h>
+#include <sensor.h> // private header from the source folder
+
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+#include <native_rtc.h>
+#endif
+
+/* A day of 0.1 hour columns */
+#define COLUMN_COUNT 240
+#define CHANNEL_COUNT 3
+/* Start, width and three single byte channels */
+#define COLUMN_SIZE 5
+/* Opcode and sensor ID */
+#define STATUS_HDR_SIZE 3
+#define BENCH_ROUNDS 100
+/* Ranges of 20 columns requested in the series get benchmark */
+#define BENCH_RANGES (COLUMN_COUNT / 20 - 1)
+#define MAX_AGE_MS 1000
+
+/****************** mock section **********************************/
+
+static uint8_t rsp_data[BT_MESH_TX_SDU_MAX];
+static size_t rsp_len;
+static int rsp_cnt;
+
+int bt_mesh_model_send(struct bt_mesh_model *model,
+		       struct bt_mesh_msg_ctx *ctx,
+		       struct net_buf_simple *msg,
+		       const struct bt_mesh_send_cb *cb, void *cb_data)
+{
+	zassert_true(msg->len <= sizeof(rsp_data), "Response too long");
+
+	memcpy(rsp_data, msg->data, msg->len);
+	rsp_len = msg->len;
+	rsp_cnt++;
+
+	return 0;
+}
+
+int32_t bt_mesh_model_pub_period_get(struct bt_mesh_model *mod)
+{
+	return 0;
+}
+
+int bt_mesh_model_data_store(struct bt_mesh_model *mod, bool vnd,
+			     const char *name, const void *data,
+			     size_t data_len)
+{
+	return 0;
+}
+
+/****************** mock section **********************************/
+
+static struct bt_mesh_sensor_column columns[COLUMN_COUNT];
+static struct bt_mesh_sensor_column columns_rev[COLUMN_COUNT];
+static struct sensor_value values[COLUMN_COUNT * CHANNEL_COUNT];
+static struct sensor_value aged_values[COLUMN_COUNT * CHANNEL_COUNT];
+static struct sensor_value sparse_values[COLUMN_COUNT * CHANNEL_COUNT];
+static ATOMIC_DEFINE(valid, COLUMN_COUNT);
+static ATOMIC_DEFINE(aged_valid, COLUMN_COUNT);
+static ATOMIC_DEFINE(sparse_valid, COLUMN_COUNT);
+static int64_t timestamps[COLUMN_COUNT];
+static int series_get_cnt;
+
+static struct sensor_value column_start(uint32_t i)
+{
+	return (struct sensor_value){ .val1 = i / 10, .val2 = (i % 10) * 100000 };
+}
+
+static void column_value(const struct bt_mesh_sensor_column *col,
+			 struct sensor_value *value)
+{
+	/* Temperature in whole degrees, derived from the column start */
+	value[0].val1 = (col->start.val1 * 10 + col->start.val2 / 100000) % 40;
+	value[0].val2 = 0;
+	value[1] = col->start;
+	value[2] = col->end;
+}
+
+static int series_get(struct bt_mesh_sensor_srv *srv,
+		      struct bt_mesh_sensor *sensor,
+		      struct bt_mesh_msg_ctx *ctx,
+		      const struct bt_mesh_sensor_column *column,
+		      struct sensor_value *value)
+{
+	series_get_cnt++;
+	column_value(column, value);
+	return 0;
+}
+
+/* Sorted columns with stored values */
+static struct bt_mesh_sensor stored_sensor = {
+	.type = &bt_mesh_sensor_avg_amb_temp_in_day,
+	.series = {
+		.columns = columns,
+		.column_count = COLUMN_COUNT,
+		.store = {
+			.values = values,
+			.valid = valid,
+		},
+	},
+};
+
+/* Unsorted columns with the series getter */
+static struct bt_mesh_sensor getter_sensor = {
+	.type = &bt_mesh_sensor_avg_amb_temp_in_day,
+	.series = {
+		.columns = columns_rev,
+		.column_count = COLUMN_COUNT,
+		.get = series_get,
+	},
+};
+
+/* Sorted columns with expiring stored values */
+static struct bt_mesh_sensor aged_sensor = {
+	.type = &bt_mesh_sensor_avg_amb_temp_in_day,
+	.series = {
+		.columns = columns,
+		.column_count = COLUMN_COUNT,
+		.store = {
+			.values = aged_values,
+			.valid = aged_valid,
+			.timestamps = timestamps,
+			.max_age = MAX_AGE_MS,
+		},
+	},
+};
+
+/* Sorted columns with stored values that never expire, only some of them set */
+static struct bt_mesh_sensor sparse_sensor = {
+	.type = &bt_mesh_sensor_avg_amb_temp_in_day,
+	.series = {
+		.columns = columns,
+		.column_count = COLUMN_COUNT,
+		.store = {
+			.values = sparse_values,
+			.valid = sparse_valid,
+		},
+	},
+};
+
+static struct bt_mesh_sensor *const stored_sensors[] = { &stored_sensor };
+static struct bt_mesh_sensor *const getter_sensors[] = { &getter_sensor };
+static struct bt_mesh_sensor *const aged_sensors[] = { &aged_sensor };
+static struct bt_mesh_sensor *const sparse_sensors[] = { &sparse_sensor };
+
+static struct bt_mesh_sensor_srv stored_srv =
+	BT_MESH_SENSOR_SRV_INIT(stored_sensors, ARRAY_SIZE(stored_sensors));
+static struct bt_mesh_sensor_srv getter_srv =
+	BT_MESH_SENSOR_SRV_INIT(getter_sensors, ARRAY_SIZE(getter_sensors));
+static struct bt_mesh_sensor_srv aged_srv =
+	BT_MESH_SENSOR_SRV_INIT(aged_sensors, ARRAY_SIZE(aged_sensors));
+static struct bt_mesh_sensor_srv sparse_srv =
+	BT_MESH_SENSOR_SRV_INIT(sparse_sensors, ARRAY_SIZE(sparse_sensors));
+
+static struct bt_mesh_model stored_model = { .user_data = &stored_srv };
+static struct bt_mesh_model getter_model = { .user_data = &getter_srv };
+static struct bt_mesh_model aged_model = { .user_data = &aged_srv };
+static struct bt_mesh_model sparse_model = { .user_data = &sparse_srv };
+
+static struct bt_mesh_msg_ctx test_ctx = { .addr = 0x0001 };
+
+static void op_call(struct bt_mesh_model *model, uint32_t opcode,
+		    struct net_buf_simple *buf)
+{
+	const struct bt_mesh_model_op *op;
+
+	for (op = _bt_mesh_sensor_srv_op; op->func; op++) {
+		if (op->opcode == opcode) {
+			zassert_ok(op->func(model, &test_ctx, buf), "Handler failed");
+			return;
+		}
+	}
+
+	zassert_unreachable("Unknown opcode 0x%x", opcode);
+}
+
+static void column_get(struct bt_mesh_model *model, uint32_t i)
+{
+	const struct bt_mesh_sensor_format *col_format =
+		bt_mesh_sensor_column_format_get(&bt_mesh_sensor_avg_amb_temp_in_day);
+	struct sensor_value start = column_start(i);
+
+	NET_BUF_SIMPLE_DEFINE(buf, 4);
+
+	net_buf_simple_add_le16(&buf, bt_mesh_sensor_avg_amb_temp_in_day.id);
+	zassert_ok(sensor_ch_encode(&buf, col_format, &start), "Encoding failed");
+
+	op_call(model, BT_MESH_SENSOR_OP_COLUMN_GET, &buf);
+}
+
+static void series_get_range(struct bt_mesh_model *model, uint32_t first,
+			     uint32_t last)
+{
+	const struct bt_mesh_sensor_format *col_format =
+		bt_mesh_sensor_column_format_get(&bt_mesh_sensor_avg_amb_temp_in_day);
+	struct sensor_value start = column_start(first);
+	struct sensor_value end = column_start(last);
+
+	NET_BUF_SIMPLE_DEFINE(buf, 6);
+
+	net_buf_simple_add_le16(&buf, bt_mesh_sensor_avg_amb_temp_in_day.id);
+	zassert_ok(sensor_ch_encode(&buf, col_format, &start), "Encoding failed");
+	zassert_ok(sensor_ch_encode(&buf, col_format, &end), "Encoding failed");
+
+	op_call(model, BT_MESH_SENSOR_OP_SERIES_GET, &buf);
+}
+
+static void series_get_all(struct bt_mesh_model *model)
+{
+	NET_BUF_SIMPLE_DEFINE(buf, 2);
+
+	net_buf_simple_add_le16(&buf, bt_mesh_sensor_avg_amb_temp_in_day.id);
+
+	op_call(model, BT_MESH_SENSOR_OP_SERIES_GET, &buf);
+}
+
+/* Checks a column in the response. The column start and the start and end
+ * channels are encoded as decihours, the temperature as half degrees.
+ */
+static void column_check(const uint8_t *data, uint32_t i)
+{
+	zassert_equal(data[0], i, "Invalid column start %u for column %u", data[0], i);
+	zassert_equal(data[1], 1, "Invalid column width %u", data[1]);
+	zassert_equal(data[2], (i % 40) * 2, "Invalid temperature %u", data[2]);
+	zassert_equal(data[3], i, "Invalid start channel %u", data[3]);
+	zassert_equal(data[4], i + 1, "Invalid end channel %u", data[4]);
+}
+
+static void test_init(void)
+{
+	for (uint32_t i = 0; i < COLUMN_COUNT; i++) {
+		columns[i].start = column_start(i);
+		columns[i].end = column_start(i + 1);
+		columns_rev[COLUMN_COUNT - 1 - i] = columns[i];
+	}
+
+	zassert_ok(_bt_mesh_sensor_srv_cb.init(&stored_model), "Init failed");
+	zassert_ok(_bt_mesh_sensor_srv_cb.init(&getter_model), "Init failed");
+	zassert_ok(_bt_mesh_sensor_srv_cb.init(&aged_model), "Init failed");
+	zassert_ok(_bt_mesh_sensor_srv_cb.init(&sparse_model), "Init failed");
+
+	zassert_true(stored_sensor.state.series_sorted, "Sorted columns not detected");
+	zassert_false(getter_sensor.state.series_sorted, "Unsorted columns not detected");
+
+	for (uint32_t i = 0; i < COLUMN_COUNT; i++) {
+		struct sensor_value value[CHANNEL_COUNT];
+
+		column_value(&columns[i], value);
+		zassert_ok(bt_mesh_sensor_srv_series_set(&stored_sensor, &columns[i].start,
+							 value),
+			   "Failed setting column %u", i);
+	}
+}
+
+static void test_series_set(void)
+{
+	struct sensor_value start = { .val1 = 30 };
+	struct sensor_value value[CHANNEL_COUNT] = {};
+
+	zassert_equal(bt_mesh_sensor_srv_series_set(&stored_sensor, &start, value), -ENOENT,
+		      "Set unknown column");
+	zassert_equal(bt_mesh_sensor_srv_series_set(&getter_sensor, &columns[0].start, value),
+		      -ENOTSUP, "Set column without storage");
+}
+
+static void test_series_unset(void)
+{
+	struct sensor_value value[CHANNEL_COUNT];
+
+	/* Columns that were never set are unknown, even right after boot when
+	 * their zero timestamps are within the max age.
+	 */
+	zassert_true(k_uptime_get() < MAX_AGE_MS, "Test started too late");
+	series_get_all(&aged_model);
+	zassert_equal(rsp_len, STATUS_HDR_SIZE, "Unset column reported");
+	column_get(&aged_model, 0);
+	zassert_equal(rsp_len, STATUS_HDR_SIZE + 1, "Unset column reported");
+
+	/* Without timestamps, only the columns that were set are reported */
+	series_get_all(&sparse_model);
+	zassert_equal(rsp_len, STATUS_HDR_SIZE, "Unset column reported");
+
+	for (uint32_t i = 10; i < 20; i += 3) {
+		column_value(&columns[i], value);
+		zassert_ok(bt_mesh_sensor_srv_series_set(&sparse_sensor, &columns[i].start,
+							 value),
+			   "Failed setting column %u", i);
+	}
+
+	series_get_all(&sparse_model);
+	zassert_equal(rsp_len, STATUS_HDR_SIZE + 4 * COLUMN_SIZE, "Invalid length %u",
+		      rsp_len);
+	for (uint32_t i = 0; i < 4; i++) {
+		column_check(&rsp_data[STATUS_HDR_SIZE + i * COLUMN_SIZE], 10 + i * 3);
+	}
+
+	column_get(&sparse_model, 11);
+	zassert_equal(rsp_len, STATUS_HDR_SIZE + 1, "Unset column reported");
+	column_get(&sparse_model, 13);
+	zassert_equal(rsp_len, STATUS_HDR_SIZE + COLUMN_SIZE, "Invalid length %u",
+		      rsp_len);
+	column_check(&rsp_data[STATUS_HDR_SIZE], 13);
+}
+
+static void test_column_get(void)
+{
+	for (uint32_t i = 0; i < COLUMN_COUNT; i += 37) {
+		column_get(&stored_model, i);
+		zassert_equal(rsp_len, STATUS_HDR_SIZE + COLUMN_SIZE, "Invalid length %u",
+			      rsp_len);
+		column_check(&rsp_data[STATUS_HDR_SIZE], i);
+
+		column_get(&getter_model, i);
+		zassert_equal(rsp_len, STATUS_HDR_SIZE + COLUMN_SIZE, "Invalid length %u",
+			      rsp_len);
+		column_check(&rsp_data[STATUS_HDR_SIZE], i);
+	}
+
+	/* Unknown column responds with the requested column start only */
+	column_get(&stored_model, COLUMN_COUNT);
+	zassert_equal(rsp_len, STATUS_HDR_SIZE + 1, "Invalid length %u", rsp_len);
+	column_get(&getter_model, COLUMN_COUNT);
+	zassert_equal(rsp_len, STATUS_HDR_SIZE + 1, "Invalid length %u", rsp_len);
+}
+
+static void test_series_range(void)
+{
+	/* The range end is inclusive */
+	series_get_range(&stored_model, 100, 120);
+	zassert_equal(rsp_len, STATUS_HDR_SIZE + 21 * COLUMN_SIZE, "Invalid length %u",
+		      rsp_len);
+	for (uint32_t i = 0; i < 21; i++) {
+		column_check(&rsp_data[STATUS_HDR_SIZE + i * COLUMN_SIZE], 100 + i);
+	}
+
+	series_get_cnt = 0;
+	series_get_range(&getter_model, 100, 120);
+	zassert_equal(series_get_cnt, 21, "Invalid number of getter calls");
+	zassert_equal(rsp_len, STATUS_HDR_SIZE + 21 * COLUMN_SIZE, "Invalid length %u",
+		      rsp_len);
+	/* Unsorted columns are encoded in their order */
+	for (uint32_t i = 0; i < 21; i++) {
+		column_check(&rsp_data[STATUS_HDR_SIZE + i * COLUMN_SIZE], 120 - i);
+	}
+
+	/* Single column range */
+	series_get_range(&stored_model, 239, 239);
+	zassert_equal(rsp_len, STATUS_HDR_SIZE + COLUMN_SIZE, "Invalid length %u", rsp_len);
+	column_check(&rsp_data[STATUS_HDR_SIZE], 239);
+}
+
+static void test_series_truncated(void)
+{
+	const uint32_t fit = (BT_MESH_TX_SDU_MAX - STATUS_HDR_SIZE) / COLUMN_SIZE;
+
+	rsp_cnt = 0;
+	series_get_all(&stored_model);
+	zassert_equal(rsp_cnt, 1, "No response");
+	zassert_equal(rsp_len, STATUS_HDR_SIZE + fit * COLUMN_SIZE, "Invalid length %u",
+		      rsp_len);
+	for (uint32_t i = 0; i < fit; i++) {
+		column_check(&rsp_data[STATUS_HDR_SIZE + i * COLUMN_SIZE], i);
+	}
+}
+
+static void test_series_expired(void)
+{
+	struct sensor_value value[CHANNEL_COUNT];
+
+	k_sleep(K_MSEC(MAX_AGE_MS * 2));
+
+	column_value(&columns[50], value);
+	zassert_ok(bt_mesh_sensor_srv_series_set(&aged_sensor, &columns[50].start, value),
+		   "Set failed");
+
+	series_get_all(&aged_model);
+	zassert_equal(rsp_len, STATUS_HDR_SIZE + COLUMN_SIZE, "Invalid length %u", rsp_len);
+	column_check(&rsp_data[STATUS_HDR_SIZE], 50);
+
+	column_get(&aged_model, 51);
+	zassert_equal(rsp_len, STATUS_HDR_SIZE + 1, "Expired column reported");
+
+	k_sleep(K_MSEC(MAX_AGE_MS * 2));
+
+	series_get_all(&aged_model);
+	zassert_equal(rsp_len, STATUS_HDR_SIZE, "Expired column reported");
+}
+
+/* Handling the messages takes no simulated time on native_posix, where the
+ * benchmark has to measure with the real time clock of the host instead.
+ */
+static uint64_t bench_time_ns(void)
+{
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+	return native_rtc_gettime_us(RTC_CLOCK_REAL) * NSEC_PER_USEC;
+#else
+	return k_cyc_to_ns_floor64(k_cycle_get_32());
+#endif
+}
+
+static void bench_column_get(const char *name, struct bt_mesh_model *model)
+{
+	uint64_t start = bench_time_ns();
+
+	for (int round = 0; round < BENCH_ROUNDS; round++) {
+		for (uint32_t i = 0; i < COLUMN_COUNT; i++) {
+			column_get(model, i);
+		}
+	}
+
+	TC_PRINT("%s column get: %u ns per message\n", name,
+		 (uint32_t)((bench_time_ns() - start) / (BENCH_ROUNDS * COLUMN_COUNT)));
+}
+
+static void bench_series_get(const char *name, struct bt_mesh_model *model)
+{
+	uint64_t start = bench_time_ns();
+
+	for (int round = 0; round < BENCH_ROUNDS; round++) {
+		for (uint32_t i = 0; i < BENCH_RANGES; i++) {
+			series_get_range(model, i * 20, i * 20 + 19);
+		}
+	}
+
+	TC_PRINT("%s series get: %u ns per message\n", name,
+		 (uint32_t)((bench_time_ns() - start) / (BENCH_ROUNDS * BENCH_RANGES)));
+}
+
+static void test_benchmark(void)
+{
+	rsp_cnt = 0;
+	series_get_cnt = 0;
+
+	bench_column_get("Sorted, stored", &stored_model);
+	bench_column_get("Unsorted, getter", &getter_model);
+	bench_series_get("Sorted, stored", &stored_model);
+	bench_series_get("Unsorted, getter", &getter_model);
+
+	zassert_equal(rsp_cnt, 2 * BENCH_ROUNDS * (COLUMN_COUNT + BENCH_RANGES),
+		      "Invalid number of responses: %d", rsp_cnt);
+	/* The stored values are encoded without calling the getter */
+	zassert_equal(series_get_cnt, BENCH_ROUNDS * (COLUMN_COUNT + 20 * BENCH_RANGES),
+		      "Invalid number of getter calls: %d", series_get_cnt);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(sensor_series_test,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_series_set),
+			 ztest_unit_test(test_series_unset),
+			 ztest_unit_test(test_column_get),
+			 ztest_unit_test(test_series_range),
+			 ztest_unit_test(test_series_truncated),
+			 ztest_unit_test(test_series_expired),
+			 ztest_unit_test(test_benchmark)
+			 );
+
+	ztest_run_test_suite(sensor_series_test);
+}
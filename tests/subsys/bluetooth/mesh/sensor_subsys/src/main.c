@@ -2437,6 +2437,27 @@ static void test_present_rel_output_ripple_voltage(void)
 	percentage8_check(sensor_type);
 }
 
+static void test_type_get(void)
+{
+	uint16_t prev_id = BT_MESH_PROP_ID_PROHIBITED;
+	uint32_t count = 0;
+
+	/* The lookup relies on the linker sorting the types by ID */
+	STRUCT_SECTION_FOREACH(bt_mesh_sensor_type, type) {
+		zassert_true(type->id > prev_id, "Type 0x%04x not sorted",
+			     type->id);
+		zassert_equal_ptr(bt_mesh_sensor_type_get(type->id), type,
+				  "Lookup of 0x%04x failed", type->id);
+		prev_id = type->id;
+		count++;
+	}
+
+	zassert_true(count > 0, "No sensor types");
+	zassert_is_null(bt_mesh_sensor_type_get(BT_MESH_PROP_ID_PROHIBITED),
+			"Found prohibited ID");
+	zassert_is_null(bt_mesh_sensor_type_get(0xffff), "Found unknown ID");
+}
+
 void test_main(void)
 {
 	ztest_test_suite(sensor_types_test,
@@ -2545,7 +2566,10 @@ void test_main(void)
 			ztest_unit_test(test_output_voltage_stat),
 			ztest_unit_test(test_present_output_current),
 			ztest_unit_test(test_present_output_voltage),
-			ztest_unit_test(test_present_rel_output_ripple_voltage)
+			ztest_unit_test(test_present_rel_output_ripple_voltage),
+
+			/* Sensor type lookup */
+			ztest_unit_test(test_type_get)
 			 );
 
 	ztest_run_test_suite(sensor_types_test);
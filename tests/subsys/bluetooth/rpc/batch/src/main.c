@@ -0,0 +1,350 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <zephyr.h>
+#include <string.h>
+
+#include <bluetooth/gatt.h>
+#include <nrf_rpc_cbor.h>
+#include <nrf_rpc_loopback.h>
+
+#include "bt_rpc.h"
+#include "bt_rpc_batch.h"
+#include "bt_rpc_common.h"
+#include "bt_rpc_gatt_common.h"
+#include "serialize.h"
+
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+#include <native_rtc.h>
+#endif
+
+#define BATCH_SIZE		512
+#define BATCH_MAX_CALLS		16
+
+#define NOTIFY_COUNT		64
+#define NOTIFY_DATA_MAX		244
+#define RESULT_TIMEOUT		K_SECONDS(1)
+
+static uint8_t batch_buf[BATCH_SIZE];
+static struct bt_rpc_batch batch;
+
+static struct bt_gatt_attr test_attrs[] = {
+	BT_GATT_PRIMARY_SERVICE(BT_UUID_DECLARE_16(0xfff0)),
+	BT_GATT_CHARACTERISTIC(BT_UUID_DECLARE_16(0xfff1), BT_GATT_CHRC_NOTIFY,
+			       BT_GATT_PERM_NONE, NULL, NULL, NULL),
+};
+
+static struct bt_gatt_service test_svc = BT_GATT_SERVICE(test_attrs);
+
+/* Value attribute of the characteristic */
+#define NOTIFY_ATTR		(&test_attrs[2])
+
+static uint8_t notify_data[NOTIFY_DATA_MAX];
+
+/* Notifications executed by the host */
+static struct {
+	atomic_t calls;
+	atomic_t bytes;
+	atomic_t errors;
+} notified;
+
+static K_SEM_DEFINE(results, 0, NOTIFY_COUNT);
+
+/* redefined mocks */
+int bt_gatt_notify_cb(struct bt_conn *conn, struct bt_gatt_notify_params *params)
+{
+	if ((params->attr != NOTIFY_ATTR) || params->func || params->uuid ||
+	    memcmp(params->data, notify_data, params->len)) {
+		atomic_inc(&notified.errors);
+	}
+
+	atomic_inc(&notified.calls);
+	atomic_add(&notified.bytes, params->len);
+
+	return 0;
+}
+
+static inline void bt_gatt_complete_func_t_callback(struct bt_conn *conn, void *user_data,
+						    uint32_t callback_slot)
+{
+}
+
+CBKPROXY_HANDLER(bt_gatt_complete_func_t_encoder, bt_gatt_complete_func_t_callback,
+		 (struct bt_conn *conn, void *user_data), (conn, user_data));
+
+int bt_rpc_batch_le_adv_update_data_exec(CborValue *value)
+{
+	return -ENOTSUP;
+}
+/* redefined mocks */
+
+/* The kernel clock of native_posix stands still while the calls are served,
+ * so the benchmark reads the clock of the host there.
+ */
+static uint64_t time_us(void)
+{
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+	return native_rtc_gettime_us(RTC_CLOCK_REAL);
+#else
+	return k_cyc_to_us_floor64(k_cycle_get_32());
+#endif
+}
+
+static void notify_done(int result, void *user_data)
+{
+	if (result) {
+		atomic_inc(&notified.errors);
+	}
+
+	k_sem_give(&results);
+}
+
+static void notify(size_t len)
+{
+	struct bt_gatt_notify_params params = {
+		.attr = NOTIFY_ATTR,
+		.data = notify_data,
+		.len = len,
+	};
+	int err;
+
+	err = bt_rpc_batch_gatt_notify(NULL, &params, notify_done, NULL);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+}
+
+static void results_wait(size_t count)
+{
+	for (size_t i = 0; i < count; i++) {
+		zassert_equal(k_sem_take(&results, RESULT_TIMEOUT), 0, "Missing result");
+	}
+}
+
+static void notified_reset(void)
+{
+	atomic_clear(&notified.calls);
+	atomic_clear(&notified.bytes);
+	atomic_clear(&notified.errors);
+	nrf_rpc_loopback_stats_reset();
+}
+
+static void notified_check(size_t len)
+{
+	zassert_equal(atomic_get(&notified.calls), NOTIFY_COUNT, "Lost calls");
+	zassert_equal(atomic_get(&notified.bytes), NOTIFY_COUNT * len, "Lost data");
+	zassert_equal(atomic_get(&notified.errors), 0, "Wrong notifications");
+}
+
+static void test_roundtrip(void)
+{
+	const uint8_t data[] = { 0x01, 0x02, 0x03 };
+	struct bt_rpc_batch_call call = {
+		.op = BT_RPC_BATCH_OP_LE_ADV_UPDATE_DATA,
+		.cb = 0x20001000,
+		.user_data = 42,
+	};
+	uint8_t out[sizeof(data)];
+	size_t out_len = sizeof(out);
+	struct cbor_buf_reader reader;
+	CborParser parser;
+	CborValue value;
+	size_t len;
+	int err;
+
+	bt_rpc_batch_init(&batch, batch_buf, sizeof(batch_buf), BATCH_MAX_CALLS);
+
+	err = bt_rpc_batch_add(&batch, &call, 10);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+	cbor_encode_byte_string(&batch.encoder, data, sizeof(data));
+
+	call.op = BT_RPC_BATCH_OP_GATT_NOTIFY;
+	call.cb = 0;
+	err = bt_rpc_batch_add(&batch, &call, 0);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+	zassert_equal(batch.count, 2, "Wrong count %zu", batch.count);
+
+	len = bt_rpc_batch_finish(&batch);
+
+	err = bt_rpc_batch_decode_init(&reader, &parser, &value, batch_buf, len);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+
+	err = bt_rpc_batch_call_decode(&value, &call);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+	zassert_equal(call.op, BT_RPC_BATCH_OP_LE_ADV_UPDATE_DATA, "Wrong operation");
+	zassert_equal(call.cb, 0x20001000, "Wrong callback");
+	zassert_equal(call.user_data, 42, "Wrong user data");
+	zassert_equal(cbor_value_copy_byte_string(&value, out, &out_len, &value), CborNoError,
+		      "Copying data failed");
+	zassert_mem_equal(out, data, sizeof(data), "Wrong data");
+
+	err = bt_rpc_batch_call_decode(&value, &call);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+	zassert_equal(call.op, BT_RPC_BATCH_OP_GATT_NOTIFY, "Wrong operation");
+	zassert_equal(call.cb, 0, "Wrong callback");
+
+	zassert_true(cbor_value_at_end(&value), "Trailing calls");
+}
+
+static void test_limits(void)
+{
+	const struct bt_rpc_batch_call call = { 0 };
+	int err;
+
+	/* Number of calls */
+	bt_rpc_batch_init(&batch, batch_buf, sizeof(batch_buf), 2);
+	zassert_equal(bt_rpc_batch_add(&batch, &call, 0), 0, "Adding failed");
+	zassert_equal(bt_rpc_batch_add(&batch, &call, 0), 0, "Adding failed");
+	err = bt_rpc_batch_add(&batch, &call, 0);
+	zassert_equal(err, -ENOSPC, "Return value %d is wrong", err);
+
+	/* Size of the calls */
+	bt_rpc_batch_init(&batch, batch_buf, sizeof(batch_buf), BATCH_MAX_CALLS);
+	err = bt_rpc_batch_add(&batch, &call, sizeof(batch_buf));
+	zassert_equal(err, -ENOMEM, "Return value %d is wrong", err);
+
+	err = bt_rpc_batch_add(&batch, &call, sizeof(batch_buf) / 2);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+	err = bt_rpc_batch_add(&batch, &call, sizeof(batch_buf) / 2);
+	zassert_equal(err, -ENOSPC, "Return value %d is wrong", err);
+	zassert_equal(batch.count, 1, "Wrong count %zu", batch.count);
+}
+
+static void test_invalid(void)
+{
+	const uint8_t not_array[] = { 0x01 };
+	const uint8_t bad_call[] = { 0x9f, 0x61, 'a', 0xff };
+	struct bt_rpc_batch_call call;
+	struct cbor_buf_reader reader;
+	CborParser parser;
+	CborValue value;
+	int err;
+
+	err = bt_rpc_batch_decode_init(&reader, &parser, &value, not_array, sizeof(not_array));
+	zassert_equal(err, -EBADMSG, "Return value %d is wrong", err);
+
+	err = bt_rpc_batch_decode_init(&reader, &parser, &value, bad_call, sizeof(bad_call));
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+	err = bt_rpc_batch_call_decode(&value, &call);
+	zassert_equal(err, -EBADMSG, "Return value %d is wrong", err);
+}
+
+static void test_buffer_in_place(void)
+{
+	const uint8_t buffers[] = { 0x83, 0x43, 0x01, 0x02, 0x03, 0xf6, 0x07 };
+	const uint8_t indefinite[] = { 0x81, 0x5f, 0x41, 0x01, 0x41, 0x02, 0xff };
+	const uint8_t not_buffer[] = { 0x81, 0x07 };
+	struct cbor_buf_reader reader;
+	CborParser parser;
+	CborValue value;
+	const uint8_t *data;
+	int err;
+
+	err = bt_rpc_batch_decode_init(&reader, &parser, &value, buffers, sizeof(buffers));
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+
+	zassert_equal(ser_decode_buffer_size(&value), 3, "Wrong size");
+	data = ser_decode_buffer_in_place(&value);
+	zassert_equal_ptr(data, &buffers[2], "Data not referenced in place");
+	zassert_true(ser_decode_valid(&value), "Decoding failed");
+
+	data = ser_decode_buffer_in_place(&value);
+	zassert_is_null(data, "Null decoded as data");
+	zassert_true(ser_decode_valid(&value), "Decoding failed");
+
+	/* The value following the buffers is decoded */
+	zassert_equal(ser_decode_uint(&value), 7, "Wrong value");
+	zassert_true(ser_decode_valid(&value), "Decoding failed");
+
+	/* Chunks of an indefinite length string are not contiguous */
+	err = bt_rpc_batch_decode_init(&reader, &parser, &value, indefinite, sizeof(indefinite));
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+	zassert_is_null(ser_decode_buffer_in_place(&value), "Indefinite string decoded");
+	zassert_false(ser_decode_valid(&value), "Decoding did not fail");
+
+	err = bt_rpc_batch_decode_init(&reader, &parser, &value, not_buffer, sizeof(not_buffer));
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+	zassert_is_null(ser_decode_buffer_in_place(&value), "Integer decoded as data");
+	zassert_false(ser_decode_valid(&value), "Decoding did not fail");
+}
+
+/* Compare notifications sent one by one with batched ones, over the loopback */
+static void test_throughput(void)
+{
+	static const size_t data_len[] = { 20, 100, NOTIFY_DATA_MAX };
+	struct nrf_rpc_loopback_stats sync_stats;
+	struct nrf_rpc_loopback_stats stats;
+	uint64_t sync_us;
+	uint64_t start;
+
+	for (size_t i = 0; i < ARRAY_SIZE(data_len); i++) {
+		size_t len = data_len[i];
+
+		/* Every call is sent and its result awaited before the next one */
+		notified_reset();
+		start = time_us();
+		for (size_t n = 0; n < NOTIFY_COUNT; n++) {
+			notify(len);
+			zassert_equal(bt_rpc_batch_flush(), 0, "Flush failed");
+			results_wait(1);
+		}
+		sync_us = time_us() - start;
+		nrf_rpc_loopback_stats_get(&sync_stats);
+		notified_check(len);
+
+		notified_reset();
+		start = time_us();
+		for (size_t n = 0; n < NOTIFY_COUNT; n++) {
+			notify(len);
+		}
+		zassert_equal(bt_rpc_batch_flush(), 0, "Flush failed");
+		results_wait(NOTIFY_COUNT);
+		nrf_rpc_loopback_stats_get(&stats);
+		notified_check(len);
+
+		TC_PRINT("%u x %zu bytes: sync %u packets, %u bytes, %u us; "
+			 "batched %u packets, %u bytes, %u us\n",
+			 NOTIFY_COUNT, len, sync_stats.packets, sync_stats.bytes,
+			 (uint32_t)sync_us, stats.packets, stats.bytes,
+			 (uint32_t)(time_us() - start));
+
+		/* A batch and its results per call */
+		zassert_equal(sync_stats.packets, 2 * NOTIFY_COUNT, "Extra packets: %u",
+			      sync_stats.packets);
+		zassert_true(stats.packets < sync_stats.packets, "Batching does not save packets");
+	}
+}
+
+static void err_handler(const struct nrf_rpc_err_report *report)
+{
+	zassert_unreachable("nRF RPC error %d", report->code);
+}
+
+void test_main(void)
+{
+	uint32_t svc_index;
+	int err;
+
+	for (size_t i = 0; i < sizeof(notify_data); i++) {
+		notify_data[i] = i;
+	}
+
+	err = nrf_rpc_init(err_handler);
+	zassert_equal(err, 0, "nRF RPC initialization failed: %d", err);
+
+	/* The client and the host share the service database */
+	err = bt_rpc_gatt_add_service(&test_svc, &svc_index);
+	zassert_equal(err, 0, "Adding the service failed: %d", err);
+
+	ztest_test_suite(bt_rpc_batch,
+		ztest_unit_test(test_roundtrip),
+		ztest_unit_test(test_limits),
+		ztest_unit_test(test_invalid),
+		ztest_unit_test(test_buffer_in_place),
+		ztest_unit_test(test_throughput)
+	);
+
+	ztest_run_test_suite(bt_rpc_batch);
+}
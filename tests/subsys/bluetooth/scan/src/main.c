@@ -0,0 +1,508 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Filter matching of the scanning module, tested by replaying captured
+ * advertising reports.
+ */
+
+#include <ztest.h>
+#include <zephyr.h>
+#include <bluetooth/scan.h>
+
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+#include <native_rtc.h>
+#endif
+
+#define REPLAY_ROUNDS 1000
+
+#define FILTERED_ADDR_IDX 9
+
+#define UUID_NUS_VAL \
+	BT_UUID_128_ENCODE(0x6e400001, 0xb5a3, 0xf393, 0xe0a9, 0xe50e24dcca9e)
+#define UUID_HRS_128_VAL \
+	BT_UUID_128_ENCODE(0x0000180d, 0x0000, 0x1000, 0x8000, 0x00805f9b34fb)
+
+#define REPORT(_addr_idx, _match, ...)					\
+	{								\
+		.addr_idx = _addr_idx,					\
+		.match = _match,					\
+		.data = (const uint8_t []){ __VA_ARGS__ },		\
+		.len = sizeof((const uint8_t []){ __VA_ARGS__ }),	\
+	}
+
+struct adv_report {
+	/* Index of the advertiser address. */
+	uint8_t addr_idx;
+
+	/* Filter types matching the report with the default filters. */
+	uint8_t match;
+
+	/* Advertising data. */
+	const uint8_t *data;
+
+	/* Length of the advertising data. */
+	uint8_t len;
+};
+
+/* Advertising reports captured from a scan of a typical environment. */
+static const struct adv_report reports[] = {
+	/* iBeacon */
+	REPORT(1, 0,
+	       0x02, 0x01, 0x06,
+	       0x1a, 0xff, 0x4c, 0x00, 0x02, 0x15,
+	       0xe2, 0xc5, 0x6d, 0xb5, 0xdf, 0xfb, 0x48, 0xd2,
+	       0xb0, 0x60, 0xd0, 0xf5, 0xa7, 0x10, 0x96, 0xe0,
+	       0x00, 0x01, 0x00, 0x02, 0xc5),
+	/* Eddystone-UID */
+	REPORT(2, 0,
+	       0x02, 0x01, 0x06,
+	       0x03, 0x03, 0xaa, 0xfe,
+	       0x17, 0x16, 0xaa, 0xfe, 0x00, 0xe7,
+	       0x8b, 0x0c, 0xa7, 0x50, 0xe1, 0xa4, 0x7f, 0x35, 0x14, 0x4f,
+	       0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00),
+	/* Nordic UART Service peripheral, advertising data */
+	REPORT(3, BT_SCAN_NAME_FILTER,
+	       0x02, 0x01, 0x06,
+	       0x0c, 0x09, 'N', 'o', 'r', 'd', 'i', 'c', '_', 'U', 'A', 'R', 'T'),
+	/* Nordic UART Service peripheral, scan response data */
+	REPORT(3, BT_SCAN_UUID_FILTER,
+	       0x11, 0x07, UUID_NUS_VAL),
+	/* Heart rate sensor */
+	REPORT(4, BT_SCAN_NAME_FILTER | BT_SCAN_UUID_FILTER,
+	       0x02, 0x01, 0x06,
+	       0x05, 0x03, 0x0d, 0x18, 0x0f, 0x18,
+	       0x0b, 0x09, 'N', 'o', 'r', 'd', 'i', 'c', '_', 'H', 'R', 'M'),
+	/* HID keyboard */
+	REPORT(5, BT_SCAN_APPEARANCE_FILTER | BT_SCAN_SHORT_NAME_FILTER,
+	       0x02, 0x01, 0x06,
+	       0x03, 0x19, 0xc1, 0x03,
+	       0x05, 0x03, 0x12, 0x18, 0x0f, 0x18,
+	       0x07, 0x08, 'N', 'o', 'r', 'd', 'i', 'c'),
+	/* Nordic manufacturer data */
+	REPORT(6, BT_SCAN_MANUFACTURER_DATA_FILTER,
+	       0x02, 0x01, 0x06,
+	       0x05, 0xff, 0x59, 0x00, 0x01, 0x02),
+	/* Apple Continuity */
+	REPORT(7, 0,
+	       0x02, 0x01, 0x1a,
+	       0x0a, 0xff, 0x4c, 0x00, 0x10, 0x05, 0x01, 0x18, 0x4a, 0x2e, 0x1d),
+	/* Microsoft Connected Devices Platform */
+	REPORT(8, 0,
+	       0x0b, 0xff, 0x06, 0x00, 0x01, 0x09, 0x20, 0x02, 0x7c, 0xa5, 0x3d, 0x11),
+	/* Device Information Service from the filtered address */
+	REPORT(FILTERED_ADDR_IDX, BT_SCAN_ADDR_FILTER,
+	       0x02, 0x01, 0x06,
+	       0x03, 0x03, 0x0a, 0x18),
+	/* Tile */
+	REPORT(10, 0,
+	       0x02, 0x01, 0x06,
+	       0x03, 0x03, 0xed, 0xfe,
+	       0x0b, 0x16, 0xed, 0xfe, 0x02, 0x00, 0x8d, 0x21, 0x3a, 0x52, 0x11, 0x07),
+	/* Short name long enough for the short name filter */
+	REPORT(11, BT_SCAN_SHORT_NAME_FILTER,
+	       0x04, 0x08, 'N', 'o', 'r'),
+	/* Short name too short for the short name filter */
+	REPORT(12, 0,
+	       0x03, 0x08, 'N', 'o'),
+	/* Heart Rate Service advertised as a 128-bit UUID */
+	REPORT(13, BT_SCAN_UUID_FILTER,
+	       0x11, 0x06, UUID_HRS_128_VAL),
+	/* Name longer than the name filter */
+	REPORT(14, 0,
+	       0x0e, 0x09, 'N', 'o', 'r', 'd', 'i', 'c', '_', 'U', 'A', 'R', 'T',
+	       '_', '2'),
+	/* Manufacturer data shorter than the manufacturer data filter */
+	REPORT(15, 0,
+	       0x02, 0xff, 0x59),
+};
+
+/* Advertising reports with UTF-8 names, matched by the UTF-8 name filters. */
+static const struct adv_report utf8_reports[] = {
+	/* Prefix of a name filter */
+	REPORT(1, BT_SCAN_NAME_FILTER,
+	       0x0c, 0x09, 'C', 'a', 'f', 0xc3, 0xa9, ' ', 'N', 'o', 'r', 'd', 'i'),
+	/* Differs from a name filter in a non-ASCII byte only */
+	REPORT(2, 0,
+	       0x0c, 0x09, 'C', 'a', 'f', 0xc3, 0xa8, ' ', 'N', 'o', 'r', 'd', 'i'),
+	/* Name starting with a non-ASCII character */
+	REPORT(3, BT_SCAN_NAME_FILTER,
+	       0x09, 0x09, 0xe2, 0x9c, 0x93, ' ', 'N', 'R', 'F', '5'),
+};
+
+static const struct bt_uuid_128 uuid_nus = BT_UUID_INIT_128(UUID_NUS_VAL);
+static const struct bt_uuid_16 uuid_hrs = BT_UUID_INIT_16(0x180d);
+
+static const bt_addr_le_t other_addr = {
+	.type = BT_ADDR_LE_PUBLIC,
+	.a.val = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06 },
+};
+
+static bt_addr_le_t addr_pool[ARRAY_SIZE(reports)];
+
+static struct bt_le_scan_cb *scan_cb;
+
+static uint32_t match_cnt;
+static uint32_t no_match_cnt;
+static uint8_t last_match;
+static struct bt_scan_filter_match last_status;
+
+/* Mocks of the Bluetooth host API used by the scanning module. */
+void bt_le_scan_cb_register(struct bt_le_scan_cb *cb)
+{
+	scan_cb = cb;
+}
+
+int bt_le_scan_start(const struct bt_le_scan_param *param, bt_le_scan_cb_t cb)
+{
+	return 0;
+}
+
+int bt_le_scan_stop(void)
+{
+	return 0;
+}
+
+int bt_conn_le_create(const bt_addr_le_t *peer,
+		      const struct bt_conn_le_create_param *create_param,
+		      const struct bt_le_conn_param *conn_param,
+		      struct bt_conn **conn)
+{
+	return -ENOTSUP;
+}
+
+void bt_conn_unref(struct bt_conn *conn)
+{
+}
+
+void bt_data_parse(struct net_buf_simple *ad,
+		   bool (*func)(struct bt_data *data, void *user_data),
+		   void *user_data)
+{
+	while (ad->len > 1) {
+		struct bt_data data;
+		uint8_t len;
+
+		len = net_buf_simple_pull_u8(ad);
+		if ((len == 0U) || (len > ad->len)) {
+			return;
+		}
+
+		data.type = net_buf_simple_pull_u8(ad);
+		data.data_len = len - 1;
+		data.data = ad->data;
+
+		if (!func(&data, user_data)) {
+			return;
+		}
+
+		net_buf_simple_pull(ad, len - 1);
+	}
+}
+
+static void filter_match(struct bt_scan_device_info *device_info,
+			 struct bt_scan_filter_match *filter_match,
+			 bool connectable)
+{
+	last_match = 0;
+	last_match |= filter_match->name.match ? BT_SCAN_NAME_FILTER : 0;
+	last_match |= filter_match->short_name.match ? BT_SCAN_SHORT_NAME_FILTER : 0;
+	last_match |= filter_match->addr.match ? BT_SCAN_ADDR_FILTER : 0;
+	last_match |= filter_match->uuid.match ? BT_SCAN_UUID_FILTER : 0;
+	last_match |= filter_match->appearance.match ? BT_SCAN_APPEARANCE_FILTER : 0;
+	last_match |= filter_match->manufacturer_data.match ?
+		      BT_SCAN_MANUFACTURER_DATA_FILTER : 0;
+
+	last_status = *filter_match;
+	match_cnt++;
+}
+
+static void filter_no_match(struct bt_scan_device_info *device_info,
+			    bool connectable)
+{
+	last_match = 0;
+	no_match_cnt++;
+}
+
+BT_SCAN_CB_INIT(scan_cb_data, filter_match, filter_no_match, NULL, NULL);
+
+static void report_replay(const struct adv_report *report)
+{
+	struct bt_le_scan_recv_info info = {
+		.addr = &addr_pool[report->addr_idx],
+		.adv_props = BT_GAP_ADV_PROP_CONNECTABLE,
+	};
+	struct net_buf_simple ad;
+
+	net_buf_simple_init_with_data(&ad, (void *)report->data, report->len);
+	scan_cb->recv(&info, &ad);
+}
+
+/* Matching does not move the simulated clock of native_posix forward,
+ * so the replay is timed with the host clock there.
+ */
+static uint64_t replay_time_us(void)
+{
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+	return native_rtc_gettime_us(RTC_CLOCK_REAL);
+#else
+	return k_cyc_to_us_floor64(k_cycle_get_32());
+#endif
+}
+
+static void default_filters_add(void)
+{
+	static const struct bt_scan_short_name short_name = {
+		.name = "Nordic",
+		.min_len = 3,
+	};
+	static const uint8_t nordic_company_id[] = { 0x59, 0x00 };
+	static const struct bt_scan_manufacturer_data manufacturer_data = {
+		.data = (uint8_t *)nordic_company_id,
+		.data_len = sizeof(nordic_company_id),
+	};
+	/* Keyboard, as read by the scanning module in big-endian order. */
+	static const uint16_t appearance = 0xc103;
+	int err;
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "Nordic_UART");
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "Nordic_HRM");
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_SHORT_NAME, &short_name);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_ADDR, &other_addr);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_ADDR,
+				 &addr_pool[FILTERED_ADDR_IDX]);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, &uuid_nus);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, &uuid_hrs);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_APPEARANCE, &appearance);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_MANUFACTURER_DATA,
+				 &manufacturer_data);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+}
+
+static void setup(void)
+{
+	bt_scan_filter_remove_all();
+	bt_scan_filter_disable();
+
+	match_cnt = 0;
+	no_match_cnt = 0;
+}
+
+static void test_filter_add(void)
+{
+	struct bt_filter_status status;
+	int err;
+
+	/* Duplicates are accepted, but not added. */
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "Nordic_HRM");
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "Nordic_HRM");
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, &uuid_hrs);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, &uuid_hrs);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_ADDR, &other_addr);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_ADDR, &other_addr);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+
+	err = bt_scan_filter_status_get(&status);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+	zassert_equal(status.name.cnt, 1, "Wrong name filter count");
+	zassert_equal(status.addr.cnt, 1, "Wrong address filter count");
+	zassert_equal(status.uuid.cnt, 1, "Wrong UUID filter count");
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "Nordic_UART");
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "Nordic_LBS");
+	zassert_equal(err, -ENOMEM, "Return value %d is wrong", err);
+
+	/* Removed filters do not match anymore. */
+	bt_scan_filter_remove_all();
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "Nordic_UART");
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+	err = bt_scan_filter_enable(BT_SCAN_NAME_FILTER | BT_SCAN_UUID_FILTER,
+				    false);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+
+	report_replay(&reports[4]);
+	zassert_equal(last_match, 0, "Report matched 0x%02x", last_match);
+	report_replay(&reports[2]);
+	zassert_equal(last_match, BT_SCAN_NAME_FILTER,
+		      "Report matched 0x%02x", last_match);
+}
+
+static void test_match_any(void)
+{
+	int err;
+
+	default_filters_add();
+
+	err = bt_scan_filter_enable(BT_SCAN_ALL_FILTER, false);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+
+	for (size_t i = 0; i < ARRAY_SIZE(reports); i++) {
+		report_replay(&reports[i]);
+		zassert_equal(last_match, reports[i].match,
+			      "Report %u matched 0x%02x", (uint32_t)i, last_match);
+	}
+
+	/* The first matching filter of each type is reported. */
+	report_replay(&reports[2]);
+	zassert_equal(strcmp(last_status.name.name, "Nordic_UART"), 0,
+		      "Wrong name matched");
+	zassert_equal(last_status.name.len, strlen("Nordic_UART"),
+		      "Wrong name length");
+
+	report_replay(&reports[9]);
+	zassert_equal(bt_addr_le_cmp(last_status.addr.addr,
+				     &addr_pool[FILTERED_ADDR_IDX]), 0,
+		      "Wrong address matched");
+
+	report_replay(&reports[13]);
+	zassert_equal(last_status.uuid.count, 1, "Wrong UUID count");
+	zassert_equal(bt_uuid_cmp(last_status.uuid.uuid[0], &uuid_hrs.uuid), 0,
+		      "Wrong UUID matched");
+
+	report_replay(&reports[11]);
+	zassert_equal(strcmp(last_status.short_name.name, "Nordic"), 0,
+		      "Wrong short name matched");
+	zassert_equal(last_status.short_name.len, 3, "Wrong short name length");
+}
+
+static void test_match_all(void)
+{
+	int err;
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "Nordic_HRM");
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, &uuid_hrs);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+
+	err = bt_scan_filter_enable(BT_SCAN_NAME_FILTER | BT_SCAN_UUID_FILTER,
+				    true);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+
+	/* Only the heart rate sensor advertises both the name and the UUID. */
+	for (size_t i = 0; i < ARRAY_SIZE(reports); i++) {
+		report_replay(&reports[i]);
+	}
+
+	zassert_equal(match_cnt, 1, "Wrong match count %u", match_cnt);
+	zassert_equal(no_match_cnt, ARRAY_SIZE(reports) - 1,
+		      "Wrong no match count %u", no_match_cnt);
+
+	report_replay(&reports[4]);
+	zassert_equal(last_match, BT_SCAN_NAME_FILTER | BT_SCAN_UUID_FILTER,
+		      "Report matched 0x%02x", last_match);
+	zassert_equal(last_status.uuid.count, 1, "Wrong UUID count");
+
+	/* All UUID filters must be found in the multifilter mode. */
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, &uuid_nus);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+
+	report_replay(&reports[4]);
+	zassert_equal(last_match, 0, "Report matched 0x%02x", last_match);
+}
+
+/* Names are compared as bytes, so UTF-8 names match too. */
+static void test_match_utf8_name(void)
+{
+	int err;
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "Caf\xc3\xa9 Nordic");
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "\xe2\x9c\x93 NRF52");
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+
+	err = bt_scan_filter_enable(BT_SCAN_NAME_FILTER, false);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+
+	for (size_t i = 0; i < ARRAY_SIZE(utf8_reports); i++) {
+		report_replay(&utf8_reports[i]);
+		zassert_equal(last_match, utf8_reports[i].match,
+			      "Report %u matched 0x%02x", (uint32_t)i, last_match);
+	}
+
+	report_replay(&utf8_reports[2]);
+	zassert_equal(strcmp(last_status.name.name, "\xe2\x9c\x93 NRF52"), 0,
+		      "Wrong name matched");
+}
+
+static void test_replay_throughput(void)
+{
+	uint32_t expected_matches = 0;
+	uint64_t start;
+	uint64_t us;
+	int err;
+
+	default_filters_add();
+
+	err = bt_scan_filter_enable(BT_SCAN_ALL_FILTER, false);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+
+	for (size_t i = 0; i < ARRAY_SIZE(reports); i++) {
+		if (reports[i].match) {
+			expected_matches++;
+		}
+	}
+
+	start = replay_time_us();
+
+	for (size_t round = 0; round < REPLAY_ROUNDS; round++) {
+		for (size_t i = 0; i < ARRAY_SIZE(reports); i++) {
+			report_replay(&reports[i]);
+		}
+	}
+
+	us = replay_time_us() - start;
+
+	TC_PRINT("Replayed %u reports in %u us, %u ns per report\n",
+		 (uint32_t)(REPLAY_ROUNDS * ARRAY_SIZE(reports)), (uint32_t)us,
+		 (uint32_t)(us * 1000 / (REPLAY_ROUNDS * ARRAY_SIZE(reports))));
+
+	zassert_equal(match_cnt, REPLAY_ROUNDS * expected_matches,
+		      "Wrong match count %u", match_cnt);
+	zassert_equal(no_match_cnt,
+		      REPLAY_ROUNDS * (ARRAY_SIZE(reports) - expected_matches),
+		      "Wrong no match count %u", no_match_cnt);
+}
+
+void test_main(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(addr_pool); i++) {
+		addr_pool[i].type = BT_ADDR_LE_RANDOM;
+		addr_pool[i].a.val[0] = i;
+		addr_pool[i].a.val[1] = 0x5a;
+		addr_pool[i].a.val[5] = 0xc0;
+	}
+
+	bt_scan_init(NULL);
+	bt_scan_cb_register(&scan_cb_data);
+
+	ztest_test_suite(bt_scan_test,
+			 ztest_unit_test_setup_teardown(test_filter_add, setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_match_any, setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_match_all, setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_match_utf8_name, setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_replay_throughput,
+							setup, unit_test_noop));
+
+	ztest_run_test_suite(bt_scan_test);
+}
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* CoAP server for the download_client test, with block-wise transfer
+ * (RFC 7959). Serves FILE_SIZE bytes of pattern() at any path.
+ * Responses are delayed with jitter, so that they arrive out of order,
+ * and every COAP_LOSS_EVERY response is dropped to simulate a lossy link.
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+#include <string.h>
+#include <random/rand32.h>
+#include <net/socket.h>
+#include <net/coap.h>
+
+#include "test_server.h"
+
+#define COAP_LOSS_EVERY 20
+#define QUEUE_SIZE 16
+#define PACKET_SIZE (CONFIG_DOWNLOAD_CLIENT_BUF_SIZE)
+#define STACK_SIZE 4096
+
+struct response {
+	uint8_t buf[PACKET_SIZE];
+	uint16_t len;
+	int64_t send_at;
+	struct sockaddr addr;
+	socklen_t addr_len;
+	bool queued;
+};
+
+static K_THREAD_STACK_DEFINE(server_stack, STACK_SIZE);
+static struct k_thread server_thread;
+
+static struct response queue[QUEUE_SIZE];
+static uint8_t req_buf[PACKET_SIZE];
+static int fd = -1;
+static uint32_t responses;
+static atomic_t dropped;
+
+static int response_create(struct response *rsp, uint8_t *req, size_t len)
+{
+	struct coap_packet request;
+	struct coap_packet response;
+	uint8_t token[COAP_TOKEN_MAX_LEN];
+	uint8_t payload[1024];
+	uint8_t token_len;
+	size_t first;
+	size_t size;
+	bool more;
+	int block;
+	int err;
+
+	err = coap_packet_parse(&request, req, len, NULL, 0);
+	if (err) {
+		return err;
+	}
+
+	block = coap_get_option_int(&request, COAP_OPTION_BLOCK2);
+	if (block < 0) {
+		block = COAP_BLOCK_1024;
+	}
+
+	size = coap_block_size_to_bytes(GET_BLOCK_SIZE(block));
+	first = GET_BLOCK_NUM(block) * size;
+	if (first >= FILE_SIZE) {
+		return -EINVAL;
+	}
+
+	size = MIN(size, FILE_SIZE - first);
+	more = first + size < FILE_SIZE;
+
+	for (size_t i = 0; i < size; i++) {
+		payload[i] = pattern(first + i);
+	}
+
+	token_len = coap_header_get_token(&request, token);
+
+	err = coap_packet_init(&response, rsp->buf, sizeof(rsp->buf), COAP_VERSION_1,
+			       COAP_TYPE_ACK, token_len, token, COAP_RESPONSE_CODE_CONTENT,
+			       coap_header_get_id(&request));
+	if (!err) {
+		err = coap_append_option_int(&response, COAP_OPTION_BLOCK2,
+					     (GET_BLOCK_NUM(block) << 4) | (more << 3) |
+						     GET_BLOCK_SIZE(block));
+	}
+
+	if (!err) {
+		err = coap_append_option_int(&response, COAP_OPTION_SIZE2, FILE_SIZE);
+	}
+
+	if (!err) {
+		err = coap_packet_append_payload_marker(&response);
+	}
+
+	if (!err) {
+		err = coap_packet_append_payload(&response, payload, size);
+	}
+
+	rsp->len = response.offset;
+
+	return err;
+}
+
+static struct response *queue_free_get(void)
+{
+	for (size_t i = 0; i < QUEUE_SIZE; i++) {
+		if (!queue[i].queued) {
+			return &queue[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Send the responses that are due, and get the time until the next one */
+static int queue_send(void)
+{
+	int64_t now = k_uptime_get();
+	int timeout = SYS_FOREVER_MS;
+
+	for (size_t i = 0; i < QUEUE_SIZE; i++) {
+		struct response *rsp = &queue[i];
+
+		if (!rsp->queued) {
+			continue;
+		}
+
+		if (rsp->send_at <= now) {
+			(void)sendto(fd, rsp->buf, rsp->len, 0, &rsp->addr, rsp->addr_len);
+			rsp->queued = false;
+		} else if (timeout == SYS_FOREVER_MS || rsp->send_at - now < timeout) {
+			timeout = rsp->send_at - now;
+		}
+	}
+
+	return timeout;
+}
+
+static void request_handle(void)
+{
+	struct sockaddr addr;
+	socklen_t addr_len = sizeof(addr);
+	struct response *rsp;
+	ssize_t len;
+
+	len = recvfrom(fd, req_buf, sizeof(req_buf), 0, &addr, &addr_len);
+	if (len <= 0) {
+		return;
+	}
+
+	rsp = queue_free_get();
+
+	if (!rsp || (++responses % COAP_LOSS_EVERY) == 0) {
+		atomic_inc(&dropped);
+		return;
+	}
+
+	if (response_create(rsp, req_buf, len)) {
+		return;
+	}
+
+	/* Between half and one and a half times the delay */
+	rsp->send_at = k_uptime_get() + SERVER_DELAY_MS / 2 + sys_rand32_get() % SERVER_DELAY_MS;
+	rsp->addr = addr;
+	rsp->addr_len = addr_len;
+	rsp->queued = true;
+}
+
+static void server_thread_fn(void *p1, void *p2, void *p3)
+{
+	struct pollfd fds = {
+		.fd = fd,
+		.events = POLLIN,
+	};
+
+	while (true) {
+		if (poll(&fds, 1, queue_send()) > 0) {
+			request_handle();
+		}
+	}
+}
+
+void coap_server_start(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(COAP_PORT),
+	};
+	int err;
+
+	zassert_equal(inet_pton(AF_INET, SERVER_ADDR, &addr.sin_addr), 1, "Bad address");
+
+	fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	zassert_true(fd >= 0, "socket() failed, errno %d", errno);
+
+	err = bind(fd, (struct sockaddr *)&addr, sizeof(addr));
+	zassert_equal(err, 0, "bind() failed, errno %d", errno);
+
+	k_thread_create(&server_thread, server_stack, STACK_SIZE, server_thread_fn,
+			NULL, NULL, NULL, K_LOWEST_APPLICATION_THREAD_PRIO, 0, K_NO_WAIT);
+}
+
+uint32_t coap_server_dropped(void)
+{
+	return atomic_get(&dropped);
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* HTTP/1.1 server for the download_client test, with range request support.
+ * Serves FILE_SIZE bytes of pattern() at any path, and delays every response
+ * by SERVER_DELAY_MS. Each connection is served by its own thread, so that a
+ * connection the client does not read from does not stall the others.
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <net/socket.h>
+
+#include "test_server.h"
+
+/* One spare worker accepts a reconnection before the old one sees the close */
+#define WORKERS (CONFIG_DOWNLOAD_CLIENT_HTTP_CONNECTIONS + 1)
+#define WORKER_STACK_SIZE 2048
+#define REQ_BUF_SIZE 512
+
+static K_THREAD_STACK_ARRAY_DEFINE(worker_stacks, WORKERS, WORKER_STACK_SIZE);
+static struct k_thread workers[WORKERS];
+
+static int listen_fd = -1;
+static atomic_t requests;
+static atomic_t close_every;
+
+static int send_all(int fd, const void *buf, size_t len)
+{
+	const uint8_t *p = buf;
+	ssize_t sent;
+
+	while (len) {
+		sent = send(fd, p, len, 0);
+		if (sent < 0) {
+			return -errno;
+		}
+
+		p += sent;
+		len -= sent;
+	}
+
+	return 0;
+}
+
+static int body_send(int fd, size_t first, size_t len)
+{
+	uint8_t chunk[256];
+	size_t n;
+	int err;
+
+	while (len) {
+		n = MIN(len, sizeof(chunk));
+
+		for (size_t i = 0; i < n; i++) {
+			chunk[i] = pattern(first + i);
+		}
+
+		err = send_all(fd, chunk, n);
+		if (err) {
+			return err;
+		}
+
+		first += n;
+		len -= n;
+	}
+
+	return 0;
+}
+
+/* Answer one request. Returns 1 if the connection is to be closed. */
+static int response_send(int fd, const char *req)
+{
+	uint32_t every = atomic_get(&close_every);
+	uint32_t count = atomic_inc(&requests) + 1;
+	bool close = every && (count % every) == 0;
+	const char *range = strstr(req, "Range: bytes=");
+	char *end;
+	char hdr[160];
+	uint32_t first = 0;
+	uint32_t last = FILE_SIZE - 1;
+	int n;
+	int err;
+
+	k_sleep(K_MSEC(SERVER_DELAY_MS));
+
+	if (range) {
+		range += strlen("Range: bytes=");
+		first = strtoul(range, &end, 10);
+		if (end == range || *end != '-') {
+			return 1;
+		}
+
+		/* The last byte position is optional */
+		range = end + 1;
+		last = strtoul(range, &end, 10);
+		if (end == range || last >= FILE_SIZE) {
+			last = FILE_SIZE - 1;
+		}
+
+		n = snprintf(hdr, sizeof(hdr),
+			     "HTTP/1.1 206 Partial Content\r\n"
+			     "Content-Range: bytes %u-%u/%u\r\n"
+			     "Content-Length: %u\r\n"
+			     "%s\r\n",
+			     first, last, FILE_SIZE, last - first + 1,
+			     close ? "Connection: close\r\n" : "");
+	} else {
+		n = snprintf(hdr, sizeof(hdr),
+			     "HTTP/1.1 200 OK\r\n"
+			     "Content-Length: %u\r\n"
+			     "%s\r\n",
+			     FILE_SIZE, close ? "Connection: close\r\n" : "");
+	}
+
+	err = send_all(fd, hdr, n);
+	if (!err) {
+		err = body_send(fd, first, last - first + 1);
+	}
+
+	return (err || close) ? 1 : 0;
+}
+
+static void connection_serve(int fd)
+{
+	char buf[REQ_BUF_SIZE + 1];
+	size_t len = 0;
+	ssize_t rcvd;
+	char *end;
+
+	while (true) {
+		if (len == REQ_BUF_SIZE) {
+			/* Request too long */
+			return;
+		}
+
+		rcvd = recv(fd, buf + len, REQ_BUF_SIZE - len, 0);
+		if (rcvd <= 0) {
+			return;
+		}
+
+		len += rcvd;
+		buf[len] = '\0';
+
+		/* Pipelined requests are answered in order */
+		while ((end = strstr(buf, "\r\n\r\n")) != NULL) {
+			end[2] = '\0';
+
+			if (response_send(fd, buf)) {
+				return;
+			}
+
+			end += 4;
+			len -= end - buf;
+			memmove(buf, end, len + 1);
+		}
+	}
+}
+
+static void worker_thread(void *p1, void *p2, void *p3)
+{
+	int fd;
+
+	while (true) {
+		fd = accept(listen_fd, NULL, NULL);
+		if (fd < 0) {
+			printk("accept() failed, errno %d\n", errno);
+			k_sleep(K_MSEC(SERVER_DELAY_MS));
+			continue;
+		}
+
+		connection_serve(fd);
+		close(fd);
+	}
+}
+
+void http_server_start(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(HTTP_PORT),
+	};
+	int err;
+
+	zassert_equal(inet_pton(AF_INET, SERVER_ADDR, &addr.sin_addr), 1, "Bad address");
+
+	listen_fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(listen_fd >= 0, "socket() failed, errno %d", errno);
+
+	err = bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr));
+	zassert_equal(err, 0, "bind() failed, errno %d", errno);
+
+	err = listen(listen_fd, WORKERS);
+	zassert_equal(err, 0, "listen() failed, errno %d", errno);
+
+	for (size_t i = 0; i < WORKERS; i++) {
+		k_thread_create(&workers[i], worker_stacks[i], WORKER_STACK_SIZE,
+				worker_thread, NULL, NULL, NULL,
+				K_LOWEST_APPLICATION_THREAD_PRIO, 0, K_NO_WAIT);
+	}
+}
+
+void http_server_close_every(uint32_t every)
+{
+	atomic_set(&close_every, every);
+}
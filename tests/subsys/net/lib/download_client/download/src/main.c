@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr.h>
+#include <ztest.h>
+#include <net/download_client.h>
+#include <native_rtc.h>
+
+#include "test_server.h"
+
+#define HTTP_SERVER "http://" SERVER_ADDR ":" STRINGIFY(HTTP_PORT)
+#define COAP_SERVER "coap://" SERVER_ADDR ":" STRINGIFY(COAP_PORT)
+#define FILE_PATH "fw/file.bin"
+
+static struct download_client client;
+static K_SEM_DEFINE(download_done, 0, 1);
+
+static size_t received;
+static size_t frag_cnt;
+static size_t mismatch_cnt;
+static int last_error;
+static bool done;
+
+static int callback(const struct download_client_evt *event)
+{
+	switch (event->id) {
+	case DOWNLOAD_CLIENT_EVT_FRAGMENT: {
+		const uint8_t *buf = event->fragment.buf;
+
+		for (size_t i = 0; i < event->fragment.len; i++) {
+			if (buf[i] != pattern(received + i)) {
+				mismatch_cnt++;
+			}
+		}
+
+		received += event->fragment.len;
+		frag_cnt++;
+		return 0;
+	}
+	case DOWNLOAD_CLIENT_EVT_DONE:
+		done = true;
+		k_sem_give(&download_done);
+		return 0;
+	case DOWNLOAD_CLIENT_EVT_ERROR:
+		last_error = event->error;
+		k_sem_give(&download_done);
+		/* Stop the download */
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+static void download(const char *server, size_t from)
+{
+	struct download_client_cfg config = {
+		.sec_tag = -1,
+	};
+	uint64_t start;
+	int err;
+
+	received = from;
+	frag_cnt = 0;
+	mismatch_cnt = 0;
+	last_error = 0;
+	done = false;
+
+	err = download_client_connect(&client, server, &config);
+	zassert_equal(err, 0, "Failed to connect, err %d", err);
+
+	start = native_rtc_gettime_us(RTC_CLOCK_REAL);
+
+	err = download_client_start(&client, FILE_PATH, from);
+	zassert_equal(err, 0, "Failed to start download, err %d", err);
+
+	err = k_sem_take(&download_done, K_SECONDS(120));
+	zassert_equal(err, 0, "Download timed out");
+
+	TC_PRINT("Downloaded %d bytes from %s in %d fragments, %d ms\n",
+		 received - from, server, frag_cnt,
+		 (int)((native_rtc_gettime_us(RTC_CLOCK_REAL) - start) / 1000));
+
+	zassert_equal(last_error, 0, "Download failed, err %d", last_error);
+	zassert_true(done, "Download not completed");
+	zassert_equal(received, FILE_SIZE, "Received %d bytes", received);
+	zassert_equal(client.file_size, FILE_SIZE, "Wrong file size");
+	zassert_equal(mismatch_cnt, 0, "%d bytes corrupted or out of order", mismatch_cnt);
+
+	if (strncmp(server, "http", 4) == 0) {
+		/* Every fragment but the last one is whole */
+		zassert_equal(frag_cnt,
+			      DIV_ROUND_UP(FILE_SIZE - from, CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE),
+			      "Body not delivered in whole fragments");
+	}
+
+	err = download_client_disconnect(&client);
+	zassert_equal(err, 0, "Failed to disconnect, err %d", err);
+}
+
+static void test_download(void)
+{
+	download(HTTP_SERVER, 0);
+}
+
+static void test_download_resume(void)
+{
+	/* Not aligned to the fragment size */
+	download(HTTP_SERVER, FILE_SIZE / 3);
+}
+
+static void test_download_last_fragment(void)
+{
+	download(HTTP_SERVER, FILE_SIZE - 100);
+}
+
+static void test_download_connection_close(void)
+{
+	/* The client reconnects and requests the lost ranges again */
+	http_server_close_every(5);
+	download(HTTP_SERVER, 0);
+	http_server_close_every(0);
+}
+
+static void test_coap_download(void)
+{
+	if (!IS_ENABLED(CONFIG_COAP)) {
+		ztest_test_skip();
+	}
+
+	uint32_t dropped = coap_server_dropped();
+
+	download(COAP_SERVER, 0);
+
+	/* The lost responses were recovered by retransmitting their requests */
+	zassert_true(coap_server_dropped() > dropped, "No response was dropped");
+}
+
+static void test_coap_download_resume(void)
+{
+	if (!IS_ENABLED(CONFIG_COAP)) {
+		ztest_test_skip();
+	}
+
+	/* Not aligned to the block size */
+	download(COAP_SERVER, FILE_SIZE / 3);
+}
+
+void test_main(void)
+{
+	int err;
+
+	/* Started first, so that the server owns the lowest file descriptor */
+	http_server_start();
+#if defined(CONFIG_COAP)
+	coap_server_start();
+#endif
+
+	err = download_client_init(&client, callback);
+	zassert_equal(err, 0, "Failed to initialize, err %d", err);
+
+	ztest_test_suite(download_client_test,
+			 ztest_unit_test(test_download),
+			 ztest_unit_test(test_download_resume),
+			 ztest_unit_test(test_download_last_fragment),
+			 ztest_unit_test(test_download_connection_close),
+			 ztest_unit_test(test_coap_download),
+			 ztest_unit_test(test_coap_download_resume)
+			 );
+	ztest_run_test_suite(download_client_test);
+}
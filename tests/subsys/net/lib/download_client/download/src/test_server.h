@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef TEST_SERVER_H__
+#define TEST_SERVER_H__
+
+#include <zephyr.h>
+
+/* The servers run in the test, on the loopback interface */
+#define SERVER_ADDR "127.0.0.1"
+#define HTTP_PORT 8080
+#define COAP_PORT 5683
+
+/* Size of the file served at any path */
+#define FILE_SIZE 65536
+
+/* Delay of every response, simulating the round-trip time of a cellular link */
+#define SERVER_DELAY_MS 100
+
+static inline uint8_t pattern(size_t i)
+{
+	return (uint8_t)((i * 7) + (i >> 8));
+}
+
+/**
+ * @brief Start the HTTP/1.1 server.
+ *
+ * The server answers range requests, and pipelined requests in order.
+ */
+void http_server_start(void);
+
+/**
+ * @brief Close connections after a number of responses.
+ *
+ * @param every Close the connection after every Nth response, or 0 to keep
+ *              connections open.
+ */
+void http_server_close_every(uint32_t every);
+
+/**
+ * @brief Start the CoAP server.
+ *
+ * The server answers Block2 requests after a random delay, so that the
+ * responses arrive out of order, and drops some of them.
+ */
+void coap_server_start(void);
+
+/** @brief Get the number of responses the CoAP server has dropped. */
+uint32_t coap_server_dropped(void);
+
+#endif /* TEST_SERVER_H__ */
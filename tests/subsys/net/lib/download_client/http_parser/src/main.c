@@ -0,0 +1,394 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr.h>
+#include <ztest.h>
+#include <logging/log.h>
+#include <native_rtc.h>
+
+#include "http_parser.h"
+
+LOG_MODULE_REGISTER(download_client, CONFIG_DOWNLOAD_CLIENT_LOG_LEVEL);
+
+#define BODY_SIZE 4096
+
+static const char response_length[] =
+	"HTTP/1.1 200 OK\r\n"
+	"Server: test\r\n"
+	"Content-Type: application/octet-stream\r\n"
+	"CONTENT-LENGTH:   26  \r\n"
+	"\r\n"
+	"abcdefghijklmnopqrstuvwxyz";
+
+static const char response_range[] =
+	"HTTP/1.1 206 Partial Content\r\n"
+	"Content-Range: bytes 100-125/1000\r\n"
+	"Connection: close\r\n"
+	"\r\n"
+	"abcdefghijklmnopqrstuvwxyz";
+
+static const char response_chunked[] =
+	"HTTP/1.1 200 OK\r\n"
+	"Transfer-Encoding: chunked\r\n"
+	"\r\n"
+	"a;name=value\r\n"
+	"abcdefghij\r\n"
+	"0F\r\n"
+	"klmnopqrstuvwxy\r\n"
+	"1\r\n"
+	"z\r\n"
+	"0\r\n"
+	"Trailer: value\r\n"
+	"\r\n";
+
+static const char response_interim[] =
+	"HTTP/1.1 100 Continue\r\n"
+	"\r\n"
+	"HTTP/1.1 200 OK\r\n"
+	"Content-Length: 26\r\n"
+	"\r\n"
+	"abcdefghijklmnopqrstuvwxyz";
+
+static const char response_no_content[] =
+	"HTTP/1.1 204 No Content\r\n"
+	"Content-Length: 26\r\n"
+	"\r\n";
+
+static const char *const malformed[] = {
+	"HTTP/2 200 OK\r\n\r\n",
+	"HTTP/1.1 2x0 OK\r\n\r\n",
+	"HTTP/1.1 200 OK\r\nContent-Length: 12a\r\n\r\n",
+	"HTTP/1.1 200 OK\r\nContent-Length: -1\r\n\r\n",
+	"HTTP/1.1 200 OK\r\nContent-Length: 123456789012345678901234567890123456789012\r\n\r\n",
+	"HTTP/1.1 206 OK\r\nContent-Range: bytes 10-5/100\r\n\r\n",
+	"HTTP/1.1 206 OK\r\nContent-Range: bytes 0-5/*\r\n\r\n",
+	"HTTP/1.1 206 OK\r\nContent-Range: items 0-5/100\r\n\r\n",
+	"HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\nxyz\r\n",
+	"HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n\r\n",
+	"HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n2\r\nabc\r\n",
+	"HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n11111111111111111111\r\n",
+};
+
+struct result {
+	int rc;
+	size_t consumed;
+	size_t headers;
+	size_t body_len;
+	char body[BODY_SIZE];
+};
+
+static struct download_client_http_parser parser;
+static struct result result;
+static uint32_t rand_state = 0x12345678;
+
+/* Reproducible pseudo-random numbers, xorshift32 */
+static uint32_t rand_get(void)
+{
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+
+	return rand_state;
+}
+
+/* Feed one response in pieces of at most max_len bytes, or random lengths
+ * if max_len is zero. Stops at the end of the response or on error.
+ */
+static void parse(const char *data, size_t len, size_t max_len)
+{
+	const char *body;
+	size_t body_len;
+	size_t consumed;
+	size_t piece;
+	size_t off = 0;
+
+	memset(&result, 0, sizeof(result));
+	http_parser_init(&parser);
+
+	while (off < len || result.rc == HTTP_PARSER_HEADER || result.rc == HTTP_PARSER_BODY) {
+		piece = max_len ? max_len : 1 + rand_get() % 64;
+		piece = MIN(piece, len - off);
+
+		result.rc = http_parser_feed(&parser, data + off, piece, &consumed, &body,
+					     &body_len);
+
+		zassert_true(consumed <= piece, "Consumed more than fed");
+		off += consumed;
+
+		if (result.rc < 0 || result.rc == HTTP_PARSER_DONE) {
+			break;
+		} else if (result.rc == HTTP_PARSER_HEADER) {
+			result.headers++;
+		} else if (result.rc == HTTP_PARSER_BODY) {
+			zassert_true(body >= data && body + body_len <= data + len,
+				     "Body outside of the data");
+			zassert_true(body_len > 0, "Empty body span");
+
+			if (result.body_len + body_len <= sizeof(result.body)) {
+				memcpy(result.body + result.body_len, body, body_len);
+			}
+			result.body_len += body_len;
+		} else {
+			zassert_equal(consumed, piece, "Data left without result");
+			if (piece == 0) {
+				break;
+			}
+		}
+	}
+
+	result.consumed = off;
+}
+
+static void parse_all_ways(const char *data, size_t len)
+{
+	static struct result first;
+
+	parse(data, len, len);
+	first = result;
+
+	for (size_t max_len = 1; max_len < 8; max_len++) {
+		parse(data, len, max_len);
+		zassert_equal(result.rc, first.rc, "Result depends on split (%d)", max_len);
+		zassert_equal(result.body_len, first.body_len, "Body depends on split");
+		zassert_mem_equal(result.body, first.body, first.body_len, "Body corrupted");
+	}
+
+	for (size_t i = 0; i < 100; i++) {
+		parse(data, len, 0);
+		zassert_equal(result.rc, first.rc, "Result depends on split");
+		zassert_equal(result.body_len, first.body_len, "Body depends on split");
+		zassert_mem_equal(result.body, first.body, first.body_len, "Body corrupted");
+	}
+}
+
+static void test_content_length(void)
+{
+	parse_all_ways(response_length, strlen(response_length));
+
+	zassert_equal(result.rc, HTTP_PARSER_DONE, "Not done");
+	zassert_equal(result.headers, 1, "No header");
+	zassert_equal(parser.status, 200, "Wrong status");
+	zassert_true(parser.has_length, "No length");
+	zassert_equal(parser.content_length, 26, "Wrong length");
+	zassert_false(parser.connection_close, "Wrong connection");
+	zassert_equal(result.body_len, 26, "Wrong body length");
+	zassert_mem_equal(result.body, "abcdefghijklmnopqrstuvwxyz", 26, "Wrong body");
+	zassert_true(http_parser_done(&parser), "Not done");
+}
+
+static void test_content_range(void)
+{
+	parse_all_ways(response_range, strlen(response_range));
+
+	zassert_equal(result.rc, HTTP_PARSER_DONE, "Not done");
+	zassert_equal(parser.status, 206, "Wrong status");
+	zassert_true(parser.has_range, "No range");
+	zassert_equal(parser.range_first, 100, "Wrong range");
+	zassert_equal(parser.range_last, 125, "Wrong range");
+	zassert_equal(parser.range_total, 1000, "Wrong range");
+	zassert_true(parser.connection_close, "Wrong connection");
+	zassert_equal(result.body_len, 26, "Wrong body length");
+}
+
+static void test_chunked(void)
+{
+	parse_all_ways(response_chunked, strlen(response_chunked));
+
+	zassert_equal(result.rc, HTTP_PARSER_DONE, "Not done");
+	zassert_true(parser.chunked, "Not chunked");
+	zassert_equal(result.consumed, strlen(response_chunked), "Trailer not consumed");
+	zassert_equal(result.body_len, 26, "Wrong body length");
+	zassert_mem_equal(result.body, "abcdefghijklmnopqrstuvwxyz", 26, "Wrong body");
+}
+
+static void test_keep_alive(void)
+{
+	static char data[3 * sizeof(response_chunked)];
+	size_t len_1 = strlen(response_length);
+	size_t len_2 = strlen(response_chunked);
+
+	/* Pipelined responses, received together */
+	memcpy(data, response_length, len_1);
+	memcpy(data + len_1, response_chunked, len_2);
+
+	parse(data, len_1 + len_2, 5);
+	zassert_equal(result.rc, HTTP_PARSER_DONE, "Not done");
+	zassert_equal(result.consumed, len_1, "Next response consumed");
+
+	parse(data + len_1, len_2, 5);
+	zassert_equal(result.rc, HTTP_PARSER_DONE, "Not done");
+	zassert_equal(result.body_len, 26, "Wrong body length");
+}
+
+static void test_interim(void)
+{
+	parse_all_ways(response_interim, strlen(response_interim));
+
+	zassert_equal(result.rc, HTTP_PARSER_DONE, "Not done");
+	zassert_equal(result.headers, 1, "Interim header reported");
+	zassert_equal(parser.status, 200, "Wrong status");
+	zassert_equal(result.body_len, 26, "Wrong body length");
+}
+
+static void test_no_content(void)
+{
+	parse_all_ways(response_no_content, strlen(response_no_content));
+
+	zassert_equal(result.rc, HTTP_PARSER_DONE, "Not done");
+	zassert_equal(parser.status, 204, "Wrong status");
+	zassert_equal(result.body_len, 0, "Body in 204 response");
+}
+
+static void test_long_header(void)
+{
+	static char data[8192];
+	size_t len;
+
+	/* Much longer than the download client buffer */
+	len = snprintf(data, sizeof(data), "HTTP/1.1 200 OK\r\n");
+	for (int i = 0; i < 100; i++) {
+		len += snprintf(data + len, sizeof(data) - len,
+				"X-Field-%d: %s\r\n", i,
+				"a value longer than the value buffer of the parser");
+	}
+	len += snprintf(data + len, sizeof(data) - len,
+			"Connection: keep-alive, close\r\nContent-Length: 3\r\n\r\nabc");
+
+	parse_all_ways(data, len);
+
+	zassert_equal(result.rc, HTTP_PARSER_DONE, "Not done");
+	zassert_true(parser.connection_close, "Wrong connection");
+	zassert_equal(result.body_len, 3, "Wrong body length");
+}
+
+static void test_malformed(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(malformed); i++) {
+		parse_all_ways(malformed[i], strlen(malformed[i]));
+		zassert_equal(result.rc, -EBADMSG, "Accepted malformed response %d", i);
+	}
+}
+
+/* Random mutations of valid responses must not crash or hang the parser,
+ * and body spans must stay within the data.
+ */
+static void test_fuzz(void)
+{
+	static const char *const seeds[] = {
+		response_length, response_range, response_chunked, response_interim,
+	};
+	static char data[256];
+	size_t len;
+	size_t errors = 0;
+
+	for (size_t i = 0; i < 20000; i++) {
+		const char *seed = seeds[i % ARRAY_SIZE(seeds)];
+
+		len = strlen(seed);
+		memcpy(data, seed, len);
+
+		for (int m = 1 + rand_get() % 4; m > 0 && len > 0; m--) {
+			size_t pos = rand_get() % len;
+
+			switch (rand_get() % 4) {
+			case 0:
+				data[pos] = rand_get();
+				break;
+			case 1:
+				data[pos] = "\r\n:;- 0129aF/*"[rand_get() % 14];
+				break;
+			case 2:
+				/* Truncate */
+				len = pos;
+				break;
+			default:
+				/* Duplicate a byte */
+				if (len < sizeof(data)) {
+					memmove(data + pos + 1, data + pos, len - pos);
+					len++;
+				}
+				break;
+			}
+		}
+
+		parse(data, len, 0);
+		if (result.rc < 0) {
+			errors++;
+		}
+	}
+
+	TC_PRINT("%d of 20000 mutated responses rejected\n", errors);
+}
+
+static void test_benchmark(void)
+{
+	static char data[16384 + 256];
+	static const size_t feed_sizes[] = { 1, 16, 128, 1024, 4096 };
+	const char *body;
+	size_t body_len;
+	size_t consumed;
+	size_t hdr_len;
+	size_t len;
+	uint64_t start;
+	uint64_t elapsed;
+	int rc;
+
+	/* A chunked response with 512 byte chunks */
+	len = hdr_len = snprintf(data, sizeof(data),
+				 "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n");
+	while (len + 512 + 16 < sizeof(data) - 8) {
+		len += snprintf(data + len, sizeof(data) - len, "200\r\n");
+		memset(data + len, 'x', 512);
+		len += 512;
+		len += snprintf(data + len, sizeof(data) - len, "\r\n");
+	}
+	len += snprintf(data + len, sizeof(data) - len, "0\r\n\r\n");
+
+	for (size_t i = 0; i < ARRAY_SIZE(feed_sizes); i++) {
+		const size_t rounds = 200;
+
+		start = native_rtc_gettime_us(RTC_CLOCK_REAL);
+
+		for (size_t r = 0; r < rounds; r++) {
+			size_t off = 0;
+
+			http_parser_init(&parser);
+
+			do {
+				rc = http_parser_feed(&parser, data + off,
+						      MIN(feed_sizes[i], len - off), &consumed,
+						      &body, &body_len);
+				off += consumed;
+			} while (rc >= 0 && rc != HTTP_PARSER_DONE);
+
+			zassert_equal(rc, HTTP_PARSER_DONE, "Not done");
+		}
+
+		elapsed = MAX(native_rtc_gettime_us(RTC_CLOCK_REAL) - start, 1);
+
+		TC_PRINT("Feeding %4d bytes at a time: %6d kB/s, header %d bytes\n",
+			 feed_sizes[i], (int)((uint64_t)len * rounds * 1000 / 1024 / elapsed),
+			 hdr_len);
+	}
+}
+
+void test_main(void)
+{
+	ztest_test_suite(http_parser_test,
+			 ztest_unit_test(test_content_length),
+			 ztest_unit_test(test_content_range),
+			 ztest_unit_test(test_chunked),
+			 ztest_unit_test(test_keep_alive),
+			 ztest_unit_test(test_interim),
+			 ztest_unit_test(test_no_content),
+			 ztest_unit_test(test_long_header),
+			 ztest_unit_test(test_malformed),
+			 ztest_unit_test(test_fuzz),
+			 ztest_unit_test(test_benchmark)
+			 );
+	ztest_run_test_suite(http_parser_test);
+}
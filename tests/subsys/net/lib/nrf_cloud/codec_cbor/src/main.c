@@ -0,0 +1,458 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <zephyr.h>
+#include <string.h>
+#include <cJSON.h>
+#include <cJSON_os.h>
+
+#include "nrf_cloud_codec.h"
+#include "nrf_cloud_mem.h"
+#include "nrf_cloud_transport.h"
+
+#define DATA_STR "{\"lat\":63.42,\"lon\":10.44}"
+
+#define SENSOR_DATA_JSON							\
+	"{"									\
+		"\"appId\":\"GPS\","						\
+		"\"data\":\"" "{\\\"lat\\\":63.42,\\\"lon\\\":10.44}" "\","		\
+		"\"messageType\":\"DATA\""					\
+	"}"
+
+static struct lte_lc_ncell ncells[] = {
+	{ .earfcn = 6300, .phys_cell_id = 101, .rsrp = 34, .rsrq = 11 },
+	{ .earfcn = 6400, .phys_cell_id = 102, .rsrp = NRF_CLOUD_CELL_POS_OMIT_RSRP,
+	  .rsrq = NRF_CLOUD_CELL_POS_OMIT_RSRQ },
+};
+
+static struct lte_lc_cells_info cells;
+
+/* Stubs and mocks */
+static uint8_t sent_buf[256];
+static size_t sent_len;
+static int sent_count;
+
+static int sent_save(const struct nrf_cloud_data *data)
+{
+	zassert_true(data->len <= sizeof(sent_buf), "Message too long");
+	memcpy(sent_buf, data->ptr, data->len);
+	sent_len = data->len;
+	sent_count++;
+
+	return 0;
+}
+
+int nct_dc_send(const struct nct_dc_data *dc)
+{
+	return sent_save(&dc->data);
+}
+
+int nct_dc_stream(const struct nct_dc_data *dc)
+{
+	return sent_save(&dc->data);
+}
+
+int nct_cc_send(const struct nct_cc_data *cc)
+{
+	return sent_save(&cc->data);
+}
+
+int nct_dc_bulk_send(const struct nct_dc_data *dc_data, enum mqtt_qos qos)
+{
+	return sent_save(&dc_data->data);
+}
+
+int nct_init(const char *const client_id)
+{
+	return 0;
+}
+
+void nct_uninit(void)
+{
+}
+
+int nct_connect(void)
+{
+	return 0;
+}
+
+int nct_disconnect(void)
+{
+	return 0;
+}
+
+int nct_process(void)
+{
+	return 0;
+}
+
+int nct_tenant_id_get(char *cur_tenant, const int cur_tenant_len)
+{
+	return -ENOTSUP;
+}
+
+void nct_set_topic_prefix(const char *topic_prefix)
+{
+}
+
+void nct_dc_endpoint_get(struct nrf_cloud_data *tx_endpoint, struct nrf_cloud_data *rx_endpoint,
+			 struct nrf_cloud_data *bulk_endpoint, struct nrf_cloud_data *m_endpoint)
+{
+}
+
+int nfsm_init(void)
+{
+	return 0;
+}
+
+int nfsm_handle_incoming_event(const struct nct_evt *evt, enum nfsm_state current_state)
+{
+	return 0;
+}
+
+int modem_info_init(void)
+{
+	return -ENOTSUP;
+}
+
+int modem_info_params_init(struct modem_param_info *modem_param)
+{
+	return -ENOTSUP;
+}
+
+int modem_info_params_get(struct modem_param_info *modem_param)
+{
+	return -ENOTSUP;
+}
+/* END stubs and mocks */
+
+/* Decode CBOR into cJSON objects, to compare it with the JSON messages. */
+
+static const uint8_t *cbor_pos;
+
+static uint64_t cbor_arg(uint8_t info)
+{
+	uint64_t arg = 0;
+
+	if (info < 24) {
+		return info;
+	}
+
+	zassert_true(info <= 27, "Unexpected additional information %d", info);
+
+	for (size_t i = 0; i < BIT(info - 24); i++) {
+		arg = (arg << 8) | *cbor_pos++;
+	}
+
+	return arg;
+}
+
+static void cbor_str(char *str, size_t size, uint8_t initial)
+{
+	uint64_t len;
+
+	zassert_equal(initial >> 5, 3, "Not a text string");
+
+	len = cbor_arg(initial & 0x1f);
+	zassert_true(len < size, "String too long");
+
+	memcpy(str, cbor_pos, len);
+	str[len] = '\0';
+	cbor_pos += len;
+}
+
+static cJSON *cbor_item(void)
+{
+	const uint8_t initial = *cbor_pos++;
+	const uint8_t info = initial & 0x1f;
+	char str[128];
+	cJSON *item;
+	uint64_t count;
+	uint32_t bits32;
+	uint64_t bits64;
+	float value32;
+	double value64;
+
+	switch (initial >> 5) {
+	case 0:
+		return cJSON_CreateNumber(cbor_arg(info));
+	case 1:
+		return cJSON_CreateNumber(-1 - (int64_t)cbor_arg(info));
+	case 3:
+		cbor_str(str, sizeof(str), initial);
+		return cJSON_CreateString(str);
+	case 4:
+		zassert_not_equal(info, 31, "Array is indefinite");
+		item = cJSON_CreateArray();
+		for (count = cbor_arg(info); count > 0; count--) {
+			cJSON_AddItemToArray(item, cbor_item());
+		}
+		return item;
+	case 5:
+		zassert_not_equal(info, 31, "Map is indefinite");
+		item = cJSON_CreateObject();
+		for (count = cbor_arg(info); count > 0; count--) {
+			cbor_str(str, sizeof(str), *cbor_pos++);
+			cJSON_AddItemToObject(item, str, cbor_item());
+		}
+		return item;
+	default:
+		break;
+	}
+
+	switch (initial) {
+	case 0xfa:
+		bits32 = cbor_arg(26);
+		memcpy(&value32, &bits32, sizeof(value32));
+		return cJSON_CreateNumber(value32);
+	case 0xfb:
+		bits64 = cbor_arg(27);
+		memcpy(&value64, &bits64, sizeof(value64));
+		return cJSON_CreateNumber(value64);
+	default:
+		zassert_unreachable("Unexpected initial byte 0x%02x", initial);
+		return NULL;
+	}
+}
+
+/* Decode the message, and compare it with the JSON message */
+static void check_cbor(const uint8_t *buf, size_t len, const char *expected)
+{
+	cJSON *root_obj;
+	char *decoded;
+
+	cbor_pos = buf;
+	root_obj = cbor_item();
+	zassert_equal_ptr(cbor_pos, buf + len, "Trailing output");
+
+	decoded = cJSON_PrintUnformatted(root_obj);
+	zassert_not_null(decoded, "Decoded buffer is NULL");
+	zassert_equal(strcmp(decoded, expected), 0, "Wrong message %s", decoded);
+	zassert_true(len < strlen(expected), "CBOR not smaller than JSON");
+
+	TC_PRINT("JSON: %zu bytes, CBOR: %zu bytes\n", strlen(expected), len);
+
+	cJSON_FreeString(decoded);
+	cJSON_Delete(root_obj);
+}
+
+static void check_output(struct nrf_cloud_data *output, const char *expected)
+{
+	check_cbor(output->ptr, output->len, expected);
+	nrf_cloud_free((void *)output->ptr);
+}
+
+static bool output_contains(const struct nrf_cloud_data *output, const uint8_t *data,
+			    size_t data_len)
+{
+	const uint8_t *buf = output->ptr;
+
+	for (size_t i = 0; i + data_len <= output->len; i++) {
+		if (memcmp(&buf[i], data, data_len) == 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void cells_init(void)
+{
+	cells = (struct lte_lc_cells_info) {
+		.current_cell = {
+			.mcc = 242,
+			.mnc = 1,
+			.id = 21858829,
+			.tac = 333,
+			.earfcn = NRF_CLOUD_CELL_POS_OMIT_EARFCN,
+			.timing_advance = NRF_CLOUD_CELL_POS_OMIT_TIME_ADV,
+			.rsrp = NRF_CLOUD_CELL_POS_OMIT_RSRP,
+			.rsrq = NRF_CLOUD_CELL_POS_OMIT_RSRQ,
+		},
+	};
+}
+
+static void test_sensor_data(void)
+{
+	const char *expected = SENSOR_DATA_JSON;
+	const struct nrf_cloud_data data = {
+		.ptr = DATA_STR,
+		.len = strlen(DATA_STR),
+	};
+	struct nrf_cloud_data output;
+	int err;
+
+	err = nrf_cloud_cbor_encode_sensor_data(NRF_CLOUD_JSON_APPID_VAL_GPS, &data, &output);
+	zassert_equal(0, err, "Return value %d is wrong", err);
+	check_output(&output, expected);
+}
+
+/* Sensor data is sent and streamed in CBOR, while shadow updates stay in JSON */
+static void test_sensor_data_send(void)
+{
+	const struct nrf_cloud_sensor_data sensor = {
+		.type = NRF_CLOUD_SENSOR_GPS,
+		.data = {
+			.ptr = DATA_STR,
+			.len = strlen(DATA_STR),
+		},
+	};
+	int err;
+
+	nfsm_set_current_state_and_notify(STATE_DC_CONNECTED, NULL);
+	sent_count = 0;
+
+	err = nrf_cloud_sensor_data_send(&sensor);
+	zassert_equal(0, err, "Return value %d is wrong", err);
+	zassert_equal(sent_count, 1, "Message not sent");
+	check_cbor(sent_buf, sent_len, SENSOR_DATA_JSON);
+
+	err = nrf_cloud_sensor_data_stream(&sensor);
+	zassert_equal(0, err, "Return value %d is wrong", err);
+	zassert_equal(sent_count, 2, "Message not streamed");
+	check_cbor(sent_buf, sent_len, SENSOR_DATA_JSON);
+
+	err = nrf_cloud_shadow_update(&sensor);
+	zassert_equal(0, err, "Return value %d is wrong", err);
+	zassert_equal(sent_count, 3, "Shadow update not sent");
+	zassert_equal(sent_buf[0], '{', "Shadow update is not JSON");
+
+	nfsm_set_current_state_and_notify(STATE_IDLE, NULL);
+}
+
+static void test_cell_pos_required(void)
+{
+	const char *expected =
+		"{"
+			"\"appId\":\"CELL_POS\","
+			"\"messageType\":\"DATA\","
+			"\"data\":{"
+				"\"lte\":[{"
+					"\"eci\":21858829,"
+					"\"mcc\":242,"
+					"\"mnc\":1,"
+					"\"tac\":333"
+				"}]"
+			"}"
+		"}";
+	struct nrf_cloud_data output;
+	int err;
+
+	cells_init();
+
+	err = nrf_cloud_cbor_encode_cell_pos_req(&cells, true, &output);
+	zassert_equal(0, err, "Return value %d is wrong", err);
+	check_output(&output, expected);
+}
+
+static void test_cell_pos_optional(void)
+{
+	const char *expected =
+		"{"
+			"\"appId\":\"CELL_POS\","
+			"\"messageType\":\"DATA\","
+			"\"data\":{"
+				"\"lte\":[{"
+					"\"eci\":21858829,"
+					"\"mcc\":242,"
+					"\"mnc\":1,"
+					"\"tac\":333,"
+					"\"earfcn\":6200,"
+					"\"rsrp\":-97,"
+					"\"rsrq\":-10.5,"
+					"\"adv\":20512,"
+					"\"nmr\":["
+						"{"
+							"\"earfcn\":6300,"
+							"\"pci\":101,"
+							"\"rsrp\":-107,"
+							"\"rsrq\":-14"
+						"},{"
+							"\"earfcn\":6400,"
+							"\"pci\":102"
+						"}"
+					"]"
+				"}],"
+				"\"doReply\":0"
+			"}"
+		"}";
+	/* RSRQ of -10.5 dB is a single precision float */
+	const uint8_t rsrq[] = { 0xfa, 0xc1, 0x28, 0x00, 0x00 };
+	struct nrf_cloud_data output;
+	int err;
+
+	cells_init();
+	cells.current_cell.earfcn = 6200;
+	cells.current_cell.rsrp = 44;
+	cells.current_cell.rsrq = 18;
+	/* Clamped to the maximum */
+	cells.current_cell.timing_advance = NRF_CLOUD_CELL_POS_TIME_ADV_MAX + 1;
+	cells.ncells_count = ARRAY_SIZE(ncells);
+	cells.neighbor_cells = ncells;
+
+	err = nrf_cloud_cbor_encode_cell_pos_req(&cells, false, &output);
+	zassert_equal(0, err, "Return value %d is wrong", err);
+	zassert_true(output_contains(&output, rsrq, sizeof(rsrq)), "No RSRQ");
+	check_output(&output, expected);
+}
+
+static void test_cell_pos_no_ncells(void)
+{
+	const char *expected =
+		"{"
+			"\"appId\":\"CELL_POS\","
+			"\"messageType\":\"DATA\","
+			"\"data\":{"
+				"\"lte\":[{"
+					"\"eci\":21858829,"
+					"\"mcc\":242,"
+					"\"mnc\":1,"
+					"\"tac\":333"
+				"}]"
+			"}"
+		"}";
+	struct nrf_cloud_data output;
+	int err;
+
+	/* The neighbor cells are left out if there is no buffer, like in JSON */
+	cells_init();
+	cells.ncells_count = ARRAY_SIZE(ncells);
+
+	err = nrf_cloud_cbor_encode_cell_pos_req(&cells, true, &output);
+	zassert_equal(0, err, "Return value %d is wrong", err);
+	check_output(&output, expected);
+}
+
+static void test_cell_pos_invalid(void)
+{
+	struct nrf_cloud_data output;
+	int err;
+
+	err = nrf_cloud_cbor_encode_cell_pos_req(NULL, true, &output);
+	zassert_equal(-EINVAL, err, "Return value %d is wrong", err);
+
+	cells_init();
+
+	err = nrf_cloud_cbor_encode_cell_pos_req(&cells, true, NULL);
+	zassert_equal(-EINVAL, err, "Return value %d is wrong", err);
+}
+
+void test_main(void)
+{
+	cJSON_Init();
+
+	ztest_test_suite(nrf_cloud_codec_cbor,
+		ztest_unit_test(test_sensor_data),
+		ztest_unit_test(test_sensor_data_send),
+		ztest_unit_test(test_cell_pos_required),
+		ztest_unit_test(test_cell_pos_optional),
+		ztest_unit_test(test_cell_pos_no_ncells),
+		ztest_unit_test(test_cell_pos_invalid)
+	);
+
+	ztest_run_test_suite(nrf_cloud_codec_cbor);
+}
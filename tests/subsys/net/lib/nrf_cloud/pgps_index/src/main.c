@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <zephyr.h>
+#include <string.h>
+#include <sys/crc.h>
+#include <native_rtc.h>
+
+#include "nrf_cloud_pgps_utils.h"
+
+#define STORAGE_BLOCK_SIZE	2048
+#define PERIOD_SEC		(240 * SEC_PER_MIN)
+#define START_SEC		1318000000LL
+#define FIRST_BLOCK		10
+
+/* Stands in for the memory mapped flash holding the predictions */
+static uint8_t storage[NUM_BLOCKS][STORAGE_BLOCK_SIZE];
+
+static struct npgps_index saved;
+
+/* Stubs and mocks */
+void *npgps_block_to_pointer(int block)
+{
+	return storage[block];
+}
+/* END stubs and mocks */
+
+static uint32_t pnum_to_sec(int pnum)
+{
+	return START_SEC + pnum * PERIOD_SEC;
+}
+
+/* Predictions are stored circularly, starting from FIRST_BLOCK */
+static int pnum_to_block(int pnum)
+{
+	return (pnum + FIRST_BLOCK) % NUM_BLOCKS;
+}
+
+static void store_all(void)
+{
+	npgps_index_reset();
+
+	for (int pnum = 0; pnum < NUM_PREDICTIONS; pnum++) {
+		int block = pnum_to_block(pnum);
+
+		for (size_t i = 0; i < STORAGE_BLOCK_SIZE; i++) {
+			storage[block][i] = (uint8_t)(pnum * 31 + i);
+		}
+		npgps_index_set(block, pnum_to_sec(pnum),
+				crc32_ieee(storage[block], STORAGE_BLOCK_SIZE));
+	}
+
+	memcpy(&saved, npgps_index_get(), sizeof(saved));
+}
+
+static void check_map(const int *blocks, int count)
+{
+	for (int pnum = 0; pnum < count; pnum++) {
+		zassert_equal(blocks[pnum], pnum_to_block(pnum),
+			      "Prediction num:%d in block:%d", pnum, blocks[pnum]);
+	}
+}
+
+static void test_map(void)
+{
+	int blocks[NUM_PREDICTIONS];
+	int num;
+
+	store_all();
+
+	num = npgps_index_map(START_SEC, PERIOD_SEC, NUM_PREDICTIONS, blocks);
+	zassert_equal(num, NUM_PREDICTIONS, "Mapped %d", num);
+	check_map(blocks, NUM_PREDICTIONS);
+}
+
+static void test_map_partial(void)
+{
+	int blocks[NUM_PREDICTIONS];
+	int num;
+
+	store_all();
+	npgps_index_clear(pnum_to_block(5));
+
+	num = npgps_index_map(START_SEC, PERIOD_SEC, NUM_PREDICTIONS, blocks);
+	zassert_equal(num, NUM_PREDICTIONS - 1, "Mapped %d", num);
+	zassert_equal(blocks[5], NO_BLOCK, "Cleared prediction is mapped");
+	check_map(blocks, 5);
+}
+
+static void test_map_stale(void)
+{
+	const struct npgps_index *index;
+	int blocks[NUM_PREDICTIONS];
+	int num;
+
+	store_all();
+
+	/* The first two predictions have expired */
+	num = npgps_index_map(pnum_to_sec(2), PERIOD_SEC, NUM_PREDICTIONS - 2, blocks);
+	zassert_equal(num, NUM_PREDICTIONS - 2, "Mapped %d", num);
+	for (int pnum = 0; pnum < NUM_PREDICTIONS - 2; pnum++) {
+		zassert_equal(blocks[pnum], pnum_to_block(pnum + 2), "Wrong block");
+	}
+
+	index = npgps_index_get();
+	zassert_equal(index->entries[pnum_to_block(0)].sentinel, 0, "Stale entry");
+	zassert_equal(index->entries[pnum_to_block(1)].sentinel, 0, "Stale entry");
+
+	/* Not on a prediction boundary */
+	store_all();
+	npgps_index_set(pnum_to_block(3), pnum_to_sec(3) + 1, 0);
+	num = npgps_index_map(START_SEC, PERIOD_SEC, NUM_PREDICTIONS, blocks);
+	zassert_equal(num, NUM_PREDICTIONS - 1, "Mapped %d", num);
+	zassert_equal(blocks[3], NO_BLOCK, "Misaligned prediction is mapped");
+}
+
+static void test_map_duplicate(void)
+{
+	int blocks[NUM_PREDICTIONS];
+	int num;
+
+	store_all();
+	npgps_index_set(pnum_to_block(7), pnum_to_sec(6), 0);
+
+	num = npgps_index_map(START_SEC, PERIOD_SEC, NUM_PREDICTIONS, blocks);
+	zassert_equal(num, NUM_PREDICTIONS - 1, "Mapped %d", num);
+	zassert_equal(blocks[6], pnum_to_block(6), "Wrong block for duplicate");
+	zassert_equal(blocks[7], NO_BLOCK, "Duplicate is mapped");
+}
+
+static void test_restore(void)
+{
+	int blocks[NUM_PREDICTIONS];
+	int err;
+	int num;
+
+	store_all();
+	npgps_index_reset();
+
+	err = npgps_index_restore(&saved);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+
+	num = npgps_index_map(START_SEC, PERIOD_SEC, NUM_PREDICTIONS, blocks);
+	zassert_equal(num, NUM_PREDICTIONS, "Mapped %d", num);
+	check_map(blocks, NUM_PREDICTIONS);
+}
+
+static void test_restore_invalid(void)
+{
+	int blocks[NUM_PREDICTIONS];
+	int err;
+	int num;
+
+	store_all();
+
+	/* Nothing saved yet */
+	saved.version = 0;
+	err = npgps_index_restore(&saved);
+	zassert_equal(err, -ENOENT, "Return value %d is wrong", err);
+
+	num = npgps_index_map(START_SEC, PERIOD_SEC, NUM_PREDICTIONS, blocks);
+	zassert_equal(num, 0, "Mapped %d", num);
+
+	/* Different number of predictions */
+	saved.version = NPGPS_INDEX_VERSION;
+	saved.num_blocks = NUM_BLOCKS - 1;
+	err = npgps_index_restore(&saved);
+	zassert_equal(err, -ENOENT, "Return value %d is wrong", err);
+}
+
+static void test_verify(void)
+{
+	int block = pnum_to_block(3);
+	int err;
+
+	store_all();
+	err = npgps_index_restore(&saved);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+
+	err = npgps_index_verify(block, storage[block], STORAGE_BLOCK_SIZE);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+
+	/* Corrupted after boot */
+	storage[block][100] ^= 0x01;
+	err = npgps_index_restore(&saved);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+
+	err = npgps_index_verify(block, storage[block], STORAGE_BLOCK_SIZE);
+	zassert_equal(err, -EBADMSG, "Return value %d is wrong", err);
+	zassert_equal(npgps_index_get()->entries[block].sentinel, 0, "Entry not cleared");
+
+	err = npgps_index_verify(block, storage[block], STORAGE_BLOCK_SIZE);
+	zassert_equal(err, -ENOENT, "Return value %d is wrong", err);
+
+	/* A prediction that was written since boot is not read again */
+	npgps_index_set(block, pnum_to_sec(3), 0);
+	err = npgps_index_verify(block, storage[block], STORAGE_BLOCK_SIZE);
+	zassert_equal(err, 0, "Return value %d is wrong", err);
+}
+
+static void test_invalid_block(void)
+{
+	int err;
+
+	store_all();
+
+	err = npgps_index_verify(NO_BLOCK, storage[0], STORAGE_BLOCK_SIZE);
+	zassert_equal(err, -EINVAL, "Return value %d is wrong", err);
+
+	err = npgps_index_verify(NUM_BLOCKS, storage[0], STORAGE_BLOCK_SIZE);
+	zassert_equal(err, -EINVAL, "Return value %d is wrong", err);
+
+	/* Ignored */
+	npgps_index_set(NUM_BLOCKS, pnum_to_sec(0), 0);
+	npgps_index_clear(NO_BLOCK);
+}
+
+/* A saved index gives the catalog that validate_stored_predictions() uses */
+static void test_catalog(void)
+{
+	struct nrf_cloud_pgps_prediction *predictions[NUM_PREDICTIONS];
+	int num;
+
+	store_all();
+	npgps_index_reset();
+
+	num = npgps_index_catalog(&saved, START_SEC, PERIOD_SEC, NUM_PREDICTIONS, predictions);
+	zassert_equal(num, NUM_PREDICTIONS, "Cataloged %d", num);
+	for (int pnum = 0; pnum < NUM_PREDICTIONS; pnum++) {
+		zassert_equal_ptr(predictions[pnum], storage[pnum_to_block(pnum)],
+				  "Wrong location for prediction num:%d", pnum);
+	}
+
+	/* Prediction missing, e.g. download interrupted */
+	saved.entries[pnum_to_block(5)].sentinel = 0;
+	num = npgps_index_catalog(&saved, START_SEC, PERIOD_SEC, NUM_PREDICTIONS, predictions);
+	zassert_equal(num, NUM_PREDICTIONS - 1, "Cataloged %d", num);
+	zassert_is_null(predictions[5], "Missing prediction is cataloged");
+	zassert_equal_ptr(predictions[6], storage[pnum_to_block(6)], "Wrong location");
+
+	/* No index saved; the predictions must be scanned */
+	saved.version = 0;
+	num = npgps_index_catalog(&saved, START_SEC, PERIOD_SEC, NUM_PREDICTIONS, predictions);
+	zassert_equal(num, -ENOENT, "Return value %d is wrong", num);
+	for (int pnum = 0; pnum < NUM_PREDICTIONS; pnum++) {
+		zassert_is_null(predictions[pnum], "Prediction num:%d cataloged", pnum);
+	}
+}
+
+/* Compare building the catalog from the index with reading every stored prediction.
+ * Neither takes any simulated time, so they are timed with the host clock.
+ */
+static void test_boot_time(void)
+{
+	struct nrf_cloud_pgps_prediction *predictions[NUM_PREDICTIONS];
+	uint64_t index_us;
+	uint64_t scan_us;
+	uint64_t start;
+	int num = 0;
+
+	store_all();
+
+	start = native_rtc_gettime_us(RTC_CLOCK_REAL);
+	for (int block = 0; block < NUM_BLOCKS; block++) {
+		if (crc32_ieee(storage[block], STORAGE_BLOCK_SIZE) == saved.entries[block].crc) {
+			num++;
+		}
+	}
+	scan_us = native_rtc_gettime_us(RTC_CLOCK_REAL) - start;
+	zassert_equal(num, NUM_PREDICTIONS, "Scanned %d", num);
+
+	start = native_rtc_gettime_us(RTC_CLOCK_REAL);
+	num = npgps_index_catalog(&saved, START_SEC, PERIOD_SEC, NUM_PREDICTIONS, predictions);
+	index_us = native_rtc_gettime_us(RTC_CLOCK_REAL) - start;
+	zassert_equal(num, NUM_PREDICTIONS, "Cataloged %d", num);
+
+	TC_PRINT("Scan: %llu us, index: %llu us\n", scan_us, index_us);
+	zassert_true(index_us <= scan_us, "Index is slower than a scan");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(nrf_cloud_pgps_index,
+		ztest_unit_test(test_map),
+		ztest_unit_test(test_map_partial),
+		ztest_unit_test(test_map_stale),
+		ztest_unit_test(test_map_duplicate),
+		ztest_unit_test(test_restore),
+		ztest_unit_test(test_restore_invalid),
+		ztest_unit_test(test_verify),
+		ztest_unit_test(test_invalid_block),
+		ztest_unit_test(test_catalog),
+		ztest_unit_test(test_boot_time)
+	);
+
+	ztest_run_test_suite(nrf_cloud_pgps_index);
+}
@@ -0,0 +1,361 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Benchmarks of nRF RPC over the loopback transport. */
+
+#include <ztest.h>
+#include <zephyr.h>
+#include <stdlib.h>
+
+#include <tinycbor/cbor.h>
+#include <nrf_rpc_cbor.h>
+#include <nrf_rpc_loopback.h>
+#include <nrf_rpc_os.h>
+
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+#include <native_rtc.h>
+#endif
+
+#define PAYLOAD_MAX		1024
+#define LATENCY_CALLS		200
+#define EVENT_COUNT		500
+
+/* nRF RPC packet header and CBOR overhead of a call */
+#define CALL_OVERHEAD_MAX	16
+
+#define CLIENT_THREADS		(2 * CONFIG_NRF_RPC_THREAD_POOL_SIZE)
+#define CLIENT_STACK_SIZE	2048
+#define CLIENT_CALLS		5
+#define HOLD_MS			10
+
+enum bench_id {
+	BENCH_ECHO_CMD,
+	BENCH_HOLD_CMD,
+	BENCH_EVT,
+};
+
+NRF_RPC_GROUP_DEFINE(bench_grp, "nrf_rpc_bench", NULL, NULL, NULL);
+
+static const size_t payload_sizes[] = { 0, 16, 64, 244, PAYLOAD_MAX };
+
+static uint8_t payload[PAYLOAD_MAX];
+static uint32_t latency[LATENCY_CALLS];
+
+static K_SEM_DEFINE(events_done, 0, 1);
+static atomic_t events_received;
+static atomic_t event_bytes;
+
+static atomic_t hold_active;
+static atomic_t hold_active_max;
+
+static K_THREAD_STACK_ARRAY_DEFINE(client_stacks, CLIENT_THREADS, CLIENT_STACK_SIZE);
+static struct k_thread client_threads[CLIENT_THREADS];
+static atomic_t client_errors;
+
+/* The kernel clock of native_posix stands still while the calls are served,
+ * so the benchmarks read the clock of the host there.
+ */
+static uint64_t time_us(void)
+{
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+	return native_rtc_gettime_us(RTC_CLOCK_REAL);
+#else
+	return k_cyc_to_us_floor64(k_cycle_get_32());
+#endif
+}
+
+static uint32_t checksum(const uint8_t *data, size_t len)
+{
+	uint32_t sum = 0;
+
+	for (size_t i = 0; i < len; i++) {
+		sum = sum * 31 + data[i];
+	}
+
+	return sum;
+}
+
+static size_t decode_payload(CborValue *value, uint8_t *buf)
+{
+	size_t len = PAYLOAD_MAX;
+
+	if (!cbor_value_is_byte_string(value) ||
+	    (cbor_value_copy_byte_string(value, buf, &len, NULL) != CborNoError)) {
+		return SIZE_MAX;
+	}
+
+	return len;
+}
+
+static void echo_handler(CborValue *value, void *handler_data)
+{
+	struct nrf_rpc_cbor_ctx ctx;
+	uint8_t buf[PAYLOAD_MAX];
+	size_t len;
+
+	len = decode_payload(value, buf);
+	nrf_rpc_cbor_decoding_done(value);
+
+	NRF_RPC_CBOR_ALLOC(ctx, 10);
+	cbor_encode_uint(&ctx.encoder, (len == SIZE_MAX) ? 0 : checksum(buf, len));
+	nrf_rpc_cbor_rsp_no_err(&ctx);
+}
+
+NRF_RPC_CBOR_CMD_DECODER(bench_grp, bench_echo, BENCH_ECHO_CMD, echo_handler, NULL);
+
+static void hold_handler(CborValue *value, void *handler_data)
+{
+	struct nrf_rpc_cbor_ctx ctx;
+	atomic_val_t active;
+	atomic_val_t max;
+
+	nrf_rpc_cbor_decoding_done(value);
+
+	active = atomic_inc(&hold_active) + 1;
+	do {
+		max = atomic_get(&hold_active_max);
+	} while ((active > max) && !atomic_cas(&hold_active_max, max, active));
+
+	/* Keeps the thread of the pool busy */
+	k_sleep(K_MSEC(HOLD_MS));
+	atomic_dec(&hold_active);
+
+	NRF_RPC_CBOR_ALLOC(ctx, 0);
+	nrf_rpc_cbor_rsp_no_err(&ctx);
+}
+
+NRF_RPC_CBOR_CMD_DECODER(bench_grp, bench_hold, BENCH_HOLD_CMD, hold_handler, NULL);
+
+static void event_handler(CborValue *value, void *handler_data)
+{
+	size_t len = 0;
+
+	if (cbor_value_is_byte_string(value)) {
+		cbor_value_get_string_length(value, &len);
+	}
+	nrf_rpc_cbor_decoding_done(value);
+
+	atomic_add(&event_bytes, len);
+	if (atomic_inc(&events_received) + 1 == EVENT_COUNT) {
+		k_sem_give(&events_done);
+	}
+}
+
+NRF_RPC_CBOR_EVT_DECODER(bench_grp, bench_evt, BENCH_EVT, event_handler, NULL);
+
+static void rsp_decode_uint(CborValue *value, void *handler_data)
+{
+	uint64_t result = 0;
+
+	if (cbor_value_is_unsigned_integer(value)) {
+		cbor_value_get_uint64(value, &result);
+	}
+
+	*(uint32_t *)handler_data = result;
+}
+
+static void rsp_decode_void(CborValue *value, void *handler_data)
+{
+}
+
+static int echo(size_t len, uint32_t *result)
+{
+	struct nrf_rpc_cbor_ctx ctx;
+
+	NRF_RPC_CBOR_ALLOC(ctx, len + 5);
+	cbor_encode_byte_string(&ctx.encoder, payload, len);
+
+	return nrf_rpc_cbor_cmd(&bench_grp, BENCH_ECHO_CMD, &ctx, rsp_decode_uint, result);
+}
+
+static int compare_u32(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a;
+	uint32_t y = *(const uint32_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+static uint32_t percentile(const uint32_t *sorted, size_t count, size_t percent)
+{
+	return sorted[(count - 1) * percent / 100];
+}
+
+static void test_cmd_latency(void)
+{
+	struct nrf_rpc_loopback_stats stats;
+	uint32_t result;
+	uint64_t start;
+	int err;
+
+	for (size_t s = 0; s < ARRAY_SIZE(payload_sizes); s++) {
+		size_t len = payload_sizes[s];
+
+		nrf_rpc_loopback_stats_reset();
+
+		for (size_t i = 0; i < LATENCY_CALLS; i++) {
+			start = time_us();
+			err = echo(len, &result);
+			latency[i] = time_us() - start;
+
+			zassert_equal(err, 0, "Return value %d is wrong", err);
+			zassert_equal(result, checksum(payload, len), "Wrong echo");
+		}
+
+		nrf_rpc_loopback_stats_get(&stats);
+		qsort(latency, LATENCY_CALLS, sizeof(latency[0]), compare_u32);
+
+		TC_PRINT("Command, %zu bytes: p50 %u us, p90 %u us, p99 %u us, max %u us, "
+			 "%u packets, %u bytes\n", len,
+			 percentile(latency, LATENCY_CALLS, 50),
+			 percentile(latency, LATENCY_CALLS, 90),
+			 percentile(latency, LATENCY_CALLS, 99),
+			 percentile(latency, LATENCY_CALLS, 100),
+			 stats.packets, stats.bytes);
+
+		/* A command and its response */
+		zassert_equal(stats.packets, 2 * LATENCY_CALLS, "Extra packets: %u",
+			      stats.packets);
+		zassert_true(stats.bytes <= LATENCY_CALLS * (len + 2 * CALL_OVERHEAD_MAX),
+			     "Call overhead grew: %u bytes", stats.bytes);
+	}
+}
+
+static void test_evt_throughput(void)
+{
+	struct nrf_rpc_loopback_stats stats;
+	struct nrf_rpc_cbor_ctx ctx;
+	uint64_t elapsed_us;
+	uint64_t start;
+	int err;
+
+	for (size_t s = 0; s < ARRAY_SIZE(payload_sizes); s++) {
+		size_t len = payload_sizes[s];
+
+		atomic_clear(&events_received);
+		atomic_clear(&event_bytes);
+		nrf_rpc_loopback_stats_reset();
+
+		start = time_us();
+		for (size_t i = 0; i < EVENT_COUNT; i++) {
+			NRF_RPC_CBOR_ALLOC(ctx, len + 5);
+			cbor_encode_byte_string(&ctx.encoder, payload, len);
+
+			err = nrf_rpc_cbor_evt(&bench_grp, BENCH_EVT, &ctx);
+			zassert_equal(err, 0, "Return value %d is wrong", err);
+		}
+
+		err = k_sem_take(&events_done, K_SECONDS(10));
+		zassert_equal(err, 0, "Events lost, received %d",
+			      atomic_get(&events_received));
+		elapsed_us = time_us() - start;
+
+		nrf_rpc_loopback_stats_get(&stats);
+
+		TC_PRINT("Event, %zu bytes: %u events in %u us, %u packets, %u bytes, "
+			 "%u pending max\n", len, EVENT_COUNT,
+			 (uint32_t)elapsed_us, stats.packets, stats.bytes,
+			 stats.max_pending);
+
+		zassert_true(elapsed_us > 0, "Time was not measured");
+		zassert_equal(atomic_get(&event_bytes), EVENT_COUNT * len, "Payload lost");
+		/* An event and its acknowledgment */
+		zassert_equal(stats.packets, 2 * EVENT_COUNT, "Extra packets: %u",
+			      stats.packets);
+	}
+}
+
+static void client_entry(void *p1, void *p2, void *p3)
+{
+	struct nrf_rpc_cbor_ctx ctx;
+	int err;
+
+	for (int i = 0; i < CLIENT_CALLS; i++) {
+		NRF_RPC_CBOR_ALLOC(ctx, 0);
+
+		err = nrf_rpc_cbor_cmd(&bench_grp, BENCH_HOLD_CMD, &ctx, rsp_decode_void, NULL);
+		if (err) {
+			atomic_inc(&client_errors);
+		}
+	}
+}
+
+/* More callers than threads in the pool compete for them */
+static void test_pool_contention(void)
+{
+	const uint32_t rounds = DIV_ROUND_UP(CLIENT_THREADS * CLIENT_CALLS,
+					     CONFIG_NRF_RPC_THREAD_POOL_SIZE);
+	struct nrf_rpc_os_stats os_stats;
+	int64_t start;
+	int64_t elapsed;
+	int err;
+
+	atomic_clear(&hold_active_max);
+	atomic_clear(&client_errors);
+	nrf_rpc_os_stats_reset();
+
+	start = k_uptime_get();
+	for (int i = 0; i < CLIENT_THREADS; i++) {
+		k_thread_create(&client_threads[i], client_stacks[i],
+				K_THREAD_STACK_SIZEOF(client_stacks[i]), client_entry,
+				NULL, NULL, NULL, K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+	}
+
+	for (int i = 0; i < CLIENT_THREADS; i++) {
+		err = k_thread_join(&client_threads[i], K_SECONDS(10));
+		zassert_equal(err, 0, "Client %d did not finish", i);
+	}
+	elapsed = k_uptime_get() - start;
+
+	TC_PRINT("Contention, %u callers, %u threads: %u ms, ideal %u ms, %u active max\n",
+		 CLIENT_THREADS, CONFIG_NRF_RPC_THREAD_POOL_SIZE, (uint32_t)elapsed,
+		 rounds * HOLD_MS, (uint32_t)atomic_get(&hold_active_max));
+
+	zassert_equal(atomic_get(&client_errors), 0, "Calls failed");
+	zassert_true(atomic_get(&hold_active_max) <= CONFIG_NRF_RPC_THREAD_POOL_SIZE,
+		     "More handlers than threads in the pool");
+	zassert_true(elapsed >= rounds * HOLD_MS, "Calls were not executed");
+
+	nrf_rpc_os_stats_get(&os_stats);
+
+	TC_PRINT("Thread pool: %u dispatched, queue depth %u max, %u busy max, "
+		 "context wait %u us max\n",
+		 os_stats.dispatched, os_stats.queue_depth_max, os_stats.threads_busy_max,
+		 (uint32_t)k_cyc_to_us_floor64(os_stats.ctx_wait_cycles_max));
+
+	zassert_true(os_stats.dispatched >= CLIENT_THREADS * CLIENT_CALLS,
+		     "Commands not dispatched to the pool");
+	zassert_true(os_stats.queue_depth_max <= CONFIG_NRF_RPC_OS_DISPATCH_QUEUE_SIZE,
+		     "Queue overflow");
+	zassert_true(os_stats.threads_busy_max <= CONFIG_NRF_RPC_THREAD_POOL_SIZE,
+		     "Too many busy threads: %u", os_stats.threads_busy_max);
+	zassert_true(os_stats.threads_busy_max > 1, "Calls were not executed concurrently");
+}
+
+static void err_handler(const struct nrf_rpc_err_report *report)
+{
+	zassert_unreachable("nRF RPC error %d", report->code);
+}
+
+void test_main(void)
+{
+	int err;
+
+	for (size_t i = 0; i < sizeof(payload); i++) {
+		payload[i] = i * 7;
+	}
+
+	err = nrf_rpc_init(err_handler);
+	zassert_equal(err, 0, "nRF RPC initialization failed: %d", err);
+
+	ztest_test_suite(nrf_rpc_loopback,
+		ztest_unit_test(test_cmd_latency),
+		ztest_unit_test(test_evt_throughput),
+		ztest_unit_test(test_pool_contention)
+	);
+
+	ztest_run_test_suite(nrf_rpc_loopback);
+}